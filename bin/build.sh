@@ -85,12 +85,34 @@ function cmake_cross_platform()
         -DCMAKE_EXE_LINKER_FLAGS="-fPIC" \
         -DCMAKE_MODULE_LINKER_FLAGS="-fPIC" \
         -DCMAKE_SHARED_LINKER_FLAGS="-fPIC" \
+        -DUSE_DOUBLE_PRECISION="$double_precision" \
+        -DUSE_BULLET_PROFILE="$bullet_profile" \
+        -DBUILD_PYTHON_BINDINGS="$python_bindings" \
+        -DPYTHON_BINDINGS_VERSION="$python_bindings_version" \
         || { echo "- ERROR: CMake for Bullet Physics failed."; exit 1; }
 }
 
 build_target=$BUILD_DIR
 build_src=$SRC_DIR
 
+# Match the precision and profiling Bullet was built with
+double_precision="ON"
+bullet_profile="OFF"
+if [ -f "$CONF_DIR/bullet.conf" ]; then
+    source "$CONF_DIR/bullet.conf"
+    double_precision="${BULLET_DOUBLE_PRECISION:-ON}"
+    bullet_profile="${BULLET_PROFILE:-OFF}"
+fi
+
+# Build the ntrt Python module if setup installed pybind11 for it
+python_bindings="OFF"
+python_bindings_version=""
+if [ -f "$CONF_DIR/pybind11.conf" ]; then
+    source "$CONF_DIR/pybind11.conf"
+    python_bindings="${PYTHON_BINDINGS:-OFF}"
+    python_bindings_version="$PYTHON_BINDINGS_VERSION"
+fi
+
 # Handle Arguments
 MAKE_CLEAN_FLAG=false
 CMAKE_COMPILER_WARNINGS_FLAG=false
@@ -157,19 +157,24 @@ function build_bullet()
     pushd "$BULLET_BUILD_DIR" > /dev/null
 
     # Perform the build
-    # If you turn double precision on, turn it on in inc.CMakeBullet.txt as well for the NTRT build
+    # Precision and profiling come from BULLET_DOUBLE_PRECISION and
+    # BULLET_PROFILE in bullet.conf; build.sh passes the same to NTRT
+    local cxx_flags="-fPIC"
+    if [ "${BULLET_PROFILE:-OFF}" != "ON" ]; then
+        cxx_flags="$cxx_flags -DBT_NO_PROFILE"
+    fi
     "$ENV_DIR/bin/cmake" . -G "Unix Makefiles" \
         -DBUILD_SHARED_LIBS=OFF \
         -DBUILD_EXTRAS=ON \
         -DCMAKE_INSTALL_PREFIX="$BULLET_INSTALL_PREFIX" \
         -DCMAKE_C_FLAGS="-fPIC" \
-        -DCMAKE_CXX_FLAGS="-fPIC" \
+        -DCMAKE_CXX_FLAGS="$cxx_flags" \
         -DCMAKE_C_COMPILER="gcc" \
         -DCMAKE_CXX_COMPILER="g++" \
         -DCMAKE_EXE_LINKER_FLAGS="-fPIC" \
         -DCMAKE_MODULE_LINKER_FLAGS="-fPIC" \
         -DCMAKE_SHARED_LINKER_FLAGS="-fPIC" \
-        -DUSE_DOUBLE_PRECISION=ON \
+        -DUSE_DOUBLE_PRECISION="${BULLET_DOUBLE_PRECISION:-ON}" \
         -DCMAKE_INSTALL_NAME_DIR="$BULLET_INSTALL_PREFIX" || { echo "- ERROR: CMake for Bullet Physics failed."; exit 1; }
     #If you turn this on, turn it on in inc.CMakeBullet.txt as well for the NTRT build
     # Additional bullet options: 
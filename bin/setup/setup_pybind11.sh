@@ -0,0 +1,138 @@
+#!/bin/bash
+
+# Copyright © 2012, United States Government, as represented by the
+# Administrator of the National Aeronautics and Space Administration.
+# All rights reserved.
+# 
+# The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+# under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+# http://www.apache.org/licenses/LICENSE-2.0.
+# 
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+# either express or implied. See the License for the specific language
+# governing permissions and limitations under the License.
+
+# Purpose: pybind11 setup, for the ntrt Python module
+# Date:    2026-10-18
+
+##############################################################################
+#                         START DO NOT MODIFY                                #
+##############################################################################
+SCRIPT_PATH="`dirname \"$0\"`"
+SCRIPT_PATH="`( cd \"$SCRIPT_PATH\" && pwd )`"
+##############################################################################
+#                          END DO NOT MODIFY                                 #
+##############################################################################
+
+# Add the relative path from this script to the helpers folder.
+pushd "${SCRIPT_PATH}/helpers/" > /dev/null
+
+##############################################################################
+#                         START DO NOT MODIFY                                #
+##############################################################################
+if [ ! -f "helper_functions.sh" ]; then
+    echo "Could not find helper_functions.sh. Are we in the bash helpers folder?"
+    exit 1;
+fi
+
+# Import our common files
+source "helper_functions.sh"
+source "helper_paths.sh"
+source "helper_definitions.sh"
+
+# Get out of the bash helpers folder.
+popd > /dev/null
+##############################################################################
+#                          END DO NOT MODIFY                                 #
+##############################################################################
+
+#Source this package's configuration
+source_conf "general.conf"
+source_conf "pybind11.conf"
+
+# Variables
+pybind11_pkg=`echo $PYBIND11_URL|awk -F/ '{print $NF}'`  # get the package name from the url
+
+# Download the package to env/downloads
+function download_pybind11()
+{
+
+    pybind11_pkg_path="$DOWNLOADS_DIR/$pybind11_pkg"
+
+    if [ -f "$pybind11_pkg_path" ]; then
+        echo "- pybind11 package already exists ('$pybind11_pkg_path') -- skipping download."
+        return
+    fi
+
+    echo "Downloading $pybind11_pkg to $pybind11_pkg_path"
+    download_file "$PYBIND11_URL" "$pybind11_pkg_path"
+}
+
+# Unpack to the build directory specified in install.conf
+function unpack_pybind11()
+{
+    # Create directory and unpack
+    if check_directory_exists "$PYBIND11_BUILD_DIR"; then
+        echo "- pybind11 is already unpacked to '$PYBIND11_BUILD_DIR' -- skipping."
+        return
+    fi
+
+    echo "Unpacking pybind11 to $PYBIND11_BUILD_DIR"
+    create_directory_if_noexist $PYBIND11_BUILD_DIR
+
+    pushd "$PYBIND11_BUILD_DIR" > /dev/null
+    tar xf "$DOWNLOADS_DIR/$pybind11_pkg" --strip-components=1 || { echo "- ERROR: Failed to unpack pybind11"; exit 1; }
+    popd > /dev/null
+}
+
+# pybind11 is header only: installing is copying the headers
+function install_pybind11()
+{
+
+    echo "- Installing pybind11 under $PYBIND11_INSTALL_PREFIX"
+
+    create_directory_if_noexist "$PYBIND11_INSTALL_PREFIX/include"
+    cp -R "$PYBIND11_PACKAGE_DIR/include/pybind11" "$PYBIND11_INSTALL_PREFIX/include/" || { echo "Install failed -- maybe you need to use sudo when running setup?"; exit 1; }
+}
+
+function main()
+{
+
+    if [ "$PYTHON_BINDINGS" != "ON" ]; then
+        echo "- Python bindings are off in conf/pybind11.conf -- skipping."
+        return
+    fi
+
+    ensure_install_prefix_writable $PYBIND11_INSTALL_PREFIX
+
+    if check_file_exists "$PYBIND11_INSTALL_PREFIX/include/pybind11/pybind11.h"; then
+        echo "- pybind11 is installed under prefix $PYBIND11_INSTALL_PREFIX -- skipping."
+        return
+    fi
+
+    if check_file_exists "$PYBIND11_PACKAGE_DIR/include/pybind11/pybind11.h"; then
+        echo "- pybind11 is already unpacked to $PYBIND11_BUILD_DIR -- skipping."
+        install_pybind11
+        return
+    fi
+
+    if check_file_exists "$DOWNLOADS_DIR/$pybind11_pkg"; then
+        echo "- pybind11 package already exists under env/downloads -- skipping download."
+        unpack_pybind11
+        install_pybind11
+        return
+    fi
+
+    # If we haven't returned by now, we have to do everything
+    download_pybind11
+    unpack_pybind11
+    install_pybind11
+
+}
+
+
+main
@@ -50,7 +50,7 @@ popd > /dev/null
 #                          END DO NOT MODIFY                                 #
 ##############################################################################
 
-CONF_FILES=("general.conf" "boost.conf" "bullet.conf" "build.conf" "jsoncpp.conf" "gmocktest.conf" "neuralnet.conf" "yamlcpp.conf")
+CONF_FILES=("general.conf" "boost.conf" "bullet.conf" "build.conf" "jsoncpp.conf" "gmocktest.conf" "neuralnet.conf" "yamlcpp.conf" "pybind11.conf")
 
 function banner() 
 {
@@ -142,6 +142,7 @@ run_setupscript "boost" "Boost"
 run_setupscript "yamlcpp" "YamlCPP"
 run_setupscript "neuralnet" "Neural Net"
 run_setupscript "bullet" "Bullet Physics Library"
+run_setupscript "pybind11" "pybind11"
 
 
 echo ""
@@ -0,0 +1,218 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgOscillatorBank.cpp
+ * @brief Implementation of the tgOscillatorBank class
+ * $Id$
+ */
+
+#include "tgOscillatorBank.h"
+
+#include "core/tgBasicActuator.h"
+
+// The C++ Standard Library
+#include <cassert>
+#include <cmath>
+#include <stdexcept>
+
+namespace
+{
+	double clamp(double x, double lo, double hi)
+	{
+		return x < lo ? lo : (x > hi ? hi : x);
+	}
+}
+
+tgOscillatorBank::Config::Config(std::size_t resync,
+									double minOut,
+									double maxOut) :
+resyncSteps(resync),
+minOutput(minOut),
+maxOutput(maxOut)
+{
+	if (resyncSteps == 0)
+	{
+		throw std::invalid_argument("resyncSteps is zero");
+	}
+	else if (minOutput > maxOutput)
+	{
+		throw std::invalid_argument("minOutput is greater than maxOutput");
+	}
+}
+
+tgOscillatorBank::tgOscillatorBank(const Config& config) :
+m_config(config),
+m_time(0.0),
+m_stepSize(0.0),
+m_stepsSinceResync(0)
+{
+}
+
+std::size_t tgOscillatorBank::addChannel(double amplitude,
+											double angularFrequency,
+											double phase,
+											double offset)
+{
+	m_amplitude.push_back(amplitude);
+	m_angularFrequency.push_back(angularFrequency);
+	m_phase.push_back(phase);
+	m_offset.push_back(offset);
+	m_sin.push_back(0.0);
+	m_cos.push_back(1.0);
+	m_stepSin.push_back(0.0);
+	m_stepCos.push_back(1.0);
+	m_outputs.push_back(0.0);
+
+	const std::size_t channel = size() - 1;
+	setChannel(channel, amplitude, angularFrequency, phase, offset);
+	return channel;
+}
+
+void tgOscillatorBank::setChannel(std::size_t channel,
+									double amplitude,
+									double angularFrequency,
+									double phase,
+									double offset)
+{
+	if (channel >= size())
+	{
+		throw std::out_of_range("No such channel");
+	}
+	m_amplitude[channel] = amplitude;
+	m_angularFrequency[channel] = angularFrequency;
+	m_phase[channel] = phase;
+	m_offset[channel] = offset;
+
+	const double angle = angularFrequency * m_time + phase;
+	m_sin[channel] = std::sin(angle);
+	m_cos[channel] = std::cos(angle);
+	if (m_stepSize > 0.0)
+	{
+		m_stepSin[channel] = std::sin(angularFrequency * m_stepSize);
+		m_stepCos[channel] = std::cos(angularFrequency * m_stepSize);
+	}
+
+	m_outputs[channel] = clamp(offset + amplitude * m_sin[channel],
+								m_config.minOutput, m_config.maxOutput);
+}
+
+void tgOscillatorBank::clear()
+{
+	m_amplitude.clear();
+	m_angularFrequency.clear();
+	m_phase.clear();
+	m_offset.clear();
+	m_sin.clear();
+	m_cos.clear();
+	m_stepSin.clear();
+	m_stepCos.clear();
+	m_outputs.clear();
+	m_time = 0.0;
+	m_stepsSinceResync = 0;
+}
+
+void tgOscillatorBank::reset()
+{
+	m_time = 0.0;
+	resync();
+	updateOutputs();
+}
+
+const std::vector<double>& tgOscillatorBank::step(double dt)
+{
+	if (dt <= 0.0)
+	{
+		throw std::invalid_argument("dt is not positive");
+	}
+
+	m_time += dt;
+
+	if (++m_stepsSinceResync >= m_config.resyncSteps)
+	{
+		resync();
+	}
+	else
+	{
+		if (dt != m_stepSize)
+		{
+			setStepSize(dt);
+		}
+
+		// Rotate each channel's (cos, sin) by its angle per step
+		const std::size_t n = size();
+		double* const s = n ? &m_sin[0] : NULL;
+		double* const c = n ? &m_cos[0] : NULL;
+		const double* const ds = n ? &m_stepSin[0] : NULL;
+		const double* const dc = n ? &m_stepCos[0] : NULL;
+		for (std::size_t i = 0; i < n; i++)
+		{
+			const double si = s[i];
+			const double ci = c[i];
+			s[i] = si * dc[i] + ci * ds[i];
+			c[i] = ci * dc[i] - si * ds[i];
+		}
+	}
+
+	updateOutputs();
+	return m_outputs;
+}
+
+void tgOscillatorBank::apply(const std::vector<tgBasicActuator*>& actuators,
+								double dt) const
+{
+	if (actuators.size() != m_outputs.size())
+	{
+		throw std::invalid_argument("Number of actuators is not the number of channels");
+	}
+	for (std::size_t i = 0; i < actuators.size(); i++)
+	{
+		assert(actuators[i] != NULL);
+		actuators[i]->setControlInput(m_outputs[i], dt);
+	}
+}
+
+void tgOscillatorBank::resync()
+{
+	for (std::size_t i = 0; i < size(); i++)
+	{
+		const double angle = m_angularFrequency[i] * m_time + m_phase[i];
+		m_sin[i] = std::sin(angle);
+		m_cos[i] = std::cos(angle);
+	}
+	m_stepsSinceResync = 0;
+}
+
+void tgOscillatorBank::setStepSize(double dt)
+{
+	for (std::size_t i = 0; i < size(); i++)
+	{
+		m_stepSin[i] = std::sin(m_angularFrequency[i] * dt);
+		m_stepCos[i] = std::cos(m_angularFrequency[i] * dt);
+	}
+	m_stepSize = dt;
+}
+
+void tgOscillatorBank::updateOutputs()
+{
+	for (std::size_t i = 0; i < size(); i++)
+	{
+		m_outputs[i] = clamp(m_offset[i] + m_amplitude[i] * m_sin[i],
+								m_config.minOutput, m_config.maxOutput);
+	}
+}
@@ -0,0 +1,163 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_OSCILLATOR_BANK_H
+#define TG_OSCILLATOR_BANK_H
+
+/**
+ * @file tgOscillatorBank.h
+ * @brief Definition of the tgOscillatorBank class
+ * $Id$
+ */
+
+// The C++ Standard Library
+#include <cstddef>
+#include <vector>
+
+// Forward declarations
+class tgBasicActuator;
+
+/**
+ * Open loop sine wave generators for any number of channels, each
+ * producing offset + amplitude * sin(angularFrequency * t + phase).
+ *
+ * Rather than calling sin() for every channel every step, each channel
+ * keeps its current sine and cosine and rotates them by a fixed angle
+ * per step, which costs four multiplies. The rotation drifts slowly, so
+ * every resyncSteps steps the bank recomputes each channel exactly from
+ * the elapsed time. apply() then writes all the outputs to their
+ * actuators in one pass.
+ */
+class tgOscillatorBank
+{
+public:
+
+	struct Config
+	{
+		/**
+		 * @param[in] resyncSteps, the number of steps between exact
+		 * evaluations; must be positive
+		 * @param[in] minOutput, outputs are clamped to at least this
+		 * @param[in] maxOutput, outputs are clamped to at most this
+		 */
+		Config(std::size_t resyncSteps = 1000,
+				double minOutput = -1.0e300,
+				double maxOutput = 1.0e300);
+
+		std::size_t resyncSteps;
+		double minOutput;
+		double maxOutput;
+	};
+
+	tgOscillatorBank(const Config& config = Config());
+
+	/**
+	 * Add a channel, starting at the current time.
+	 * @param[in] angularFrequency, in radians per second
+	 * @param[in] phase, in radians
+	 * @return the index of the channel, which is the index of its
+	 * output and of its actuator in apply()
+	 */
+	std::size_t addChannel(double amplitude,
+							double angularFrequency,
+							double phase,
+							double offset);
+
+	/** Change the parameters of a channel; see addChannel() */
+	void setChannel(std::size_t channel,
+					double amplitude,
+					double angularFrequency,
+					double phase,
+					double offset);
+
+	/** Remove all channels and set the time back to zero. */
+	void clear();
+
+	/** Set the time back to zero, keeping the channels. */
+	void reset();
+
+	/**
+	 * Advance every channel by dt and compute the outputs.
+	 * @param[in] dt - the timestep. Must be positive.
+	 * @return getOutputs()
+	 */
+	const std::vector<double>& step(double dt);
+
+	/**
+	 * Send each output to the actuator with the same index, as
+	 * tgBasicActuator::setControlInput(output, dt).
+	 * @throw std::invalid_argument if the sizes differ
+	 */
+	void apply(const std::vector<tgBasicActuator*>& actuators, double dt) const;
+
+	/** Return the output of each channel at getTime(). */
+	const std::vector<double>& getOutputs() const
+	{
+		return m_outputs;
+	}
+
+	std::size_t size() const
+	{
+		return m_amplitude.size();
+	}
+
+	double getTime() const
+	{
+		return m_time;
+	}
+
+private:
+
+	/** Recompute every channel's sine and cosine from the time. */
+	void resync();
+
+	/** Recompute the per step rotation of every channel for dt. */
+	void setStepSize(double dt);
+
+	/** Offset plus amplitude times sine, clamped. */
+	void updateOutputs();
+
+private:
+
+	const Config m_config;
+
+	/** One entry per channel */
+	std::vector<double> m_amplitude;
+	std::vector<double> m_angularFrequency;
+	std::vector<double> m_phase;
+	std::vector<double> m_offset;
+
+	/** The sine and cosine of each channel's angle at m_time */
+	std::vector<double> m_sin;
+	std::vector<double> m_cos;
+
+	/** The sine and cosine of each channel's angle per step */
+	std::vector<double> m_stepSin;
+	std::vector<double> m_stepCos;
+
+	std::vector<double> m_outputs;
+
+	double m_time;
+
+	/** The dt m_stepSin and m_stepCos are for; 0 if none yet */
+	double m_stepSize;
+
+	std::size_t m_stepsSinceResync;
+};
+
+#endif  // TG_OSCILLATOR_BANK_H
@@ -0,0 +1,285 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgSamplingMPC.cpp
+ * @brief Implementation of the tgSamplingMPC base class
+ * $Id$
+ */
+
+#include "tgSamplingMPC.h"
+
+#include "core/tgBasicActuator.h"
+#include "core/tgCast.h"
+#include "core/tgModel.h"
+#include "core/tgSimulation.h"
+
+// The C++ Standard Library
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <stdexcept>
+
+tgSamplingMPC::Config::Config(std::size_t s,
+								std::size_t h,
+								std::size_t k,
+								double sd,
+								double t,
+								double minRest,
+								double maxRest,
+								std::size_t th,
+								unsigned long sd0) :
+samples(s),
+horizon(h),
+knotSteps(k),
+sigma(sd),
+temperature(t),
+minRestLength(minRest),
+maxRestLength(maxRest),
+threads(th),
+seed(sd0)
+{
+	if (samples == 0)
+	{
+		throw std::invalid_argument("samples is zero");
+	}
+	else if (horizon == 0)
+	{
+		throw std::invalid_argument("horizon is zero");
+	}
+	else if (knotSteps == 0)
+	{
+		throw std::invalid_argument("knotSteps is zero");
+	}
+	else if (sigma < 0.0)
+	{
+		throw std::invalid_argument("sigma is negative");
+	}
+	else if (temperature < 0.0)
+	{
+		throw std::invalid_argument("temperature is negative");
+	}
+	else if (minRestLength > maxRestLength)
+	{
+		throw std::invalid_argument("minRestLength is greater than maxRestLength");
+	}
+}
+
+tgSamplingMPC::tgSamplingMPC(const Config& config,
+								tgSimulation& simulation,
+								tgSimulationFork::Factory& factory) :
+m_config(config),
+m_simulation(simulation),
+m_factory(factory),
+m_pFork(NULL),
+m_width(0),
+m_bestCost(0.0),
+m_planCount(0),
+m_stepsSincePlan(0),
+m_noise(std::tr1::mt19937(config.seed),
+		std::tr1::normal_distribution<double>(0.0, 1.0))
+{
+}
+
+tgSamplingMPC::~tgSamplingMPC()
+{
+	delete m_pFork;
+}
+
+void tgSamplingMPC::control(const std::vector<tgBasicActuator*>& actuators,
+							double dt)
+{
+	if (m_pFork == NULL || m_stepsSincePlan >= m_config.knotSteps)
+	{
+		plan(actuators, dt);
+	}
+	assert(m_action.size() == actuators.size());
+	for (std::size_t i = 0; i < actuators.size(); i++)
+	{
+		actuators[i]->setControlInput(m_action[i], dt);
+	}
+	m_stepsSincePlan++;
+}
+
+const std::vector<double>& tgSamplingMPC::plan(const std::vector<tgBasicActuator*>& actuators,
+												double dt)
+{
+	if (actuators.empty())
+	{
+		throw std::invalid_argument("No actuators to control");
+	}
+
+	// Fork once; after that, move the branches to the current state
+	m_simulation.captureState(m_state);
+	if (m_pFork == NULL)
+	{
+		tgSimulationFork* const pFork =
+			m_simulation.fork(m_config.samples, m_factory, m_config.threads);
+
+		// Syncing keeps the branches' models, and with them their actuators
+		std::vector<std::vector<tgBasicActuator*> > branchActuators(pFork->size());
+		for (std::size_t i = 0; i < pFork->size(); i++)
+		{
+			branchActuators[i] = tgCast::filter<tgModel, tgBasicActuator>
+				(pFork->getModel(i).getDescendants());
+			if (branchActuators[i].size() != actuators.size())
+			{
+				delete pFork;
+				throw std::invalid_argument("Branch has a different number of actuators");
+			}
+		}
+		m_pFork = pFork;
+		m_branchActuators.swap(branchActuators);
+	}
+	else
+	{
+		m_pFork->sync(m_state);
+	}
+
+	warmStart(actuators);
+	sample();
+	m_costs.assign(m_config.samples, 0.0);
+
+	m_pFork->step(dt, m_config.horizon * m_config.knotSteps, this);
+
+	// The last period ends after the last step
+	for (std::size_t i = 0; i < m_pFork->size(); i++)
+	{
+		const tgModel& model = m_pFork->getModel(i);
+		m_costs[i] += stageCost(model, m_config.horizon - 1) +
+						terminalCost(model);
+	}
+
+	update();
+	m_action.assign(m_nominal.begin(), m_nominal.begin() + m_width);
+	m_stepsSincePlan = 0;
+	m_planCount++;
+	return m_action;
+}
+
+void tgSamplingMPC::reset()
+{
+	delete m_pFork;
+	m_pFork = NULL;
+	m_branchActuators.clear();
+	m_nominal.clear();
+	m_action.clear();
+	m_stepsSincePlan = 0;
+}
+
+void tgSamplingMPC::onStep(std::size_t branch, tgModel& model,
+							std::size_t step, double dt)
+{
+	const std::size_t knot = step / m_config.knotSteps;
+	if (step > 0 && step % m_config.knotSteps == 0)
+	{
+		m_costs[branch] += stageCost(model, knot - 1);
+	}
+
+	const double* const targets =
+		&m_samples[(branch * m_config.horizon + knot) * m_width];
+	const std::vector<tgBasicActuator*>& actuators = m_branchActuators[branch];
+	for (std::size_t i = 0; i < actuators.size(); i++)
+	{
+		actuators[i]->setControlInput(targets[i], dt);
+	}
+}
+
+void tgSamplingMPC::warmStart(const std::vector<tgBasicActuator*>& actuators)
+{
+	const std::size_t n = actuators.size();
+	if (m_width != n || m_nominal.empty())
+	{
+		// Start by holding the current rest lengths
+		m_width = n;
+		m_nominal.resize(m_config.horizon * n);
+		for (std::size_t k = 0; k < m_config.horizon; k++)
+		{
+			for (std::size_t i = 0; i < n; i++)
+			{
+				m_nominal[k * n + i] = clamp(actuators[i]->getRestLength());
+			}
+		}
+	}
+	else
+	{
+		// One period has passed; repeat the last
+		std::copy(m_nominal.begin() + n, m_nominal.end(), m_nominal.begin());
+	}
+}
+
+void tgSamplingMPC::sample()
+{
+	const std::size_t length = m_nominal.size();
+	m_samples.resize(m_config.samples * length);
+	std::copy(m_nominal.begin(), m_nominal.end(), m_samples.begin());
+
+	for (std::size_t s = 1; s < m_config.samples; s++)
+	{
+		double* const pSample = &m_samples[s * length];
+		for (std::size_t j = 0; j < length; j++)
+		{
+			pSample[j] = clamp(m_nominal[j] +
+								m_config.sigma * m_noise());
+		}
+	}
+}
+
+void tgSamplingMPC::update()
+{
+	const std::size_t best =
+		std::min_element(m_costs.begin(), m_costs.end()) - m_costs.begin();
+	m_bestCost = m_costs[best];
+	const std::size_t length = m_nominal.size();
+
+	if (m_config.temperature <= 0.0)
+	{
+		std::copy(m_samples.begin() + best * length,
+					m_samples.begin() + (best + 1) * length,
+					m_nominal.begin());
+	}
+	else
+	{
+		// MPPI: weight each sample by exp(-cost / temperature), relative
+		// to the best so the weights can't all underflow
+		std::fill(m_nominal.begin(), m_nominal.end(), 0.0);
+		double total = 0.0;
+		for (std::size_t s = 0; s < m_config.samples; s++)
+		{
+			const double w =
+				std::exp(-(m_costs[s] - m_bestCost) / m_config.temperature);
+			const double* const pSample = &m_samples[s * length];
+			for (std::size_t j = 0; j < length; j++)
+			{
+				m_nominal[j] += w * pSample[j];
+			}
+			total += w;
+		}
+		assert(total >= 1.0);
+		for (std::size_t j = 0; j < length; j++)
+		{
+			m_nominal[j] /= total;
+		}
+	}
+}
+
+double tgSamplingMPC::clamp(double restLength) const
+{
+	return std::max(m_config.minRestLength,
+					std::min(m_config.maxRestLength, restLength));
+}
@@ -0,0 +1,244 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_SAMPLING_MPC_H
+#define TG_SAMPLING_MPC_H
+
+/**
+ * @file tgSamplingMPC.h
+ * @brief Definition of the tgSamplingMPC base class
+ * $Id$
+ */
+
+#include "core/tgSimulationFork.h"
+#include "core/tgSimulationState.h"
+
+// The C++ Standard Library
+#include <cstddef>
+#include <vector>
+#include <tr1/random>
+
+// Forward declarations
+class tgBasicActuator;
+class tgModel;
+class tgSimulation;
+
+/**
+ * Sampling based model predictive control of rest lengths, in the style
+ * of MPPI and the cross entropy method.
+ *
+ * Every control period (knotSteps physics steps) the controller forks
+ * the simulation into one branch per sample (see tgSimulation::fork()),
+ * perturbs its nominal sequence of rest length targets with Gaussian
+ * noise, and rolls every sample out for horizon periods on the fork's
+ * threads. The nominal sequence becomes the best sample, or the
+ * exponentially cost weighted mean of all of them, and its first
+ * targets are sent to the actuators until the next replan. The next
+ * replan starts from that sequence shifted by one period.
+ *
+ * Subclasses define the cost. The branches are built once by a
+ * tgSimulationFork::Factory, which may build a reduced shadow model (no
+ * sensors, a simpler ground) as long as it has the same bodies and
+ * basic actuators as the real one, without this controller attached.
+ * A replan costs samples * horizon * knotSteps physics steps, split
+ * across the threads.
+ *
+ * Call control() from the model's controller on every step.
+ */
+class tgSamplingMPC : private tgSimulationFork::Policy
+{
+public:
+
+	struct Config
+	{
+		/**
+		 * @param[in] samples, the number of rollouts per replan; must
+		 * be positive. The first is always the nominal sequence.
+		 * @param[in] horizon, the number of control periods each
+		 * rollout looks ahead; must be positive
+		 * @param[in] knotSteps, the number of physics steps in a control
+		 * period; must be positive
+		 * @param[in] sigma, the standard deviation of the noise added
+		 * to each rest length target; must not be negative
+		 * @param[in] temperature, 0 to follow the best sample, or the
+		 * cost scale of the MPPI weights; must not be negative
+		 * @param[in] minRestLength, targets are clamped to at least this
+		 * @param[in] maxRestLength, targets are clamped to at most this
+		 * @param[in] threads, passed to tgSimulation::fork()
+		 * @param[in] seed, for the noise, so runs are repeatable
+		 */
+		Config(std::size_t samples = 32,
+				std::size_t horizon = 10,
+				std::size_t knotSteps = 20,
+				double sigma = 0.5,
+				double temperature = 0.0,
+				double minRestLength = 0.0,
+				double maxRestLength = 1.0e300,
+				std::size_t threads = 0,
+				unsigned long seed = 1);
+
+		std::size_t samples;
+		std::size_t horizon;
+		std::size_t knotSteps;
+		double sigma;
+		double temperature;
+		double minRestLength;
+		double maxRestLength;
+		std::size_t threads;
+		unsigned long seed;
+	};
+
+	/**
+	 * @param[in] simulation, the simulation whose state each replan
+	 * starts from; must outlive this
+	 * @param[in] factory, builds the branches' models; must outlive
+	 * this
+	 */
+	tgSamplingMPC(const Config& config,
+					tgSimulation& simulation,
+					tgSimulationFork::Factory& factory);
+
+	virtual ~tgSamplingMPC();
+
+	/**
+	 * Replan at the start of each control period, then send the current
+	 * targets to the actuators with setControlInput(target, dt).
+	 * @param[in] actuators, the basic actuators of the real model, in
+	 * the order tgCast::filter finds them among its descendants
+	 * @param[in] dt, the physics timestep
+	 * @throw std::invalid_argument if the branches have a different
+	 * number of actuators
+	 */
+	void control(const std::vector<tgBasicActuator*>& actuators, double dt);
+
+	/**
+	 * Replan now from the simulation's current state.
+	 * @return getAction()
+	 */
+	const std::vector<double>& plan(const std::vector<tgBasicActuator*>& actuators,
+									double dt);
+
+	/**
+	 * Forget the nominal sequence and delete the branches, e.g. after
+	 * the simulation is reset.
+	 */
+	void reset();
+
+	/** The rest length targets being applied, one per actuator */
+	const std::vector<double>& getAction() const
+	{
+		return m_action;
+	}
+
+	/** The cost of the best sample in the last replan */
+	double getBestCost() const
+	{
+		return m_bestCost;
+	}
+
+	/** The number of replans so far */
+	std::size_t getPlanCount() const
+	{
+		return m_planCount;
+	}
+
+protected:
+
+	/**
+	 * The cost of a branch at the end of a control period. Called from
+	 * onStep() on the fork's worker threads, concurrently for different
+	 * branches, so it must be thread-safe: read only the branch's model,
+	 * and nothing shared with other branches or the real simulation
+	 * (no members that change, no globals, no output streams).
+	 * @param[in] model, the branch's model
+	 * @param[in] knot, the control period that just ended, from 0
+	 */
+	virtual double stageCost(const tgModel& model, std::size_t knot) const = 0;
+
+	/**
+	 * The extra cost of a branch at the end of the horizon. Called on
+	 * the calling thread today, but held to the same rules as
+	 * stageCost(): read only the branch's model.
+	 * @param[in] model, the branch's model
+	 */
+	virtual double terminalCost(const tgModel& /* model */) const
+	{
+		return 0.0;
+	}
+
+private:
+
+	/** Set a branch's targets for this step, and score past periods. */
+	virtual void onStep(std::size_t branch, tgModel& model,
+						std::size_t step, double dt);
+
+	/** Start or shift the nominal sequence for n actuators. */
+	void warmStart(const std::vector<tgBasicActuator*>& actuators);
+
+	/** Fill m_samples from the nominal sequence. */
+	void sample();
+
+	/** Replace the nominal sequence from the samples and their costs. */
+	void update();
+
+	double clamp(double restLength) const;
+
+private:
+
+	const Config m_config;
+
+	tgSimulation& m_simulation;
+
+	tgSimulationFork::Factory& m_factory;
+
+	/** The branches; NULL until the first replan */
+	tgSimulationFork* m_pFork;
+
+	/** The state each replan starts from */
+	tgSimulationState m_state;
+
+	/** The basic actuators of each branch, found when forking */
+	std::vector<std::vector<tgBasicActuator*> > m_branchActuators;
+
+	/** The number of actuators */
+	std::size_t m_width;
+
+	/** horizon * m_width rest length targets */
+	std::vector<double> m_nominal;
+
+	/** samples * horizon * m_width rest length targets */
+	std::vector<double> m_samples;
+
+	/** The cost of each sample */
+	std::vector<double> m_costs;
+
+	std::vector<double> m_action;
+
+	double m_bestCost;
+
+	std::size_t m_planCount;
+
+	/** Physics steps since the last replan */
+	std::size_t m_stepsSincePlan;
+
+	/** Standard normal noise */
+	std::tr1::variate_generator<std::tr1::mt19937,
+								std::tr1::normal_distribution<double> > m_noise;
+};
+
+#endif  // TG_SAMPLING_MPC_H
@@ -0,0 +1,271 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgAdaptiveTimestep.cpp
+ * @brief Contains the definitions of members of class tgAdaptiveTimestep
+ * $Id$
+ */
+
+// This module
+#include "tgAdaptiveTimestep.h"
+// This application
+#include "tgBulletUtil.h"
+#include "tgSpringCable.h"
+#include "tgSpringCableActuator.h"
+#include "tgWorld.h"
+// The Bullet Physics Library
+#include "btBulletDynamicsCommon.h"
+// The C++ Standard Library
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <stdexcept>
+
+tgAdaptiveTimestep::Config::Config(double min,
+                                   double max,
+                                   double strain,
+                                   double drift,
+                                   double grow,
+                                   double shrink) :
+    minStep(min),
+    maxStep(max),
+    maxStrainPerStep(strain),
+    maxEnergyDrift(drift),
+    growFactor(grow),
+    shrinkFactor(shrink)
+{
+    if (minStep <= 0.0)
+    {
+        throw std::invalid_argument("minStep is not positive");
+    }
+    else if (maxStep < minStep)
+    {
+        throw std::invalid_argument("maxStep is less than minStep");
+    }
+    else if (maxStrainPerStep <= 0.0)
+    {
+        throw std::invalid_argument("maxStrainPerStep is not positive");
+    }
+    else if (maxEnergyDrift <= 0.0)
+    {
+        throw std::invalid_argument("maxEnergyDrift is not positive");
+    }
+    else if (growFactor < 1.0)
+    {
+        throw std::invalid_argument("growFactor is less than 1");
+    }
+    else if ((shrinkFactor <= 0.0) || (shrinkFactor >= 1.0))
+    {
+        throw std::invalid_argument("shrinkFactor is not in (0, 1)");
+    }
+}
+
+tgAdaptiveTimestep::tgAdaptiveTimestep(const Config& config) :
+    m_config(config)
+{
+    reset();
+}
+
+void tgAdaptiveTimestep::reset()
+{
+    m_step = m_config.minStep;
+    m_measured = false;
+    m_energy = 0.0;
+    m_referencePotential = 0.0;
+    m_scaleFloor = 0.0;
+    m_restLengths.clear();
+    m_contacts = 0;
+    m_substeps = 0;
+}
+
+double tgAdaptiveTimestep::nextStep(double remaining) const
+{
+    assert(remaining > 0.0);
+    // Split evenly; the tolerance keeps rounding from adding a substep
+    const double n = std::ceil(remaining / m_step - 1.0e-9);
+    return (n <= 1.0) ? remaining : remaining / n;
+}
+
+void tgAdaptiveTimestep::update(const tgWorld& world,
+                                const std::vector<tgSpringCableActuator*>& cables,
+                                double dt)
+{
+    assert(dt > 0.0);
+    m_substeps++;
+
+    double target = dt * m_config.growFactor;
+
+    // Cable strain rate, from the velocity tgSpringCable just measured
+    double maxRate = 0.0;
+    for (std::size_t i = 0; i < cables.size(); i++)
+    {
+        const double restLength = cables[i]->getRestLength();
+        if (restLength > 0.0)
+        {
+            maxRate = std::max(maxRate,
+                               std::fabs(cables[i]->getVelocity()) / restLength);
+        }
+    }
+    if (maxRate > 0.0)
+    {
+        target = std::min(target, m_config.maxStrainPerStep / maxRate);
+    }
+
+    // Contact events and energy drift. What the actuators put in and
+    // the dampers take out is expected, so only the rest is drift
+    const int contacts = contactCount(world);
+    double scale = 0.0;
+    const double e = energy(world, cables, scale);
+    const double work = cableWork(cables, dt);
+    if (m_measured)
+    {
+        const double drift = std::fabs(e - m_energy - work) /
+                             std::max(scale, m_scaleFloor);
+        if ((contacts > m_contacts) || (drift > m_config.maxEnergyDrift))
+        {
+            target = std::min(target, dt * m_config.shrinkFactor);
+        }
+    }
+    m_measured = true;
+    m_energy = e;
+    m_contacts = contacts;
+
+    m_step = std::max(m_config.minStep, std::min(m_config.maxStep, target));
+}
+
+double tgAdaptiveTimestep::energy(const tgWorld& world,
+                                  const std::vector<tgSpringCableActuator*>& cables,
+                                  double& scale)
+{
+    const btDynamicsWorld& dynamicsWorld =
+        tgBulletUtil::worldToDynamicsWorld(world);
+    const btCollisionObjectArray& objects =
+        dynamicsWorld.getCollisionObjectArray();
+    const double g = world.getWorldGravity();
+
+    double kinetic = 0.0;
+    double potential = 0.0;
+    double mass = 0.0;
+    double lowest = 0.0;
+    for (int i = 0; i < objects.size(); i++)
+    {
+        const btRigidBody* const pBody =
+            btRigidBody::upcast(objects[i]);
+        if ((pBody == NULL) || (pBody->getInvMass() == 0.0))
+        {
+            continue;
+        }
+        const double m = 1.0 / pBody->getInvMass();
+        kinetic += 0.5 * m * pBody->getLinearVelocity().length2();
+
+        // Rotational energy in the body frame, where inertia is diagonal
+        const btVector3 omega =
+            pBody->getWorldTransform().getBasis().transpose() *
+            pBody->getAngularVelocity();
+        const btVector3& invInertia = pBody->getInvInertiaDiagLocal();
+        for (int j = 0; j < 3; j++)
+        {
+            if (invInertia[j] > 0.0)
+            {
+                kinetic += 0.5 * omega[j] * omega[j] / invInertia[j];
+            }
+        }
+
+        const double y = pBody->getCenterOfMassPosition().y();
+        potential += m * g * y;
+        lowest = (mass == 0.0) ? y : std::min(lowest, y);
+        mass += m;
+    }
+
+    double elastic = 0.0;
+    for (std::size_t i = 0; i < cables.size(); i++)
+    {
+        const double stretch =
+            cables[i]->getCurrentLength() - cables[i]->getRestLength();
+        if (stretch > 0.0)
+        {
+            elastic += 0.5 * cables[i]->getSpringCable()->getCoefK() *
+                       stretch * stretch;
+        }
+    }
+
+    if (!m_measured)
+    {
+        // Potential energy counts from the first measurement, so moving
+        // the model up or down changes nothing. A small share of the
+        // energy then, with the potential energy taken above the lowest
+        // body, keeps the scale from vanishing for a structure at rest
+        m_referencePotential = potential;
+        m_scaleFloor = std::max(1.0e-3 * (kinetic + elastic +
+                                          std::fabs(potential - mass * g * lowest)),
+                                1.0e-12);
+    }
+
+    scale = kinetic + elastic;
+    return kinetic + (potential - m_referencePotential) + elastic;
+}
+
+double tgAdaptiveTimestep::cableWork(const std::vector<tgSpringCableActuator*>& cables,
+                                     double dt)
+{
+    const bool known = (m_restLengths.size() == cables.size());
+    double work = 0.0;
+    for (std::size_t i = 0; i < cables.size(); i++)
+    {
+        const tgSpringCable* const pCable = cables[i]->getSpringCable();
+        const double k = pCable->getCoefK();
+        const double length = cables[i]->getCurrentLength();
+        const double restLength = cables[i]->getRestLength();
+        const double stretch = std::max(length - restLength, 0.0);
+        if (known)
+        {
+            // Moving the rest length at the current length
+            const double before = std::max(length - m_restLengths[i], 0.0);
+            work += 0.5 * k * (stretch * stretch - before * before);
+        }
+        if (stretch > 0.0)
+        {
+            // Damping only acts while the cable is taut
+            work -= std::fabs(pCable->getDamping() * pCable->getVelocity()) * dt;
+        }
+    }
+
+    m_restLengths.resize(cables.size());
+    for (std::size_t i = 0; i < cables.size(); i++)
+    {
+        m_restLengths[i] = cables[i]->getRestLength();
+    }
+    return work;
+}
+
+int tgAdaptiveTimestep::contactCount(const tgWorld& world) const
+{
+    btDispatcher* const pDispatcher =
+        tgBulletUtil::worldToDynamicsWorld(world).getDispatcher();
+    int count = 0;
+    const int n = pDispatcher->getNumManifolds();
+    for (int i = 0; i < n; i++)
+    {
+        if (pDispatcher->getManifoldByIndexInternal(i)->getNumContacts() > 0)
+        {
+            count++;
+        }
+    }
+    return count;
+}
@@ -0,0 +1,182 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_ADAPTIVE_TIMESTEP_H
+#define TG_ADAPTIVE_TIMESTEP_H
+
+/**
+ * @file tgAdaptiveTimestep.h
+ * @brief Contains the definition of class tgAdaptiveTimestep
+ * $Id$
+ */
+
+// The C++ Standard Library
+#include <vector>
+
+// Forward declarations
+class tgSpringCableActuator;
+class tgWorld;
+
+/**
+ * Chooses the physics substep for tgSimulation's adaptive mode. Each
+ * control period passed to tgSimulation::step() is split into substeps
+ * that are as long as three error indicators allow:
+ * - the fastest cable strain rate, so no cable stretches by more than
+ *   Config::maxStrainPerStep in one substep;
+ * - new contact manifolds, which shrink the substep for impacts;
+ * - the drift of the total mechanical energy over a substep, less the
+ *   work the actuators did by moving rest lengths and what the cable
+ *   dampers dissipated. Potential energy counts from the first
+ *   substep, so the tolerance doesn't depend on where the model is.
+ * Calm stretches grow the substep again by Config::growFactor.
+ */
+class tgAdaptiveTimestep
+{
+public:
+
+    /**
+     * The bounds and tolerances. This is Plain Old Data.
+     */
+    struct Config
+    {
+        /**
+         * @param[in] minStep the shortest substep, in seconds; must be
+         * positive
+         * @param[in] maxStep the longest substep, in seconds; must not be
+         * less than minStep
+         * @param[in] maxStrainPerStep the most any cable may stretch or
+         * shorten in one substep, as a fraction of its rest length; must
+         * be positive
+         * @param[in] maxEnergyDrift the most the mechanical energy may
+         * change in one substep, as a fraction of the kinetic and elastic
+         * energy; must be positive
+         * @param[in] growFactor how fast calm substeps grow; must be at
+         * least 1
+         * @param[in] shrinkFactor how fast substeps shrink on a contact
+         * or energy event; must be in (0, 1)
+         * @throw std::invalid_argument if any parameter is out of range
+         */
+        Config(double minStep = 1.0 / 4000.0,
+               double maxStep = 1.0 / 250.0,
+               double maxStrainPerStep = 1.0e-3,
+               double maxEnergyDrift = 1.0e-2,
+               double growFactor = 1.25,
+               double shrinkFactor = 0.5);
+
+        double minStep;
+        double maxStep;
+        double maxStrainPerStep;
+        double maxEnergyDrift;
+        double growFactor;
+        double shrinkFactor;
+    };
+
+    tgAdaptiveTimestep(const Config& config = Config());
+
+    /**
+     * Forget the indicators, e.g. after the world was rebuilt. The next
+     * substep is Config::minStep.
+     */
+    void reset();
+
+    /**
+     * Return the length of the next substep. Substeps split what is left
+     * of a control period evenly, so there is never a short last one.
+     * @param[in] remaining the time left in the control period; must be
+     * positive
+     * @return a substep no longer than remaining
+     */
+    double nextStep(double remaining) const;
+
+    /**
+     * Measure the indicators after a substep and choose the next one.
+     * @param[in] world the world that just stepped
+     * @param[in] cables the spring cable actuators that just stepped
+     * @param[in] dt the substep that was taken
+     */
+    void update(const tgWorld& world,
+                const std::vector<tgSpringCableActuator*>& cables,
+                double dt);
+
+    /** Return the substep that nextStep() is aiming for. */
+    double getStep() const
+    {
+        return m_step;
+    }
+
+    /** Return the number of substeps taken since reset(). */
+    long getSubstepCount() const
+    {
+        return m_substeps;
+    }
+
+    const Config& getConfig() const
+    {
+        return m_config;
+    }
+
+private:
+
+    /**
+     * Return the total mechanical energy: kinetic and gravitational
+     * energy of the rigid bodies, relative to the first measurement,
+     * and elastic energy of the cables. The first measurement also sets
+     * m_scaleFloor.
+     * @param[out] scale what drift is measured against: the kinetic and
+     * elastic parts
+     */
+    double energy(const tgWorld& world,
+                  const std::vector<tgSpringCableActuator*>& cables,
+                  double& scale);
+
+    /**
+     * Return the energy the cables' actuators and dampers added over a
+     * substep (negative if they took it out), and remember the rest
+     * lengths for the next one.
+     */
+    double cableWork(const std::vector<tgSpringCableActuator*>& cables,
+                     double dt);
+
+    /** Return the number of contact manifolds that have contacts. */
+    int contactCount(const tgWorld& world) const;
+
+private:
+
+    const Config m_config;
+
+    /** The substep being aimed for. */
+    double m_step;
+
+    /** The indicators after the previous substep. */
+    bool m_measured;
+    double m_energy;
+    int m_contacts;
+
+    /** The gravitational energy at the first measurement */
+    double m_referencePotential;
+
+    /** The least scale drift is measured against */
+    double m_scaleFloor;
+
+    /** The cables' rest lengths after the previous substep */
+    std::vector<double> m_restLengths;
+
+    long m_substeps;
+};
+
+#endif  // TG_ADAPTIVE_TIMESTEP_H
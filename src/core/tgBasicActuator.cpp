@@ -134,6 +134,12 @@ void tgBasicActuator::logHistory()
     }
 }
 
+void tgBasicActuator::setInitialRestLength(double restLength)
+{
+    tgSpringCableActuator::setInitialRestLength(restLength);
+    m_preferredLength = restLength;
+}
+
 void tgBasicActuator::setControlInput(double input)
 {
     if (input < 0.0)
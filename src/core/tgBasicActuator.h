@@ -101,6 +101,12 @@ public:
      * @param[in] dt, time elapsed since last call.
 	 */
 	virtual void setControlInput(double input, double dt);
+    
+    /**
+     * Also moves m_preferredLength, so moveMotors doesn't undo the change.
+     * @param[in] restLength the new rest length, must be positive
+     */
+    virtual void setInitialRestLength(double restLength);
   
     /** Called from public functions, it makes the restLength get closer
      * to preferredlength, according to config constraints.
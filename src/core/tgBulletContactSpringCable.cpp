@@ -81,7 +81,7 @@ tgBulletContactSpringCable::~tgBulletContactSpringCable()
     delete m_ghostObject;
 }
 
-const btScalar tgBulletContactSpringCable::getActualLength() const
+const double tgBulletContactSpringCable::getActualLength() const
 {
     btScalar length = 0;
     
@@ -125,6 +125,19 @@ void tgBulletContactSpringCable::step(double dt)
     assert(invariant());
 }
 
+void tgBulletContactSpringCable::setState(const State& state)
+{
+    tgBulletSpringCable::setState(state);
+    
+    for (int i = m_anchors.size() - 1; i >= 0; i--)
+    {
+        deleteAnchor(i);
+    }
+    updateCollisionObject();
+    
+    assert(invariant());
+}
+
 void tgBulletContactSpringCable::calculateAndApplyForce(double dt)
 {
 #ifndef BT_NO_PROFILE 
@@ -111,7 +111,16 @@ public:
      * @return a btScalar of the string's actual length - the sum of the
      * lengths between the anchors.
      */
-    virtual const btScalar getActualLength() const;
+    virtual const double getActualLength() const;
+    
+    /**
+     * Replace the state carried between steps. Anchors picked up from
+     * contacts are not part of it, so they are dropped and the collision
+     * object is refit to the anchors the cable was built with, wherever
+     * their bodies now are.
+     * @param[in] state the state, as returned by getState()
+     */
+    virtual void setState(const State& state);
     
 private:
     
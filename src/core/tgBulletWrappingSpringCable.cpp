@@ -0,0 +1,287 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgBulletWrappingSpringCable.cpp
+ * @brief Implementation of class tgBulletWrappingSpringCable
+ * $Id$
+ */
+
+// This module
+#include "tgBulletWrappingSpringCable.h"
+#include "tgBulletSpringCableAnchor.h"
+// The Bullet Physics library
+#include "BulletDynamics/Dynamics/btRigidBody.h"
+// The C++ Standard Library
+#include <cassert>
+#include <cmath>
+#include <stdexcept>
+
+tgBulletWrappingSpringCable::Cylinder::Cylinder(btRigidBody* b,
+                                                const btVector3& from,
+                                                const btVector3& to,
+                                                double r) :
+body(b),
+radius(r)
+{
+    if (body == NULL)
+    {
+        throw std::invalid_argument("Cylinder has no body");
+    }
+    else if (from == to)
+    {
+        throw std::invalid_argument("Cylinder axis has no length");
+    }
+    else if (!(radius > 0.0))
+    {
+        throw std::invalid_argument("Cylinder radius is not positive");
+    }
+    const btTransform toLocal = body->getWorldTransform().inverse();
+    localFrom = toLocal * from;
+    localTo = toLocal * to;
+}
+
+tgBulletWrappingSpringCable::Wrap::Wrap() :
+cylinder(-1),
+tangent1(0.0, 0.0, 0.0),
+tangent2(0.0, 0.0, 0.0),
+angle(0.0),
+length(0.0)
+{
+}
+
+tgBulletWrappingSpringCable::tgBulletWrappingSpringCable(
+                        const std::vector<tgBulletSpringCableAnchor*>& anchors,
+                        double coefK,
+                        double dampingCoefficient,
+                        const std::vector<Cylinder>& cylinders,
+                        double pretension) :
+tgBulletSpringCable(anchors, coefK, dampingCoefficient, pretension),
+m_cylinders(cylinders)
+{
+    if (m_anchors.size() != 2)
+    {
+        throw std::invalid_argument("Wrapping cables take exactly two anchors");
+    }
+    for (std::size_t i = 0; i < m_cylinders.size(); i++)
+    {
+        if (m_cylinders[i].body == anchor1->attachedBody ||
+            m_cylinders[i].body == anchor2->attachedBody)
+        {
+            throw std::invalid_argument("Cylinder is on an anchor's body");
+        }
+    }
+
+    // tgSpringCable took the rest length from the straight line
+    const double straight =
+        anchor1->getWorldPosition().distance(anchor2->getWorldPosition());
+    m_wrap = findWrap();
+    m_restLength += m_wrap.length - straight;
+    m_prevLength = m_restLength;
+    updateAnchors();
+}
+
+tgBulletWrappingSpringCable::~tgBulletWrappingSpringCable()
+{
+    // tgBulletSpringCable deletes the anchors, including the tangent points
+}
+
+const double tgBulletWrappingSpringCable::getActualLength() const
+{
+    return findWrap().length;
+}
+
+tgBulletWrappingSpringCable::Wrap
+tgBulletWrappingSpringCable::wrapCylinder(const btVector3& from,
+                                          const btVector3& to,
+                                          const btVector3& axisFrom,
+                                          const btVector3& axisTo,
+                                          double radius)
+{
+    // Straight unless shown otherwise. Each end is pulled towards its
+    // tangent point, so those are the other end
+    Wrap wrap;
+    wrap.tangent1 = to;
+    wrap.tangent2 = from;
+    wrap.length = from.distance(to);
+
+    // A frame with z along the axis and x towards from
+    const btVector3 center = (axisFrom + axisTo) / 2.0;
+    const double halfLength = axisFrom.distance(axisTo) / 2.0;
+    const btVector3 axis = (axisTo - axisFrom) / (2.0 * halfLength);
+
+    const btVector3 p = from - center;
+    const double zp = p.dot(axis);
+    const btVector3 radial = p - axis * zp;
+    const double rp = radial.length();
+    if (rp <= radius)
+    {
+        return wrap;
+    }
+    const btVector3 e1 = radial / rp;
+    const btVector3 e2 = axis.cross(e1);
+
+    const btVector3 q = to - center;
+    const double zq = q.dot(axis);
+    const double qx = q.dot(e1);
+    const double qy = q.dot(e2);
+    const double rq = std::sqrt(qx * qx + qy * qy);
+    if (rq <= radius)
+    {
+        return wrap;
+    }
+
+    // Seen down the axis, the cable leaves from at a tangent, goes round
+    // the shorter way and reaches to at a tangent. If the tangents
+    // overlap, the straight line misses
+    const double thetaQ = std::atan2(qy, qx);
+    const double side = (thetaQ >= 0.0) ? 1.0 : -1.0;
+    const double alphaP = std::acos(radius / rp);
+    const double alphaQ = std::acos(radius / rq);
+    const double angle = std::fabs(thetaQ) - alphaP - alphaQ;
+    if (angle <= 0.0)
+    {
+        return wrap;
+    }
+
+    // Unrolled, the geodesic is a straight line, so height grows
+    // linearly with the distance travelled round the axis
+    const double lp = std::sqrt(rp * rp - radius * radius);
+    const double lq = std::sqrt(rq * rq - radius * radius);
+    const double around = lp + radius * angle + lq;
+    const double rise = zq - zp;
+    const double z1 = zp + rise * lp / around;
+    const double z2 = zp + rise * (lp + radius * angle) / around;
+    if (std::fabs(z1) > halfLength || std::fabs(z2) > halfLength)
+    {
+        return wrap;
+    }
+
+    const double theta1 = side * alphaP;
+    const double theta2 = thetaQ - side * alphaQ;
+    wrap.cylinder = 0;
+    wrap.tangent1 = center + (e1 * std::cos(theta1) + e2 * std::sin(theta1)) * radius +
+                    axis * z1;
+    wrap.tangent2 = center + (e1 * std::cos(theta2) + e2 * std::sin(theta2)) * radius +
+                    axis * z2;
+    wrap.angle = angle;
+    wrap.length = std::sqrt(around * around + rise * rise);
+    return wrap;
+}
+
+tgBulletWrappingSpringCable::Wrap tgBulletWrappingSpringCable::findWrap() const
+{
+    const btVector3 pos1 = anchor1->getWorldPosition();
+    const btVector3 pos2 = anchor2->getWorldPosition();
+
+    Wrap best;
+    best.tangent1 = pos2;
+    best.tangent2 = pos1;
+    best.length = pos1.distance(pos2);
+    for (std::size_t i = 0; i < m_cylinders.size(); i++)
+    {
+        const Cylinder& cylinder = m_cylinders[i];
+        const btTransform& transform = cylinder.body->getWorldTransform();
+        const Wrap wrap = wrapCylinder(pos1, pos2,
+                                       transform * cylinder.localFrom,
+                                       transform * cylinder.localTo,
+                                       cylinder.radius);
+        if (wrap.cylinder == 0 && wrap.length > best.length)
+        {
+            best = wrap;
+            best.cylinder = static_cast<int>(i);
+        }
+    }
+    return best;
+}
+
+void tgBulletWrappingSpringCable::calculateAndApplyForce(double dt)
+{
+    m_wrap = findWrap();
+
+    // As tgBulletSpringCable, but along the path
+    const double currLength = m_wrap.length;
+    const double stretch = currLength - m_restLength;
+    double magnitude = m_coefK * stretch;
+
+    const double deltaStretch = currLength - m_prevLength;
+    m_velocity = deltaStretch / dt;
+
+    m_damping = m_dampingCoefficient * m_velocity;
+
+    if (std::fabs(magnitude) < std::fabs(m_damping))
+    {
+        m_damping = (m_damping > 0.0 ? magnitude : -magnitude);
+    }
+
+    magnitude += m_damping;
+
+    m_prevLength = currLength;
+
+    if (currLength > m_restLength)
+    {
+        const btVector3 pos1 = anchor1->getWorldPosition();
+        const btVector3 pos2 = anchor2->getWorldPosition();
+        const btVector3 leg1 = m_wrap.tangent1 - pos1;
+        const btVector3 leg2 = m_wrap.tangent2 - pos2;
+        const btVector3 impulse1 =
+            leg1.fuzzyZero() ? btVector3(0.0, 0.0, 0.0) : leg1.normalized() * magnitude * dt;
+        const btVector3 impulse2 =
+            leg2.fuzzyZero() ? btVector3(0.0, 0.0, 0.0) : leg2.normalized() * magnitude * dt;
+
+        anchor1->attachedBody->activate();
+        anchor1->attachedBody->applyImpulse(impulse1, anchor1->getRelativePosition());
+        anchor2->attachedBody->activate();
+        anchor2->attachedBody->applyImpulse(impulse2, anchor2->getRelativePosition());
+
+        // The cylinder is pulled at the tangent points; being frictionless,
+        // the pulls have no moment about its axis
+        if (m_wrap.cylinder >= 0)
+        {
+            btRigidBody* const body = m_cylinders[m_wrap.cylinder].body;
+            const btVector3 com = body->getCenterOfMassPosition();
+            body->activate();
+            body->applyImpulse(-impulse1, m_wrap.tangent1 - com);
+            body->applyImpulse(-impulse2, m_wrap.tangent2 - com);
+        }
+    }
+
+    updateAnchors();
+}
+
+void tgBulletWrappingSpringCable::updateAnchors()
+{
+    assert(m_anchors.front() == anchor1 && m_anchors.back() == anchor2);
+    for (std::size_t i = 1; i + 1 < m_anchors.size(); i++)
+    {
+        delete m_anchors[i];
+    }
+    m_anchors.clear();
+    m_anchors.push_back(anchor1);
+    if (m_wrap.cylinder >= 0)
+    {
+        btRigidBody* const body = m_cylinders[m_wrap.cylinder].body;
+        m_anchors.push_back(new tgBulletSpringCableAnchor(body, m_wrap.tangent1,
+                                                          btVector3(0.0, 0.0, 0.0),
+                                                          false));
+        m_anchors.push_back(new tgBulletSpringCableAnchor(body, m_wrap.tangent2,
+                                                          btVector3(0.0, 0.0, 0.0),
+                                                          false));
+    }
+    m_anchors.push_back(anchor2);
+}
@@ -0,0 +1,173 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef SRC_CORE_TG_BULLET_WRAPPING_SPRING_CABLE_H_
+#define SRC_CORE_TG_BULLET_WRAPPING_SPRING_CABLE_H_
+
+/**
+ * @file tgBulletWrappingSpringCable.h
+ * @brief Definition of class tgBulletWrappingSpringCable
+ * $Id$
+ */
+
+// This module
+#include "tgBulletSpringCable.h"
+// The Bullet Physics library
+#include "LinearMath/btVector3.h"
+// The C++ Standard Library
+#include <vector>
+
+// Forward references
+class btRigidBody;
+class tgBulletSpringCableAnchor;
+
+/**
+ * A spring cable that wraps over known cylinders, such as the rods of
+ * the structure, without contact detection. Each step it finds the
+ * shortest path from anchor1 to anchor2 over the cylinder it would
+ * otherwise pass through: straight to a tangent point, along a helix
+ * on the surface, and straight from the other tangent point. Tension
+ * follows the length of that path. The anchors are pulled towards the
+ * tangent points, and the cylinder's body is pulled at them; the
+ * surface is frictionless, so the cable slides freely.
+ *
+ * It wraps one cylinder at a time, the one that lengthens the path
+ * most, and only along the cylinder's length; the end caps are
+ * ignored. This is much cheaper than tgBulletContactSpringCable, which
+ * needs a ghost object and contact manifolds, but it only knows about
+ * the cylinders it is given.
+ */
+class tgBulletWrappingSpringCable : public tgBulletSpringCable
+{
+public:
+
+    /** A cylinder the cable may wrap, fixed to a rigid body */
+    struct Cylinder
+    {
+        /**
+         * @param[in] body the body the cylinder is part of
+         * @param[in] from one end of the axis, in world coordinates now
+         * @param[in] to the other end of the axis
+         * @param[in] radius must be positive
+         * @throw std::invalid_argument if body is NULL, the axis has no
+         * length or radius is not positive
+         */
+        Cylinder(btRigidBody* body,
+                 const btVector3& from,
+                 const btVector3& to,
+                 double radius);
+
+        btRigidBody* body;
+
+        /** The ends of the axis in the body's frame */
+        btVector3 localFrom;
+        btVector3 localTo;
+
+        double radius;
+    };
+
+    /** The path of the cable */
+    struct Wrap
+    {
+        Wrap();
+
+        /** The cylinder wrapped, or -1 if the cable is straight */
+        int cylinder;
+
+        /** Where the cable meets and leaves the cylinder, in world coordinates */
+        btVector3 tangent1;
+        btVector3 tangent2;
+
+        /** The angle the cable turns through around the axis, in radians */
+        double angle;
+
+        /** The length of the whole path */
+        double length;
+    };
+
+    /**
+     * @param[in] anchors the two attachments; this takes ownership
+     * @param[in] coefK the stiffness of the spring. Must be positive
+     * @param[in] dampingCoefficient the damping in the spring. Must be non-negative
+     * @param[in] cylinders the cylinders the cable may wrap; they must
+     * not be on the anchors' bodies
+     * @param[in] pretension must be small enough to keep the rest
+     * length positive. It applies to the wrapped length
+     */
+    tgBulletWrappingSpringCable(const std::vector<tgBulletSpringCableAnchor*>& anchors,
+                                double coefK,
+                                double dampingCoefficient,
+                                const std::vector<Cylinder>& cylinders,
+                                double pretension = 0.0);
+
+    virtual ~tgBulletWrappingSpringCable();
+
+    /** Return the length of the path over the cylinder */
+    virtual const double getActualLength() const;
+
+    /** Return the path found by the last step, or by construction */
+    const Wrap& getWrap() const
+    {
+        return m_wrap;
+    }
+
+    const std::vector<Cylinder>& getCylinders() const
+    {
+        return m_cylinders;
+    }
+
+    /**
+     * Find the shortest path from one point to another over the
+     * outside of a cylinder.
+     * @param[in] from the start of the path
+     * @param[in] to the end of the path
+     * @param[in] axisFrom one end of the cylinder's axis
+     * @param[in] axisTo the other end of the cylinder's axis
+     * @param[in] radius the cylinder's radius
+     * @return the path; its cylinder is 0 if it wraps, -1 if the straight
+     * line misses the cylinder, either end is inside it, or the path
+     * would leave it past an end
+     */
+    static Wrap wrapCylinder(const btVector3& from,
+                             const btVector3& to,
+                             const btVector3& axisFrom,
+                             const btVector3& axisTo,
+                             double radius);
+
+private:
+
+    /** Apply the tension at the anchors and the tangent points. */
+    virtual void calculateAndApplyForce(double dt);
+
+    /** Find the path over the cylinder that lengthens it most */
+    Wrap findWrap() const;
+
+    /**
+     * Put anchors on the wrapped cylinder at the tangent points, so the
+     * path renders, or remove them if the cable is straight.
+     */
+    void updateAnchors();
+
+private:
+
+    const std::vector<Cylinder> m_cylinders;
+
+    Wrap m_wrap;
+};
+
+#endif  // SRC_CORE_TG_BULLET_WRAPPING_SPRING_CABLE_H_
@@ -0,0 +1,723 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgCableProximity.cpp
+ * @brief Contains the definitions of members of class tgCableProximity
+ * $Id$
+ */
+
+// This module
+#include "tgCableProximity.h"
+// This application
+#include "tgBulletSpringCableAnchor.h"
+#include "tgSpringCable.h"
+#include "tgSpringCableActuator.h"
+// The Bullet Physics Library
+#include "BulletDynamics/Dynamics/btRigidBody.h"
+// The C++ Standard Library
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <stdexcept>
+// POSIX
+#include <unistd.h>
+
+namespace
+{
+    /** Orders pairs by their cables, then their segments */
+    bool byIndex(const tgCableProximity::Pair& a, const tgCableProximity::Pair& b)
+    {
+        if (a.cable1 != b.cable1)
+        {
+            return a.cable1 < b.cable1;
+        }
+        else if (a.segment1 != b.segment1)
+        {
+            return a.segment1 < b.segment1;
+        }
+        else if (a.cable2 != b.cable2)
+        {
+            return a.cable2 < b.cable2;
+        }
+        return a.segment2 < b.segment2;
+    }
+
+    double clamp01(double x)
+    {
+        return (x < 0.0) ? 0.0 : ((x > 1.0) ? 1.0 : x);
+    }
+
+    double surfaceArea(const btVector3& min, const btVector3& max)
+    {
+        const btVector3 d = max - min;
+        return 2.0 * (d.x() * d.y() + d.y() * d.z() + d.z() * d.x());
+    }
+
+    void applyImpulse(btRigidBody* body, const btVector3& impulse,
+                      const btVector3& position)
+    {
+        if (body != NULL)
+        {
+            body->activate();
+            body->applyImpulse(impulse, position - body->getCenterOfMassPosition());
+        }
+    }
+} // namespace
+
+struct tgCableProximity::ByCentroid
+{
+    ByCentroid(const std::vector<Segment>& segments, int axis) :
+        m_segments(segments),
+        m_axis(axis)
+    {
+    }
+
+    bool operator()(int a, int b) const
+    {
+        const Segment& one = m_segments[a];
+        const Segment& two = m_segments[b];
+        return (one.from[m_axis] + one.to[m_axis]) <
+               (two.from[m_axis] + two.to[m_axis]);
+    }
+
+    const std::vector<Segment>& m_segments;
+    const int m_axis;
+};
+
+tgCableProximity::Config::Config(double m,
+                                 double k,
+                                 double ratio,
+                                 std::size_t n) :
+    margin(m),
+    stiffness(k),
+    rebuildRatio(ratio),
+    threads(n)
+{
+    if (!(margin > 0.0))
+    {
+        throw std::invalid_argument("margin is not positive");
+    }
+    else if (stiffness < 0.0)
+    {
+        throw std::invalid_argument("stiffness is negative");
+    }
+    else if (!(rebuildRatio >= 1.0))
+    {
+        throw std::invalid_argument("rebuildRatio is less than 1");
+    }
+}
+
+tgCableProximity::tgCableProximity(const Config& config) :
+    m_config(config),
+    m_builtArea(0.0),
+    m_nextTask(0),
+    m_crossings(0),
+    m_tests(0),
+    m_rebuilds(0),
+    m_refits(0),
+    m_generation(0),
+    m_pending(0),
+    m_shutdown(false)
+{
+    std::size_t threads = m_config.threads;
+    if (threads == 0)
+    {
+        const long processors = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = (processors > 0) ? static_cast<std::size_t>(processors) : 1;
+    }
+    m_results.resize(threads);
+    m_resultTests.resize(threads, 0);
+
+    pthread_mutex_init(&m_mutex, NULL);
+    pthread_cond_init(&m_startCondition, NULL);
+    pthread_cond_init(&m_doneCondition, NULL);
+
+    startThreads(threads - 1);
+}
+
+tgCableProximity::~tgCableProximity()
+{
+    stopThreads();
+}
+
+void tgCableProximity::reset()
+{
+    m_segments.clear();
+    m_offsets.clear();
+    m_nodes.clear();
+    m_order.clear();
+    m_builtArea = 0.0;
+    m_pairs.clear();
+    m_sides.clear();
+    m_crossings = 0;
+    m_tests = 0;
+    m_rebuilds = 0;
+    m_refits = 0;
+}
+
+void tgCableProximity::update(const std::vector<tgSpringCableActuator*>& cables,
+                              double dt)
+{
+    if (dt <= 0.0)
+    {
+        throw std::invalid_argument("dt is not positive");
+    }
+
+    if (!gather(cables))
+    {
+        // Segment indexes have moved, so the sides are meaningless
+        m_sides.clear();
+        build();
+    }
+    else if (!m_nodes.empty())
+    {
+        const double area = refit();
+        m_refits++;
+        if (area > m_config.rebuildRatio * m_builtArea)
+        {
+            build();
+        }
+    }
+
+    makeTasks();
+    m_nextTask = 0;
+    for (std::size_t i = 0; i < m_results.size(); i++)
+    {
+        m_results[i].clear();
+        m_resultTests[i] = 0;
+    }
+
+    if (m_workers.empty() || m_tasks.size() < 2)
+    {
+        runTasks(0);
+    }
+    else
+    {
+        pthread_mutex_lock(&m_mutex);
+        m_pending = m_workers.size();
+        m_generation++;
+        pthread_cond_broadcast(&m_startCondition);
+        pthread_mutex_unlock(&m_mutex);
+
+        runTasks(0);
+
+        pthread_mutex_lock(&m_mutex);
+        while (m_pending > 0)
+        {
+            pthread_cond_wait(&m_doneCondition, &m_mutex);
+        }
+        pthread_mutex_unlock(&m_mutex);
+    }
+
+    finish(dt);
+}
+
+double tgCableProximity::closestPoints(const btVector3& p1, const btVector3& q1,
+                                       const btVector3& p2, const btVector3& q2,
+                                       double& s, double& t)
+{
+    // After Ericson, Real-Time Collision Detection, 5.1.9
+    const btVector3 d1 = q1 - p1;
+    const btVector3 d2 = q2 - p2;
+    const btVector3 r = p1 - p2;
+    const double a = d1.dot(d1);
+    const double e = d2.dot(d2);
+    const double f = d2.dot(r);
+    const double tiny = 1.0e-20;
+
+    if (a <= tiny && e <= tiny)
+    {
+        s = 0.0;
+        t = 0.0;
+    }
+    else if (a <= tiny)
+    {
+        s = 0.0;
+        t = clamp01(f / e);
+    }
+    else
+    {
+        const double c = d1.dot(r);
+        if (e <= tiny)
+        {
+            t = 0.0;
+            s = clamp01(-c / a);
+        }
+        else
+        {
+            // Nearest points of the lines, then clamped to the segments
+            const double b = d1.dot(d2);
+            const double denominator = a * e - b * b;
+            s = (denominator > tiny * a * e) ?
+                clamp01((b * f - c * e) / denominator) : 0.0;
+            t = (b * s + f) / e;
+            if (t < 0.0)
+            {
+                t = 0.0;
+                s = clamp01(-c / a);
+            }
+            else if (t > 1.0)
+            {
+                t = 1.0;
+                s = clamp01((b - c) / a);
+            }
+        }
+    }
+    return (p1 + d1 * s).distance(p2 + d2 * t);
+}
+
+bool tgCableProximity::gather(const std::vector<tgSpringCableActuator*>& cables)
+{
+    const std::vector<std::size_t> oldOffsets = m_offsets;
+    m_offsets.resize(cables.size());
+    m_segments.clear();
+
+    for (std::size_t c = 0; c < cables.size(); c++)
+    {
+        assert(cables[c] != NULL);
+        m_offsets[c] = m_segments.size();
+        const std::vector<const tgSpringCableAnchor*> anchors =
+            cables[c]->getSpringCable()->getAnchors();
+        for (std::size_t i = 0; i + 1 < anchors.size(); i++)
+        {
+            const tgBulletSpringCableAnchor* const pFrom =
+                dynamic_cast<const tgBulletSpringCableAnchor*>(anchors[i]);
+            const tgBulletSpringCableAnchor* const pTo =
+                dynamic_cast<const tgBulletSpringCableAnchor*>(anchors[i + 1]);
+
+            Segment segment;
+            segment.from = anchors[i]->getWorldPosition();
+            segment.to = anchors[i + 1]->getWorldPosition();
+            segment.fromBody = pFrom ? pFrom->attachedBody : NULL;
+            segment.toBody = pTo ? pTo->attachedBody : NULL;
+            segment.cable = c;
+            segment.index = i;
+            m_segments.push_back(segment);
+        }
+    }
+
+    // The same offsets and total mean the same number per cable
+    return (m_offsets == oldOffsets) &&
+           (m_order.size() == m_segments.size());
+}
+
+void tgCableProximity::build()
+{
+    m_nodes.clear();
+    m_order.resize(m_segments.size());
+    for (std::size_t i = 0; i < m_order.size(); i++)
+    {
+        m_order[i] = static_cast<int>(i);
+    }
+    if (!m_segments.empty())
+    {
+        m_nodes.reserve(2 * m_segments.size() - 1);
+        build(0, m_segments.size());
+    }
+    m_builtArea = refit();
+    m_rebuilds++;
+}
+
+int tgCableProximity::build(std::size_t begin, std::size_t end)
+{
+    assert(begin < end);
+    const int index = static_cast<int>(m_nodes.size());
+    m_nodes.push_back(Node());
+    Node& node = m_nodes.back();
+    node.left = -1;
+    node.right = -1;
+    node.segment = m_order[begin];
+    if (end - begin == 1)
+    {
+        return index;
+    }
+
+    // Split at the median along the widest spread of midpoints
+    btVector3 min = m_segments[m_order[begin]].from + m_segments[m_order[begin]].to;
+    btVector3 max = min;
+    for (std::size_t i = begin + 1; i < end; i++)
+    {
+        const Segment& segment = m_segments[m_order[i]];
+        const btVector3 centroid = segment.from + segment.to;
+        min.setMin(centroid);
+        max.setMax(centroid);
+    }
+    const int axis = (max - min).maxAxis();
+    const std::size_t middle = (begin + end) / 2;
+    std::nth_element(m_order.begin() + begin, m_order.begin() + middle,
+                     m_order.begin() + end, ByCentroid(m_segments, axis));
+
+    // Building the children may reallocate m_nodes
+    const int left = build(begin, middle);
+    const int right = build(middle, end);
+    m_nodes[index].left = left;
+    m_nodes[index].right = right;
+    m_nodes[index].segment = -1;
+    return index;
+}
+
+double tgCableProximity::refit()
+{
+    double area = 0.0;
+    for (std::size_t i = m_nodes.size(); i-- > 0; )
+    {
+        Node& node = m_nodes[i];
+        if (node.left < 0)
+        {
+            fitLeaf(node);
+        }
+        else
+        {
+            const Node& left = m_nodes[node.left];
+            const Node& right = m_nodes[node.right];
+            node.min = left.min;
+            node.min.setMin(right.min);
+            node.max = left.max;
+            node.max.setMax(right.max);
+        }
+        area += surfaceArea(node.min, node.max);
+    }
+    return area;
+}
+
+void tgCableProximity::fitLeaf(Node& node) const
+{
+    const Segment& segment = m_segments[node.segment];
+    const double half = m_config.margin / 2.0;
+    const btVector3 widen(half, half, half);
+    node.min = segment.from;
+    node.min.setMin(segment.to);
+    node.min -= widen;
+    node.max = segment.from;
+    node.max.setMax(segment.to);
+    node.max += widen;
+}
+
+void tgCableProximity::makeTasks()
+{
+    m_tasks.clear();
+    if (m_nodes.empty())
+    {
+        return;
+    }
+    m_tasks.push_back(Task(0, 0));
+
+    // Open the top of the traversal until every thread has a few tasks
+    const std::size_t target = 4 * m_results.size();
+    bool opened = (m_results.size() > 1);
+    while (opened && m_tasks.size() < target)
+    {
+        opened = false;
+        std::vector<Task> next;
+        for (std::size_t i = 0; i < m_tasks.size(); i++)
+        {
+            const Task& task = m_tasks[i];
+            const Node& a = m_nodes[task.first];
+            const Node& b = m_nodes[task.second];
+            if (task.first == task.second)
+            {
+                if (a.left < 0)
+                {
+                    continue;
+                }
+                next.push_back(Task(a.left, a.left));
+                next.push_back(Task(a.right, a.right));
+                next.push_back(Task(a.left, a.right));
+                opened = true;
+            }
+            else if (a.left >= 0)
+            {
+                next.push_back(Task(a.left, task.second));
+                next.push_back(Task(a.right, task.second));
+                opened = true;
+            }
+            else if (b.left >= 0)
+            {
+                next.push_back(Task(task.first, b.left));
+                next.push_back(Task(task.first, b.right));
+                opened = true;
+            }
+            else
+            {
+                next.push_back(task);
+            }
+        }
+        m_tasks.swap(next);
+    }
+}
+
+void tgCableProximity::runTasks(std::size_t result)
+{
+    const long count = static_cast<long>(m_tasks.size());
+    while (true)
+    {
+        const long i = __sync_fetch_and_add(&m_nextTask, 1);
+        if (i >= count)
+        {
+            break;
+        }
+        const Task& task = m_tasks[i];
+        if (task.first == task.second)
+        {
+            traverse(task.first, result);
+        }
+        else
+        {
+            traverse(task.first, task.second, result);
+        }
+    }
+}
+
+void tgCableProximity::traverse(int index, std::size_t result)
+{
+    const Node& node = m_nodes[index];
+    if (node.left >= 0)
+    {
+        traverse(node.left, result);
+        traverse(node.right, result);
+        traverse(node.left, node.right, result);
+    }
+}
+
+void tgCableProximity::traverse(int a, int b, std::size_t result)
+{
+    const Node& one = m_nodes[a];
+    const Node& two = m_nodes[b];
+    if (one.max.x() < two.min.x() || two.max.x() < one.min.x() ||
+        one.max.y() < two.min.y() || two.max.y() < one.min.y() ||
+        one.max.z() < two.min.z() || two.max.z() < one.min.z())
+    {
+        return;
+    }
+
+    if (one.left < 0 && two.left < 0)
+    {
+        test(a, b, result);
+    }
+    else if (one.left < 0 ||
+             (two.left >= 0 &&
+              surfaceArea(two.min, two.max) > surfaceArea(one.min, one.max)))
+    {
+        traverse(a, two.left, result);
+        traverse(a, two.right, result);
+    }
+    else
+    {
+        traverse(one.left, b, result);
+        traverse(one.right, b, result);
+    }
+}
+
+void tgCableProximity::test(int a, int b, std::size_t result)
+{
+    const Segment* pOne = &m_segments[m_nodes[a].segment];
+    const Segment* pTwo = &m_segments[m_nodes[b].segment];
+    if (pOne->cable == pTwo->cable)
+    {
+        return;
+    }
+    else if (pOne->cable > pTwo->cable)
+    {
+        std::swap(pOne, pTwo);
+    }
+    m_resultTests[result]++;
+
+    Pair pair;
+    pair.distance = closestPoints(pOne->from, pOne->to, pTwo->from, pTwo->to,
+                                  pair.s, pair.t);
+    if (pair.distance >= m_config.margin)
+    {
+        return;
+    }
+
+    // Cables that meet at an anchor are close there by design
+    if ((pair.s <= 0.0 || pair.s >= 1.0) && (pair.t <= 0.0 || pair.t >= 1.0))
+    {
+        btRigidBody* const pBody1 = (pair.s <= 0.0) ? pOne->fromBody : pOne->toBody;
+        btRigidBody* const pBody2 = (pair.t <= 0.0) ? pTwo->fromBody : pTwo->toBody;
+        if (pBody1 != NULL && pBody1 == pBody2)
+        {
+            return;
+        }
+    }
+
+    pair.cable1 = pOne->cable;
+    pair.cable2 = pTwo->cable;
+    pair.segment1 = pOne->index;
+    pair.segment2 = pTwo->index;
+    pair.point1 = pOne->from + (pOne->to - pOne->from) * pair.s;
+    pair.point2 = pTwo->from + (pTwo->to - pTwo->from) * pair.t;
+    pair.crossed = false;
+    m_results[result].push_back(pair);
+}
+
+void tgCableProximity::finish(double dt)
+{
+    m_pairs.clear();
+    m_tests = 0;
+    for (std::size_t i = 0; i < m_results.size(); i++)
+    {
+        m_pairs.insert(m_pairs.end(), m_results[i].begin(), m_results[i].end());
+        m_tests += m_resultTests[i];
+    }
+    // The threads' order depends on timing
+    std::sort(m_pairs.begin(), m_pairs.end(), byIndex);
+
+    std::map<std::pair<std::size_t, std::size_t>, Side> sides;
+    for (std::size_t i = 0; i < m_pairs.size(); i++)
+    {
+        Pair& pair = m_pairs[i];
+        const Segment& one = m_segments[m_offsets[pair.cable1] + pair.segment1];
+        const Segment& two = m_segments[m_offsets[pair.cable2] + pair.segment2];
+
+        // Parallel segments have no side
+        const btVector3 normal = (one.to - one.from).cross(two.to - two.from);
+        const double along = (pair.point1 - pair.point2).dot(normal);
+        const int sign = (normal.fuzzyZero() || along == 0.0) ? 0 :
+                         ((along > 0.0) ? 1 : -1);
+
+        const std::pair<std::size_t, std::size_t> key(
+            m_offsets[pair.cable1] + pair.segment1,
+            m_offsets[pair.cable2] + pair.segment2);
+        const std::map<std::pair<std::size_t, std::size_t>, Side>::const_iterator
+            previous = m_sides.find(key);
+
+        Side side;
+        if (previous != m_sides.end() && previous->second.sign != 0)
+        {
+            side.sign = previous->second.sign;
+            pair.crossed = (sign != 0) && (sign != side.sign);
+            if (pair.crossed && !previous->second.crossed)
+            {
+                m_crossings++;
+            }
+        }
+        else
+        {
+            side.sign = sign;
+        }
+        side.crossed = pair.crossed;
+        sides[key] = side;
+
+        if (m_config.stiffness > 0.0)
+        {
+            repel(pair, side.sign, dt);
+        }
+    }
+    m_sides.swap(sides);
+}
+
+void tgCableProximity::repel(const Pair& pair, int sign, double dt) const
+{
+    const Segment& one = m_segments[m_offsets[pair.cable1] + pair.segment1];
+    const Segment& two = m_segments[m_offsets[pair.cable2] + pair.segment2];
+
+    // Apart along the line between the nearest points, or back through
+    // each other along the normal if they have crossed
+    btVector3 direction;
+    double depth;
+    if (!pair.crossed && pair.distance > m_config.margin * 1.0e-6)
+    {
+        direction = (pair.point1 - pair.point2) / pair.distance;
+        depth = m_config.margin - pair.distance;
+    }
+    else
+    {
+        const btVector3 normal = (one.to - one.from).cross(two.to - two.from);
+        if (sign == 0 || normal.fuzzyZero())
+        {
+            return;
+        }
+        direction = normal.normalized() * static_cast<double>(sign);
+        depth = m_config.margin + (pair.crossed ? pair.distance : 0.0);
+    }
+
+    const btVector3 impulse = direction * (m_config.stiffness * depth * dt);
+    applyImpulse(one.fromBody, impulse * (1.0 - pair.s), one.from);
+    applyImpulse(one.toBody, impulse * pair.s, one.to);
+    applyImpulse(two.fromBody, -impulse * (1.0 - pair.t), two.from);
+    applyImpulse(two.toBody, -impulse * pair.t, two.to);
+}
+
+void tgCableProximity::startThreads(std::size_t count)
+{
+    // Size first: the threads hold pointers into m_workers
+    m_workers.resize(count);
+    for (std::size_t i = 0; i < m_workers.size(); i++)
+    {
+        m_workers[i].pProximity = this;
+        m_workers[i].index = i + 1;
+        if (pthread_create(&m_workers[i].thread, NULL, run,
+                           &m_workers[i]) != 0)
+        {
+            m_workers.resize(i);
+            stopThreads();
+            throw std::runtime_error("Could not start a proximity thread");
+        }
+    }
+}
+
+void tgCableProximity::stopThreads()
+{
+    pthread_mutex_lock(&m_mutex);
+    m_shutdown = true;
+    pthread_cond_broadcast(&m_startCondition);
+    pthread_mutex_unlock(&m_mutex);
+    for (std::size_t i = 0; i < m_workers.size(); i++)
+    {
+        pthread_join(m_workers[i].thread, NULL);
+    }
+    m_workers.clear();
+
+    pthread_cond_destroy(&m_doneCondition);
+    pthread_cond_destroy(&m_startCondition);
+    pthread_mutex_destroy(&m_mutex);
+}
+
+void* tgCableProximity::run(void* pArg)
+{
+    Worker* const pWorker = static_cast<Worker*>(pArg);
+    tgCableProximity& proximity = *pWorker->pProximity;
+
+    unsigned long seen = 0;
+    pthread_mutex_lock(&proximity.m_mutex);
+    while (true)
+    {
+        while ((proximity.m_generation == seen) && !proximity.m_shutdown)
+        {
+            pthread_cond_wait(&proximity.m_startCondition, &proximity.m_mutex);
+        }
+        if (proximity.m_shutdown)
+        {
+            break;
+        }
+        seen = proximity.m_generation;
+        pthread_mutex_unlock(&proximity.m_mutex);
+
+        proximity.runTasks(pWorker->index);
+
+        pthread_mutex_lock(&proximity.m_mutex);
+        if (--proximity.m_pending == 0)
+        {
+            pthread_cond_signal(&proximity.m_doneCondition);
+        }
+    }
+    pthread_mutex_unlock(&proximity.m_mutex);
+    return NULL;
+}
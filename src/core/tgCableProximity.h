@@ -0,0 +1,373 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_CABLE_PROXIMITY_H
+#define TG_CABLE_PROXIMITY_H
+
+/**
+ * @file tgCableProximity.h
+ * @brief Contains the definition of class tgCableProximity
+ * $Id$
+ */
+
+// The Bullet Physics library
+#include "LinearMath/btVector3.h"
+// The C++ Standard Library
+#include <map>
+#include <utility>
+#include <vector>
+// POSIX threads
+#include <pthread.h>
+
+// Forward declarations
+class btRigidBody;
+class tgSpringCableActuator;
+
+/**
+ * Finds cable segments that come close to or pass through each other,
+ * and optionally pushes them apart. A segment runs between consecutive
+ * anchors of a cable, so contact cables have several.
+ *
+ * The segments are kept in a bounding volume hierarchy. Each update
+ * refits its boxes to where the segments have moved, and rebuilds it
+ * only if the number of segments changed or refitting has loosened the
+ * boxes too much. The tree is traversed against itself, so only
+ * segments whose boxes overlap are tested: close to linear in the
+ * number of segments for a spread out net, instead of testing every
+ * pair. The traversal is split among a pool of threads; it only reads
+ * positions gathered beforehand, so it doesn't touch Bullet.
+ *
+ * Segments of the same cable are never paired, nor are segments whose
+ * nearest points are ends on the same body, such as two cables meeting
+ * at a node. A crossing is seen when a close pair's segments swap
+ * sides; that needs them to move less than the margin per update.
+ *
+ * Repulsion, if enabled, is a spring of the given stiffness across the
+ * part of the margin the segments are inside of. Cables have no mass,
+ * so each segment's share goes to the bodies at its ends, split by
+ * where along it the nearest point is. A pair that has crossed is
+ * pushed back towards the side it came from.
+ */
+class tgCableProximity
+{
+public:
+
+    /**
+     * The margin, repulsion and tree parameters. This is Plain Old Data.
+     */
+    struct Config
+    {
+        /**
+         * @param[in] margin the distance under which segments are
+         * paired; must be positive
+         * @param[in] stiffness the repulsion, in force per length inside
+         * the margin; 0 for none. Must not be negative
+         * @param[in] rebuildRatio how much the total surface area of the
+         * refit boxes may grow over that of a fresh tree before it is
+         * rebuilt; must be at least 1
+         * @param[in] threads the number of threads that traverse the
+         * tree, including the caller; 0 for one per processor
+         * @throw std::invalid_argument if any parameter is out of range
+         */
+        Config(double margin = 0.01,
+               double stiffness = 0.0,
+               double rebuildRatio = 2.0,
+               std::size_t threads = 1);
+
+        double margin;
+        double stiffness;
+        double rebuildRatio;
+        std::size_t threads;
+    };
+
+    /** Two segments closer than the margin */
+    struct Pair
+    {
+        /** Indexes into the cables passed to update(); cable1 < cable2 */
+        std::size_t cable1;
+        std::size_t cable2;
+
+        /** Indexes of the segments within their cables */
+        std::size_t segment1;
+        std::size_t segment2;
+
+        /** Where the nearest points are along the segments, in [0, 1] */
+        double s;
+        double t;
+
+        /** The nearest points, in world coordinates */
+        btVector3 point1;
+        btVector3 point2;
+
+        double distance;
+
+        /**
+         * Whether the segments are on the wrong side of each other,
+         * having passed through since they came close
+         */
+        bool crossed;
+    };
+
+    tgCableProximity(const Config& config = Config());
+
+    /** Stops the pool threads */
+    ~tgCableProximity();
+
+    /**
+     * Forget the tree and the sides of the pairs, e.g. after the world
+     * was rebuilt.
+     */
+    void reset();
+
+    /**
+     * Refit or rebuild the tree over the cables' segments, find the
+     * close pairs and, if stiffness is set, push them apart.
+     * @param[in] cables the spring cable actuators to check; the same
+     * ones in the same order every update, until reset()
+     * @param[in] dt the time over which repulsion acts; must be positive
+     * @throw std::invalid_argument if dt is not positive
+     */
+    void update(const std::vector<tgSpringCableActuator*>& cables, double dt);
+
+    /** Return the close pairs found by the last update, in order. */
+    const std::vector<Pair>& getPairs() const
+    {
+        return m_pairs;
+    }
+
+    /** Return the number of crossings seen since reset(). */
+    std::size_t getCrossingCount() const
+    {
+        return m_crossings;
+    }
+
+    /** Return the number of segments in the tree. */
+    std::size_t getSegmentCount() const
+    {
+        return m_segments.size();
+    }
+
+    /**
+     * Return the number of segment pairs whose distance the last update
+     * measured, to compare with the n(n - 1) / 2 of checking them all.
+     */
+    std::size_t getTestCount() const
+    {
+        return m_tests;
+    }
+
+    std::size_t getRebuildCount() const
+    {
+        return m_rebuilds;
+    }
+
+    std::size_t getRefitCount() const
+    {
+        return m_refits;
+    }
+
+    /** Return the number of threads, including the calling thread. */
+    std::size_t getThreadCount() const
+    {
+        return m_workers.size() + 1;
+    }
+
+    const Config& getConfig() const
+    {
+        return m_config;
+    }
+
+    /**
+     * Find the nearest points of two segments.
+     * @param[in] p1 the start of the first segment
+     * @param[in] q1 the end of the first segment
+     * @param[in] p2 the start of the second segment
+     * @param[in] q2 the end of the second segment
+     * @param[out] s where the nearest point is along the first, in [0, 1]
+     * @param[out] t where the nearest point is along the second
+     * @return the distance between the nearest points
+     */
+    static double closestPoints(const btVector3& p1, const btVector3& q1,
+                                const btVector3& p2, const btVector3& q2,
+                                double& s, double& t);
+
+private:
+
+    /** A piece of cable between two anchors */
+    struct Segment
+    {
+        btVector3 from;
+        btVector3 to;
+
+        /** The bodies of the anchors, or NULL if they aren't Bullet anchors */
+        btRigidBody* fromBody;
+        btRigidBody* toBody;
+
+        std::size_t cable;
+        std::size_t index;
+    };
+
+    /**
+     * A box of the tree. Children come after their parent, so refitting
+     * in reverse order sees children first.
+     */
+    struct Node
+    {
+        btVector3 min;
+        btVector3 max;
+
+        /** The children, or -1 for a leaf */
+        int left;
+        int right;
+
+        /** The segment of a leaf */
+        int segment;
+    };
+
+    /** Sorts segment indexes by their midpoints along an axis */
+    struct ByCentroid;
+
+    /** Which side of each other a close pair belongs on */
+    struct Side
+    {
+        /** The sign of the pair's separation along the cross product of the segments */
+        int sign;
+        bool crossed;
+    };
+
+    /** Two subtrees to traverse against each other; the same one for itself */
+    struct Task
+    {
+        Task(int a, int b) : first(a), second(b) { }
+        int first;
+        int second;
+    };
+
+    /** A pool thread and the index of its results */
+    struct Worker
+    {
+        tgCableProximity* pProximity;
+        std::size_t index;
+        pthread_t thread;
+    };
+
+    /**
+     * Read the segments of the cables.
+     * @return false if a cable's number of segments changed
+     */
+    bool gather(const std::vector<tgSpringCableActuator*>& cables);
+
+    /** Build the tree from scratch. */
+    void build();
+
+    /** Build the subtree over m_order[begin, end) and return its node. */
+    int build(std::size_t begin, std::size_t end);
+
+    /** Fit the boxes to the segments; return their total surface area. */
+    double refit();
+
+    /** Set a leaf's box to its segment's, widened by half the margin. */
+    void fitLeaf(Node& node) const;
+
+    /** Split the traversal into at least a few tasks per thread. */
+    void makeTasks();
+
+    /** Run tasks until there are none left, collecting into one result. */
+    void runTasks(std::size_t result);
+
+    void traverse(int node, std::size_t result);
+    void traverse(int a, int b, std::size_t result);
+
+    /** Measure a pair of leaves, and record it if it is close. */
+    void test(int a, int b, std::size_t result);
+
+    /** Merge the threads' pairs, see crossings and apply repulsion. */
+    void finish(double dt);
+
+    /** Push a pair apart towards the side it belongs on. */
+    void repel(const Pair& pair, int sign, double dt) const;
+
+    /** The body of a pool thread. */
+    static void* run(void* pWorker);
+
+    /**
+     * Start the pool threads.
+     * @throw std::runtime_error if a thread can't be started
+     */
+    void startThreads(std::size_t count);
+
+    /** Stop and join the pool threads, and release the pthread objects. */
+    void stopThreads();
+
+private:
+
+    const Config m_config;
+
+    /** The segments, cable by cable */
+    std::vector<Segment> m_segments;
+
+    /** The tree; the root is node 0 */
+    std::vector<Node> m_nodes;
+
+    /** Segment indexes, sorted while building */
+    std::vector<int> m_order;
+
+    /** The total surface area of the boxes when the tree was built */
+    double m_builtArea;
+
+    std::vector<Task> m_tasks;
+
+    /** The next task to take, shared by the threads */
+    volatile long m_nextTask;
+
+    /** Each thread's pairs, and how many tests it made */
+    std::vector<std::vector<Pair> > m_results;
+    std::vector<std::size_t> m_resultTests;
+
+    std::vector<Pair> m_pairs;
+
+    /** The first segment of each cable in m_segments */
+    std::vector<std::size_t> m_offsets;
+
+    /**
+     * Which side of each other the close pairs belong on, keyed by their
+     * segments' indexes in m_segments
+     */
+    std::map<std::pair<std::size_t, std::size_t>, Side> m_sides;
+
+    std::size_t m_crossings;
+    std::size_t m_tests;
+    std::size_t m_rebuilds;
+    std::size_t m_refits;
+
+    /** The pool threads; empty for one thread */
+    std::vector<Worker> m_workers;
+    pthread_mutex_t m_mutex;
+    pthread_cond_t m_startCondition;
+    pthread_cond_t m_doneCondition;
+
+    /** Incremented once per update that uses the pool */
+    unsigned long m_generation;
+
+    /** Pool threads still traversing in this generation */
+    std::size_t m_pending;
+
+    bool m_shutdown;
+};
+
+#endif  // TG_CABLE_PROXIMITY_H
@@ -0,0 +1,84 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_HASH_H
+#define TG_HASH_H
+
+/**
+ * @file tgHash.h
+ * @brief Contains the definition of class tgHash
+ * $Id$
+ */
+
+// The C++ Standard Library
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+/**
+ * Hashes that are the same for every build and run, so they can key
+ * files such as a tgSettleCache. tgUtil's hash functions use these.
+ */
+class tgHash
+{
+public:
+
+    /**
+     * Mix a hash into a running hash, as boost::hash_combine does.
+     * @param[in,out] seed the running hash
+     * @param[in] h the hash to mix in
+     */
+    inline static void combine(std::size_t& seed, std::size_t h)
+    {
+        seed ^= h + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    }
+
+    /**
+     * Hash a double exactly. 0.0 and -0.0 hash the same.
+     * @param[in] d a double
+     * @return a hash of d
+     */
+    inline static std::size_t ofDouble(double d)
+    {
+        if (d == 0.0)
+        {
+            return 0;
+        }
+        unsigned long long bits;
+        std::memcpy(&bits, &d, sizeof(bits));
+        return static_cast<std::size_t>(bits ^ (bits >> 32));
+    }
+
+    /**
+     * Hash a string with FNV-1a.
+     * @param[in] s a string
+     * @return a hash of s
+     */
+    inline static std::size_t ofString(const std::string& s)
+    {
+        unsigned long long h = 14695981039346656037ULL;
+        for (std::size_t i = 0; i < s.size(); i++)
+        {
+            h ^= static_cast<unsigned char>(s[i]);
+            h *= 1099511628211ULL;
+        }
+        return static_cast<std::size_t>(h ^ (h >> 32));
+    }
+};
+
+#endif  // TG_HASH_H
@@ -0,0 +1,366 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgIslandParallelSolver.cpp
+ * @brief Contains the definitions of members of class
+ * tgIslandParallelSolver
+ * $Id$
+ */
+
+// This module
+#include "tgIslandParallelSolver.h"
+// The Bullet Physics Library
+#include "BulletCollision/NarrowPhaseCollision/btPersistentManifold.h"
+#include "BulletDynamics/ConstraintSolver/btContactSolverInfo.h"
+#include "BulletDynamics/ConstraintSolver/btTypedConstraint.h"
+#include "BulletDynamics/Dynamics/btRigidBody.h"
+// The C++ Standard Library
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+
+namespace
+{
+    /** Return true if the solver would write to a shared body */
+    bool isKinematic(const btCollisionObject* pObject)
+    {
+        return (pObject != NULL) && pObject->isKinematicObject();
+    }
+}
+
+bool tgIslandParallelSolver::ByCost::operator()(std::size_t a,
+                                                std::size_t b) const
+{
+    if (m_groups[a].cost != m_groups[b].cost)
+    {
+        return m_groups[a].cost > m_groups[b].cost;
+    }
+    return a < b;
+}
+
+tgIslandParallelSolver::tgIslandParallelSolver(
+    const std::vector<btConstraintSolver*>& solvers) :
+    m_solvers(solvers),
+    m_groupCount(0),
+    m_assignment(solvers.size()),
+    m_pInfo(NULL),
+    m_pDebugDrawer(NULL),
+    m_generation(0),
+    m_pending(0),
+    m_shutdown(false)
+{
+    if (solvers.empty())
+    {
+        throw std::invalid_argument("No solvers");
+    }
+    else if (std::find(solvers.begin(), solvers.end(),
+                       static_cast<btConstraintSolver*>(NULL)) !=
+             solvers.end())
+    {
+        deleteSolvers();
+        throw std::invalid_argument("Solver is NULL");
+    }
+
+    pthread_mutex_init(&m_mutex, NULL);
+    pthread_cond_init(&m_startCondition, NULL);
+    pthread_cond_init(&m_doneCondition, NULL);
+
+    // Without BT_NO_PROFILE the pool would never be used
+    if (isParallel())
+    {
+        startThreads();
+    }
+}
+
+tgIslandParallelSolver::~tgIslandParallelSolver()
+{
+    stopThreads();
+    deleteSolvers();
+}
+
+bool tgIslandParallelSolver::isParallel()
+{
+#ifdef BT_NO_PROFILE
+    return true;
+#else
+    return false;
+#endif
+}
+
+void tgIslandParallelSolver::prepareSolve(int, int)
+{
+    m_groupCount = 0;
+}
+
+btScalar tgIslandParallelSolver::solveGroup(btCollisionObject** bodies,
+                                            int numBodies,
+                                            btPersistentManifold** manifolds,
+                                            int numManifolds,
+                                            btTypedConstraint** constraints,
+                                            int numConstraints,
+                                            const btContactSolverInfo&,
+                                            btIDebugDraw*,
+                                            btDispatcher* dispatcher)
+{
+    // The island callback flushes an empty batch at the end of a step
+    if ((numBodies == 0) && (numManifolds == 0) && (numConstraints == 0))
+    {
+        return 0.0;
+    }
+
+    // Reuse the vectors of earlier steps
+    if (m_groupCount == m_groups.size())
+    {
+        m_groups.push_back(Group());
+    }
+    Group& group = m_groups[m_groupCount++];
+    group.bodies.assign(bodies, bodies + numBodies);
+    group.manifolds.assign(manifolds, manifolds + numManifolds);
+    group.constraints.assign(constraints, constraints + numConstraints);
+    group.dispatcher = dispatcher;
+    group.cost = numBodies + numManifolds + numConstraints;
+
+    // Kinematic and static bodies are not part of any island, so they
+    // show up through the contacts and constraints that reach them
+    group.serial = false;
+    for (int i = 0; !group.serial && (i < numManifolds); i++)
+    {
+        group.serial = isKinematic(manifolds[i]->getBody0()) ||
+                       isKinematic(manifolds[i]->getBody1());
+    }
+    for (int i = 0; !group.serial && (i < numConstraints); i++)
+    {
+        group.serial = constraints[i]->getRigidBodyA().isKinematicObject() ||
+                       constraints[i]->getRigidBodyB().isKinematicObject();
+    }
+
+    return 0.0;
+}
+
+void tgIslandParallelSolver::allSolved(const btContactSolverInfo& info,
+                                       btIDebugDraw* debugDrawer)
+{
+    if (m_groupCount == 0)
+    {
+        return;
+    }
+    m_pInfo = &info;
+    m_pDebugDrawer = debugDrawer;
+
+    assign();
+
+    // Skip the pool if only one thread has work
+    std::size_t busy = 0;
+    for (std::size_t i = 0; i < m_assignment.size(); i++)
+    {
+        if (!m_assignment[i].empty())
+        {
+            busy++;
+        }
+    }
+
+    if (busy > 1)
+    {
+        pthread_mutex_lock(&m_mutex);
+        m_pending = static_cast<int>(m_workers.size());
+        m_generation++;
+        pthread_cond_broadcast(&m_startCondition);
+        pthread_mutex_unlock(&m_mutex);
+
+        solveAssigned(0);
+
+        pthread_mutex_lock(&m_mutex);
+        while (m_pending > 0)
+        {
+            pthread_cond_wait(&m_doneCondition, &m_mutex);
+        }
+        pthread_mutex_unlock(&m_mutex);
+    }
+    else
+    {
+        for (std::size_t i = 0; i < m_assignment.size(); i++)
+        {
+            solveAssigned(i);
+        }
+    }
+
+    for (std::size_t i = 0; i < m_serial.size(); i++)
+    {
+        solve(0, m_groups[m_serial[i]]);
+    }
+
+    m_groupCount = 0;
+    m_pInfo = NULL;
+    m_pDebugDrawer = NULL;
+}
+
+void tgIslandParallelSolver::reset()
+{
+    for (std::size_t i = 0; i < m_solvers.size(); i++)
+    {
+        m_solvers[i]->reset();
+    }
+}
+
+btConstraintSolverType tgIslandParallelSolver::getSolverType() const
+{
+    return m_solvers[0]->getSolverType();
+}
+
+void tgIslandParallelSolver::assign()
+{
+    for (std::size_t i = 0; i < m_assignment.size(); i++)
+    {
+        m_assignment[i].clear();
+    }
+    m_serial.clear();
+
+    std::vector<std::size_t> order;
+    for (std::size_t i = 0; i < m_groupCount; i++)
+    {
+        if (m_groups[i].serial)
+        {
+            m_serial.push_back(i);
+        }
+        else if (isParallel())
+        {
+            order.push_back(i);
+        }
+        else
+        {
+            m_assignment[0].push_back(i);
+        }
+    }
+
+    // Longest first to the least loaded thread. Ties go to the lower
+    // index, so the same islands always land on the same threads.
+    std::sort(order.begin(), order.end(), ByCost(m_groups));
+    std::vector<std::size_t> load(m_assignment.size(), 0);
+    for (std::size_t i = 0; i < order.size(); i++)
+    {
+        const std::size_t thread =
+            std::min_element(load.begin(), load.end()) - load.begin();
+        m_assignment[thread].push_back(order[i]);
+        load[thread] += m_groups[order[i]].cost;
+    }
+
+    // Each thread solves in Bullet's island order
+    for (std::size_t i = 0; i < m_assignment.size(); i++)
+    {
+        std::sort(m_assignment[i].begin(), m_assignment[i].end());
+    }
+}
+
+void tgIslandParallelSolver::solveAssigned(int thread)
+{
+    const std::vector<std::size_t>& assigned = m_assignment[thread];
+    for (std::size_t i = 0; i < assigned.size(); i++)
+    {
+        solve(thread, m_groups[assigned[i]]);
+    }
+}
+
+void tgIslandParallelSolver::solve(int thread, Group& group)
+{
+    assert(m_pInfo != NULL);
+    m_solvers[thread]->solveGroup(
+        group.bodies.empty() ? NULL : &group.bodies[0],
+        static_cast<int>(group.bodies.size()),
+        group.manifolds.empty() ? NULL : &group.manifolds[0],
+        static_cast<int>(group.manifolds.size()),
+        group.constraints.empty() ? NULL : &group.constraints[0],
+        static_cast<int>(group.constraints.size()),
+        *m_pInfo, m_pDebugDrawer, group.dispatcher);
+}
+
+void tgIslandParallelSolver::startThreads()
+{
+    // Size first: the threads hold pointers into m_workers
+    m_workers.resize(m_solvers.size() - 1);
+    for (std::size_t i = 0; i < m_workers.size(); i++)
+    {
+        m_workers[i].pSolver = this;
+        m_workers[i].index = static_cast<int>(i) + 1;
+        if (pthread_create(&m_workers[i].thread, NULL, run,
+                           &m_workers[i]) != 0)
+        {
+            m_workers.resize(i);
+            stopThreads();
+            deleteSolvers();
+            throw std::runtime_error("Could not start a solver thread");
+        }
+    }
+}
+
+void tgIslandParallelSolver::stopThreads()
+{
+    pthread_mutex_lock(&m_mutex);
+    m_shutdown = true;
+    pthread_cond_broadcast(&m_startCondition);
+    pthread_mutex_unlock(&m_mutex);
+    for (std::size_t i = 0; i < m_workers.size(); i++)
+    {
+        pthread_join(m_workers[i].thread, NULL);
+    }
+    m_workers.clear();
+
+    pthread_cond_destroy(&m_doneCondition);
+    pthread_cond_destroy(&m_startCondition);
+    pthread_mutex_destroy(&m_mutex);
+}
+
+void tgIslandParallelSolver::deleteSolvers()
+{
+    for (std::size_t i = 0; i < m_solvers.size(); i++)
+    {
+        delete m_solvers[i];
+    }
+}
+
+void* tgIslandParallelSolver::run(void* pArg)
+{
+    Worker* const pWorker = static_cast<Worker*>(pArg);
+    tgIslandParallelSolver& solver = *pWorker->pSolver;
+
+    unsigned long seen = 0;
+    pthread_mutex_lock(&solver.m_mutex);
+    while (true)
+    {
+        while ((solver.m_generation == seen) && !solver.m_shutdown)
+        {
+            pthread_cond_wait(&solver.m_startCondition, &solver.m_mutex);
+        }
+        if (solver.m_shutdown)
+        {
+            break;
+        }
+        seen = solver.m_generation;
+        pthread_mutex_unlock(&solver.m_mutex);
+
+        solver.solveAssigned(pWorker->index);
+
+        pthread_mutex_lock(&solver.m_mutex);
+        if (--solver.m_pending == 0)
+        {
+            pthread_cond_signal(&solver.m_doneCondition);
+        }
+    }
+    pthread_mutex_unlock(&solver.m_mutex);
+    return NULL;
+}
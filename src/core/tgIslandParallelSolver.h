@@ -0,0 +1,202 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_ISLAND_PARALLEL_SOLVER_H
+#define TG_ISLAND_PARALLEL_SOLVER_H
+
+/**
+ * @file tgIslandParallelSolver.h
+ * @brief Contains the definition of class tgIslandParallelSolver
+ * $Id$
+ */
+
+// The Bullet Physics Library
+#include "BulletDynamics/ConstraintSolver/btConstraintSolver.h"
+#include "LinearMath/btScalar.h"
+// The C++ Standard Library
+#include <vector>
+// POSIX threads
+#include <pthread.h>
+
+// Forward declarations
+class btCollisionObject;
+class btDispatcher;
+class btIDebugDraw;
+class btPersistentManifold;
+class btTypedConstraint;
+struct btContactSolverInfo;
+
+/**
+ * A constraint solver that solves independent simulation islands on a
+ * pool of threads.
+ *
+ * The dynamics world hands over one island (or batch of islands) per
+ * solveGroup() call. These are only recorded; allSolved() then deals
+ * them out to the threads, each of which runs its own copy of the usual
+ * solver over its share in order. Islands share no dynamic bodies, so
+ * the result of each island does not depend on which thread solved it
+ * or when, and a run is repeatable for a fixed thread count.
+ *
+ * Islands that touch a kinematic body are solved on the calling thread
+ * after the others, since the solver writes to every non-static body it
+ * sees. Bullet's profiler is not thread safe either, so unless Bullet
+ * and NTRT are built with BT_NO_PROFILE all islands are solved on the
+ * calling thread, and tgWorld::Config refuses more than one solver
+ * thread in such a build; see BULLET_PROFILE in bullet.conf.
+ */
+class tgIslandParallelSolver : public btConstraintSolver
+{
+public:
+
+    /**
+     * @param[in] solvers one solver per thread; the first is used by the
+     * calling thread. Takes ownership.
+     * @throw std::invalid_argument if solvers is empty or has a NULL
+     * @throw std::runtime_error if the threads can't be started
+     */
+    tgIslandParallelSolver(const std::vector<btConstraintSolver*>& solvers);
+
+    /** Stop the threads and delete the solvers. */
+    virtual ~tgIslandParallelSolver();
+
+    virtual void prepareSolve(int numBodies, int numManifolds);
+
+    /**
+     * Record a group of islands to be solved by allSolved().
+     * @return 0; the residual is not known yet
+     */
+    virtual btScalar solveGroup(btCollisionObject** bodies,
+                                int numBodies,
+                                btPersistentManifold** manifolds,
+                                int numManifolds,
+                                btTypedConstraint** constraints,
+                                int numConstraints,
+                                const btContactSolverInfo& info,
+                                btIDebugDraw* debugDrawer,
+                                btDispatcher* dispatcher);
+
+    /** Solve all the groups recorded since prepareSolve(). */
+    virtual void allSolved(const btContactSolverInfo& info,
+                           btIDebugDraw* debugDrawer);
+
+    virtual void reset();
+
+    virtual btConstraintSolverType getSolverType() const;
+
+    /** Return the number of threads, including the calling thread. */
+    int getThreadCount() const
+    {
+        return static_cast<int>(m_solvers.size());
+    }
+
+    /**
+     * Return true if islands are really solved concurrently, i.e.
+     * Bullet's profiler is compiled out.
+     */
+    static bool isParallel();
+
+private:
+
+    /** The arguments of one solveGroup() call. */
+    struct Group
+    {
+        std::vector<btCollisionObject*> bodies;
+        std::vector<btPersistentManifold*> manifolds;
+        std::vector<btTypedConstraint*> constraints;
+        btDispatcher* dispatcher;
+
+        /** Whether it touches a kinematic body */
+        bool serial;
+
+        /** Relative solve time, for load balancing */
+        std::size_t cost;
+    };
+
+    /** Sort order for load balancing: costly first, then Bullet's order */
+    struct ByCost
+    {
+        ByCost(const std::vector<Group>& groups) : m_groups(groups) { }
+        bool operator()(std::size_t a, std::size_t b) const;
+        const std::vector<Group>& m_groups;
+    };
+
+    /** A pool thread and the index of its solver */
+    struct Worker
+    {
+        tgIslandParallelSolver* pSolver;
+        int index;
+        pthread_t thread;
+    };
+
+    /** Deal the parallel groups out to the threads. */
+    void assign();
+
+    /** Solve the groups assigned to one thread, in order. */
+    void solveAssigned(int thread);
+
+    /** Solve one recorded group with the given thread's solver. */
+    void solve(int thread, Group& group);
+
+    /** The body of a pool thread. */
+    static void* run(void* pWorker);
+
+    /**
+     * Start the pool threads.
+     * @throw std::runtime_error if a thread can't be started
+     */
+    void startThreads();
+
+    /** Stop and join the pool threads, and release the pthread objects. */
+    void stopThreads();
+
+    void deleteSolvers();
+
+private:
+
+    const std::vector<btConstraintSolver*> m_solvers;
+
+    /** Recorded groups; only the first m_groupCount are current */
+    std::vector<Group> m_groups;
+    std::size_t m_groupCount;
+
+    /** Indexes of the groups each thread solves */
+    std::vector<std::vector<std::size_t> > m_assignment;
+
+    /** Indexes of the groups that must be solved serially */
+    std::vector<std::size_t> m_serial;
+
+    /** The arguments of the current allSolved() call */
+    const btContactSolverInfo* m_pInfo;
+    btIDebugDraw* m_pDebugDrawer;
+
+    /** The pool threads; empty unless isParallel() */
+    std::vector<Worker> m_workers;
+    pthread_mutex_t m_mutex;
+    pthread_cond_t m_startCondition;
+    pthread_cond_t m_doneCondition;
+
+    /** Incremented once per allSolved() that uses the pool */
+    unsigned long m_generation;
+
+    /** Pool threads still solving in this generation */
+    int m_pending;
+
+    bool m_shutdown;
+};
+
+#endif  // TG_ISLAND_PARALLEL_SOLVER_H
@@ -224,6 +224,16 @@ double tgKinematicActuator::getAppliedTorque(double desiredTorque) const
 		desiredTorque / abs(desiredTorque) * maxTorque;
 }
 
+double tgKinematicActuator::getMotorVelocity() const
+{
+    return m_motorVel;
+}
+
+void tgKinematicActuator::setMotorVelocity(double motorVelocity)
+{
+    m_motorVel = motorVelocity;
+}
+
 void tgKinematicActuator::setControlInput(double input)
 {
 	m_desiredTorque = input;
@@ -157,6 +157,10 @@ public:
      * available speeds and torques
      */
     virtual double getAppliedTorque(double desiredTorque) const;
+    
+    virtual double getMotorVelocity() const;
+    
+    virtual void setMotorVelocity(double motorVelocity);
 	
 	
 	/**
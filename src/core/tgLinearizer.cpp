@@ -0,0 +1,278 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgLinearizer.cpp
+ * @brief Contains the definitions of members of class tgLinearizer
+ * $Id$
+ */
+
+// This module
+#include "tgLinearizer.h"
+// This application
+#include "tgSimulation.h"
+// The Bullet Physics Library
+#include "LinearMath/btMatrix3x3.h"
+#include "LinearMath/btQuaternion.h"
+// The C++ Standard Library
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <stdexcept>
+// POSIX
+#include <unistd.h>
+
+namespace
+{
+    /** The rotation of a body in a state's raw data */
+    btMatrix3x3 basisAt(const double* p)
+    {
+        return btMatrix3x3(p[0], p[1], p[2],
+                           p[3], p[4], p[5],
+                           p[6], p[7], p[8]);
+    }
+
+    /** The rotation vector of a rotation matrix, of angle at most pi */
+    btVector3 rotationVector(const btMatrix3x3& rotation)
+    {
+        btQuaternion q;
+        rotation.getRotation(q);
+        if (q.getW() < 0.0)
+        {
+            q = -q;
+        }
+        const btVector3 v(q.getX(), q.getY(), q.getZ());
+        const double sine = v.length();
+        if (sine < 1.0e-12)
+        {
+            // angle / sin(angle / 2) tends to 2
+            return 2.0 * v;
+        }
+        const double angle = 2.0 * std::atan2(sine, q.getW());
+        return v * (angle / sine);
+    }
+}
+
+const std::size_t tgLinearizer::bodyCoordinates;
+
+tgLinearizer::Config::Config(double t,
+                             std::size_t s,
+                             double stateEps,
+                             double inputEps,
+                             bool c,
+                             std::size_t b) :
+    dt(t),
+    steps(s),
+    stateEpsilon(stateEps),
+    inputEpsilon(inputEps),
+    central(c),
+    branches(b)
+{
+    if (!(dt > 0.0))
+    {
+        throw std::invalid_argument("dt is not positive");
+    }
+    else if (steps == 0)
+    {
+        throw std::invalid_argument("steps is zero");
+    }
+    else if (!(stateEpsilon > 0.0))
+    {
+        throw std::invalid_argument("stateEpsilon is not positive");
+    }
+    else if (!(inputEpsilon > 0.0))
+    {
+        throw std::invalid_argument("inputEpsilon is not positive");
+    }
+}
+
+tgLinearizer::tgLinearizer(const Config& config,
+                           tgSimulation& simulation,
+                           tgSimulationFork::Factory& factory) :
+    m_config(config),
+    m_simulation(simulation),
+    m_factory(factory),
+    m_pFork(NULL),
+    m_stateSize(0),
+    m_inputSize(0),
+    m_runCount(0)
+{
+}
+
+tgLinearizer::~tgLinearizer()
+{
+    delete m_pFork;
+}
+
+void tgLinearizer::linearize()
+{
+    tgSimulationState nominal;
+    m_simulation.captureState(nominal);
+    m_stateSize = nominal.getBodyCount() * bodyCoordinates;
+    m_inputSize = nominal.getCableCount();
+
+    // Run 0 is the nominal state; then each coordinate plus epsilon and,
+    // for central differences, minus epsilon
+    const std::size_t coordinates = m_stateSize + m_inputSize;
+    const std::size_t perCoordinate = m_config.central ? 2 : 1;
+    m_runCount = 1 + perCoordinate * coordinates;
+
+    if (m_pFork == NULL)
+    {
+        std::size_t branches = m_config.branches;
+        if (branches == 0)
+        {
+            const long processors = sysconf(_SC_NPROCESSORS_ONLN);
+            branches = (processors > 0) ? static_cast<std::size_t>(processors) : 1;
+        }
+        branches = std::min(branches, m_runCount);
+        m_pFork = m_simulation.fork(branches, m_factory);
+    }
+
+    std::vector<tgSimulationState> results(m_runCount);
+    std::vector<tgSimulationState> starts(m_pFork->size(), nominal);
+    std::vector<double> data;
+    for (std::size_t first = 0; first < m_runCount; first += m_pFork->size())
+    {
+        const std::size_t count = std::min(m_pFork->size(), m_runCount - first);
+        for (std::size_t i = 0; i < count; i++)
+        {
+            const std::size_t run = first + i;
+            data = nominal.getData();
+            if (run > 0)
+            {
+                const std::size_t coordinate = (run - 1) / perCoordinate;
+                const bool minus = ((run - 1) % perCoordinate) == 1;
+                const double epsilon = (coordinate < m_stateSize) ?
+                    m_config.stateEpsilon : m_config.inputEpsilon;
+                perturb(data, coordinate, minus ? -epsilon : epsilon);
+            }
+            starts[i] = tgSimulationState(nominal.getBodyCount(),
+                                          nominal.getCableCount(), data);
+        }
+        // Spare branches just repeat the nominal run
+        for (std::size_t i = count; i < starts.size(); i++)
+        {
+            starts[i] = nominal;
+        }
+
+        m_pFork->sync(starts);
+        m_pFork->step(m_config.dt, m_config.steps);
+        for (std::size_t i = 0; i < count; i++)
+        {
+            m_pFork->getSimulation(i).captureState(results[first + i]);
+        }
+    }
+
+    m_nominalNext = results[0];
+    m_A.assign(m_stateSize * m_stateSize, 0.0);
+    m_B.assign(m_stateSize * m_inputSize, 0.0);
+    for (std::size_t j = 0; j < coordinates; j++)
+    {
+        const double epsilon = (j < m_stateSize) ?
+            m_config.stateEpsilon : m_config.inputEpsilon;
+        if (m_config.central)
+        {
+            difference(results[1 + 2 * j], results[2 + 2 * j],
+                       2.0 * epsilon, j);
+        }
+        else
+        {
+            difference(results[1 + j], results[0], epsilon, j);
+        }
+    }
+}
+
+void tgLinearizer::perturb(std::vector<double>& data, std::size_t index,
+                           double delta) const
+{
+    if (index >= m_stateSize)
+    {
+        const std::size_t cable = index - m_stateSize;
+        const std::size_t offset =
+            (m_stateSize / bodyCoordinates) * tgSimulationState::bodySize +
+            cable * tgSimulationState::cableSize;
+        // The rest length comes first in a cable's state
+        data[offset] += delta;
+        return;
+    }
+
+    double* const p = &data[(index / bodyCoordinates) * tgSimulationState::bodySize];
+    const std::size_t k = index % bodyCoordinates;
+    if (k < 3)
+    {
+        p[9 + k] += delta;
+    }
+    else if (k < 6)
+    {
+        btVector3 axis(0.0, 0.0, 0.0);
+        axis[k - 3] = 1.0;
+        const btMatrix3x3 rotation =
+            btMatrix3x3(btQuaternion(axis, delta)) * basisAt(p);
+        for (int row = 0; row < 3; row++)
+        {
+            for (int col = 0; col < 3; col++)
+            {
+                p[3 * row + col] = rotation[row][col];
+            }
+        }
+    }
+    else
+    {
+        // Linear then angular velocity follow the origin
+        p[12 + (k - 6)] += delta;
+    }
+}
+
+void tgLinearizer::difference(const tgSimulationState& plus,
+                              const tgSimulationState& minus,
+                              double scale, std::size_t column)
+{
+    assert(plus.getData().size() == minus.getData().size());
+    std::vector<double>& matrix = (column < m_stateSize) ? m_A : m_B;
+    const std::size_t width = (column < m_stateSize) ? m_stateSize : m_inputSize;
+    const std::size_t col = (column < m_stateSize) ? column : column - m_stateSize;
+
+    const std::size_t bodies = m_stateSize / bodyCoordinates;
+    for (std::size_t b = 0; b < bodies; b++)
+    {
+        const double* const p = &plus.getData()[b * tgSimulationState::bodySize];
+        const double* const q = &minus.getData()[b * tgSimulationState::bodySize];
+        double d[bodyCoordinates];
+        for (int k = 0; k < 3; k++)
+        {
+            d[k] = p[9 + k] - q[9 + k];
+        }
+        const btVector3 rotation =
+            rotationVector(basisAt(p) * basisAt(q).transpose());
+        for (int k = 0; k < 3; k++)
+        {
+            d[3 + k] = rotation[k];
+        }
+        for (int k = 0; k < 6; k++)
+        {
+            d[6 + k] = p[12 + k] - q[12 + k];
+        }
+
+        for (std::size_t k = 0; k < bodyCoordinates; k++)
+        {
+            const std::size_t row = b * bodyCoordinates + k;
+            matrix[row * width + col] = d[k] / scale;
+        }
+    }
+}
@@ -0,0 +1,199 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_LINEARIZER_H
+#define TG_LINEARIZER_H
+
+/**
+ * @file tgLinearizer.h
+ * @brief Contains the definition of class tgLinearizer
+ * $Id$
+ */
+
+// This application
+#include "tgSimulationFork.h"
+#include "tgSimulationState.h"
+// The C++ Standard Library
+#include <cstddef>
+#include <vector>
+
+// Forward declarations
+class tgSimulation;
+
+/**
+ * Linearizes a simulation's dynamics about its current state by finite
+ * differences, for LQR design and stability analysis of gaits: the
+ * Jacobians A = dx'/dx and B = dx'/du of the state x' after a control
+ * period with respect to the state x and inputs u at its start.
+ *
+ * The state has twelve coordinates per dynamic rigid body, in world
+ * order: position, orientation, linear velocity and angular velocity.
+ * The orientation coordinates are a rotation vector applied on the left
+ * of the body's rotation, so they are zero at the linearization point
+ * and the result is in error coordinates, as an LQR on rotations wants.
+ * The inputs are the rest lengths of the spring cable actuators, in
+ * pre-order, held for the period. The rest of each cable's state is
+ * left as it was.
+ *
+ * Each perturbed state runs in its own branch of a tgSimulationFork, so
+ * the runs share the cores; the fork is made on the first call and kept.
+ * Its factory should build the model without controllers, which would
+ * move the rest lengths.
+ */
+class tgLinearizer
+{
+public:
+
+    /**
+     * The finite difference options. This is Plain Old Data.
+     */
+    struct Config
+    {
+        /**
+         * @param[in] dt the timestep; must be positive
+         * @param[in] steps the number of steps in a control period; must
+         * be positive
+         * @param[in] stateEpsilon the perturbation of each state
+         * coordinate, in meters, radians, m/s or rad/s; must be positive
+         * @param[in] inputEpsilon the perturbation of each rest length,
+         * in meters; must be positive
+         * @param[in] central true for central differences, which cost
+         * twice the runs and are second order accurate; false for
+         * forward differences
+         * @param[in] branches the number of runs at a time; 0 for one
+         * per processor
+         * @throw std::invalid_argument if any parameter is out of range
+         */
+        Config(double dt = 1.0/1000.0,
+               std::size_t steps = 1,
+               double stateEpsilon = 1.0e-4,
+               double inputEpsilon = 1.0e-4,
+               bool central = true,
+               std::size_t branches = 0);
+
+        double dt;
+        std::size_t steps;
+        double stateEpsilon;
+        double inputEpsilon;
+        bool central;
+        std::size_t branches;
+    };
+
+    /** Doubles of state per rigid body */
+    static const std::size_t bodyCoordinates = 12;
+
+    /**
+     * @param[in] config the finite difference options
+     * @param[in] simulation the simulation to linearize; not owned
+     * @param[in,out] factory builds the model of each branch the way
+     * the simulation's was built; not owned
+     */
+    tgLinearizer(const Config& config,
+                 tgSimulation& simulation,
+                 tgSimulationFork::Factory& factory);
+
+    ~tgLinearizer();
+
+    /**
+     * Linearize about the simulation's current state and rest lengths.
+     * The simulation itself is not stepped.
+     * @throw std::invalid_argument if the simulation can't be forked; see
+     * tgSimulation::fork()
+     * @throw std::runtime_error if a run threw
+     */
+    void linearize();
+
+    /** The number of state coordinates, n */
+    std::size_t getStateSize() const
+    {
+        return m_stateSize;
+    }
+
+    /** The number of inputs, m */
+    std::size_t getInputSize() const
+    {
+        return m_inputSize;
+    }
+
+    /** The n by n state Jacobian, row-major */
+    const std::vector<double>& getA() const
+    {
+        return m_A;
+    }
+
+    /** The n by m input Jacobian, row-major */
+    const std::vector<double>& getB() const
+    {
+        return m_B;
+    }
+
+    /** The state after a period from the unperturbed state */
+    const tgSimulationState& getNominalNext() const
+    {
+        return m_nominalNext;
+    }
+
+    /** The number of runs in the last linearize() */
+    std::size_t getRunCount() const
+    {
+        return m_runCount;
+    }
+
+private:
+
+    /** Not copyable */
+    tgLinearizer(const tgLinearizer&);
+    tgLinearizer& operator=(const tgLinearizer&);
+
+    /**
+     * Perturb one coordinate of a state: a state coordinate below n, or
+     * the rest length of input index - n.
+     */
+    void perturb(std::vector<double>& data, std::size_t index,
+                 double delta) const;
+
+    /**
+     * The state coordinates of plus relative to minus, divided by
+     * scale, into column index of A or B.
+     */
+    void difference(const tgSimulationState& plus,
+                    const tgSimulationState& minus,
+                    double scale, std::size_t column);
+
+private:
+
+    const Config m_config;
+
+    tgSimulation& m_simulation;
+
+    tgSimulationFork::Factory& m_factory;
+
+    tgSimulationFork* m_pFork;
+
+    std::size_t m_stateSize;
+    std::size_t m_inputSize;
+
+    std::vector<double> m_A;
+    std::vector<double> m_B;
+
+    tgSimulationState m_nominalNext;
+
+    std::size_t m_runCount;
+};
+
+#endif  // TG_LINEARIZER_H
@@ -30,14 +30,20 @@
 // The C++ Standard Library
 #include <stdexcept>
 
-tgModel::tgModel()
+tgModel::tgModel() :
+  m_parent(NULL),
+  m_descendantCount(0),
+  m_stepsChildren(true)
 {
   // Postcondition
   assert(invariant());
 }
 
 tgModel::tgModel(const tgTags& tags) :
-        tgTaggable(tags)
+        tgTaggable(tags),
+        m_parent(NULL),
+        m_descendantCount(0),
+        m_stepsChildren(true)
 {
   assert(invariant());
 }
@@ -73,6 +79,15 @@ void tgModel::teardown()
     delete m_children[i];
   }
   m_children.clear();
+
+  // The children's teardown has already accounted for their own subtrees
+  for (tgModel* p = m_parent; p != NULL; p = p->m_parent)
+  {
+    assert(p->m_descendantCount >= m_descendantCount);
+    p->m_descendantCount -= m_descendantCount;
+  }
+  m_descendantCount = 0;
+
   //Clear the markers
   this->m_markers.clear();
 
@@ -87,7 +102,7 @@ void tgModel::step(double dt)
   {
     throw std::invalid_argument("dt is not positive");
   }
-  else
+  else if (m_stepsChildren)
   {
     // Note: You can adjust whether to step children before notifying 
     // controllers or the other way around in your model
@@ -130,17 +145,35 @@ void tgModel::addChild(tgModel* pChild)
   {
     throw std::invalid_argument("child is this object");
   } 
-  else 
+  else if (pChild->m_parent != NULL)
+  {
+    for (const tgModel* p = pChild->m_parent; p != NULL; p = p->m_parent)
+    {
+      if (p == this)
+      {
+        throw std::invalid_argument("child is already a descendant");
+      }
+    }
+    throw std::invalid_argument("child already belongs to another model");
+  }
+  else
   {
-    const std::vector<tgModel*> descendants = getDescendants();
-    if (std::find(descendants.begin(), descendants.end(), pChild) !=
-    descendants.end())
+    for (const tgModel* p = m_parent; p != NULL; p = p->m_parent)
     {
-      throw std::invalid_argument("child is already a descendant");
+      if (p == pChild)
+      {
+        throw std::invalid_argument("child is an ancestor of this object");
+      }
     }
   }
 
   m_children.push_back(pChild);
+  pChild->m_parent = this;
+  const std::size_t added = pChild->m_descendantCount + 1;
+  for (tgModel* p = this; p != NULL; p = p->m_parent)
+  {
+    p->m_descendantCount += added;
+  }
 
   // Postcondition
   assert(invariant());
@@ -163,26 +196,39 @@ std::string tgModel::toString(std::string prefix) const
   return os.str();
 }
 
-/**
- * @todo Unnecessary copying can be avoided by pasing the result
- * collection in the recursive step.
- */
+namespace
+{
+  /** Appends each model it is called with to a vector. */
+  class DescendantCollector
+  {
+  public:
+    DescendantCollector(std::vector<tgModel*>& result) : m_result(result) { }
+    void operator()(tgModel* pModel) { m_result.push_back(pModel); }
+  private:
+    std::vector<tgModel*>& m_result;
+  };
+}
+
 std::vector<tgModel*> tgModel::getDescendants() const
 {
   std::vector<tgModel*> result;
-  const size_t n = m_children.size();
-  for (std::size_t i = 0; i < n; i++)
-  {
-    tgModel* const pChild = m_children[i];
-    assert(pChild != NULL);
-    result.push_back(pChild);
-    // Recursion
-    const std::vector<tgModel*> cd = pChild->getDescendants();
-    result.insert(result.end(), cd.begin(), cd.end());
-  }
+  result.reserve(m_descendantCount);
+  DescendantCollector collect(result);
+  forEachDescendant(collect);
+  assert(result.size() == m_descendantCount);
   return result;
 }
 
+std::size_t tgModel::getDescendantCount() const
+{
+  return m_descendantCount;
+}
+
+tgModel* tgModel::getParent() const
+{
+  return m_parent;
+}
+
 /**
  * For tgSenseable: just return the results of getDescendants here.
  * This should be OK, since a vector of tgModel* is also a vector of
@@ -200,6 +246,16 @@ std::vector<tgSenseable*> tgModel::getSenseableDescendants() const
   return mySenseableDescendants;
 }
 
+const std::vector<tgModel*>& tgModel::getChildren() const
+{
+  return m_children;
+}
+
+void tgModel::setStepsChildren(bool stepsChildren)
+{
+  m_stepsChildren = stepsChildren;
+}
+
 const std::vector<abstractMarker>& tgModel::getMarkers() const {
     return m_markers;
 }
@@ -212,6 +268,14 @@ bool tgModel::invariant() const
 {
   // No child is NULL
   // No child appears more than once in the tree
+  // Every child's parent is this object
+  for (std::size_t i = 0; i < m_children.size(); i++)
+  {
+    if (m_children[i] == NULL || m_children[i]->m_parent != this)
+    {
+      return false;
+    }
+  }
   return true;
 }
 
@@ -102,10 +102,12 @@ public:
     * Add a sub-model to this model.
     * The model takes ownership of the child sub-model and is responsible for
     * deallocating it.
+    * Duplicate and cycle checks walk the parent links, so this is
+    * O(depth) rather than O(size of the tree).
     * @param[in,out] pChild a pointer to a sub-model
-    * @throw std::invalid_argument is pChild is NULL, this object, or already
-    * a descendant
-    * @todo Make sure that every child appears no more than once in the tree.
+    * @throw std::invalid_argument is pChild is NULL, this object, already
+    * a descendant, already owned by another model, or an ancestor of this
+    * object
     */
     void addChild(tgModel* pChild);
 	
@@ -151,6 +153,44 @@ public:
      */
     std::vector<tgModel*> getDescendants() const;
 
+    /**
+     * Call f(pModel) for every descendant, in the same (pre-)order as
+     * getDescendants(), without allocating.
+     * @param[in,out] f a function or functor taking a tgModel*
+     */
+    template <typename F>
+    void forEachDescendant(F& f) const
+    {
+        for (std::size_t i = 0; i < m_children.size(); i++)
+        {
+            f(m_children[i]);
+            m_children[i]->forEachDescendant(f);
+        }
+    }
+
+    /**
+     * Return the number of descendants. Cached; O(1).
+     */
+    std::size_t getDescendantCount() const;
+
+    /**
+     * Return the model that owns this one, or NULL for a root.
+     */
+    tgModel* getParent() const;
+
+    /**
+     * Return the immediate sub-models, in the order they were added.
+     */
+    const std::vector<tgModel*>& getChildren() const;
+
+    /**
+     * Whether step() recurses into the children. tgSimulation turns this
+     * off for every model in its step plan, since it steps each of them
+     * directly.
+     * @param[in] stepsChildren false if something else steps the children
+     */
+    void setStepsChildren(bool stepsChildren);
+
     const std::vector<abstractMarker>& getMarkers() const;
 
     void addMarker(abstractMarker a);
@@ -177,8 +217,20 @@ private:
      */
     std::vector<tgModel*> m_children;
 
+    /** The model that owns this one, or NULL for a root. */
+    tgModel* m_parent;
+
+    /**
+     * The number of models in the subtree below this one. Kept up to date
+     * by addChild() and teardown() through the parent links.
+     */
+    std::size_t m_descendantCount;
+
     std::vector<abstractMarker> m_markers;
 
+    /** If false, step() leaves the children to the caller. */
+    bool m_stepsChildren;
+
 };
 
 /**
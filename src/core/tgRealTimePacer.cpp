@@ -0,0 +1,298 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgRealTimePacer.cpp
+ * @brief Contains the definitions of members of class tgRealTimePacer
+ * $Id$
+ */
+
+// This module
+#include "tgRealTimePacer.h"
+// The C++ Standard Library
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cmath>
+#include <stdexcept>
+// POSIX
+#include <time.h>
+
+tgRealTimePacer::Config::Config(Policy p,
+                                std::size_t catchUp,
+                                double scale,
+                                int c,
+                                int priority) :
+    policy(p),
+    maxCatchUp(catchUp),
+    timeScale(scale),
+    cpu(c),
+    fifoPriority(priority)
+{
+    if ((policy != eCatchUp) && (policy != eSkip))
+    {
+        throw std::invalid_argument("policy is not a Policy");
+    }
+    else if (maxCatchUp == 0)
+    {
+        throw std::invalid_argument("maxCatchUp is zero");
+    }
+    else if (!(timeScale > 0.0))
+    {
+        throw std::invalid_argument("timeScale is not positive");
+    }
+    else if (cpu < -1)
+    {
+        throw std::invalid_argument("cpu is less than -1");
+    }
+    else if (fifoPriority < 0)
+    {
+        throw std::invalid_argument("fifoPriority is negative");
+    }
+}
+
+tgRealTimePacer::Statistics::Statistics() :
+    steps(0),
+    misses(0),
+    skipped(0),
+    restarts(0),
+    waits(0),
+    jitterSum(0.0),
+    jitterSquaredSum(0.0),
+    maxJitter(0.0),
+    stepTimeSum(0.0),
+    maxStepTime(0.0)
+{
+}
+
+double tgRealTimePacer::Statistics::getMeanJitter() const
+{
+    return (waits == 0) ? 0.0 : jitterSum / waits;
+}
+
+double tgRealTimePacer::Statistics::getRmsJitter() const
+{
+    return (waits == 0) ? 0.0 : std::sqrt(jitterSquaredSum / waits);
+}
+
+double tgRealTimePacer::Statistics::getMeanStepTime() const
+{
+    return (steps == 0) ? 0.0 : stepTimeSum / steps;
+}
+
+tgRealTimePacer::tgRealTimePacer(const Config& config, double period) :
+    m_config(config),
+    m_period(0.0),
+    m_release(0.0),
+    m_current(0.0),
+    m_lateSteps(0),
+    m_firstStep(true),
+    m_threadConfigured(false),
+    m_pinned(false),
+    m_fifo(false),
+    m_thread(),
+    m_savedPolicy(SCHED_OTHER),
+    m_savedParam(),
+    m_lastJitter(0.0),
+    m_lastStepTime(0.0),
+    m_lastMissed(false)
+{
+    setPeriod(period);
+}
+
+tgRealTimePacer::~tgRealTimePacer()
+{
+    restoreThread();
+}
+
+void tgRealTimePacer::setPeriod(double period)
+{
+    if (!(period > 0.0))
+    {
+        throw std::invalid_argument("period is not positive");
+    }
+    m_period = period * m_config.timeScale;
+}
+
+void tgRealTimePacer::start()
+{
+    if (!m_threadConfigured)
+    {
+        configureThread();
+        m_threadConfigured = true;
+    }
+    m_statistics = Statistics();
+    m_lateSteps = 0;
+    m_lastJitter = 0.0;
+    m_lastStepTime = 0.0;
+    m_lastMissed = false;
+    m_firstStep = true;
+    m_release = currentTime();
+    m_current = m_release;
+}
+
+void tgRealTimePacer::beginStep()
+{
+    const double t = currentTime();
+    if (m_firstStep)
+    {
+        // Step 0 was released by start(), so it runs at once
+        m_firstStep = false;
+        m_lastJitter = 0.0;
+        m_lateSteps = 0;
+    }
+    else if (t < m_release)
+    {
+        // On time: sleep until the release and see how late we woke
+        sleepUntil(m_release);
+        recordJitter(std::max(0.0, currentTime() - m_release));
+        m_lateSteps = 0;
+    }
+    else if (m_config.policy == eSkip)
+    {
+        // Drop the releases that have passed and wait for the next one
+        const double behind = std::floor((t - m_release) / m_period) + 1.0;
+        m_statistics.skipped += static_cast<std::size_t>(behind);
+        m_release += behind * m_period;
+        sleepUntil(m_release);
+        recordJitter(std::max(0.0, currentTime() - m_release));
+    }
+    else
+    {
+        // Late: run now to catch up, unless we've been behind too long
+        m_lastJitter = 0.0;
+        m_lateSteps++;
+        if (m_lateSteps > m_config.maxCatchUp)
+        {
+            m_statistics.restarts++;
+            m_lateSteps = 0;
+            m_release = t;
+        }
+    }
+    m_current = m_release;
+    m_release += m_period;
+}
+
+void tgRealTimePacer::endStep()
+{
+    const double t = currentTime();
+    m_lastStepTime = t - m_current;
+    m_lastMissed = (t > m_release);
+    m_statistics.steps++;
+    if (m_lastMissed)
+    {
+        m_statistics.misses++;
+    }
+    m_statistics.stepTimeSum += m_lastStepTime;
+    m_statistics.maxStepTime = std::max(m_statistics.maxStepTime,
+                                        m_lastStepTime);
+}
+
+void tgRealTimePacer::recordJitter(double jitter)
+{
+    m_lastJitter = jitter;
+    m_statistics.waits++;
+    m_statistics.jitterSum += jitter;
+    m_statistics.jitterSquaredSum += jitter * jitter;
+    m_statistics.maxJitter = std::max(m_statistics.maxJitter, jitter);
+}
+
+double tgRealTimePacer::now()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + 1.0e-9 * ts.tv_nsec;
+}
+
+double tgRealTimePacer::currentTime() const
+{
+    return now();
+}
+
+void tgRealTimePacer::sleepUntil(double t)
+{
+#ifdef __linux__
+    timespec ts;
+    ts.tv_sec = static_cast<time_t>(t);
+    ts.tv_nsec = static_cast<long>((t - ts.tv_sec) * 1.0e9);
+    if (ts.tv_nsec >= 1000000000L)
+    {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000L;
+    }
+    // An absolute deadline doesn't drift when a signal interrupts the sleep
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
+    {
+    }
+#else
+    double remaining = t - now();
+    while (remaining > 0.0)
+    {
+        timespec ts;
+        ts.tv_sec = static_cast<time_t>(remaining);
+        ts.tv_nsec = static_cast<long>((remaining - ts.tv_sec) * 1.0e9);
+        nanosleep(&ts, NULL);
+        remaining = t - now();
+    }
+#endif
+}
+
+void tgRealTimePacer::configureThread()
+{
+    m_thread = pthread_self();
+#ifdef __linux__
+    if (m_config.cpu >= 0 && m_config.cpu < CPU_SETSIZE &&
+        pthread_getaffinity_np(m_thread, sizeof(m_savedAffinity),
+                               &m_savedAffinity) == 0)
+    {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(m_config.cpu, &cpus);
+        m_pinned = (pthread_setaffinity_np(m_thread,
+                                           sizeof(cpus), &cpus) == 0);
+    }
+#endif
+    if (m_config.fifoPriority > 0 &&
+        pthread_getschedparam(m_thread, &m_savedPolicy, &m_savedParam) == 0)
+    {
+        sched_param param;
+        param.sched_priority =
+            std::min(m_config.fifoPriority, sched_get_priority_max(SCHED_FIFO));
+        // Fails with EPERM without the privilege; carry on regardless
+        m_fifo = (pthread_setschedparam(m_thread, SCHED_FIFO, &param) == 0);
+    }
+}
+
+void tgRealTimePacer::restoreThread()
+{
+    // Dropping SCHED_FIFO needs no privilege, so this doesn't fail for
+    // want of one
+    if (m_fifo)
+    {
+        pthread_setschedparam(m_thread, m_savedPolicy, &m_savedParam);
+        m_fifo = false;
+    }
+#ifdef __linux__
+    if (m_pinned)
+    {
+        pthread_setaffinity_np(m_thread, sizeof(m_savedAffinity),
+                               &m_savedAffinity);
+        m_pinned = false;
+    }
+#endif
+}
@@ -0,0 +1,271 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_REAL_TIME_PACER_H
+#define TG_REAL_TIME_PACER_H
+
+/**
+ * @file tgRealTimePacer.h
+ * @brief Contains the definition of class tgRealTimePacer
+ * $Id$
+ */
+
+// The C++ Standard Library
+#include <cstddef>
+// POSIX
+#include <pthread.h>
+#include <sched.h>
+
+/**
+ * Paces a loop of fixed steps to a monotonic wall clock, for software
+ * in the loop runs that must keep time with a physical robot. Step k is
+ * released at start + k * period; the step should end by the release of
+ * the next one, and a step that doesn't is a deadline miss.
+ *
+ * When steps fall behind, the policy decides what happens:
+ * - eCatchUp runs the late steps back to back, so simulated time catches
+ *   up with wall time; after maxCatchUp late steps in a row it gives up
+ *   and restarts the schedule from now.
+ * - eSkip drops the release times that have passed and waits for the
+ *   next one, so the cadence holds but simulated time falls behind.
+ *
+ * The pacing thread can be pinned to a CPU and given SCHED_FIFO priority
+ * (Linux; SCHED_FIFO needs CAP_SYS_NICE or an rtprio limit). Without
+ * permission the pacer carries on with normal scheduling, which
+ * isRealTimeScheduled() reports. The thread's original affinity and
+ * scheduling are put back when the pacer is destroyed.
+ *
+ * Subclasses may override currentTime() and sleepUntil() to run the
+ * schedule on another clock, as the tests do.
+ */
+class tgRealTimePacer
+{
+public:
+
+    enum Policy
+    {
+        eCatchUp,
+        eSkip
+    };
+
+    /**
+     * The pacing options. This is Plain Old Data.
+     */
+    struct Config
+    {
+        /**
+         * @param[in] policy what to do when steps fall behind
+         * @param[in] maxCatchUp the most late steps eCatchUp runs in a
+         * row before restarting the schedule; must be positive
+         * @param[in] timeScale wall seconds per simulated second; 1 for
+         * real time, 2 for half speed. Must be positive.
+         * @param[in] cpu the CPU to pin the pacing thread to, or -1
+         * @param[in] fifoPriority the SCHED_FIFO priority to ask for, or
+         * 0 for normal scheduling
+         * @throw std::invalid_argument if any parameter is out of range
+         */
+        Config(Policy policy = eCatchUp,
+               std::size_t maxCatchUp = 10,
+               double timeScale = 1.0,
+               int cpu = -1,
+               int fifoPriority = 0);
+
+        Policy policy;
+        std::size_t maxCatchUp;
+        double timeScale;
+        int cpu;
+        int fifoPriority;
+    };
+
+    /** The timing of the steps since start() */
+    struct Statistics
+    {
+        Statistics();
+
+        /** The mean wake-up lateness of steps that waited, in seconds */
+        double getMeanJitter() const;
+
+        /** The root mean square wake-up lateness, in seconds */
+        double getRmsJitter() const;
+
+        /** The mean time from release to the end of a step, in seconds */
+        double getMeanStepTime() const;
+
+        std::size_t steps;
+
+        /** Steps that ended after the release of the next step */
+        std::size_t misses;
+
+        /** Release times dropped by eSkip */
+        std::size_t skipped;
+
+        /** Times eCatchUp gave up and restarted the schedule */
+        std::size_t restarts;
+
+        /** The number of steps that waited for their release */
+        std::size_t waits;
+        double jitterSum;
+        double jitterSquaredSum;
+        double maxJitter;
+
+        double stepTimeSum;
+        double maxStepTime;
+    };
+
+    /**
+     * @param[in] period the simulated time per step, in seconds; must be
+     * positive
+     * @throw std::invalid_argument if period is not positive
+     */
+    tgRealTimePacer(const Config& config, double period);
+
+    /** Restores the affinity and scheduling of the thread start() configured. */
+    virtual ~tgRealTimePacer();
+
+    /**
+     * Start the schedule from now and clear the statistics. Step 0 is
+     * released now, so it is on time. The first call also pins and
+     * prioritizes the calling thread, as configured.
+     */
+    void start();
+
+    /** Wait for the release of the next step. */
+    void beginStep();
+
+    /** Note the end of the step, checking its deadline. */
+    void endStep();
+
+    /**
+     * Change the simulated time per step, e.g. if the view's step size
+     * changed. The schedule continues from the next step.
+     * @throw std::invalid_argument if period is not positive
+     */
+    void setPeriod(double period);
+
+    double getPeriod() const
+    {
+        return m_period;
+    }
+
+    const Statistics& getStatistics() const
+    {
+        return m_statistics;
+    }
+
+    /** The release time of the step in progress, or of the last step */
+    double getReleaseTime() const
+    {
+        return m_current;
+    }
+
+    /** The wake-up lateness of the last step, in seconds; 0 if it didn't wait */
+    double getLastJitter() const
+    {
+        return m_lastJitter;
+    }
+
+    /** The time from release to the end of the last step, in seconds */
+    double getLastStepTime() const
+    {
+        return m_lastStepTime;
+    }
+
+    /** True if the last step ended after its deadline */
+    bool getLastMissed() const
+    {
+        return m_lastMissed;
+    }
+
+    /** True if the thread was pinned to Config::cpu */
+    bool isPinned() const
+    {
+        return m_pinned;
+    }
+
+    /** True if the thread got SCHED_FIFO */
+    bool isRealTimeScheduled() const
+    {
+        return m_fifo;
+    }
+
+    const Config& getConfig() const
+    {
+        return m_config;
+    }
+
+    /** Seconds on the monotonic clock */
+    static double now();
+
+protected:
+
+    /** The time the schedule runs on, in seconds; now() by default */
+    virtual double currentTime() const;
+
+    /** Sleep until a time from currentTime(). */
+    virtual void sleepUntil(double t);
+
+private:
+
+    /** Pin and prioritize the calling thread, saving how it was. */
+    void configureThread();
+
+    /** Put back the affinity and scheduling configureThread() changed. */
+    void restoreThread();
+
+    /** Record the wake-up lateness of a step that waited. */
+    void recordJitter(double jitter);
+
+private:
+
+    const Config m_config;
+
+    /** Wall seconds per step */
+    double m_period;
+
+    /** The release time of the next step */
+    double m_release;
+
+    /** The release time of the step in progress */
+    double m_current;
+
+    /** Late steps in a row */
+    std::size_t m_lateSteps;
+
+    /** True until the first beginStep() after start() */
+    bool m_firstStep;
+
+    bool m_threadConfigured;
+    bool m_pinned;
+    bool m_fifo;
+
+    /** The thread configureThread() changed, and how it was before */
+    pthread_t m_thread;
+#ifdef __linux__
+    cpu_set_t m_savedAffinity;
+#endif
+    int m_savedPolicy;
+    sched_param m_savedParam;
+
+    double m_lastJitter;
+    double m_lastStepTime;
+    bool m_lastMissed;
+
+    Statistics m_statistics;
+};
+
+#endif  // TG_REAL_TIME_PACER_H
@@ -0,0 +1,164 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgSettleCache.cpp
+ * @brief Contains the definitions of members of class tgSettleCache
+ * $Id$
+ */
+
+// This module
+#include "tgSettleCache.h"
+// This application
+#include "tgBulletContactSpringCable.h"
+#include "tgHash.h"
+#include "tgSimulationState.h"
+#include "tgSpringCableActuator.h"
+#include "tgWorld.h"
+// The C++ Standard Library
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace
+{
+    /** Identifies a settle cache file, and its format version */
+    const char magic[8] = { 'N', 'T', 'R', 'T', 'S', 'E', 'T', '2' };
+}
+
+tgSettleCache::tgSettleCache(const std::string& filename, std::size_t key) :
+    m_filename(filename),
+    m_key(key)
+{
+    if (filename.empty())
+    {
+        throw std::invalid_argument("Settle cache filename is empty");
+    }
+}
+
+std::size_t tgSettleCache::fullKey(const tgWorld& world, double dt,
+                                   int steps) const
+{
+    const tgWorld::Config& config = world.getConfig();
+    std::size_t key = m_key;
+    tgHash::combine(key, tgHash::ofDouble(dt));
+    tgHash::combine(key, static_cast<std::size_t>(steps));
+    tgHash::combine(key, tgHash::ofDouble(config.gravity));
+    tgHash::combine(key, tgHash::ofDouble(config.worldSize));
+    tgHash::combine(key, static_cast<std::size_t>(config.solverThreads));
+    return key;
+}
+
+void tgSettleCache::checkCacheable(const std::vector<tgModel*>& models)
+{
+    const std::vector<tgSpringCableActuator*> cables =
+        tgSimulationState::springCables(models);
+    for (std::size_t i = 0; i < cables.size(); i++)
+    {
+        if (dynamic_cast<const tgBulletContactSpringCable*>
+            (cables[i]->getSpringCable()) != NULL)
+        {
+            throw std::invalid_argument("Settle cache can't save the "
+                                        "anchors of contact cables");
+        }
+    }
+}
+
+bool tgSettleCache::restore(tgWorld& world,
+                            const std::vector<tgModel*>& models,
+                            double dt, int steps) const
+{
+    checkCacheable(models);
+
+    std::ifstream in(m_filename.c_str(), std::ios::in | std::ios::binary);
+    if (!in)
+    {
+        return false;
+    }
+
+    const std::size_t bodySize = tgSimulationState::bodySize;
+    const std::size_t cableSize = tgSimulationState::cableSize;
+    const std::size_t bodyCount =
+        tgSimulationState::dynamicBodies(world).size();
+    const std::size_t cableCount =
+        tgSimulationState::springCables(models).size();
+
+    char fileMagic[sizeof(magic)];
+    unsigned long long key = 0;
+    unsigned int nBodies = 0;
+    unsigned int nCables = 0;
+    in.read(fileMagic, sizeof(fileMagic));
+    in.read(reinterpret_cast<char*>(&key), sizeof(key));
+    in.read(reinterpret_cast<char*>(&nBodies), sizeof(nBodies));
+    in.read(reinterpret_cast<char*>(&nCables), sizeof(nCables));
+    if (!in ||
+        std::memcmp(fileMagic, magic, sizeof(magic)) != 0 ||
+        key != fullKey(world, dt, steps) ||
+        nBodies != bodyCount ||
+        nCables != cableCount)
+    {
+        return false;
+    }
+
+    // Read everything before changing anything, so a truncated file
+    // leaves the world as it was
+    std::vector<double> data(nBodies * bodySize + nCables * cableSize);
+    if (!data.empty())
+    {
+        in.read(reinterpret_cast<char*>(&data[0]),
+                data.size() * sizeof(double));
+    }
+    if (!in)
+    {
+        return false;
+    }
+
+    tgSimulationState(nBodies, nCables, data).apply(world, models);
+    return true;
+}
+
+void tgSettleCache::save(const tgWorld& world,
+                         const std::vector<tgModel*>& models,
+                         double dt, int steps) const
+{
+    checkCacheable(models);
+
+    tgSimulationState state;
+    state.capture(world, models);
+    const std::vector<double>& data = state.getData();
+
+    std::ofstream out(m_filename.c_str(),
+                      std::ios::out | std::ios::binary | std::ios::trunc);
+    const unsigned long long key = fullKey(world, dt, steps);
+    const unsigned int nBodies = state.getBodyCount();
+    const unsigned int nCables = state.getCableCount();
+    out.write(magic, sizeof(magic));
+    out.write(reinterpret_cast<const char*>(&key), sizeof(key));
+    out.write(reinterpret_cast<const char*>(&nBodies), sizeof(nBodies));
+    out.write(reinterpret_cast<const char*>(&nCables), sizeof(nCables));
+    if (!data.empty())
+    {
+        out.write(reinterpret_cast<const char*>(&data[0]),
+                  data.size() * sizeof(double));
+    }
+    if (!out)
+    {
+        throw std::runtime_error("Could not write settle cache " +
+                                 m_filename);
+    }
+}
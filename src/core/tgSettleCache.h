@@ -0,0 +1,112 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_SETTLE_CACHE_H
+#define TG_SETTLE_CACHE_H
+
+/**
+ * @file tgSettleCache.h
+ * @brief Contains the definition of class tgSettleCache
+ * $Id$
+ */
+
+// The C++ Standard Library
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Forward declarations
+class tgModel;
+class tgWorld;
+
+/**
+ * Saves the state of a world after its settle phase to a file, and
+ * restores it in later runs that would settle the same way.
+ *
+ * The saved state is a tgSimulationState: the transform and velocity of
+ * every dynamic rigid body in the world, and the tgSpringCable::State
+ * and motor velocity of every spring cable actuator in the models.
+ *
+ * Contact cables gain and lose anchors as they touch the bodies, which
+ * that state can't hold, so models with them are refused. Controllers
+ * are invisible to the cache: one that keeps state from the settle
+ * phase (timers, targets, learned parameters) would see a restored
+ * run as though the phase had taken no time, so attach controllers
+ * after settling.
+ */
+class tgSettleCache
+{
+public:
+
+    /**
+     * @param[in] filename the cache file; it need not exist yet
+     * @param[in] key a hash of everything that determines the settled
+     * state that the simulation can't see: the structure, the build
+     * spec configs, the ground and so on.
+     */
+    tgSettleCache(const std::string& filename, std::size_t key);
+
+    /**
+     * Restore a saved state into the world and models.
+     * @param[in,out] world the world, with the models already set up
+     * @param[in,out] models the models in the world
+     * @param[in] dt the timestep of the settle phase
+     * @param[in] steps the length of the settle phase
+     * @return false, changing nothing, if the file doesn't exist or was
+     * saved under another key, timestep or world config, or for other
+     * bodies and cables
+     * @throw std::invalid_argument if a model has contact cables
+     */
+    bool restore(tgWorld& world, const std::vector<tgModel*>& models,
+                 double dt, int steps) const;
+
+    /**
+     * Save the current state of the world and models, replacing the file.
+     * @param[in] world the world, after the settle phase
+     * @param[in] models the models in the world
+     * @param[in] dt the timestep of the settle phase
+     * @param[in] steps the length of the settle phase
+     * @throw std::invalid_argument if a model has contact cables
+     * @throw std::runtime_error if the file can't be written
+     */
+    void save(const tgWorld& world, const std::vector<tgModel*>& models,
+              double dt, int steps) const;
+
+private:
+
+    /**
+     * Combine the user's key with the parameters that the simulation
+     * knows about: the timestep, the length of the settle phase and the
+     * whole tgWorld::Config.
+     */
+    std::size_t fullKey(const tgWorld& world, double dt, int steps) const;
+
+    /**
+     * Check that the state of the models can be saved.
+     * @throw std::invalid_argument if a model has contact cables
+     */
+    static void checkCacheable(const std::vector<tgModel*>& models);
+
+private:
+
+    const std::string m_filename;
+
+    const std::size_t m_key;
+};
+
+#endif  // TG_SETTLE_CACHE_H
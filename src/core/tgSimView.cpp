@@ -42,7 +42,8 @@ tgSimView::tgSimView(tgWorld& world,
   m_stepSize(stepSize),
   m_renderRate(renderRate),         
   m_renderTime(0.0),
-  m_initialized(false)
+  m_initialized(false),
+  m_pPacer(NULL)
 {
   if (m_stepSize < 0.0)
   {
@@ -71,6 +72,7 @@ tgSimView::~tgSimView()
             teardown();
     }
     delete m_pModelVisitor;
+    delete m_pPacer;
 }
 
 
@@ -144,8 +146,21 @@ void tgSimView::run(int steps)
         // This would normally run forever, but this is just for testing
         m_renderTime = 0;
         double totalTime = 0.0;
+        if (m_pPacer != NULL)
+        {
+            m_pPacer->start();
+        }
         for (int i = 0; i < steps; i++) {
-            m_pSimulation->step(m_stepSize);    
+            if (m_pPacer != NULL)
+            {
+                m_pPacer->beginStep();
+                m_pSimulation->step(m_stepSize);
+                m_pPacer->endStep();
+            }
+            else
+            {
+                m_pSimulation->step(m_stepSize);
+            }
             m_renderTime += m_stepSize;
             totalTime += m_stepSize;
             
@@ -202,6 +217,10 @@ void tgSimView::setStepSize(double stepSize)
   else
   {
       m_stepSize = stepSize;
+      if (m_pPacer != NULL)
+      {
+          m_pPacer->setPeriod(m_stepSize);
+      }
       // Assure that the render rate is no less than the new step size
       setRenderRate(m_renderRate);
   }
@@ -211,6 +230,22 @@ void tgSimView::setStepSize(double stepSize)
   assert((stepSize <= 0.0) || (m_stepSize == stepSize));
 }
 
+void tgSimView::setRealTime(const tgRealTimePacer::Config& config)
+{
+  tgRealTimePacer* const pPacer = new tgRealTimePacer(config, m_stepSize);
+  delete m_pPacer;
+  m_pPacer = pPacer;
+
+  // Postcondition
+  assert(m_pPacer != NULL);
+}
+
+void tgSimView::disableRealTime()
+{
+  delete m_pPacer;
+  m_pPacer = NULL;
+}
+
 bool tgSimView::invariant() const
 {
   return
@@ -26,6 +26,9 @@
  * $Id$
  */
 
+// This application
+#include "tgRealTimePacer.h"
+
 // Forward declarations
 class tgModelVisitor;
 class tgSimulation;
@@ -131,6 +134,27 @@ public:
      * @return the interval in seconds at which the graphics are rendered
      */
     double getStepSize() const { return m_stepSize; }
+
+    /**
+     * Pace run(int steps) to the wall clock, one step per m_stepSize
+     * seconds (scaled by config.timeScale), for running against hardware.
+     * Replaces any earlier pacing. Only this headless view is paced;
+     * tgSimViewGraphics runs at the speed of the display loop.
+     * @param[in] config how to pace, and how to schedule the thread
+     */
+    void setRealTime(const tgRealTimePacer::Config& config);
+
+    /**
+     * Run as fast as possible again. This is the default. The thread's
+     * affinity and scheduling are put back as they were before pacing.
+     */
+    void disableRealTime();
+
+    /**
+     * Return the pacer, for its jitter and deadline statistics.
+     * @return the pacer, or NULL if not running in real time
+     */
+    const tgRealTimePacer* getRealTimePacer() const { return m_pPacer; }
     
 protected:
 
@@ -216,6 +240,9 @@ private:
 
     /** Ensures the world has been initialized before running */
     bool m_initialized;
+
+    /** Paces run(int steps) if not NULL; owned */
+    tgRealTimePacer* m_pPacer;
 };
 
 #endif  // TG_SIM_VIEW_H
@@ -26,10 +26,15 @@
 // This module
 #include "tgSimulation.h"
 // This application
+#include "tgCompressionSpringActuator.h"
 #include "tgModel.h"
+#include "tgSettleCache.h"
 #include "tgSimView.h"
 #include "tgSimViewGraphics.h"
+#include "tgSimulationState.h"
+#include "tgSpringCableActuator.h"
 #include "tgWorld.h"
+#include "tgWorldArena.h"
 #include "sensors/tgDataManager.h" //for loggers etc.
 // The Bullet Physics Library
 #include "LinearMath/btQuickprof.h"
@@ -38,7 +43,11 @@
 #include <stdexcept>
 
 tgSimulation::tgSimulation(tgSimView& view) :
-  m_view(view)
+  m_view(view),
+  m_useStepPlan(false),
+  m_pSettleCache(NULL),
+  m_pAdaptiveTimestep(NULL),
+  m_pCableProximity(NULL)
 {
         m_view.bindToSimulation(*this);
 
@@ -60,6 +69,9 @@ tgSimulation::~tgSimulation()
     for (std::size_t i=0; i < m_dataManagers.size(); i++) {
       delete m_dataManagers[i];
     }
+    delete m_pSettleCache;
+    delete m_pAdaptiveTimestep;
+    delete m_pCableProximity;
 }
 
 void tgSimulation::addModel(tgModel* pModel)
@@ -71,8 +83,15 @@ void tgSimulation::addModel(tgModel* pModel)
     }
     else
     {
-
-        pModel->setup(m_view.world());
+        // Nothing after setup() throws, so the model is only owned if
+        // this returns
+        m_models.reserve(m_models.size() + 1);
+        {
+            // Bodies, shapes and motion states come from the world's arena
+            tgWorldArena::Scope scope(m_view.world().arena());
+            pModel->setup(m_view.world());
+        }
+        appendToStepPlan(pModel);
         m_models.push_back(pModel);
     }
 
@@ -90,9 +109,12 @@ void tgSimulation::addObstacle(tgModel* pObstacle)
     }
     else
     {
-
-        pObstacle->setup(m_view.world());
+        {
+            tgWorldArena::Scope scope(m_view.world().arena());
+            pObstacle->setup(m_view.world());
+        }
         m_obstacles.push_back(pObstacle);
+        appendToStepPlan(pObstacle);
     }
 
     // Postcondition
@@ -139,10 +161,12 @@ void tgSimulation::reset()
     teardown();
 
     m_view.setup();
-    for (std::size_t i = 0; i != m_models.size(); i++)
     {
-        
-        m_models[i]->setup(m_view.world());
+        tgWorldArena::Scope scope(m_view.world().arena());
+        for (std::size_t i = 0; i != m_models.size(); i++)
+        {
+            m_models[i]->setup(m_view.world());
+        }
     }
     // Also, need to set up the data managers again.
     // Note that this MUST occur after calling setup on the models,
@@ -153,6 +177,8 @@ void tgSimulation::reset()
       m_dataManagers[i]->setup();
     }
     
+    compileStepPlan();
+    
     // Don't need to set up obstacles since they will be added after this
 }
 
@@ -165,10 +191,12 @@ void tgSimulation::reset(tgGround* newGround)
     m_view.world().reset(newGround);
     
     m_view.setup();
-    for (std::size_t i = 0; i != m_models.size(); i++)
     {
-        
-        m_models[i]->setup(m_view.world());
+        tgWorldArena::Scope scope(m_view.world().arena());
+        for (std::size_t i = 0; i != m_models.size(); i++)
+        {
+            m_models[i]->setup(m_view.world());
+        }
     }
     // Also, need to set up the data managers again.
     // Note that this MUST occur after calling setup on the models,
@@ -179,6 +207,8 @@ void tgSimulation::reset(tgGround* newGround)
       m_dataManagers[i]->setup();
     }
     
+    compileStepPlan();
+    
     // Don't need to set up obstacles since they were just added
 }
 
@@ -190,6 +220,190 @@ tgWorld& tgSimulation::getWorld() const
     return m_view.world();
 }
 
+void tgSimulation::setStepPlanEnabled(bool enabled)
+{
+    if (!enabled &&
+        ((m_pAdaptiveTimestep != NULL) || (m_pCableProximity != NULL)))
+    {
+        throw std::logic_error("Adaptive timestep and cable proximity "
+                               "need the step plan");
+    }
+    else if (enabled != m_useStepPlan)
+    {
+        m_useStepPlan = enabled;
+        compileStepPlan();
+    }
+}
+
+void tgSimulation::setSettleCache(const std::string& filename,
+                                  std::size_t key)
+{
+    tgSettleCache* const pCache = new tgSettleCache(filename, key);
+    delete m_pSettleCache;
+    m_pSettleCache = pCache;
+}
+
+bool tgSimulation::settle(double dt, int steps)
+{
+    if (dt <= 0)
+    {
+        throw std::invalid_argument("dt for settle is not positive");
+    }
+    else if (steps < 0)
+    {
+        throw std::invalid_argument("steps for settle is negative");
+    }
+
+    if (m_pSettleCache != NULL &&
+        m_pSettleCache->restore(getWorld(), m_models, dt, steps))
+    {
+        return true;
+    }
+
+    for (int i = 0; i < steps; i++)
+    {
+        step(dt);
+    }
+
+    if (m_pSettleCache != NULL)
+    {
+        m_pSettleCache->save(getWorld(), m_models, dt, steps);
+    }
+    return false;
+}
+
+void tgSimulation::captureState(tgSimulationState& state) const
+{
+    state.capture(getWorld(), m_models);
+}
+
+tgSimulationFork* tgSimulation::fork(std::size_t k,
+                                     tgSimulationFork::Factory& factory,
+                                     std::size_t threads) const
+{
+    tgSimulationState state;
+    captureState(state);
+
+    tgSimulationFork* const pFork =
+        new tgSimulationFork(k, factory, getWorld().getConfig(), threads);
+    try
+    {
+        pFork->sync(state);
+    }
+    catch (...)
+    {
+        delete pFork;
+        throw;
+    }
+    return pFork;
+}
+
+void tgSimulation::setAdaptiveTimestep(const tgAdaptiveTimestep::Config& config)
+{
+    if (!m_useStepPlan)
+    {
+        throw std::logic_error("Adaptive timestep needs the step plan");
+    }
+    tgAdaptiveTimestep* const pAdaptive = new tgAdaptiveTimestep(config);
+    delete m_pAdaptiveTimestep;
+    m_pAdaptiveTimestep = pAdaptive;
+}
+
+void tgSimulation::disableAdaptiveTimestep()
+{
+    delete m_pAdaptiveTimestep;
+    m_pAdaptiveTimestep = NULL;
+}
+
+void tgSimulation::setCableProximity(const tgCableProximity::Config& config)
+{
+    if (!m_useStepPlan)
+    {
+        throw std::logic_error("Cable proximity needs the step plan");
+    }
+    tgCableProximity* const pProximity = new tgCableProximity(config);
+    delete m_pCableProximity;
+    m_pCableProximity = pProximity;
+}
+
+void tgSimulation::disableCableProximity()
+{
+    delete m_pCableProximity;
+    m_pCableProximity = NULL;
+}
+
+void tgSimulation::compileStepPlan()
+{
+    clearStepPlan();
+    for (std::size_t i = 0; i < m_models.size(); i++)
+    {
+        appendToStepPlan(m_models[i]);
+    }
+    for (std::size_t i = 0; i < m_obstacles.size(); i++)
+    {
+        appendToStepPlan(m_obstacles[i]);
+    }
+    if (m_pAdaptiveTimestep != NULL)
+    {
+        // The world was rebuilt
+        m_pAdaptiveTimestep->reset();
+    }
+    if (m_pCableProximity != NULL)
+    {
+        m_pCableProximity->reset();
+    }
+}
+
+void tgSimulation::appendToStepPlan(tgModel* pModel)
+{
+    assert(pModel != NULL);
+    if (!m_useStepPlan)
+    {
+        return;
+    }
+    
+    // Pre-order, so parents are notified before their children
+    std::vector<tgModel*> tree = pModel->getDescendants();
+    tree.insert(tree.begin(), pModel);
+    // Allocate up front, so a failure leaves the plan as it was
+    m_plan.reserve(m_plan.size() + tree.size());
+    m_planPerPeriod.reserve(m_planPerPeriod.size() + tree.size());
+    m_planSubstepped.reserve(m_planSubstepped.size() + tree.size());
+    m_planCables.reserve(m_planCables.size() + tree.size());
+    for (std::size_t i = 0; i < tree.size(); i++)
+    {
+        tgModel* const pNode = tree[i];
+        pNode->setStepsChildren(false);
+        tgSpringCableActuator* const pCable =
+            dynamic_cast<tgSpringCableActuator*>(pNode);
+        const bool perPeriod = (pCable == NULL) &&
+            !dynamic_cast<tgCompressionSpringActuator*>(pNode) &&
+            !pNode->getChildren().empty();
+        m_plan.push_back(pNode);
+        m_planPerPeriod.push_back(perPeriod);
+        if (!perPeriod)
+        {
+            m_planSubstepped.push_back(pNode);
+        }
+        if (pCable != NULL)
+        {
+            m_planCables.push_back(pCable);
+        }
+    }
+}
+
+void tgSimulation::clearStepPlan()
+{
+    for (std::size_t i = 0; i < m_plan.size(); i++)
+    {
+        m_plan[i]->setStepsChildren(true);
+    }
+    m_plan.clear();
+    m_planPerPeriod.clear();
+    m_planSubstepped.clear();
+    m_planCables.clear();
+}
+
 void tgSimulation::step(double dt) const
 {
 // Trying to profile here creates trouble for tgLinearString -  this is outside of the profile loop	
@@ -198,23 +412,46 @@ void tgSimulation::step(double dt) const
     {
         throw std::invalid_argument("dt for step is not positive");
     }
+    else if (m_useStepPlan && (m_pAdaptiveTimestep != NULL))
+    {
+        stepAdaptive(dt);
+
+        for (std::size_t i = 0; i < m_dataManagers.size(); i++) {
+          m_dataManagers[i]->step(dt);
+        }
+    }
     else
     {
         // Step the world.
         // This can be done before or after stepping the models.
         m_view.world().step(dt);
 
-        // Step the models
-        for (std::size_t i = 0; i < m_models.size(); i++)
+        if (m_useStepPlan)
         {
-            m_models[i]->step(dt);
+            // Step every model in the plan; none of them recurse
+            for (std::size_t i = 0; i < m_plan.size(); i++)
+            {
+                m_plan[i]->step(dt);
+            }
+            if (m_pCableProximity != NULL)
+            {
+                m_pCableProximity->update(m_planCables, dt);
+            }
         }
-        
-        // Step the obstacles
-        /// @todo determine if this is necessary
-        for (std::size_t i = 0; i < m_obstacles.size(); i++)
+        else
         {
-            m_obstacles[i]->step(dt);
+            // Step the models
+            for (std::size_t i = 0; i < m_models.size(); i++)
+            {
+                m_models[i]->step(dt);
+            }
+            
+            // Step the obstacles
+            /// @todo determine if this is necessary
+            for (std::size_t i = 0; i < m_obstacles.size(); i++)
+            {
+                m_obstacles[i]->step(dt);
+            }
         }
 
 	// Step the data managers
@@ -224,8 +461,50 @@ void tgSimulation::step(double dt) const
     }
 }
   
+void tgSimulation::stepAdaptive(double dt) const
+{
+    assert(m_pAdaptiveTimestep != NULL);
+    
+    // With a single substep this is exactly the fixed step above
+    double remaining = dt;
+    bool first = true;
+    while (remaining > 0.0)
+    {
+        const double h = m_pAdaptiveTimestep->nextStep(remaining);
+        remaining = (h < remaining) ? remaining - h : 0.0;
+        
+        m_view.world().step(h);
+        
+        // Controllers see one consistent control period
+        if (first)
+        {
+            for (std::size_t i = 0; i < m_plan.size(); i++)
+            {
+                m_plan[i]->step(m_planPerPeriod[i] ? dt : h);
+            }
+            first = false;
+        }
+        else
+        {
+            for (std::size_t i = 0; i < m_planSubstepped.size(); i++)
+            {
+                m_planSubstepped[i]->step(h);
+            }
+        }
+        if (m_pCableProximity != NULL)
+        {
+            m_pCableProximity->update(m_planCables, h);
+        }
+        
+        m_pAdaptiveTimestep->update(m_view.world(), m_planCables, h);
+    }
+}
+  
 void tgSimulation::teardown()
 {
+    // The plan points into the trees that are about to be deleted
+    clearStepPlan();
+    
     const size_t n = m_models.size();
     for (std::size_t i = 0; i < n; i++)
     {
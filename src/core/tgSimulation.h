@@ -26,8 +26,14 @@
  * $Id$
  */
 
+// This application
+#include "tgAdaptiveTimestep.h"
+#include "tgCableProximity.h"
+#include "tgSimulationFork.h"
 // The C++ Standard Library
+#include <cstddef>
 #include <iostream>
+#include <string>
 #include <vector>
 
 // Forward declarations
@@ -37,6 +43,9 @@ class tgSimView;
 class tgWorld;
 class tgGround;
 class tgDataManager;
+class tgSettleCache;
+class tgSimulationState;
+class tgSpringCableActuator;
 
 /**
  * Holds objects necessary for simulation, a world, a view
@@ -56,6 +65,9 @@ public:
 
     /**
      * Advance the simulation.
+     * In adaptive mode dt is the control period: controllers and data
+     * managers step once with dt, while the world and actuators take as
+     * many substeps as tgAdaptiveTimestep asks for.
      * @param[in] dt the number of seconds since the previous call;
      * throw an exception if not positive
      * @throw std::invalid_argument if dt is not positive
@@ -77,7 +89,9 @@ public:
     /**
      * Add a Tensegrity to the simulation.
      * @param[in] pModel a pointer to a tgModel representing a Tensegrity;
-     * an exception is thrown if it is NULL
+     * an exception is thrown if it is NULL. The simulation takes
+     * ownership only if this returns; if it throws, the caller still
+     * owns pModel
      * @throw std::invalid_argument if pModel is NULL
      */
     void addModel(tgModel* pModel);
@@ -126,6 +140,119 @@ public:
      */
     tgWorld& getWorld() const;
 
+    /**
+     * Choose whether step() runs the flat step plan or recurses through
+     * each model tree as tgModel::step() does (the default). The plan
+     * steps the same models in the same order without recursing; it
+     * changes the traversal, not the work, as each model still steps
+     * through its virtual step(). It is only for models that step their
+     * children through tgModel::step(), after notifying their
+     * controllers. A model that calls step() on its children itself
+     * would step them twice.
+     * @param[in] enabled true to use the step plan
+     * @throw std::logic_error if disabling it while an adaptive timestep
+     * or cable proximity, which need it, is set
+     */
+    void setStepPlanEnabled(bool enabled);
+
+    /**
+     * Cache the result of settle() in a file. Later runs with the same
+     * key restore it instead of simulating the settle phase again.
+     * @param[in] filename the cache file; it need not exist yet
+     * @param[in] key a hash of everything that determines the settled
+     * state other than the settle parameters and gravity, e.g. the
+     * structure and build spec (see tgStructure::getHash() and
+     * tgBuildSpec::getHash()) and the ground
+     * @note Controller state isn't saved, so attach controllers after
+     * settle().
+     */
+    void setSettleCache(const std::string& filename, std::size_t key);
+
+    /**
+     * Run the settle phase: step the models, without rendering, until the
+     * structure comes to rest. If a settle cache is set and holds a state
+     * for the same parameters, restore that instead.
+     * Call after the models are added or reset, before run().
+     * @param[in] dt the timestep; must be positive
+     * @param[in] steps the number of steps to settle for
+     * @return true if the settled state was restored from the cache
+     * @throw std::invalid_argument if dt is not positive or steps is
+     * negative, or if a settle cache is set and a model has contact
+     * cables; see tgSettleCache
+     */
+    bool settle(double dt, int steps);
+
+    /**
+     * Switch to adaptive mode: step() splits each control period into
+     * substeps chosen from cable strain rates, contact events and energy
+     * drift.
+     * @param[in] config the bounds and tolerances of the substeps
+     * @throw std::logic_error if the step plan isn't enabled; see
+     * setStepPlanEnabled()
+     */
+    void setAdaptiveTimestep(const tgAdaptiveTimestep::Config& config);
+
+    /** Go back to one world step per call to step(). */
+    void disableAdaptiveTimestep();
+
+    /**
+     * Check the spring cables for segments that come close or cross,
+     * after the actuators step and before the next world step, pushing
+     * them apart if the config has a stiffness.
+     * @param[in] config the margin, repulsion and threads
+     * @throw std::logic_error if the step plan isn't enabled; see
+     * setStepPlanEnabled()
+     */
+    void setCableProximity(const tgCableProximity::Config& config);
+
+    /** Stop checking the cables for proximity. */
+    void disableCableProximity();
+
+    /**
+     * Save the state of the world and the models, e.g. to sync a fork.
+     * @param[out] state the transforms and velocities of the bodies and
+     * the states of the spring cables; see tgSimulationState
+     */
+    void captureState(tgSimulationState& state) const;
+
+    /**
+     * Make k independent copies of this simulation at its current state,
+     * to be stepped in parallel. Each branch's model is built by the
+     * factory and moved to this simulation's state; controllers and
+     * anything else outside tgSimulationState start fresh.
+     * The world config is copied; the ground comes from the factory.
+     * @param[in] k the number of branches; must be positive
+     * @param[in,out] factory builds each branch's model the way this
+     * simulation's was built
+     * @param[in] threads the number of threads that step the branches;
+     * 0 for one per processor
+     * @return the branches; the caller takes ownership
+     * @throw std::invalid_argument if k is 0, or if this simulation has
+     * obstacles or more than one model, so that the branches' bodies
+     * and cables don't match
+     */
+    tgSimulationFork* fork(std::size_t k,
+                           tgSimulationFork::Factory& factory,
+                           std::size_t threads = 0) const;
+
+    /**
+     * Return the adaptive timestep controller, e.g. for its substep
+     * count, or NULL if not in adaptive mode.
+     */
+    const tgAdaptiveTimestep* getAdaptiveTimestep() const
+    {
+        return m_pAdaptiveTimestep;
+    }
+
+    /**
+     * Return the cable proximity check, e.g. for the pairs it found in
+     * the last step, or NULL if it is disabled.
+     */
+    const tgCableProximity* getCableProximity() const
+    {
+        return m_pCableProximity;
+    }
+
  private:
     
     /**
@@ -133,6 +260,30 @@ public:
      */
     void teardown();
 
+    /**
+     * Flatten the trees of all models and obstacles into the step plan.
+     * Called whenever the models have been (re)built.
+     */
+    void compileStepPlan();
+
+    /**
+     * Add a model and its descendants to the step plan
+     * @param[in,out] pModel the root of the tree; must be set up
+     */
+    void appendToStepPlan(tgModel* pModel);
+
+    /**
+     * Empty the step plan and let its models step their children again.
+     * Must be called before the models are torn down.
+     */
+    void clearStepPlan();
+
+    /**
+     * Step the world and the plan in substeps that add up to dt.
+     * @param[in] dt the control period
+     */
+    void stepAdaptive(double dt) const;
+
     /** Integrity predicate. */
     bool invariant() const;
 
@@ -162,6 +313,47 @@ private:
      * All pointers should be non-NULL.
      */
     std::vector<tgDataManager*> m_dataManagers;
+
+    /**
+     * If true, step() runs the step plan below instead of recursing
+     * through the model trees.
+     */
+    bool m_useStepPlan;
+
+    /**
+     * The step plan: every model in every tree, in pre-order, which is
+     * the order tgModel::step() recurses in. None of them recurse into
+     * their children while they're in the plan.
+     * Rebuilt on setup and reset; models must not add children while
+     * the simulation is stepping.
+     */
+    std::vector<tgModel*> m_plan;
+
+    /**
+     * For each model in m_plan, whether it steps once per control
+     * period in adaptive mode, so the controllers it notifies see one
+     * consistent dt. True for models with children that aren't
+     * actuators; all others step once per substep.
+     */
+    std::vector<bool> m_planPerPeriod;
+
+    /** The models in m_plan that step once per substep, in order */
+    std::vector<tgModel*> m_planSubstepped;
+
+    /**
+     * The spring cable actuators in m_plan, for tgAdaptiveTimestep and
+     * tgCableProximity
+     */
+    std::vector<tgSpringCableActuator*> m_planCables;
+
+    /** Where settle() saves and restores its result; may be NULL. */
+    tgSettleCache* m_pSettleCache;
+
+    /** Chooses the substeps in adaptive mode; NULL otherwise. */
+    tgAdaptiveTimestep* m_pAdaptiveTimestep;
+
+    /** Checks the cables for proximity each step; may be NULL. */
+    tgCableProximity* m_pCableProximity;
 };
 
 #endif  // TG_SIMULATION_H
@@ -0,0 +1,402 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgSimulationFork.cpp
+ * @brief Contains the definitions of members of class tgSimulationFork
+ * $Id$
+ */
+
+// This module
+#include "tgSimulationFork.h"
+// This application
+#include "tgCast.h"
+#include "tgModel.h"
+#include "tgSimView.h"
+#include "tgSimulation.h"
+#include "tgSimulationState.h"
+#include "terrain/tgBoxGround.h"
+#include "terrain/tgBulletGround.h"
+#include "terrain/tgEmptyGround.h"
+// The C++ Standard Library
+#include <cassert>
+#include <stdexcept>
+// POSIX
+#include <unistd.h>
+
+namespace
+{
+    /**
+     * Lends a branch's world the fork's ground. Each world still makes
+     * its own ground body, but from the shared ground's collision shape.
+     */
+    class SharedGround : public tgBulletGround
+    {
+    public:
+        SharedGround(const tgBulletGround& ground) : m_ground(ground) { }
+
+        virtual btRigidBody* getGroundRigidBody() const
+        {
+            return m_ground.getGroundRigidBody();
+        }
+
+    private:
+        const tgBulletGround& m_ground;
+    };
+
+    /** Return a ground for a branch's world, which takes ownership. */
+    tgGround* lendGround(const tgBulletGround& ground)
+    {
+        // The world adds no body for an empty ground
+        if (tgCast::cast<tgBulletGround, tgEmptyGround>(&ground) != NULL)
+        {
+            return new tgEmptyGround();
+        }
+        return new SharedGround(ground);
+    }
+}
+
+tgSimulationFork::tgSimulationFork(std::size_t branches,
+                                   Factory& factory,
+                                   const tgWorld::Config& worldConfig,
+                                   std::size_t threads) :
+    m_pGround(NULL),
+    m_time(0.0),
+    m_dt(0.0),
+    m_steps(0),
+    m_pPolicy(NULL),
+    m_generation(0),
+    m_pending(0),
+    m_shutdown(false)
+{
+    if (branches == 0)
+    {
+        throw std::invalid_argument("No branches to fork");
+    }
+
+    try
+    {
+        tgGround* const pGround = factory.createGround();
+        m_pGround = (pGround == NULL) ? new tgBoxGround() :
+            tgCast::cast<tgGround, tgBulletGround>(pGround);
+        if (m_pGround == NULL)
+        {
+            delete pGround;
+            throw std::invalid_argument("Ground is not a tgBulletGround");
+        }
+
+        m_branches.reserve(branches);
+        for (std::size_t i = 0; i < branches; i++)
+        {
+            Branch branch = { NULL, NULL, NULL, NULL };
+            m_branches.push_back(branch);
+            Branch& b = m_branches.back();
+
+            b.pWorld = new tgWorld(worldConfig, lendGround(*m_pGround));
+            b.pView = new tgSimView(*b.pWorld);
+            b.pSimulation = new tgSimulation(*b.pView);
+            tgModel* const pModel = factory.createModel(i);
+            try
+            {
+                // Throws if NULL
+                b.pSimulation->addModel(pModel);
+            }
+            catch (...)
+            {
+                // Not yet owned by the branch, so deleteBranches() misses it
+                delete pModel;
+                throw;
+            }
+            b.pModel = pModel;
+        }
+    }
+    catch (...)
+    {
+        deleteBranches();
+        throw;
+    }
+
+    if (threads == 0)
+    {
+        const long processors = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = (processors > 0) ? static_cast<std::size_t>(processors) : 1;
+    }
+    if (threads > branches)
+    {
+        threads = branches;
+    }
+    if (!isParallel())
+    {
+        threads = 1;
+    }
+    m_errors.resize(threads);
+
+    pthread_mutex_init(&m_mutex, NULL);
+    pthread_cond_init(&m_startCondition, NULL);
+    pthread_cond_init(&m_doneCondition, NULL);
+    try
+    {
+        startThreads(threads - 1);
+    }
+    catch (...)
+    {
+        deleteBranches();
+        throw;
+    }
+}
+
+tgSimulationFork::~tgSimulationFork()
+{
+    stopThreads();
+    deleteBranches();
+}
+
+void tgSimulationFork::sync(const tgSimulationState& state)
+{
+    sync(std::vector<const tgSimulationState*>(m_branches.size(), &state));
+}
+
+void tgSimulationFork::sync(const std::vector<tgSimulationState>& states)
+{
+    if (states.size() != m_branches.size())
+    {
+        throw std::invalid_argument("Not one state per branch");
+    }
+    std::vector<const tgSimulationState*> pointers(states.size());
+    for (std::size_t i = 0; i < states.size(); i++)
+    {
+        pointers[i] = &states[i];
+    }
+    sync(pointers);
+}
+
+void tgSimulationFork::sync(const std::vector<const tgSimulationState*>& states)
+{
+    assert(states.size() == m_branches.size());
+    // Check every branch before moving any
+    for (std::size_t i = 0; i < m_branches.size(); i++)
+    {
+        const std::vector<tgModel*> models(1, m_branches[i].pModel);
+        if (!states[i]->matches(*m_branches[i].pWorld, models))
+        {
+            throw std::invalid_argument(
+                "State is for a different number of bodies or cables");
+        }
+    }
+    for (std::size_t i = 0; i < m_branches.size(); i++)
+    {
+        // Contacts of the old positions would warm start the solver, so
+        // clear them even on a new branch: every rollout then starts
+        // from the same broadphase, whatever the branch did before
+        const std::vector<tgModel*> models(1, m_branches[i].pModel);
+        states[i]->apply(*m_branches[i].pWorld, models);
+        m_branches[i].pWorld->clearContacts();
+    }
+    m_time = 0.0;
+}
+
+void tgSimulationFork::step(double dt, std::size_t steps, Policy* pPolicy)
+{
+    if (dt <= 0.0)
+    {
+        throw std::invalid_argument("dt for step is not positive");
+    }
+    m_dt = dt;
+    m_steps = steps;
+    m_pPolicy = pPolicy;
+    for (std::size_t i = 0; i < m_errors.size(); i++)
+    {
+        m_errors[i].clear();
+    }
+
+    if (m_workers.empty())
+    {
+        stepAssigned(0);
+    }
+    else
+    {
+        pthread_mutex_lock(&m_mutex);
+        m_pending = m_workers.size();
+        m_generation++;
+        pthread_cond_broadcast(&m_startCondition);
+        pthread_mutex_unlock(&m_mutex);
+
+        stepAssigned(0);
+
+        pthread_mutex_lock(&m_mutex);
+        while (m_pending > 0)
+        {
+            pthread_cond_wait(&m_doneCondition, &m_mutex);
+        }
+        pthread_mutex_unlock(&m_mutex);
+    }
+
+    m_time += dt * steps;
+
+    for (std::size_t i = 0; i < m_errors.size(); i++)
+    {
+        if (!m_errors[i].empty())
+        {
+            throw std::runtime_error(m_errors[i]);
+        }
+    }
+}
+
+tgSimulation& tgSimulationFork::getSimulation(std::size_t branch) const
+{
+    if (branch >= m_branches.size())
+    {
+        throw std::out_of_range("No such branch");
+    }
+    return *m_branches[branch].pSimulation;
+}
+
+tgModel& tgSimulationFork::getModel(std::size_t branch) const
+{
+    if (branch >= m_branches.size())
+    {
+        throw std::out_of_range("No such branch");
+    }
+    return *m_branches[branch].pModel;
+}
+
+bool tgSimulationFork::isParallel()
+{
+#ifdef BT_NO_PROFILE
+    return true;
+#else
+    return false;
+#endif
+}
+
+void tgSimulationFork::stepAssigned(std::size_t thread)
+{
+    const std::size_t stride = getThreadCount();
+    for (std::size_t i = thread; i < m_branches.size(); i += stride)
+    {
+        try
+        {
+            for (std::size_t j = 0; j < m_steps; j++)
+            {
+                if (m_pPolicy != NULL)
+                {
+                    m_pPolicy->onStep(i, *m_branches[i].pModel, j, m_dt);
+                }
+                m_branches[i].pSimulation->step(m_dt);
+            }
+        }
+        catch (const std::exception& e)
+        {
+            if (m_errors[thread].empty())
+            {
+                m_errors[thread] = e.what();
+            }
+        }
+        catch (...)
+        {
+            if (m_errors[thread].empty())
+            {
+                m_errors[thread] = "Unknown exception in a forked branch";
+            }
+        }
+    }
+}
+
+void tgSimulationFork::startThreads(std::size_t count)
+{
+    // Size first: the threads hold pointers into m_workers
+    m_workers.resize(count);
+    for (std::size_t i = 0; i < m_workers.size(); i++)
+    {
+        m_workers[i].pFork = this;
+        m_workers[i].index = i + 1;
+        if (pthread_create(&m_workers[i].thread, NULL, run,
+                           &m_workers[i]) != 0)
+        {
+            m_workers.resize(i);
+            stopThreads();
+            throw std::runtime_error("Could not start a fork thread");
+        }
+    }
+}
+
+void tgSimulationFork::stopThreads()
+{
+    pthread_mutex_lock(&m_mutex);
+    m_shutdown = true;
+    pthread_cond_broadcast(&m_startCondition);
+    pthread_mutex_unlock(&m_mutex);
+    for (std::size_t i = 0; i < m_workers.size(); i++)
+    {
+        pthread_join(m_workers[i].thread, NULL);
+    }
+    m_workers.clear();
+
+    pthread_cond_destroy(&m_doneCondition);
+    pthread_cond_destroy(&m_startCondition);
+    pthread_mutex_destroy(&m_mutex);
+}
+
+void tgSimulationFork::deleteBranches()
+{
+    // The simulation deletes its model and must go before its view and
+    // world
+    for (std::size_t i = 0; i < m_branches.size(); i++)
+    {
+        delete m_branches[i].pSimulation;
+        delete m_branches[i].pView;
+        delete m_branches[i].pWorld;
+    }
+    m_branches.clear();
+
+    // The worlds' ground bodies use its shape
+    delete m_pGround;
+    m_pGround = NULL;
+}
+
+void* tgSimulationFork::run(void* pArg)
+{
+    Worker* const pWorker = static_cast<Worker*>(pArg);
+    tgSimulationFork& fork = *pWorker->pFork;
+
+    unsigned long seen = 0;
+    pthread_mutex_lock(&fork.m_mutex);
+    while (true)
+    {
+        while ((fork.m_generation == seen) && !fork.m_shutdown)
+        {
+            pthread_cond_wait(&fork.m_startCondition, &fork.m_mutex);
+        }
+        if (fork.m_shutdown)
+        {
+            break;
+        }
+        seen = fork.m_generation;
+        pthread_mutex_unlock(&fork.m_mutex);
+
+        fork.stepAssigned(pWorker->index);
+
+        pthread_mutex_lock(&fork.m_mutex);
+        if (--fork.m_pending == 0)
+        {
+            pthread_cond_signal(&fork.m_doneCondition);
+        }
+    }
+    pthread_mutex_unlock(&fork.m_mutex);
+    return NULL;
+}
@@ -0,0 +1,284 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_SIMULATION_FORK_H
+#define TG_SIMULATION_FORK_H
+
+/**
+ * @file tgSimulationFork.h
+ * @brief Contains the definition of class tgSimulationFork
+ * $Id$
+ */
+
+// This application
+#include "tgWorld.h"
+// The C++ Standard Library
+#include <cstddef>
+#include <string>
+#include <vector>
+// POSIX threads
+#include <pthread.h>
+
+// Forward declarations
+class tgBulletGround;
+class tgGround;
+class tgModel;
+class tgSimulation;
+class tgSimulationState;
+class tgSimView;
+
+/**
+ * K independent copies of a simulation, for what-if rollouts from the
+ * state of a running one: model predictive control, tree search and so
+ * on. Make one with tgSimulation::fork().
+ *
+ * Each branch is a headless tgSimulation with its own world, built once
+ * by a Factory. Each branch gets its own controllers, and with them its
+ * own candidate actions and its own random numbers; the factory is told
+ * which branch it is building. The worlds share one ground, so a
+ * terrain's collision shape and its BVH are only built once. sync()
+ * moves the bodies and cables of every branch to a tgSimulationState of
+ * the parent and clears their contacts, so a planner forks once and
+ * syncs each control tick without rebuilding anything.
+ *
+ * step() advances all the branches on a pool of threads. The branches
+ * share no mutable state: each world has its own tgWorldArena, and the
+ * arenas are thread safe. Bullet's profiler is not, so if Bullet is
+ * built without BT_NO_PROFILE the branches are stepped one after another
+ * on the calling thread; see BULLET_PROFILE in bullet.conf.
+ */
+class tgSimulationFork
+{
+public:
+
+    /** Builds the model of each branch. */
+    class Factory
+    {
+    public:
+
+        virtual ~Factory() { }
+
+        /**
+         * Build the model of a branch the same way as the parent's, with
+         * any controllers attached. Called on the calling thread.
+         * @param[in] branch the index of the branch
+         * @return a new model; the branch takes ownership
+         */
+        virtual tgModel* createModel(std::size_t branch) = 0;
+
+        /**
+         * Build the ground that every branch's world shares. Called
+         * once, on the calling thread.
+         * @return a new tgBulletGround, which the fork takes ownership
+         * of, or NULL (the default) for a tgBoxGround
+         */
+        virtual tgGround* createGround()
+        {
+            return NULL;
+        }
+    };
+
+    /**
+     * Sets each branch's actions before each step, e.g. from a candidate
+     * action sequence, and may score the branch as it goes.
+     */
+    class Policy
+    {
+    public:
+
+        virtual ~Policy() { }
+
+        /**
+         * Called before each step of each branch, on the thread stepping
+         * that branch. Calls for different branches may be concurrent,
+         * so touch nothing shared between branches.
+         * @param[in] branch the index of the branch
+         * @param[in,out] model the branch's model
+         * @param[in] step the index of the step within this step() call
+         * @param[in] dt the timestep
+         */
+        virtual void onStep(std::size_t branch, tgModel& model,
+                            std::size_t step, double dt) = 0;
+    };
+
+    /**
+     * Build the branches.
+     * @param[in] branches the number of branches; must be positive
+     * @param[in,out] factory builds the model of each branch
+     * @param[in] worldConfig the config of each branch's world
+     * @param[in] threads the number of threads that step the branches,
+     * including the calling thread; 0 for one per processor, up to one
+     * per branch
+     * @throw std::invalid_argument if branches is 0, the factory
+     * returns a NULL model or its ground is not a tgBulletGround
+     * @throw std::runtime_error if the threads can't be started
+     */
+    tgSimulationFork(std::size_t branches,
+                     Factory& factory,
+                     const tgWorld::Config& worldConfig,
+                     std::size_t threads = 0);
+
+    /** Stop the threads and delete the branches and the ground. */
+    ~tgSimulationFork();
+
+    /**
+     * Move every branch to a state, clear its contacts and set the time
+     * back to zero. The models are not rebuilt: contact cables drop the
+     * anchors they picked up, but controllers and anything else outside
+     * tgSimulationState carry on. Stepping on from the same state gives
+     * the same result each time.
+     * @param[in] state a state of a world and models built the same way
+     * @throw std::invalid_argument, changing nothing, if the branches
+     * have a different number of bodies or cables
+     */
+    void sync(const tgSimulationState& state);
+
+    /**
+     * Move each branch to its own state, e.g. to perturb each one
+     * differently, and set the time back to zero.
+     * @param[in] states one state per branch
+     * @throw std::invalid_argument, changing nothing, if there isn't one
+     * state per branch or a branch has a different number of bodies or
+     * cables than its state
+     */
+    void sync(const std::vector<tgSimulationState>& states);
+
+    /**
+     * Advance every branch.
+     * @param[in] dt the timestep; must be positive
+     * @param[in] steps the number of steps
+     * @param[in,out] pPolicy called before each step of each branch;
+     * may be NULL
+     * @throw std::invalid_argument if dt is not positive
+     * @throw std::runtime_error if a branch or the policy threw, after
+     * every branch has finished; the message is that of the first
+     */
+    void step(double dt, std::size_t steps = 1, Policy* pPolicy = NULL);
+
+    /** Return the number of branches. */
+    std::size_t size() const
+    {
+        return m_branches.size();
+    }
+
+    /** Return the number of threads, including the calling thread. */
+    std::size_t getThreadCount() const
+    {
+        return m_workers.size() + 1;
+    }
+
+    /** Return the seconds stepped since the last sync(). */
+    double getTime() const
+    {
+        return m_time;
+    }
+
+    /**
+     * Return the simulation of a branch.
+     * @throw std::out_of_range if there is no such branch
+     */
+    tgSimulation& getSimulation(std::size_t branch) const;
+
+    /**
+     * Return the model of a branch, as built by the factory.
+     * @throw std::out_of_range if there is no such branch
+     */
+    tgModel& getModel(std::size_t branch) const;
+
+    /**
+     * Return true if the branches are really stepped concurrently, i.e.
+     * Bullet's profiler is compiled out.
+     */
+    static bool isParallel();
+
+private:
+
+    /** Not copyable */
+    tgSimulationFork(const tgSimulationFork&);
+    tgSimulationFork& operator=(const tgSimulationFork&);
+
+    /** One independent simulation */
+    struct Branch
+    {
+        tgWorld* pWorld;
+        tgSimView* pView;
+        tgSimulation* pSimulation;
+        tgModel* pModel;
+    };
+
+    /** A pool thread and its index */
+    struct Worker
+    {
+        tgSimulationFork* pFork;
+        std::size_t index;
+        pthread_t thread;
+    };
+
+    /** Both sync()s; one state per branch */
+    void sync(const std::vector<const tgSimulationState*>& states);
+
+    /** Step the branches of one thread: every getThreadCount()th. */
+    void stepAssigned(std::size_t thread);
+
+    /** The body of a pool thread. */
+    static void* run(void* pWorker);
+
+    /**
+     * Start the pool threads.
+     * @throw std::runtime_error if a thread can't be started
+     */
+    void startThreads(std::size_t count);
+
+    /** Stop and join the pool threads. */
+    void stopThreads();
+
+    void deleteBranches();
+
+private:
+
+    std::vector<Branch> m_branches;
+
+    /** The ground that the branches' worlds share */
+    tgBulletGround* m_pGround;
+
+    double m_time;
+
+    /** The arguments of the current step() call */
+    double m_dt;
+    std::size_t m_steps;
+    Policy* m_pPolicy;
+
+    /** The first error of each thread in this step(); empty if none */
+    std::vector<std::string> m_errors;
+
+    /** The pool threads; empty unless isParallel() */
+    std::vector<Worker> m_workers;
+    pthread_mutex_t m_mutex;
+    pthread_cond_t m_startCondition;
+    pthread_cond_t m_doneCondition;
+
+    /** Incremented once per step() */
+    unsigned long m_generation;
+
+    /** Pool threads still stepping in this generation */
+    std::size_t m_pending;
+
+    bool m_shutdown;
+};
+
+#endif  // TG_SIMULATION_FORK_H
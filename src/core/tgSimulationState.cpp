@@ -0,0 +1,195 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgSimulationState.cpp
+ * @brief Contains the definitions of members of class tgSimulationState
+ * $Id$
+ */
+
+// This module
+#include "tgSimulationState.h"
+// This application
+#include "tgBulletUtil.h"
+#include "tgCast.h"
+#include "tgModel.h"
+#include "tgSpringCable.h"
+#include "tgSpringCableActuator.h"
+#include "tgWorld.h"
+// The Bullet Physics Library
+#include "btBulletDynamicsCommon.h"
+// The C++ Standard Library
+#include <cassert>
+#include <stdexcept>
+
+const std::size_t tgSimulationState::bodySize;
+const std::size_t tgSimulationState::cableSize;
+
+tgSimulationState::tgSimulationState() :
+    m_bodyCount(0),
+    m_cableCount(0)
+{
+}
+
+tgSimulationState::tgSimulationState(std::size_t bodyCount,
+                                     std::size_t cableCount,
+                                     const std::vector<double>& data) :
+    m_bodyCount(bodyCount),
+    m_cableCount(cableCount),
+    m_data(data)
+{
+    if (data.size() != bodyCount * bodySize + cableCount * cableSize)
+    {
+        throw std::invalid_argument("State data is the wrong size");
+    }
+}
+
+void tgSimulationState::capture(const tgWorld& world,
+                                const std::vector<tgModel*>& models)
+{
+    const std::vector<btRigidBody*> bodies = dynamicBodies(world);
+    const std::vector<tgSpringCableActuator*> cables = springCables(models);
+
+    m_data.clear();
+    m_data.reserve(bodies.size() * bodySize + cables.size() * cableSize);
+    for (std::size_t i = 0; i < bodies.size(); i++)
+    {
+        const btRigidBody* const pBody = bodies[i];
+        const btTransform& transform = pBody->getWorldTransform();
+        for (int row = 0; row < 3; row++)
+        {
+            for (int col = 0; col < 3; col++)
+            {
+                m_data.push_back(transform.getBasis()[row][col]);
+            }
+        }
+        for (int j = 0; j < 3; j++)
+        {
+            m_data.push_back(transform.getOrigin()[j]);
+        }
+        for (int j = 0; j < 3; j++)
+        {
+            m_data.push_back(pBody->getLinearVelocity()[j]);
+        }
+        for (int j = 0; j < 3; j++)
+        {
+            m_data.push_back(pBody->getAngularVelocity()[j]);
+        }
+    }
+    for (std::size_t i = 0; i < cables.size(); i++)
+    {
+        const tgSpringCable::State state =
+            cables[i]->getSpringCable()->getState();
+        m_data.push_back(state.restLength);
+        m_data.push_back(state.prevLength);
+        m_data.push_back(state.velocity);
+        m_data.push_back(state.damping);
+        m_data.push_back(cables[i]->getMotorVelocity());
+    }
+    m_bodyCount = bodies.size();
+    m_cableCount = cables.size();
+
+    assert(m_data.size() == m_bodyCount * bodySize + m_cableCount * cableSize);
+}
+
+void tgSimulationState::apply(tgWorld& world,
+                              const std::vector<tgModel*>& models) const
+{
+    const std::vector<btRigidBody*> bodies = dynamicBodies(world);
+    const std::vector<tgSpringCableActuator*> cables = springCables(models);
+    if (bodies.size() != m_bodyCount || cables.size() != m_cableCount)
+    {
+        throw std::invalid_argument(
+            "State is for a different number of bodies or cables");
+    }
+
+    const double* p = m_data.empty() ? NULL : &m_data[0];
+    for (std::size_t i = 0; i < bodies.size(); i++, p += bodySize)
+    {
+        btRigidBody* const pBody = bodies[i];
+        const btTransform transform(
+            btMatrix3x3(p[0], p[1], p[2],
+                        p[3], p[4], p[5],
+                        p[6], p[7], p[8]),
+            btVector3(p[9], p[10], p[11]));
+        const btVector3 linearVelocity(p[12], p[13], p[14]);
+        const btVector3 angularVelocity(p[15], p[16], p[17]);
+
+        pBody->setWorldTransform(transform);
+        pBody->setInterpolationWorldTransform(transform);
+        if (pBody->getMotionState() != NULL)
+        {
+            pBody->getMotionState()->setWorldTransform(transform);
+        }
+        pBody->setLinearVelocity(linearVelocity);
+        pBody->setInterpolationLinearVelocity(linearVelocity);
+        pBody->setAngularVelocity(angularVelocity);
+        pBody->setInterpolationAngularVelocity(angularVelocity);
+        pBody->clearForces();
+        pBody->activate(true);
+    }
+    for (std::size_t i = 0; i < cables.size(); i++, p += cableSize)
+    {
+        tgSpringCable::State state;
+        state.restLength = p[0];
+        state.prevLength = p[1];
+        state.velocity = p[2];
+        state.damping = p[3];
+        cables[i]->setSpringCableState(state);
+        cables[i]->setMotorVelocity(p[4]);
+    }
+}
+
+bool tgSimulationState::matches(const tgWorld& world,
+                                const std::vector<tgModel*>& models) const
+{
+    return dynamicBodies(world).size() == m_bodyCount &&
+           springCables(models).size() == m_cableCount;
+}
+
+std::vector<btRigidBody*>
+tgSimulationState::dynamicBodies(const tgWorld& world)
+{
+    const btCollisionObjectArray& objects =
+        tgBulletUtil::worldToDynamicsWorld(world).getCollisionObjectArray();
+    std::vector<btRigidBody*> bodies;
+    for (int i = 0; i < objects.size(); i++)
+    {
+        btRigidBody* const pBody = btRigidBody::upcast(objects[i]);
+        if (pBody != NULL && !pBody->isStaticOrKinematicObject())
+        {
+            bodies.push_back(pBody);
+        }
+    }
+    return bodies;
+}
+
+std::vector<tgSpringCableActuator*>
+tgSimulationState::springCables(const std::vector<tgModel*>& models)
+{
+    std::vector<tgSpringCableActuator*> cables;
+    for (std::size_t i = 0; i < models.size(); i++)
+    {
+        std::vector<tgModel*> tree = models[i]->getDescendants();
+        tree.insert(tree.begin(), models[i]);
+        const std::vector<tgSpringCableActuator*> found =
+            tgCast::filter<tgModel, tgSpringCableActuator>(tree);
+        cables.insert(cables.end(), found.begin(), found.end());
+    }
+    return cables;
+}
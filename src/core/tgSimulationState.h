@@ -0,0 +1,129 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_SIMULATION_STATE_H
+#define TG_SIMULATION_STATE_H
+
+/**
+ * @file tgSimulationState.h
+ * @brief Contains the definition of class tgSimulationState
+ * $Id$
+ */
+
+// The C++ Standard Library
+#include <cstddef>
+#include <vector>
+
+// Forward declarations
+class btRigidBody;
+class tgModel;
+class tgSpringCableActuator;
+class tgWorld;
+
+/**
+ * The dynamic state of a world and its models, held in memory: the
+ * transform and velocity of every dynamic rigid body in the world, in
+ * the world's order, and the tgSpringCable::State and motor velocity of
+ * every spring cable actuator in the models, in pre-order.
+ *
+ * Anything else a model or controller keeps (timers, control inputs,
+ * contact cable anchors) is not part of it. A state can be applied to
+ * any world and models built the same way, which is how tgSettleCache
+ * restores a settled structure and tgSimulationFork starts its branches.
+ */
+class tgSimulationState
+{
+public:
+
+    /** Doubles per rigid body: basis, origin, linear, angular velocity */
+    static const std::size_t bodySize = 9 + 3 + 3 + 3;
+
+    /**
+     * Doubles per spring cable: a tgSpringCable::State, then the
+     * actuator's motor velocity
+     */
+    static const std::size_t cableSize = 5;
+
+    /** An empty state, of no bodies and no cables. */
+    tgSimulationState();
+
+    /**
+     * A state from raw data, e.g. read from a file.
+     * @param[in] data bodyCount * bodySize doubles for the bodies, then
+     * cableCount * cableSize for the cables
+     * @throw std::invalid_argument if data is not that size
+     */
+    tgSimulationState(std::size_t bodyCount, std::size_t cableCount,
+                      const std::vector<double>& data);
+
+    /**
+     * Replace the state with that of a world and its models.
+     * @param[in] world the world
+     * @param[in] models the models in the world
+     */
+    void capture(const tgWorld& world, const std::vector<tgModel*>& models);
+
+    /**
+     * Move the bodies and set the cables of a world and its models to
+     * this state.
+     * @param[in,out] world the world, with the models already set up
+     * @param[in,out] models the models in the world
+     * @throw std::invalid_argument, changing nothing, if the world or
+     * the models have a different number of bodies or cables
+     */
+    void apply(tgWorld& world, const std::vector<tgModel*>& models) const;
+
+    /**
+     * Return true if apply() would accept the world and models.
+     */
+    bool matches(const tgWorld& world,
+                 const std::vector<tgModel*>& models) const;
+
+    std::size_t getBodyCount() const
+    {
+        return m_bodyCount;
+    }
+
+    std::size_t getCableCount() const
+    {
+        return m_cableCount;
+    }
+
+    /** Return the raw data; see the constructor. */
+    const std::vector<double>& getData() const
+    {
+        return m_data;
+    }
+
+    /** The rigid bodies that a state covers, in world order */
+    static std::vector<btRigidBody*> dynamicBodies(const tgWorld& world);
+
+    /** The spring cable actuators that a state covers, in pre-order */
+    static std::vector<tgSpringCableActuator*>
+    springCables(const std::vector<tgModel*>& models);
+
+private:
+
+    std::size_t m_bodyCount;
+
+    std::size_t m_cableCount;
+
+    std::vector<double> m_data;
+};
+
+#endif  // TG_SIMULATION_STATE_H
@@ -76,3 +76,29 @@ void tgSpringCable::setRestLength( const double newRestLength)
     
     m_restLength = newRestLength;
 }
+
+tgSpringCable::State tgSpringCable::getState() const
+{
+    State state;
+    state.restLength = m_restLength;
+    state.prevLength = m_prevLength;
+    state.velocity = m_velocity;
+    state.damping = m_damping;
+    return state;
+}
+
+void tgSpringCable::setState(const State& state)
+{
+    if (state.restLength <= 0.0)
+    {
+        throw std::invalid_argument("Rest length is not positive.");
+    }
+    else if (state.prevLength < 0.0)
+    {
+        throw std::invalid_argument("Previous length is negative.");
+    }
+    m_restLength = state.restLength;
+    m_prevLength = state.prevLength;
+    m_velocity = state.velocity;
+    m_damping = state.damping;
+}
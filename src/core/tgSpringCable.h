@@ -41,6 +41,18 @@ class tgSpringCable
 {
 public: 
     
+    /**
+     * Everything a spring cable carries from one step to the next.
+     * This is Plain Old Data.
+     */
+    struct State
+    {
+        double restLength;
+        double prevLength;
+        double velocity;
+        double damping;
+    };
+    
     /**
      * The only constructor. Takes a list of anchors, a coefficient
      * of stiffness, a coefficent of damping, and optionally the amount
@@ -126,6 +138,18 @@ public:
      * always define a way to return a vector of base anchors
      */
     virtual const std::vector<const tgSpringCableAnchor*> getAnchors() const = 0;
+    
+    /**
+     * Return the state carried between steps, e.g. to save it
+     */
+    State getState() const;
+    
+    /**
+     * Replace the state carried between steps, e.g. when restoring a
+     * saved world
+     * @param[in] state the state, as returned by getState()
+     */
+    virtual void setState(const State& state);
 
 protected:
  
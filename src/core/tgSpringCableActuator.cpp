@@ -179,6 +179,22 @@ const double tgSpringCableActuator::getRestLength() const
     return m_springCable->getRestLength();
 }
 
+void tgSpringCableActuator::setInitialRestLength(double restLength)
+{
+    if (restLength <= 0.0)
+    {
+        throw std::invalid_argument("Rest length is not positive.");
+    }
+    m_restLength = restLength;
+    m_springCable->setRestLength(restLength);
+}
+
+void tgSpringCableActuator::setSpringCableState(const tgSpringCable::State& state)
+{
+    setInitialRestLength(state.restLength);
+    m_springCable->setState(state);
+}
+
 const double tgSpringCableActuator::getVelocity() const
 {
     return m_springCable->getVelocity();
@@ -30,12 +30,12 @@
 // This application
 #include "tgModel.h"
 #include "tgControllable.h"
+#include "tgSpringCable.h"
 #include "tgSubject.h"
 
 #include <deque> // For history
 // Forward declarations
 class tgWorld;
-class tgSpringCable;
 
 /**
  * Sets a basic API for spring cable actuator models, so controllers can interface
@@ -235,6 +235,37 @@ public:
      */
     virtual const double getRestLength() const;
     
+    /**
+     * Replace the rest length the cable was built with, e.g. to restore
+     * pretension after building at a pose other than the design pose.
+     * Call before the first step.
+     * @param[in] restLength the new rest length, must be positive
+     */
+    virtual void setInitialRestLength(double restLength);
+    
+    /**
+     * Restore the spring cable's state, e.g. from a saved world. The
+     * actuator's rest length follows, as with setInitialRestLength().
+     * @param[in] state the state, as returned by tgSpringCable::getState()
+     */
+    void setSpringCableState(const tgSpringCable::State& state);
+    
+    /**
+     * Return the angular velocity of the motor that winds the cable,
+     * which it carries from one step to the next; 0 if it has none.
+     */
+    virtual double getMotorVelocity() const
+    {
+        return 0.0;
+    }
+    
+    /**
+     * Restore the angular velocity of the motor, e.g. from a saved
+     * world; does nothing if there is no motor.
+     * @param[in] motorVelocity as returned by getMotorVelocity()
+     */
+    virtual void setMotorVelocity(double /* motorVelocity */) { }
+    
     /**
      * In the default implementation returns the change in actual
      * length / time of the spring cable. Some child classes return
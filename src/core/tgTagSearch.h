@@ -92,6 +92,14 @@ public:
         m_search.remove(tags);
     }
     
+    /**
+     * Return the tags that this search looks for
+     */
+    const tgTags& getSearch() const
+    {
+        return m_search;
+    }
+    
 private:
     
     // @todo: change this to a parsed representation of the and/or/not setup
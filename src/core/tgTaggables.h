@@ -28,17 +28,31 @@
 
 #include <iostream> // Testing only
 #include <algorithm>
+#include <cstddef>
 #include <vector>
 #include <stdexcept>
+#include <tr1/unordered_map>
 #include "tgTaggable.h"
 class tgTaggable;
 
+/**
+ * A list of taggable elements that must be unique by value.
+ * Uniqueness is checked against a hash index (element hash => index in the
+ * list), so adding and looking up an element is O(1) on average. Subclasses
+ * supply the hash and the notion of equality through elementHash() and
+ * elementsMatch(); the defaults put every element in a single bucket and
+ * compare with operator==.
+ * Adding, setting and removing elements update the index in place. A
+ * caller with non-const access may move elements, so the keys handed out
+ * that way are rehashed before the next lookup; handing out the whole
+ * list (getElements(), find() and so on) rebuilds the index instead.
+ */
 template <class T>
 class tgTaggables
 {
 public:
     
-    tgTaggables() {
+    tgTaggables() : m_allTouched(false) {
         // Postcondition
         assert(m_elements.empty());
     };
@@ -49,10 +63,12 @@ public:
      * @author Lee Brownston
      * @date Wed 26 Feb 2014
      */
-    tgTaggables(std::vector<T>& elements) : m_elements(elements) {
-        // All elements must be unique
-        assertUniqueElements("All elements must be unique.");
-        
+    tgTaggables(std::vector<T>& elements) :
+        m_elements(elements),
+        m_allTouched(true)
+    {
+        // Uniqueness is checked by the subclass constructor, since
+        // elementHash() can't dispatch to it until then.
     }
         
     virtual ~tgTaggables() {};
@@ -63,8 +79,9 @@ public:
      */
     std::vector<T*> find(std::string tags) 
     {
+        touchAll();
         std::vector<T*> result;
-        for(int i = 0; i < m_elements.size(); i++) {
+        for(std::size_t i = 0; i < m_elements.size(); i++) {
             if(_taggable(&m_elements[i])->hasAllTags(tags)) {
                 result.push_back(&(m_elements[i]));
             }
@@ -79,8 +96,9 @@ public:
     
     std::vector<T*> findAll()
     {
+        touchAll();
         std::vector<T*> result;
-        for(int i = 0; i < m_elements.size(); i++) {
+        for(std::size_t i = 0; i < m_elements.size(); i++) {
             result.push_back(&(m_elements[i]));
         }
         return result;
@@ -88,8 +106,9 @@ public:
     
     std::vector<T*> findUntagged()
     {
+        touchAll();
         std::vector<T*> result;
-        for(int i = 0; i < m_elements.size(); i++) {
+        for(std::size_t i = 0; i < m_elements.size(); i++) {
             tgTaggable* t = _taggable(&m_elements[i]);
             if(t->hasNoTags()) {
                 result.push_back(&(m_elements[i]));
@@ -103,14 +122,13 @@ public:
         return std::find(haystack.begin(), haystack.end(), needle) != haystack.end();
     }
 
+    /**
+     * Does an element matching needle (see elementsMatch()) exist?
+     * @param[in] needle the element to look for
+     */
     bool contains(const T& needle) const
     {
-        //return std::find(m_elements.begin(), m_elements.end(), needle) != m_elements.end(); // generates errors??
-        for(typename std::vector<T>::const_iterator it = m_elements.begin(); it != m_elements.end(); it++) {
-            if(&(*it) == &needle)
-                return true;
-        }
-        return false;
+        return elementExists(needle);
     }
     
     
@@ -122,6 +140,7 @@ public:
      */
     T& operator[](int key) { 
         assertKeyExists(key);
+        touch(key);
         return m_elements[key]; 
     }
     
@@ -156,30 +175,48 @@ public:
 
 protected:
     
-    // @todo: think about uniqueness -- if not unique, throw an error? return -1? 
+    /**
+     * Add an element and return the created index.
+     * @throw std::logic_error if a matching element already exists
+     */
     int addElement(T element) 
     {
-        // @todo: make sure the element is unique
-        assert(!elementExists(element));  // segfault?
         assertUnique(element);
+        const int key = m_elements.size();
+        const std::size_t hash = elementHash(element);
         m_elements.push_back(element);
-        return m_elements.size() - 1;  // This is the index that was created.
+        m_hashes.push_back(hash);
+        m_index.insert(std::make_pair(hash, key));
+        return key;  // This is the index that was created.
     }
 
     void addElements(std::vector<T*> elements) 
     {
-        for(int i = 0; i < elements.size(); i++) {
+        for(std::size_t i = 0; i < elements.size(); i++) {
             this->addElement(elements[i]);
         }
     }
 
+    /**
+     * Replace the element at key.
+     * @throw std::out_of_range if there is no element at key
+     * @throw std::logic_error if another element matches the new one
+     */
     void setElement(int key, T element) {
-        assert((0 <= key) && (key <= m_elements.size()));
+        assertKeyExists(key);
+        const int match = findElement(element);
+        if ((match >= 0) && (match != key)) {
+            throw std::logic_error("Taggable elements must be unique.");
+        }
+        eraseFromIndex(key);
         m_elements[key] = element;
+        m_hashes[key] = elementHash(m_elements[key]);
+        m_index.insert(std::make_pair(m_hashes[key], key));
     }
         
     std::vector<T>& getElements() 
     {
+        touchAll();
         return m_elements;
     };
 
@@ -188,22 +225,38 @@ protected:
         return m_elements;
     };
 
+    /**
+     * Remove the element matching the given one, if any. The lookup is
+     * hashed, but the list keeps its order (indices are keys), so the
+     * erase and renumbering the keys after it are linear.
+     */
     void removeElement(const T& element) {
-        m_elements.erase(std::remove(m_elements.begin(), m_elements.end(), element), m_elements.end());
+        const int key = findElement(element);
+        if (key >= 0) {
+            eraseFromIndex(key);
+            m_elements.erase(m_elements.begin() + key);
+            m_hashes.erase(m_hashes.begin() + key);
+            for (typename IndexMap::iterator it = m_index.begin();
+                 it != m_index.end(); ++it) {
+                if (it->second > key) {
+                    it->second--;
+                }
+            }
+        }
     }
 
     void removeElement(const T* element) {
-        m_elements.erase(std::remove(m_elements.begin(), m_elements.end(), *element), m_elements.end());
+        removeElement(*element);
     }
 
     void removeElements(const std::vector<T>& elements) {
-        for(int i = 0; i < elements.size(); i++) {
+        for(std::size_t i = 0; i < elements.size(); i++) {
             removeElement(elements[i]);
         }
     }
 
     void removeElements(const std::vector<T*>& elements) {
-        for(int i = 0; i < elements.size(); i++) {
+        for(std::size_t i = 0; i < elements.size(); i++) {
             removeElement(elements[i]);
         }
     }
@@ -211,6 +264,7 @@ protected:
     // To make subclassing operators easier...
     T& getElement(int key) 
     {
+        touch(key);
         return m_elements[key];
     }
 
@@ -228,21 +282,65 @@ protected:
      */
     bool keyExists(int key) const
     {
-        return (0 <= key) && (key < m_elements.size());
+        return (0 <= key) && (static_cast<std::size_t>(key) < m_elements.size());
     }        
     
-    // @todo: FIX THIS -- segfaults, etc. -- what's going on? 
     bool elementExists(const T& element) const
-    {        
-        //return std::find(m_elements.begin(), m_elements.end(), element) != m_elements.end(); // segfault?
-        for(int i = 0; i < m_elements.size(); i++) {
-            // This is a little strange to me, but at least it doesn't cause a segfault...
-            const T* elem =& m_elements[i];
-            if (elem == &element) {
-                return true;
-            }
+    {
+        return findElement(element) >= 0;
+    }
+
+    /**
+     * Return the index of the element matching the given one, or -1 if
+     * there is none.
+     */
+    int findElement(const T& element) const
+    {
+        syncIndex();
+        return lookup(element);
+    }
+
+    /**
+     * Hash used by the uniqueness index. Elements that match (see
+     * elementsMatch()) must hash to the same value.
+     */
+    virtual std::size_t elementHash(const T& element) const
+    {
+        return 0;
+    }
+
+    /** The equality used for uniqueness, lookup and removal. */
+    virtual bool elementsMatch(const T& a, const T& b) const
+    {
+        return a == b;
+    }
+
+    /**
+     * Note that the caller may change the element at key, so it must be
+     * rehashed before the next lookup.
+     */
+    void touch(int key)
+    {
+        if (m_allTouched) {
+            return;
+        }
+        // Past one per element, a rebuild is cheaper
+        if (m_touched.size() >= m_elements.size()) {
+            touchAll();
+        }
+        else {
+            m_touched.push_back(key);
         }
-        return false;
+    }
+
+    /**
+     * Note that the caller may change any element, so the index must be
+     * rebuilt before the next lookup.
+     */
+    void touchAll()
+    {
+        m_allTouched = true;
+        m_touched.clear();
     }
     
     void assertKeyExists(int key, std::string message = "Element at index does not exist") const
@@ -262,15 +360,10 @@ protected:
     
     void assertUniqueElements(std::string message = "Taggable elements must be unique.") const
     {
-        /* Note: this throws a "Most vexing parse" error (http://en.wikipedia.org/wiki/Most_vexing_parse)
-        // Note: This would probably work if we implemented operator< on tgPair...
-        */
-        
-        if(! std::set<T>(m_elements.begin(), m_elements.end()).size() ==
-             m_elements.size()) {
-                 throw std::logic_error(message);
-             }
-
+        // Rebuilding the index checks every element against the ones before it
+        if (!rebuildIndex()) {
+            throw std::logic_error(message);
+        }
     }
     
     // Cast T to taggable (after all, T must be a tgTaggable in the first place, but )
@@ -280,7 +373,92 @@ protected:
     }
     
 private:
+
+    typedef std::tr1::unordered_multimap<std::size_t, int> IndexMap;
+
+    /** Find a match in the index as it stands. */
+    int lookup(const T& element) const
+    {
+        std::pair<typename IndexMap::const_iterator,
+                  typename IndexMap::const_iterator> range =
+            m_index.equal_range(elementHash(element));
+        for (typename IndexMap::const_iterator it = range.first;
+             it != range.second; ++it) {
+            if (elementsMatch(m_elements[it->second], element)) {
+                return it->second;
+            }
+        }
+        return -1;
+    }
+
+    /** Bring the index up to date with any elements that were touched. */
+    void syncIndex() const
+    {
+        if (m_allTouched) {
+            rebuildIndex();
+            return;
+        }
+        for (std::size_t i = 0; i < m_touched.size(); i++) {
+            const int key = m_touched[i];
+            const std::size_t hash = elementHash(m_elements[key]);
+            if (hash != m_hashes[key]) {
+                eraseFromIndex(key);
+                m_hashes[key] = hash;
+                m_index.insert(std::make_pair(hash, key));
+            }
+        }
+        m_touched.clear();
+    }
+
+    /** Remove the entry for key, under the hash it was indexed with. */
+    void eraseFromIndex(int key) const
+    {
+        std::pair<typename IndexMap::iterator,
+                  typename IndexMap::iterator> range =
+            m_index.equal_range(m_hashes[key]);
+        for (typename IndexMap::iterator it = range.first;
+             it != range.second; ++it) {
+            if (it->second == key) {
+                m_index.erase(it);
+                return;
+            }
+        }
+    }
+
+    /**
+     * Rebuild the index from m_elements.
+     * @return false if two elements match
+     */
+    bool rebuildIndex() const
+    {
+        bool unique = true;
+        m_index.clear();
+        m_hashes.resize(m_elements.size());
+        m_touched.clear();
+        m_allTouched = false;
+        for (std::size_t i = 0; i < m_elements.size(); i++) {
+            if (lookup(m_elements[i]) >= 0) {
+                unique = false;
+            }
+            m_hashes[i] = elementHash(m_elements[i]);
+            m_index.insert(std::make_pair(m_hashes[i], static_cast<int>(i)));
+        }
+        return unique;
+    }
+
     std::vector<T> m_elements;
+
+    /** Element hash => index in m_elements */
+    mutable IndexMap m_index;
+
+    /** The hash each element is indexed under */
+    mutable std::vector<std::size_t> m_hashes;
+
+    /** Keys handed out non-const since the index was last brought up to date */
+    mutable std::vector<int> m_touched;
+
+    /** True when the whole list was handed out, and m_touched is moot */
+    mutable bool m_allTouched;
 };
 
 
@@ -26,20 +26,31 @@
 // This module
 #include "tgWorld.h"
 // This application
+#include "tgIslandParallelSolver.h"
+#include "tgWorldArena.h"
 #include "tgWorldBulletPhysicsImpl.h"
 #include "terrain/tgBoxGround.h"
 // The C++ Standard Library
 #include <cassert>
 #include <stdexcept>
 
-tgWorld::Config::Config(double g, double ws) :
+tgWorld::Config::Config(double g, double ws, int st) :
 gravity(g),
-worldSize(ws)
+worldSize(ws),
+solverThreads(st)
 {
   if (ws <= 0.0)
   {
     throw std::invalid_argument("worldSize is not postive");
   }
+  else if (st < 1)
+  {
+    throw std::invalid_argument("solverThreads is not positive");
+  }
+  else if ((st > 1) && !tgIslandParallelSolver::isParallel())
+  {
+    throw std::invalid_argument("solverThreads needs a BT_NO_PROFILE build");
+  }
 }
 
 /**
@@ -49,8 +60,11 @@ worldSize(ws)
 tgWorld::tgWorld() :
   m_config(),
   m_pGround(new tgBoxGround()),
-  m_pImpl(new tgWorldBulletPhysicsImpl(m_config, (tgBulletGround*)m_pGround))
+  m_pArena(NULL),
+  m_pImpl(NULL)
 {
+  createImpl();
+
   // Postcondition
   assert(invariant());
 }
@@ -62,8 +76,11 @@ tgWorld::tgWorld() :
 tgWorld::tgWorld(const tgWorld::Config& config) :
   m_config(config),
   m_pGround(new tgBoxGround()),
-  m_pImpl(new tgWorldBulletPhysicsImpl(m_config, (tgBulletGround*)m_pGround))
+  m_pArena(NULL),
+  m_pImpl(NULL)
 {
+  createImpl();
+
   // Postcondition
   assert(invariant());
 }
@@ -75,21 +92,53 @@ tgWorld::tgWorld(const tgWorld::Config& config) :
 tgWorld::tgWorld(const tgWorld::Config& config, tgGround* ground) :
   m_config(config),
   m_pGround(ground),
-  m_pImpl(new tgWorldBulletPhysicsImpl(m_config, (tgBulletGround*)m_pGround))
+  m_pArena(NULL),
+  m_pImpl(NULL)
 {
+  createImpl();
+
   // Postcondition
   assert(invariant());
 }
 
+void tgWorld::createImpl()
+{
+  // The world owns the ground; don't leak it or the arena if the
+  // implementation can't be made
+  try
+  {
+    m_pArena = new tgWorldArena();
+    tgWorldArena::Scope scope(*m_pArena);
+    m_pImpl = new tgWorldBulletPhysicsImpl(m_config, (tgBulletGround*)m_pGround);
+  }
+  catch (...)
+  {
+    if (m_pArena != NULL)
+    {
+      m_pArena->release();
+    }
+    delete m_pGround;
+    throw;
+  }
+}
+
 tgWorld::~tgWorld()
 {
   delete m_pImpl;
   delete m_pGround;
+  m_pArena->release();
 }
 
 void tgWorld::reset()
 {
-  delete m_pImpl;
+  {
+    // Release the implementation in bulk, and start over at the first
+    // chunk if the models let go of everything too
+    tgWorldArena::Teardown teardown(*m_pArena);
+    delete m_pImpl;
+    m_pImpl = NULL;
+  }
+  tgWorldArena::Scope scope(*m_pArena);
   m_pImpl = new tgWorldBulletPhysicsImpl(m_config, (tgBulletGround*)m_pGround);
   // Postcondition
   assert(invariant());
@@ -124,11 +173,19 @@ void tgWorld::step(double dt) const
   }
   else
   {
-    // Forward to the implementation
+    // Forward to the implementation; contacts and solver rows come
+    // from the arena too
+    tgWorldArena::Scope scope(*m_pArena);
     m_pImpl->step(dt);
   }
 }
 
+void tgWorld::clearContacts()
+{
+  tgWorldArena::Scope scope(*m_pArena);
+  m_pImpl->clearContacts();
+}
+
 // Add a function that returns the amount of gravity in the world.
 // This is useful for calculating the forces applied by rigid bodies
 // inside models (e.g., ForcePlateModel.)
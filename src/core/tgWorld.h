@@ -28,6 +28,7 @@
 
 // Forward declarations
 class tgWorldImpl;
+class tgWorldArena;
 class tgGround;
 
 /**
@@ -44,7 +45,7 @@ public:
    */
   struct Config
   {
-	Config(double g = 9.81, double ws = 1000);
+	Config(double g = 9.81, double ws = 1000, int st = 1);
     /**
      * Gravitational acceleration.
      * The units are application depenent.
@@ -56,6 +57,16 @@ public:
      * the length of one side of the detection cube. Must be positive.
      */
     double worldSize;
+    /**
+     * Number of threads that solve the constraints of independent
+     * simulation islands. 1 uses the usual single threaded solver; more
+     * dispatch islands to a tgIslandParallelSolver. Results depend on
+     * the island layout only, so they are repeatable for a fixed value.
+     * Must be positive, and may only exceed 1 if Bullet and NTRT are
+     * built with BT_NO_PROFILE defined, since Bullet's profiler is not
+     * thread safe; see BULLET_PROFILE in bullet.conf.
+     */
+    int solverThreads;
   };
 
   /** Construct with the default configuration. */
@@ -100,6 +111,12 @@ public:
    */
   void step(double dt) const;
 
+  /**
+   * Forget every contact, as if the world had just been built with its
+   * bodies where they now are, e.g. after moving them to a saved state.
+   */
+  void clearContacts();
+
   /**
    * Return a pointer to the implementation.
    * @return a pointer to the implementation; may be NULL.
@@ -110,13 +127,37 @@ public:
     return *m_pImpl;
   }
 
+  /**
+   * Return the allocator for this world's Bullet objects. Open a
+   * tgWorldArena::Scope on it while creating models in the world.
+   */
+  tgWorldArena& arena() const
+  {
+    return *m_pArena;
+  }
+
   /**
    * Returns the level of gravity in this world.
    */
   double getWorldGravity() const;
- 
+
+  /**
+   * Returns the configuration passed at construction or upon reset,
+   * e.g. to build another world like this one.
+   */
+  const Config& getConfig() const
+  {
+    return m_config;
+  }
+
 private:
 
+  /**
+   * Make the arena and the implementation, deleting the ground if
+   * either throws.
+   */
+  void createImpl();
+
   /** Integrity predicate */
   bool invariant() const;
 
@@ -130,6 +171,12 @@ private:
   /** Implementation of the ground, such as a box, hills or ramp */
   tgGround* m_pGround;
 
+  /**
+   * Where the implementation's Bullet objects are allocated. Outlives
+   * resets, so their memory is reused.
+   */
+  tgWorldArena * m_pArena;
+
   /** The implementation of the tgWorld. */
   tgWorldImpl * m_pImpl;
 };
@@ -0,0 +1,331 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgWorldArena.cpp
+ * @brief Contains the definitions of members of class tgWorldArena
+ * $Id$
+ */
+
+// This module
+#include "tgWorldArena.h"
+// The Bullet Physics Library
+#include "LinearMath/btAlignedAllocator.h"
+// The C++ Standard Library
+#include <cassert>
+#include <cstdlib>
+#include <map>
+#include <stdexcept>
+
+namespace
+{
+    /**
+     * Every block in a chunk starts with its size class. 16 bytes keep
+     * the payload as aligned as malloc's.
+     */
+    const std::size_t headerSize = 16;
+
+    /** Blocks are 32 << c bytes, header included */
+    const std::size_t minBlockSize = 32;
+    const std::size_t classCount = 13;
+
+    std::size_t blockSize(std::size_t sizeClass)
+    {
+        return minBlockSize << sizeClass;
+    }
+
+    /** Holds the current arena of each thread */
+    pthread_key_t currentKey;
+
+    /** Whether install() has made currentKey */
+    volatile bool installed = false;
+
+    pthread_once_t installOnce = PTHREAD_ONCE_INIT;
+
+    /**
+     * The chunks of every arena by their first byte. Frees only read it,
+     * so they share the lock; it is written when a chunk is reserved or
+     * an arena is destroyed.
+     */
+    typedef std::map<const char*, tgWorldArena*> ChunkMap;
+    ChunkMap* pChunks = NULL;
+    pthread_rwlock_t chunksLock = PTHREAD_RWLOCK_INITIALIZER;
+}
+
+tgWorldArena::Scope::Scope(tgWorldArena& arena) :
+    m_pPrevious(current())
+{
+    pthread_setspecific(currentKey, &arena);
+}
+
+tgWorldArena::Scope::~Scope()
+{
+    pthread_setspecific(currentKey, m_pPrevious);
+}
+
+tgWorldArena::Teardown::Teardown(tgWorldArena& arena) :
+    m_arena(arena)
+{
+    pthread_mutex_lock(&m_arena.m_mutex);
+    m_arena.m_teardowns++;
+    pthread_mutex_unlock(&m_arena.m_mutex);
+}
+
+tgWorldArena::Teardown::~Teardown()
+{
+    pthread_mutex_lock(&m_arena.m_mutex);
+    assert(m_arena.m_teardowns > 0);
+    const bool last = (--m_arena.m_teardowns == 0);
+    pthread_mutex_unlock(&m_arena.m_mutex);
+    if (last)
+    {
+        m_arena.rewind();
+    }
+}
+
+tgWorldArena::tgWorldArena(std::size_t chunkSize) :
+    m_chunkSize(chunkSize),
+    m_chunkIndex(0),
+    m_offset(0),
+    m_freeLists(classCount, static_cast<void*>(NULL)),
+    m_live(0),
+    m_released(false),
+    m_teardowns(0)
+{
+    if (chunkSize < blockSize(classCount - 1))
+    {
+        throw std::invalid_argument("chunkSize is less than a block");
+    }
+    pthread_mutex_init(&m_mutex, NULL);
+
+    pthread_once(&installOnce, install);
+}
+
+tgWorldArena::~tgWorldArena()
+{
+    assert(m_live == 0);
+    pthread_rwlock_wrlock(&chunksLock);
+    for (std::size_t i = 0; i < m_chunks.size(); i++)
+    {
+        pChunks->erase(m_chunks[i]);
+    }
+    pthread_rwlock_unlock(&chunksLock);
+    for (std::size_t i = 0; i < m_chunks.size(); i++)
+    {
+        std::free(m_chunks[i]);
+    }
+    pthread_mutex_destroy(&m_mutex);
+}
+
+void tgWorldArena::release()
+{
+    pthread_mutex_lock(&m_mutex);
+    m_released = true;
+    const bool empty = (m_live == 0);
+    pthread_mutex_unlock(&m_mutex);
+
+    // Otherwise the last deallocate() deletes it
+    if (empty)
+    {
+        delete this;
+    }
+}
+
+bool tgWorldArena::rewind()
+{
+    pthread_mutex_lock(&m_mutex);
+    const bool empty = (m_live == 0);
+    if (empty)
+    {
+        m_chunkIndex = 0;
+        m_offset = 0;
+        m_freeLists.assign(classCount, static_cast<void*>(NULL));
+    }
+    pthread_mutex_unlock(&m_mutex);
+    return empty;
+}
+
+std::size_t tgWorldArena::getLiveCount() const
+{
+    pthread_mutex_lock(&m_mutex);
+    const std::size_t live = m_live;
+    pthread_mutex_unlock(&m_mutex);
+    return live;
+}
+
+std::size_t tgWorldArena::getChunkCount() const
+{
+    pthread_mutex_lock(&m_mutex);
+    const std::size_t n = m_chunks.size();
+    pthread_mutex_unlock(&m_mutex);
+    return n;
+}
+
+std::size_t tgWorldArena::getMaxBlockSize()
+{
+    return blockSize(classCount - 1) - headerSize;
+}
+
+tgWorldArena* tgWorldArena::current()
+{
+    // No arena has been made yet, so the key doesn't exist either
+    if (!installed)
+    {
+        return NULL;
+    }
+    return static_cast<tgWorldArena*>(pthread_getspecific(currentKey));
+}
+
+void* tgWorldArena::allocate(std::size_t size)
+{
+    if (size > getMaxBlockSize())
+    {
+        return NULL;
+    }
+    std::size_t sizeClass = 0;
+    while (blockSize(sizeClass) < size + headerSize)
+    {
+        sizeClass++;
+    }
+
+    pthread_mutex_lock(&m_mutex);
+    char* pBlock = static_cast<char*>(m_freeLists[sizeClass]);
+    if (pBlock != NULL)
+    {
+        // The link lives where the payload goes
+        m_freeLists[sizeClass] = *reinterpret_cast<void**>(pBlock + headerSize);
+    }
+    else
+    {
+        const std::size_t n = blockSize(sizeClass);
+        if ((m_chunks.empty()) || (m_offset + n > m_chunkSize))
+        {
+            // Move on to the next chunk, reserving one if need be
+            if (!m_chunks.empty())
+            {
+                m_chunkIndex++;
+            }
+            if ((m_chunkIndex == m_chunks.size()) && (reserveChunk() == NULL))
+            {
+                pthread_mutex_unlock(&m_mutex);
+                return NULL;
+            }
+            m_offset = 0;
+        }
+        pBlock = m_chunks[m_chunkIndex] + m_offset;
+        m_offset += n;
+        *reinterpret_cast<std::size_t*>(pBlock) = sizeClass;
+    }
+    m_live++;
+    pthread_mutex_unlock(&m_mutex);
+
+    return pBlock + headerSize;
+}
+
+char* tgWorldArena::reserveChunk()
+{
+    char* const pChunk = static_cast<char*>(std::malloc(m_chunkSize));
+    if (pChunk != NULL)
+    {
+        pthread_rwlock_wrlock(&chunksLock);
+        (*pChunks)[pChunk] = this;
+        pthread_rwlock_unlock(&chunksLock);
+        m_chunks.push_back(pChunk);
+    }
+    return pChunk;
+}
+
+void tgWorldArena::deallocate(void* pMemory)
+{
+    char* const pBlock = static_cast<char*>(pMemory) - headerSize;
+    const std::size_t sizeClass = *reinterpret_cast<std::size_t*>(pBlock);
+    assert(sizeClass < classCount);
+
+    pthread_mutex_lock(&m_mutex);
+    // A Teardown rewinds the whole arena, so the free lists can wait
+    if (m_teardowns == 0)
+    {
+        *reinterpret_cast<void**>(pMemory) = m_freeLists[sizeClass];
+        m_freeLists[sizeClass] = pBlock;
+    }
+    assert(m_live > 0);
+    m_live--;
+    const bool orphaned = m_released && (m_live == 0);
+    pthread_mutex_unlock(&m_mutex);
+
+    if (orphaned)
+    {
+        delete this;
+    }
+}
+
+tgWorldArena* tgWorldArena::owner(const void* pMemory)
+{
+    const char* const p = static_cast<const char*>(pMemory);
+    tgWorldArena* pArena = NULL;
+    pthread_rwlock_rdlock(&chunksLock);
+    // The last chunk that starts at or before p
+    ChunkMap::const_iterator it = pChunks->upper_bound(p);
+    if (it != pChunks->begin())
+    {
+        --it;
+        if (p < it->first + it->second->m_chunkSize)
+        {
+            pArena = it->second;
+        }
+    }
+    pthread_rwlock_unlock(&chunksLock);
+    return pArena;
+}
+
+void tgWorldArena::install()
+{
+    // The key and the map must exist before the hooks can run
+    pthread_key_create(&currentKey, NULL);
+    pChunks = new ChunkMap();
+    installed = true;
+    btAlignedAllocSetCustom(allocHook, freeHook);
+}
+
+void* tgWorldArena::allocHook(std::size_t size)
+{
+    tgWorldArena* const pArena = current();
+    void* const pMemory = (pArena != NULL) ? pArena->allocate(size) : NULL;
+    // Too large, or no Scope: malloc, as if the hooks weren't there
+    return (pMemory != NULL) ? pMemory : std::malloc(size);
+}
+
+void tgWorldArena::freeHook(void* pMemory)
+{
+    if (pMemory == NULL)
+    {
+        return;
+    }
+
+    // Only memory in a chunk is ours to read; the rest came from malloc,
+    // whether before or after the hooks were installed
+    tgWorldArena* const pArena = owner(pMemory);
+    if (pArena != NULL)
+    {
+        pArena->deallocate(pMemory);
+    }
+    else
+    {
+        std::free(pMemory);
+    }
+}
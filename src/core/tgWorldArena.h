@@ -0,0 +1,167 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_WORLD_ARENA_H
+#define TG_WORLD_ARENA_H
+
+/**
+ * @file tgWorldArena.h
+ * @brief Contains the definition of class tgWorldArena
+ * $Id$
+ */
+
+// The C++ Standard Library
+#include <cstddef>
+#include <vector>
+// POSIX threads
+#include <pthread.h>
+
+/**
+ * A pool allocator for the Bullet objects of one tgWorld: rigid bodies,
+ * motion states, collision shapes, contact manifolds, solver rows and
+ * everything else Bullet allocates through btAlignedAlloc.
+ *
+ * The first arena installs itself with btAlignedAllocSetCustom(). From
+ * then on, Bullet allocations on a thread with an open Scope come from
+ * that arena's chunks, in power of two size classes with a free list
+ * each; all others, and very large blocks, still use malloc. A free
+ * finds its arena by looking the address up among the chunks of all
+ * arenas, under a shared lock, so a Scope is only needed where objects
+ * are created. Memory that isn't in a chunk, including anything Bullet
+ * allocated before the hooks were installed, goes to free() untouched.
+ *
+ * tgWorld keeps one arena for its whole life. A reset runs under a
+ * Teardown, during which frees skip the free lists; once everything is
+ * gone the chunks are handed out again from the start, so long learning
+ * runs reuse the same memory instead of fragmenting the heap.
+ */
+class tgWorldArena
+{
+public:
+
+    /**
+     * Makes an arena the one that Bullet allocates from on this thread
+     * while the Scope exists.
+     */
+    class Scope
+    {
+    public:
+        Scope(tgWorldArena& arena);
+        ~Scope();
+    private:
+        /** The arena that was current before */
+        tgWorldArena* const m_pPrevious;
+    };
+
+    /**
+     * Releases an arena in bulk. While a Teardown exists, freed blocks
+     * are only counted off; when the last one ends, the arena rewinds if
+     * nothing is left. Blocks freed while something outlives the
+     * Teardown stay unused until a later rewind succeeds.
+     */
+    class Teardown
+    {
+    public:
+        Teardown(tgWorldArena& arena);
+        ~Teardown();
+    private:
+        tgWorldArena& m_arena;
+    };
+
+    /**
+     * @param[in] chunkSize the bytes to reserve at a time; must be at
+     * least getMaxBlockSize()
+     * @throw std::invalid_argument if chunkSize is too small
+     */
+    tgWorldArena(std::size_t chunkSize = 1 << 20);
+
+    /**
+     * Destroy the arena, or, if blocks are still allocated, mark it to
+     * be destroyed when the last one is freed. Use this instead of
+     * delete.
+     */
+    void release();
+
+    /**
+     * Start handing out the chunks from the beginning again.
+     * @return false, changing nothing, if blocks are still allocated
+     */
+    bool rewind();
+
+    /** Return the number of blocks allocated and not yet freed. */
+    std::size_t getLiveCount() const;
+
+    /** Return the number of chunks reserved. */
+    std::size_t getChunkCount() const;
+
+    /** Return the largest block the arena serves; larger go to malloc. */
+    static std::size_t getMaxBlockSize();
+
+    /** Return the arena that is current on this thread, or NULL. */
+    static tgWorldArena* current();
+
+private:
+
+    /** Use release() */
+    ~tgWorldArena();
+
+    /** Return a block of at least size bytes, or NULL if too large. */
+    void* allocate(std::size_t size);
+
+    /** Return a block to its free list, or drop it during a Teardown. */
+    void deallocate(void* pBlock);
+
+    /** Reserve a chunk and record it as this arena's. */
+    char* reserveChunk();
+
+    /** Return the arena whose chunk holds pMemory, or NULL. */
+    static tgWorldArena* owner(const void* pMemory);
+
+    /** Install the hooks; runs once, with the first arena. */
+    static void install();
+
+    /** The Bullet allocation hooks */
+    static void* allocHook(std::size_t size);
+    static void freeHook(void* pMemory);
+
+private:
+
+    const std::size_t m_chunkSize;
+
+    /** Reserved chunks, in the order they are handed out */
+    std::vector<char*> m_chunks;
+
+    /** The chunk being carved up, and how far */
+    std::size_t m_chunkIndex;
+    std::size_t m_offset;
+
+    /** The first free block of each size class */
+    std::vector<void*> m_freeLists;
+
+    std::size_t m_live;
+
+    /** Whether release() was called */
+    bool m_released;
+
+    /** The number of open Teardowns */
+    std::size_t m_teardowns;
+
+    mutable pthread_mutex_t m_mutex;
+};
+
+#endif  // TG_WORLD_ARENA_H
@@ -29,6 +29,7 @@
 // This application
 #include "tgWorld.h"
 #include "tgCast.h"
+#include "tgIslandParallelSolver.h"
 #include "terrain/tgBulletGround.h"
 #include "terrain/tgEmptyGround.h"
 // The Bullet Physics library
@@ -50,6 +51,8 @@
 #include "LinearMath/btTransform.h"
 #include "LinearMath/btVector3.h"
 #include "LinearMath/btQuickprof.h"
+// The C++ Standard Library
+#include <vector>
 
 // Ghost objects
 #include "BulletCollision/CollisionDispatch/btGhostObject.h"
@@ -72,23 +75,55 @@
 class IntermediateBuildProducts
 {
     public:
-        IntermediateBuildProducts(double worldSize) : 
-            corner1 (-worldSize,-worldSize, -worldSize),
-            corner2 (worldSize, worldSize, worldSize),
+        IntermediateBuildProducts(const tgWorld::Config& config) : 
+            corner1 (-config.worldSize,-config.worldSize, -config.worldSize),
+            corner2 (config.worldSize, config.worldSize, config.worldSize),
             dispatcher(&collisionConfiguration),
             ghostCallback(),
 #ifndef   MLCP_SOLVER       
 	#if (1) // More acc broadphase - remeber the comma (consider doing ifndef)
-				broadphase(corner1, corner2, 16384)
+				broadphase(corner1, corner2, 16384),
 	#endif // Broadphase
 #else
 			broadphase(corner1, corner2, 16384),
-			solver(&mlcp)
+			solver(&mlcp),
 #endif //MLCP_SOLVER  
+			pSolver(&solver)
 			
   {
 	  broadphase.getOverlappingPairCache()->setInternalGhostPairCallback(&ghostCallback);
+	  
+	  // One more solver of the same kind per thread
+	  if (config.solverThreads > 1)
+	  {
+		  std::vector<btConstraintSolver*> solvers;
+		  for (int i = 0; i < config.solverThreads; i++)
+		  {
+#ifdef MLCP_SOLVER
+			  islandMlcp.push_back(new btDantzigSolver());
+			  solvers.push_back(new btMLCPSolver(islandMlcp.back()));
+#else
+			  solvers.push_back(new btSequentialImpulseConstraintSolver());
+#endif
+		  }
+		  pSolver = new tgIslandParallelSolver(solvers);
+	  }
+  }
+  
+  ~IntermediateBuildProducts()
+  {
+	  if (pSolver != &solver)
+	  {
+		  delete pSolver;
+	  }
+#ifdef MLCP_SOLVER
+	  for (std::size_t i = 0; i < islandMlcp.size(); i++)
+	  {
+		  delete islandMlcp[i];
+	  }
+#endif
   }
+  
   const btVector3 corner1;
   const btVector3 corner2;
   btSoftBodyRigidBodyCollisionConfiguration collisionConfiguration;
@@ -105,16 +140,20 @@ class IntermediateBuildProducts
 		btDantzigSolver mlcp;
         //btSolveProjectedGaussSeidel mlcp;
 		btMLCPSolver solver;
+		/** The MLCP solvers of the island solver's threads */
+		std::vector<btDantzigSolver*> islandMlcp;
 #else
 		btSequentialImpulseConstraintSolver solver;
 #endif
+		/** The solver in use: solver, or a tgIslandParallelSolver */
+		btConstraintSolver* pSolver;
 	
 };
 
 tgWorldBulletPhysicsImpl::tgWorldBulletPhysicsImpl(const tgWorld::Config& config,
         tgBulletGround* ground) :
     tgWorldImpl(config, ground),
-    m_pIntermediateBuildProducts(new IntermediateBuildProducts(config.worldSize)),
+    m_pIntermediateBuildProducts(new IntermediateBuildProducts(config)),
     m_pDynamicsWorld(createDynamicsWorld())
 {
 
@@ -198,11 +237,16 @@ btDynamicsWorld* tgWorldBulletPhysicsImpl::createDynamicsWorld() const
   btSoftRigidDynamicsWorld* const result =
     new btSoftRigidDynamicsWorld(&m_pIntermediateBuildProducts->dispatcher,
                  &m_pIntermediateBuildProducts->broadphase,
-                 &m_pIntermediateBuildProducts->solver, 
+                 m_pIntermediateBuildProducts->pSolver, 
                  &m_pIntermediateBuildProducts->collisionConfiguration);
 #ifdef MLCPSOLVER	
 		result ->getSolverInfo().m_minimumSolverBatchSize = 1;//for direct solver it is better to have a small A matrix
 #endif	
+  // Hand each island over on its own so they can be spread over threads
+  if (m_pIntermediateBuildProducts->pSolver != &m_pIntermediateBuildProducts->solver)
+  {
+    result->getSolverInfo().m_minimumSolverBatchSize = 1;
+  }
   return result;
 }
 
@@ -220,6 +264,58 @@ void tgWorldBulletPhysicsImpl::step(double dt)
     assert(invariant());
 }
 
+void tgWorldBulletPhysicsImpl::clearContacts()
+{
+    btCollisionObjectArray& objects =
+        m_pDynamicsWorld->getCollisionObjectArray();
+    const int n = objects.size();
+    std::vector<btCollisionObject*> order(n);
+    std::vector<short> groups(n);
+    std::vector<short> masks(n);
+    std::vector<btVector3> gravities(n);
+    for (int i = 0; i < n; i++)
+    {
+        order[i] = objects[i];
+        groups[i] = objects[i]->getBroadphaseHandle()->m_collisionFilterGroup;
+        masks[i] = objects[i]->getBroadphaseHandle()->m_collisionFilterMask;
+        const btRigidBody* const pBody = btRigidBody::upcast(objects[i]);
+        if (pBody)
+        {
+            gravities[i] = pBody->getGravity();
+        }
+    }
+
+    // Removing a proxy drops its pairs, and with them their manifolds
+    for (int i = n - 1; i >= 0; --i)
+    {
+        m_pDynamicsWorld->removeCollisionObject(order[i]);
+    }
+    // With no proxies left, the broadphase starts its handles over
+    m_pDynamicsWorld->getBroadphase()->resetPool(
+        m_pDynamicsWorld->getDispatcher());
+    m_pDynamicsWorld->getConstraintSolver()->reset();
+
+    for (int i = 0; i < n; i++)
+    {
+        btRigidBody* const pBody = btRigidBody::upcast(order[i]);
+        if (pBody)
+        {
+            m_pDynamicsWorld->addRigidBody(pBody, groups[i], masks[i]);
+            // Adding sets the world's gravity; keep any the model set
+            pBody->setGravity(gravities[i]);
+        }
+        else
+        {
+            m_pDynamicsWorld->addCollisionObject(order[i], groups[i],
+                                                 masks[i]);
+        }
+    }
+
+    // Postcondition
+    assert(invariant());
+    assert(m_pDynamicsWorld->getNumCollisionObjects() == n);
+}
+
 void tgWorldBulletPhysicsImpl::addCollisionShape(btCollisionShape* pShape)
 {
 #ifndef BT_NO_PROFILE 
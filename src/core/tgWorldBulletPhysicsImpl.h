@@ -73,6 +73,16 @@ class tgWorldBulletPhysicsImpl : public tgWorldImpl
    */
   virtual void step(double dt);
 
+  /**
+   * Forget every contact, as if the world had just been built with its
+   * bodies where they now are. Takes every collision object out and
+   * puts it back in the same order, so that the broadphase hands out
+   * the same proxies and pairs, in the same order, as a new world, and
+   * resets the solver's random seed. Stepping on from the same state is
+   * then repeatable.
+   */
+  virtual void clearContacts();
+
   /**
    * Return a reference to the dynamics world.
    * @return a reference to the dynamics world
@@ -55,6 +55,12 @@ public:
    * must be positive
    */
   virtual void step(double dt) = 0;
+
+  /**
+   * Forget every contact, as if the world had just been built with its
+   * bodies where they now are.
+   */
+  virtual void clearContacts() = 0;
 };
 
 
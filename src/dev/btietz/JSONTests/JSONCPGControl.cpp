@@ -373,6 +373,11 @@ const double JSONCPGControl::getCPGValue(std::size_t i) const
 	return (*m_pCPGSys)[i];
 }
 
+std::size_t JSONCPGControl::getCPGNodeCount() const
+{
+	return (m_pCPGSys != NULL) ? m_pCPGSys->getNodeCount() : 0;
+}
+
 double JSONCPGControl::getScore() const
 {
 	if (scores.size() == 2)
@@ -123,6 +123,20 @@ struct Config
 
 	const double getCPGValue(std::size_t i) const;
 	
+	/**
+	 * The number of CPG nodes; 0 between trials, when there is no CPG
+	 */
+	std::size_t getCPGNodeCount() const;
+	
+	/**
+	 * The CPG of the current trial, for its state arrays
+	 * (CPGEquations::getPhases() etc.), or NULL between trials
+	 */
+	const CPGEquations* getCPGSys() const
+	{
+		return m_pCPGSys;
+	}
+	
 	double getScore() const;
 	
 protected:
@@ -26,17 +26,20 @@
 #include "tgCPGJSONLogger.h"
 
 #include "JSONCPGControl.h"
+#include "util/CPGEquations.h"
 
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <vector>
 
 /**
  * Construct our data logger
  */
 tgCPGJSONLogger::tgCPGJSONLogger(std::string fileName) :
 time (0.0),
-m_fileName(fileName)
+m_fileName(fileName),
+m_output(fileName.c_str(), std::ios::app)
 {
 }
 
@@ -48,30 +51,17 @@ void tgCPGJSONLogger::onStep(JSONCPGControl& subject, double dt)
 {
 	time += dt;
 	
-      // Then, open our output stream and render!
-      std::ofstream tgOutput;
-      tgOutput.open(m_fileName.c_str(), std::ios::app);
+	m_output << time << ",";
 	
-	tgOutput << time << ",";
-	
-	bool runLoop = true;
-	std::size_t i = 0;
-	
-	while (runLoop)
+	const CPGEquations* const pCPGs = subject.getCPGSys();
+	if (pCPGs != NULL)
 	{
-		// Don't know how many nodes are in CPG, so just try until we fail
-	  try 
-	  {
-        tgOutput << subject.getCPGValue(i) << ",";
-        i++;
-	  }
-	  catch (std::invalid_argument e)
-	  {
-		// Got the error we expected, end the loop
-		tgOutput << std::endl;
-		runLoop = false;
-	  }
+		const std::vector<double>& values = pCPGs->getOutputs();
+		for (std::size_t i = 0; i < values.size(); i++)
+		{
+			m_output << values[i] << ",";
+		}
 	}
-	
-	tgOutput.close();
+	// Buffered; the stream is flushed when the logger is destroyed
+	m_output << '\n';
 }
@@ -29,6 +29,7 @@
 
 // This library
 #include "core/tgObserver.h"
+#include <fstream>
 #include <string>
 
 // Forward declarations
@@ -42,7 +43,7 @@ class tgCPGJSONLogger : public tgObserver <JSONCPGControl>
     
 public:
 
-  /** Constructor
+  /** Constructor. Opens the file, appending
    * @param[in[ fileName, the filename where the data is logged
    */
   tgCPGJSONLogger (std::string fileName);
@@ -55,6 +56,7 @@ public:
 private:
 	double time;
 	std::string m_fileName;
+	std::ofstream m_output;
 
 };
 
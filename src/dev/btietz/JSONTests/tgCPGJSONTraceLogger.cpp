@@ -0,0 +1,56 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgCPGJSONTraceLogger.cpp
+ * @brief Contains the implementation of class tgCPGJSONTraceLogger.
+ * $Id$
+ */
+
+#include "tgCPGJSONTraceLogger.h"
+
+#include "JSONCPGControl.h"
+#include "util/CPGEquations.h"
+
+tgCPGJSONTraceLogger::tgCPGJSONTraceLogger(const std::string& fileName) :
+time (0.0),
+m_trace(fileName),
+m_pLastCPGs(NULL),
+m_lastUpdate(0)
+{
+}
+
+tgCPGJSONTraceLogger::~tgCPGJSONTraceLogger()
+{ }
+
+void tgCPGJSONTraceLogger::onStep(JSONCPGControl& subject, double dt)
+{
+	time += dt;
+	
+	const CPGEquations* const pCPGs = subject.getCPGSys();
+	if (pCPGs == NULL)
+	{
+		return;
+	}
+	if ((pCPGs != m_pLastCPGs) || (pCPGs->getUpdateCount() != m_lastUpdate))
+	{
+		m_trace.record(time, *pCPGs);
+		m_pLastCPGs = pCPGs;
+		m_lastUpdate = pCPGs->getUpdateCount();
+	}
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_CPGJSON_TRACE_LOGGER_H
+#define TG_CPGJSON_TRACE_LOGGER_H
+
+/**
+ * @file tgCPGJSONTraceLogger.h
+ * @brief Contains the definition of class tgCPGJSONTraceLogger
+ * $Id$
+ */
+
+
+// This library
+#include "core/tgObserver.h"
+#include "util/CPGTraceLogger.h"
+#include <cstddef>
+#include <string>
+
+// Forward declarations
+class CPGEquations;
+class JSONCPGControl;
+
+/**
+ * Logs the phases, amplitudes and outputs of a JSONCPGControl's CPG in
+ * binary (see CPGTraceLogger), once per control tick rather than once
+ * per physics step.
+ */
+class tgCPGJSONTraceLogger : public tgObserver <JSONCPGControl>
+{
+    
+public:
+
+  /** Constructor
+   * @param[in] fileName, the file to log to; replaced
+   */
+  tgCPGJSONTraceLogger (const std::string& fileName);
+
+  virtual ~tgCPGJSONTraceLogger ();
+
+  /** Records the CPG if it was updated since the last step */
+  virtual void onStep(JSONCPGControl& subject, double dt);
+  
+private:
+	double time;
+	CPGTraceLogger m_trace;
+
+	/** The CPG and update last recorded; a new trial has a new CPG */
+	const CPGEquations* m_pLastCPGs;
+	std::size_t m_lastUpdate;
+};
+
+#endif
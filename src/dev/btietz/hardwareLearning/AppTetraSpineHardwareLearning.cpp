@@ -31,6 +31,7 @@
 #include "LearningSpineJSON.h"
 // This library
 #include "core/tgModel.h"
+#include "core/tgRealTimePacer.h"
 #include "core/tgSimView.h"
 #include "core/tgSimViewGraphics.h"
 #include "core/tgSimulation.h"
@@ -89,10 +90,19 @@ int main(int argc, char** argv)
     
     simulation.addModel(myModel);
     
+    // Keep time with the hardware: late steps catch up, so the controller
+    // sees as much simulated time as the robot has had
+    view.setRealTime(tgRealTimePacer::Config());
+    
     int i = 0;
     while (i < 1)
     {
         simulation.run(60000);
+        const tgRealTimePacer::Statistics& stats =
+            view.getRealTimePacer()->getStatistics();
+        std::cout << "Deadline misses: " << stats.misses << " of "
+                  << stats.steps << " steps, RMS jitter "
+                  << stats.getRmsJitter() << " s" << std::endl;
         simulation.reset();
         i++;
     }
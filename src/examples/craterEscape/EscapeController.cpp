@@ -52,10 +52,13 @@ EscapeController::EscapeController(const double initialLength,
                                     std::string resourcePath,
                                     std::string config) :
     m_initialLengths(initialLength),
-    m_totalTime(0.0),
     maxStringLengthFactor(0.50),
     nClusters(8),
     musclesPerCluster(3),
+    // Lengths are clamped to maxStringLengthFactor of the initial length
+    m_oscillators(tgOscillatorBank::Config(1000,
+                                           initialLength * (1 - maxStringLengthFactor),
+                                           initialLength * (1 + maxStringLengthFactor))),
     suffix(args),
     configPath(resourcePath),
     configName(config)
@@ -69,7 +72,6 @@ EscapeController::EscapeController(const double initialLength,
 /** Set the lengths of the muscles and initialize the learning adapter */
 void EscapeController::onSetup(EscapeModel& subject)
 {
-    m_totalTime = 0;
     double dt = 0.0001;
 
     //Set the initial length of every muscle in the subject
@@ -95,6 +97,7 @@ void EscapeController::onSetup(EscapeModel& subject)
 
     //apply these actions to the appropriate muscles according to the sensor values
     applyActions(subject,actions);
+    initializeOscillators(subject);
 }
 
 void EscapeController::onStep(EscapeModel& subject, double dt)
@@ -102,9 +105,10 @@ void EscapeController::onStep(EscapeModel& subject, double dt)
     if (dt <= 0.0) {
         throw std::invalid_argument("dt is not positive");
     }
-    m_totalTime+=dt;
 
-    setPreferredMuscleLengths(subject, dt);
+    // Set target lengths for each muscle
+    m_oscillators.step(dt);
+    m_oscillators.apply(m_sineMuscles, dt);
     const std::vector<tgBasicActuator*> muscles = subject.getAllMuscles();
     
     //Move motors for all the muscles
@@ -240,21 +244,23 @@ double EscapeController::totalEnergySpent(EscapeModel& subject) {
     return totalEnergySpent;
 }
 
-// Pre-condition: every element in muscles must be defined
-// Post-condition: every muscle will have a new target length
-void EscapeController::setPreferredMuscleLengths(EscapeModel& subject, double dt) {
+// Pre-condition: the sine wave parameters are set (see applyActions)
+// Post-condition: m_oscillators has one channel per muscle
+void EscapeController::initializeOscillators(EscapeModel& subject) {
     double phase = 0; // Phase of cluster1
     
     int nMuscles = 24;
     int oldCluster = 0;
     int cluster = 0;
 
-    for(int iMuscle=0; iMuscle < nMuscles; iMuscle++) {
+    const std::vector<tgBasicActuator*> muscles = subject.getAllMuscles();
+    assert(muscles.size() >= static_cast<std::size_t>(nMuscles));
+    m_sineMuscles.assign(muscles.begin(), muscles.begin() + nMuscles);
 
-        const std::vector<tgBasicActuator*> muscles = subject.getAllMuscles();
-        tgBasicActuator *const pMuscle = muscles[iMuscle];
+    m_oscillators.clear();
+    for(int iMuscle=0; iMuscle < nMuscles; iMuscle++) {
 
-        assert(pMuscle != NULL);
+        assert(m_sineMuscles[iMuscle] != NULL);
 
         // Determine cluster
         oldCluster = cluster;
@@ -276,37 +282,14 @@ void EscapeController::setPreferredMuscleLengths(EscapeModel& subject, double dt
             cluster = 7;
         }
 
-        double newLength = amplitude[cluster] * sin(angularFrequency[cluster] * m_totalTime + phase) + dcOffset[cluster];
-        double minLength = m_initialLengths * (1-maxStringLengthFactor);
-        double maxLength = m_initialLengths * (1+maxStringLengthFactor);
-        if (newLength <= minLength) {
-            newLength = minLength;
-        } else if (newLength >= maxLength) {
-            newLength = maxLength;
-        }
-        pMuscle->setControlInput(newLength, dt);
+        m_oscillators.addChannel(amplitude[cluster],
+                                 angularFrequency[cluster],
+                                 phase,
+                                 dcOffset[cluster]);
         if (oldCluster != cluster) {
             phase += phaseChange[cluster];
         }
     }
-
-    /*
-    for(int cluster=0; cluster<nClusters; cluster++) {
-        for(int node=0; node<musclesPerCluster; node++) {
-            tgBasicActuator *const pMuscle = clusters[cluster][node];
-            assert(pMuscle != NULL);
-            double newLength = amplitude[cluster] * sin(angularFrequency[cluster] * m_totalTime + phase) + dcOffset[cluster];
-            double minLength = m_initialLengths * (1-maxStringLengthFactor);
-            double maxLength = m_initialLengths * (1+maxStringLengthFactor);
-            if (newLength <= minLength) {
-                newLength = minLength;
-            } else if (newLength >= maxLength) {
-                newLength = maxLength;
-            }
-            pMuscle->setControlInput(newLength, dt);
-        }
-        phase += phaseChange[cluster];
-    }*/
 }
 
 void EscapeController::populateClusters(EscapeModel& subject) {
@@ -30,6 +30,7 @@
 #include <vector>
 
 #include "core/tgObserver.h"
+#include "controllers/tgOscillatorBank.h"
 #include "learning/Adapters/AnnealAdapter.h"
 #include "learning/Configuration/configuration.h"
 #include "learning/AnnealEvolution/AnnealEvolution.h"
@@ -65,7 +66,6 @@ class EscapeController : public tgObserver<EscapeModel>
     private:
         std::vector<double> initPosition; // Initial position of model
         const double m_initialLengths;
-        double m_totalTime;
         double const maxStringLengthFactor; // Proportion of string's initial length by which a given actuator can increase/decrease
 
         // Evolution and Adapter
@@ -83,6 +83,10 @@ class EscapeController : public tgObserver<EscapeModel>
         double* angularFrequency;
         double* phaseChange;
         double* dcOffset;
+
+        /** One sine wave per muscle in m_sineMuscles, from the above */
+        tgOscillatorBank m_oscillators;
+        std::vector<tgBasicActuator*> m_sineMuscles;
         
         // Configuration strings
         std::string suffix;
@@ -95,8 +99,9 @@ class EscapeController : public tgObserver<EscapeModel>
         /** Returns amount of energy spent by each muscle in subject */
         double totalEnergySpent(EscapeModel& subject);
 
-        /** Sets target lengths for each muscle */
-        void setPreferredMuscleLengths(EscapeModel& subject, double dt);
+        /** Sets up a sine wave for each muscle, from its cluster's
+         * parameters */
+        void initializeOscillators(EscapeModel& subject);
 
         /** Divides the 24 muscles of an EscapeModel 
          * into 8 clusters of 3 muscles */
@@ -347,6 +347,11 @@ const double BaseSpineCPGControl::getCPGValue(std::size_t i) const
 	return (*m_pCPGSys)[i];
 }
 
+std::size_t BaseSpineCPGControl::getCPGNodeCount() const
+{
+	return (m_pCPGSys != NULL) ? m_pCPGSys->getNodeCount() : 0;
+}
+
 double BaseSpineCPGControl::getScore() const
 {
 	if (scores.size() == 2)
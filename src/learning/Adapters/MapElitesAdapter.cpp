@@ -0,0 +1,86 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file MapElitesAdapter.cpp
+ * @brief Contains the implementation of class MapElitesAdapter.
+ * $Id$
+ */
+
+#include <vector>
+#include <iostream>
+#include <stdexcept>
+#include "MapElitesAdapter.h"
+#include "learning/MapElites/MapElites.h"
+#include "learning/Configuration/configuration.h"
+
+using namespace std;
+
+MapElitesAdapter::MapElitesAdapter() :
+mapElites(NULL),
+learning(false),
+totalTime(0.0)
+{
+}
+MapElitesAdapter::~MapElitesAdapter(){};
+
+void MapElitesAdapter::initialize(MapElites *evo,bool isLearning,configuration)
+{
+    this->mapElites = evo;
+    learning = isLearning;
+    totalTime=0.0;
+
+    if(isLearning)
+    {
+        mapElites->nextCandidate(currentGenome);
+    }
+    else
+    {
+        double fitness;
+        if(!mapElites->getBest(currentGenome, fitness))
+        {
+            throw runtime_error("MAP-Elites archive is empty");
+        }
+    }
+}
+
+vector<vector<double> > MapElitesAdapter::step(double deltaTimeSeconds,vector<double>)
+{
+    totalTime+=deltaTimeSeconds;
+    return vector< vector<double> >(1, currentGenome);
+}
+
+void MapElitesAdapter::endEpisode(vector<double> scores)
+{
+    // Replaying an elite doesn't change the archive
+    if(!learning)
+    {
+        return;
+    }
+    if(scores.size()==0)
+    {
+        mapElites->reportFailure();
+        cout<<"Exploded"<<endl;
+    }
+    else
+    {
+        vector<double> descriptor(scores.begin()+1, scores.end());
+        mapElites->report(currentGenome, scores[0], descriptor);
+    }
+    return;
+}
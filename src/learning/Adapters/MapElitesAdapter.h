@@ -0,0 +1,69 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef MAPELITESADAPTER_H_
+#define MAPELITESADAPTER_H_
+
+/**
+ * @file MapElitesAdapter.h
+ * @brief Defines a class MapElitesAdapter to pass parameters from MapElites to a controller.
+ * $Id$
+ */
+
+#include <vector>
+
+class MapElites;
+class configuration;
+
+/**
+ * Passes one candidate from MapElites to a controller per trial, with
+ * the same interface as AnnealAdapter. Use one adapter per simulation,
+ * so trials can run in parallel against a shared MapElites.
+ */
+class MapElitesAdapter
+{
+public:
+    MapElitesAdapter();
+    ~MapElitesAdapter();
+    /**
+     * Initialize needs to be called at the beginning of each trial.
+     * When learning, this takes the next candidate; otherwise it takes
+     * the best elite so far.
+     * @throw std::runtime_error if not learning and the archive is empty
+     */
+    void initialize(MapElites *evo,bool isLearning,configuration config);
+    /**
+     * Returns a single controller, the candidate's parameters scaled
+     * 0.0 to 1.0
+     */
+    std::vector<std::vector<double> > step(double deltaTimeSeconds, std::vector<double> state);
+    /**
+     * Report the trial. scores[0] is the fitness and the rest is the
+     * behavior descriptor, scaled 0.0 to 1.0. An empty vector means the
+     * structure exploded.
+     */
+    void endEpisode(std::vector<double> scores);
+
+private:
+    MapElites *mapElites;
+    std::vector<double> currentGenome;
+    bool learning;
+    double totalTime;
+};
+
+#endif /* MAPELITESADAPTER_H_ */
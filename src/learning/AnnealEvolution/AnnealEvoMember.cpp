@@ -33,14 +33,12 @@
 
 using namespace std;
 
-AnnealEvoMember::AnnealEvoMember(configuration config)
+AnnealEvoMember::AnnealEvoMember(configuration config, double* pParameters) :
+statelessParameters(pParameters, config.getintvalue("numberOfActions"))
 {
     //readConfigFromXML(configFile);
     this->numOutputs=config.getintvalue("numberOfActions");
-    this->devBase=config.getDoubleValue("deviation");
-    this->monteCarlo=config.getintvalue("MonteCarlo");
     
-    statelessParameters.resize(numOutputs);
     for(int i=0;i<numOutputs;i++)
         statelessParameters[i]=rand()*1.0/RAND_MAX;
 
@@ -51,40 +49,6 @@ AnnealEvoMember::~AnnealEvoMember()
 {
 }
 
-void AnnealEvoMember::mutate(std::tr1::ranlux64_base_01 *eng, double T){
-    
-    assert (T <= 1.0);
-    std::tr1::uniform_real<double> unif(0, 1);
-
-    //TODO: for each weight of the NN with 0.5 probability mutate it
-
-    double dev = devBase * T / 100.0; 
-    std::tr1::normal_distribution<double> normal(0, dev);
-    for(std::size_t i=0;i<statelessParameters.size();i++)
-    {
-        double newParam;
-        if (monteCarlo)
-        {
-            newParam= unif(*eng);
-        }
-        else
-        {   
-            double mutAmount = normal(*eng);
-              //std::cout<<"param: "<<i<<" dev: "<<dev<<" rand: "<<mutAmount<<endl;
-            newParam= statelessParameters[i] + mutAmount;
-        }
-
-        if(newParam < 0.0)
-            statelessParameters[i] = 0.0;
-        else if(newParam > 1.0)
-            statelessParameters[i] = 1.0;
-        else
-            statelessParameters[i] =newParam;
-    }
-
-
-}
-
 void AnnealEvoMember::copyFrom(AnnealEvoMember* otherMember)
 {
 
@@ -30,22 +30,29 @@
 
 #include <string>
 #include <vector>
-#include <tr1/random>
 #include "learning/Configuration/configuration.h"
+#include "learning/Genome/GenomeRow.h"
 
 
 class AnnealEvoMember
 {
 public:
-    AnnealEvoMember(configuration config);
+    /**
+     * @param[in] pParameters this member's row of its population's
+     * GenomeMatrix, numberOfActions long; filled with random values here
+     */
+    AnnealEvoMember(configuration config, double* pParameters);
     ~AnnealEvoMember();
-    void mutate(std::tr1::ranlux64_base_01 *eng, double T);
 
     void copyFrom(AnnealEvoMember *otherMember);
     void saveToFile(const char* outputFilename);
     void loadFromFile(const char* inputFilename);
 
-    std::vector<double> statelessParameters;
+    /**
+     * A view of this member's row of the population's GenomeMatrix,
+     * which mutates it
+     */
+    GenomeRow statelessParameters;
     //scores for evaluation
     std::vector<double> pastScores;
     double maxScore;
@@ -55,8 +62,6 @@ public:
 
 private:
     int numOutputs;
-    double devBase;
-    bool monteCarlo;
 };
 
 
@@ -32,53 +32,59 @@
 #include <numeric>
 #include <fstream>
 #include <algorithm>
+#include <cassert>
 
 using namespace std;
 
-AnnealEvoPopulation::AnnealEvoPopulation(int populationSize,configuration config)
+AnnealEvoPopulation::AnnealEvoPopulation(int populationSize,configuration config,
+                                         unsigned long long seed) :
+genomes(populationSize, config.getintvalue("numberOfActions"), seed)
 {
     compareAverageScores=true;
     clearScoresBetweenGenerations=false;
     this->compareAverageScores=config.getintvalue("compareAverageScores");
     this->clearScoresBetweenGenerations=config.getintvalue("clearScoresBetweenGenerations");
+    this->devBase=config.getDoubleValue("deviation");
+    this->monteCarlo=config.getintvalue("MonteCarlo");
 
     for(int i=0;i<populationSize;i++)
     {
         //cout<<"  creating members"<<endl;
-        controllers.push_back(new AnnealEvoMember(config));
+        members.push_back(new AnnealEvoMember(config, genomes.row(i)));
     }
+    controllers = members;
 }
 
 AnnealEvoPopulation::~AnnealEvoPopulation()
 {
-    for(std::size_t i=0;i<controllers.size();i++)
+    for(std::size_t i=0;i<members.size();i++)
     {
-        delete controllers[i];
+        delete members[i];
     }
 }
 
-void AnnealEvoPopulation::mutate(std::tr1::ranlux64_base_01 *engPntr,std::size_t numMutate, double T)
+void AnnealEvoPopulation::mutate(std::size_t numMutate, double T)
 {
+    assert (T <= 1.0);
+    const std::vector<std::size_t>& order = genomes.getOrder();
+    const double dev = devBase * T / 100.0;
     for(std::size_t i=0;i<numMutate;i++)
     {
-        int copyFrom = 0; // Always copy from the best
-        int copyTo = this->controllers.size()-1-i;
-        controllers.at(copyTo)->copyFrom(controllers.at(copyFrom));
-        controllers.at(copyTo)->mutate(engPntr, T);
+        const std::size_t copyFrom = order[0]; // Always copy from the best
+        const std::size_t copyTo = order[order.size()-1-i];
+        if (monteCarlo)
+        {
+            genomes.mutateUniform(copyTo);
+        }
+        else
+        {
+            genomes.copyRow(copyFrom, copyTo);
+            genomes.mutate(copyTo, dev);
+        }
     }
-    return;
+    genomes.advance();
 }
 
-bool AnnealEvoPopulation::comparisonFuncForAverage(AnnealEvoMember * elm1, AnnealEvoMember * elm2)
-{
-        return elm1->averageScore > elm2->averageScore;
-}
-bool AnnealEvoPopulation::comparisonFuncForMax(AnnealEvoMember * elm1, AnnealEvoMember * elm2)
-{
-    return elm1->maxScore > elm2->maxScore;
-}
-
-
 void AnnealEvoPopulation::orderPopulation()
 {
     //calculate each member's average score
@@ -91,11 +97,17 @@ void AnnealEvoPopulation::orderPopulation()
             controllers[i]->pastScores.clear();
     }
 //  cout<<"ordering the whole population"<<endl;
-    if(compareAverageScores)
-        sort(controllers.begin(),controllers.end(),this->comparisonFuncForAverage);
-    else
-        sort(controllers.begin(),controllers.end(),this->comparisonFuncForMax);
-
+    // Rank the rows; the members follow their rows
+    std::vector<double> scores(members.size());
+    for(std::size_t i=0;i<members.size();i++)
+    {
+        scores[i] = compareAverageScores ? members[i]->averageScore : members[i]->maxScore;
+    }
+    genomes.order(scores);
+    for(std::size_t k=0;k<members.size();k++)
+    {
+        controllers[k] = members[genomes.getOrder()[k]];
+    }
 }
 
 void AnnealEvoPopulation::readConfigFromXML(std::string configFile)
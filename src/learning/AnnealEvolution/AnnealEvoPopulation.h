@@ -29,25 +29,43 @@
  */
 
 #include "AnnealEvoMember.h"
+#include "learning/Genome/GenomeMatrix.h"
 #include <vector>
 
+/**
+ * The members' parameters live in one GenomeMatrix, a row each. The
+ * matrix ranks the rows and mutates them in place with its counter-based
+ * generator; controllers is the members in that rank.
+ */
 class AnnealEvoPopulation {
 public:
-    AnnealEvoPopulation(int numControllers,configuration config);
+    /**
+     * @param[in] seed selects the random stream of the mutations
+     */
+    AnnealEvoPopulation(int numControllers, configuration config,
+                        unsigned long long seed);
     ~AnnealEvoPopulation();
+    /** The members, best first as of the last orderPopulation() */
     std::vector<AnnealEvoMember *> controllers;
-    void mutate(std::tr1::ranlux64_base_01 *eng,std::size_t numToMutate, double T);
+    /**
+     * Overwrite the worst numToMutate members with mutated copies of the
+     * best, with a deviation that shrinks with the temperature T.
+     */
+    void mutate(std::size_t numToMutate, double T);
     void orderPopulation();
     AnnealEvoMember * selectMemberToEvaluate();
     AnnealEvoMember * getMember(int i){return controllers[i];};
 
 private:
-    static bool comparisonFuncForAverage(AnnealEvoMember * elm1, AnnealEvoMember * elm2);
-    static bool comparisonFuncForMax(AnnealEvoMember * elm1, AnnealEvoMember * elm2);
     void readConfigFromXML(std::string configFile);
     bool compareAverageScores;
     bool clearScoresBetweenGenerations;
     int populationSize;
+    double devBase;
+    bool monteCarlo;
+    GenomeMatrix genomes;
+    /** The members by row of genomes */
+    std::vector<AnnealEvoMember *> members;
 };
 
 
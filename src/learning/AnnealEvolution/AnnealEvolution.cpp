@@ -82,6 +82,7 @@ Temp(1.0)
     leniencyCoef=myconfigdataaa.getDoubleValue("leniencyCoef");
     coevolution=myconfigdataaa.getintvalue("coevolution");
     seeded = myconfigdataaa.getintvalue("startSeed");
+    surrogate = new FitnessSurrogate(FitnessSurrogate::Config(myconfigdataaa));
     
     bool learning = myconfigdataaa.getintvalue("learning");
 
@@ -90,7 +91,7 @@ Temp(1.0)
 
     for(int j=0;j<numberOfControllers;j++)
     {
-        populations.push_back(new AnnealEvoPopulation(populationSize,myconfigdataaa));
+        populations.push_back(new AnnealEvoPopulation(populationSize,myconfigdataaa,rdtsc()));
     }
     
     // Overwrite the random parameters based on data
@@ -116,6 +117,7 @@ Temp(1.0)
 
 AnnealEvolution::~AnnealEvolution()
 {
+    delete surrogate;
     // @todo - solve the invalid pointer that occurs here
     #if (0)
     for(std::size_t i = 0; i < populations.size(); i++)
@@ -130,7 +132,7 @@ void AnnealEvolution::mutateEveryController()
 {
     for(std::size_t i=0;i<populations.size();i++)
     {
-        populations.at(i)->mutate(&eng,numberOfElementsToMutate, Temp);
+        populations.at(i)->mutate(numberOfElementsToMutate, Temp);
     }
 }
 
@@ -192,18 +194,27 @@ vector <AnnealEvoMember *> AnnealEvolution::nextSetOfControllers()
     else
         testsToDo=populationSize; //stop when we test each element once
 
-    if(currentTest == testsToDo)
+    // Skip at most a generation's worth of hopeless candidates per trial
+    int skipped = 0;
+    while(true)
     {
-        orderAllPopulations();
-        mutateEveryController();
-        Temp -= 0.0; // @todo - make this a parameter
-//        cout<<"mutated the populations"<<endl;
-        this->scoresOfTheGeneration.clear();
+        if(currentTest == testsToDo)
+        {
+            orderAllPopulations();
+            mutateEveryController();
+            Temp -= 0.0; // @todo - make this a parameter
+//            cout<<"mutated the populations"<<endl;
+            this->scoresOfTheGeneration.clear();
 
-        if(coevolution)
-            currentTest=0;//Start from 0
-        else
-            currentTest=populationSize-numberOfElementsToMutate; //start from the mutated ones only (last x)
+            if(coevolution)
+                currentTest=0;//Start from 0
+            else
+                currentTest=populationSize-numberOfElementsToMutate; //start from the mutated ones only (last x)
+        }
+        if(coevolution || subTests != 0 || skipped == testsToDo || !skipHopeless(currentTest))
+            break;
+        currentTest++;
+        skipped++;
     }
 
     selectedControllers.clear();
@@ -238,6 +249,14 @@ void AnnealEvolution::updateScores(vector <double> multiscore)
     else
         multiscore.push_back(-1.0);
     double score=1.0* multiscore[0] - 0.0 * multiscore[1];
+    if(surrogate->isEnabled())
+    {
+        const vector<double> parameters = parametersOf(selectedControllers);
+        if(!parameters.empty())
+        {
+            surrogate->add(parameters, score);
+        }
+    }
     
     //Record it to the file
     ofstream payloadLog;
@@ -272,3 +291,41 @@ void AnnealEvolution::updateScores(vector <double> multiscore)
     payloadLog.close();
     return;
 }
+
+vector<double> AnnealEvolution::parametersOf(const vector<AnnealEvoMember *>& members)
+{
+    vector<double> parameters;
+    for(std::size_t i=0;i<members.size();i++)
+    {
+        parameters.insert(parameters.end(),
+                members[i]->statelessParameters.begin(),
+                members[i]->statelessParameters.end());
+    }
+    return parameters;
+}
+
+bool AnnealEvolution::skipHopeless(int memberIndex)
+{
+    if(!surrogate->isEnabled())
+        return false;
+
+    vector<AnnealEvoMember *> members;
+    for(std::size_t i=0;i<populations.size();i++)
+        members.push_back(populations.at(i)->getMember(memberIndex));
+    // Neural network weights aren't modelled
+    const vector<double> parameters = parametersOf(members);
+    double predicted = 0.0;
+    if(parameters.empty() || !surrogate->shouldSkip(parameters, &eng, predicted))
+        return false;
+
+    // Score it as if it had been simulated, so ordering drops it
+    for(std::size_t i=0;i<members.size();i++)
+    {
+        members[i]->pastScores.push_back(predicted);
+        if(members[i]->maxScore>predicted)
+            members[i]->maxScore=leniencyCoef * members[i]->maxScore + (1.0 - leniencyCoef) * predicted;
+        else
+            members[i]->maxScore=predicted;
+    }
+    return true;
+}
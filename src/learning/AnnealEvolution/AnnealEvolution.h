@@ -30,6 +30,7 @@
 
 #include "AnnealEvoPopulation.h"
 #include "AnnealEvoMember.h"
+#include "learning/Surrogate/FitnessSurrogate.h"
 #include <fstream>
 #include <boost/iterator/iterator_concepts.hpp>
 
@@ -68,6 +69,10 @@ private:
     int numberOfElementsToMutate;
     int numberOfSubtests;
     int subTests;
+    /// Skips candidates predicted to be hopeless; off unless configured
+    FitnessSurrogate* surrogate;
+    std::vector<double> parametersOf(const std::vector<AnnealEvoMember *>& members);
+    bool skipHopeless(int memberIndex);
 };
 
 #endif /* ANNEALEVOLUTION_H_ */
@@ -0,0 +1,221 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file GenomeMatrix.cpp
+ * @brief Contains the implementation of class GenomeMatrix
+ * $Id$
+ */
+
+#include "GenomeMatrix.h"
+
+// The C++ Standard Library
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <stdexcept>
+
+namespace
+{
+    /**
+     * SplitMix64's output function: a counter-based generator that
+     * hashes its position in the stream instead of updating a state
+     */
+    unsigned long long mix(unsigned long long x)
+    {
+        x += 0x9E3779B97F4A7C15ULL;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        return x ^ (x >> 31);
+    }
+
+    double clamp01(double x)
+    {
+        return std::max(0.0, std::min(1.0, x));
+    }
+
+    /** Sorts storage indexes by score, highest first */
+    class ByScore
+    {
+    public:
+        ByScore(const std::vector<double>& scores) : m_scores(scores) { }
+
+        bool operator()(std::size_t a, std::size_t b) const
+        {
+            return m_scores[a] > m_scores[b];
+        }
+
+    private:
+        const std::vector<double>& m_scores;
+    };
+
+    const double twoPi = 6.283185307179586;
+}
+
+GenomeMatrix::GenomeMatrix(std::size_t rows, std::size_t columns,
+                           unsigned long long seed) :
+m_rows(rows),
+m_columns(columns),
+m_stride(std::max<std::size_t>(columns, 2)),
+m_seed(mix(seed)),
+m_generation(0),
+m_data(rows * columns, 0.0),
+m_order(rows)
+{
+    if (rows == 0)
+    {
+        throw std::invalid_argument("GenomeMatrix has no rows");
+    }
+    else if (columns == 0)
+    {
+        throw std::invalid_argument("GenomeMatrix has no columns");
+    }
+    for (std::size_t r = 0; r < rows; r++)
+    {
+        m_order[r] = r;
+    }
+}
+
+double GenomeMatrix::random(std::size_t r, std::size_t c, Stream stream) const
+{
+    assert(c < m_stride);
+    const unsigned long long counter =
+        ((m_generation * m_rows + r) * eStreamCount + stream) * m_stride + c;
+    // The top 53 bits, as a double in [0, 1)
+    return (mix(m_seed ^ mix(counter)) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+void GenomeMatrix::randomize()
+{
+    for (std::size_t r = 0; r < m_rows; r++)
+    {
+        double* const p = row(r);
+        for (std::size_t c = 0; c < m_columns; c++)
+        {
+            p[c] = random(r, c, eInitial);
+        }
+    }
+}
+
+void GenomeMatrix::order(const std::vector<double>& scores)
+{
+    if (scores.size() != m_rows)
+    {
+        throw std::invalid_argument("Need one score per row");
+    }
+    for (std::size_t r = 0; r < m_rows; r++)
+    {
+        m_order[r] = r;
+    }
+    std::stable_sort(m_order.begin(), m_order.end(), ByScore(scores));
+}
+
+void GenomeMatrix::copyRow(std::size_t from, std::size_t to)
+{
+    std::copy(row(from), row(from) + m_columns, row(to));
+}
+
+void GenomeMatrix::mutate(std::size_t r, double sigma, double rate)
+{
+    double* const p = row(r);
+    for (std::size_t c = 0; c < m_columns; c++)
+    {
+        // Box-Muller; 1 - u is in (0, 1] so the log is finite
+        const double u1 = 1.0 - random(r, c, eMutateNormal1);
+        const double u2 = random(r, c, eMutateNormal2);
+        const double noise =
+            std::sqrt(-2.0 * std::log(u1)) * std::cos(twoPi * u2);
+        const double gate = (random(r, c, eMutateGate) < rate) ? 1.0 : 0.0;
+        p[c] = clamp01(p[c] + gate * sigma * noise);
+    }
+}
+
+void GenomeMatrix::mutateUniform(std::size_t r, double rate)
+{
+    double* const p = row(r);
+    for (std::size_t c = 0; c < m_columns; c++)
+    {
+        const double value = random(r, c, eUniform);
+        p[c] = (random(r, c, eMutateGate) < rate) ? value : p[c];
+    }
+}
+
+void GenomeMatrix::crossover(std::size_t a, std::size_t b, std::size_t to)
+{
+    const double* const pA = row(a);
+    const double* const pB = row(b);
+    double* const p = row(to);
+    for (std::size_t c = 0; c < m_columns; c++)
+    {
+        p[c] = (random(to, c, eCrossover) < 0.5) ? pA[c] : pB[c];
+    }
+}
+
+void GenomeMatrix::advance()
+{
+    m_generation++;
+}
+
+std::size_t GenomeMatrix::select(double u, std::size_t survivors) const
+{
+    // Rank k has weight survivors - k. Invert the cumulative weight
+    // k * (s + 1/2) - k^2 / 2 at u times the total.
+    const double s = static_cast<double>(survivors);
+    const double x = u * s * (s + 1.0) / 2.0;
+    const double b = s + 0.5;
+    const double k = std::floor(b - std::sqrt(std::max(0.0, b * b - 2.0 * x)));
+    const std::size_t rank = (k < 0.0) ? 0 : static_cast<std::size_t>(k);
+    return m_order[std::min(rank, survivors - 1)];
+}
+
+void GenomeMatrix::nextGeneration(std::size_t numToMutate,
+                                  std::size_t numToCombine,
+                                  double sigma, double rate)
+{
+    const std::size_t replaced = numToMutate + numToCombine;
+    if (replaced >= m_rows ||
+        (numToCombine > 0 && m_rows - replaced < 2))
+    {
+        throw std::invalid_argument("Too few genomes would survive");
+    }
+    const std::size_t survivors = m_rows - replaced;
+
+    // The survivors' rows are never written, so each child can be made
+    // independently
+    for (std::size_t i = 0; i < replaced; i++)
+    {
+        const std::size_t to = m_order[m_rows - 1 - i];
+        const std::size_t a = select(random(to, 0, eSelect), survivors);
+        if (i < numToCombine)
+        {
+            std::size_t b = select(random(to, 1, eSelect), survivors);
+            if (b == a)
+            {
+                // Another parent, as in combineAndMutate
+                b = (a == m_order[0]) ? m_order[1] : m_order[0];
+            }
+            crossover(a, b, to);
+        }
+        else
+        {
+            copyRow(a, to);
+            mutate(to, sigma, rate);
+        }
+    }
+    advance();
+}
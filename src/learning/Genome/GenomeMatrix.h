@@ -0,0 +1,192 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef GENOMEMATRIX_H_
+#define GENOMEMATRIX_H_
+
+/**
+ * @file GenomeMatrix.h
+ * @brief Contains the definition of class GenomeMatrix, a population of
+ * parameter vectors in one block of memory
+ * $Id$
+ */
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * A population of genomes of parameters in [0, 1], stored as one
+ * row-major matrix instead of a member object per genome, so the
+ * variation operators are tight loops over contiguous rows.
+ *
+ * Ranking is a permutation of row indexes: order() sorts the
+ * permutation by score and leaves the rows where they are, and
+ * nextGeneration() overwrites the worst ranked rows in place, so
+ * turnover costs no allocation or copying of survivors.
+ *
+ * Random numbers come from a counter-based generator: each draw is a
+ * hash of the seed, generation, row, column and purpose. A row's
+ * offspring are the same whatever order rows are processed in, so the
+ * kernels can be split across threads without changing the result.
+ * Populations that vary rows themselves call advance() once a
+ * generation, so the next one draws fresh numbers.
+ */
+class GenomeMatrix
+{
+public:
+
+    /**
+     * @param[in] rows the population size; must be positive
+     * @param[in] columns the parameters per genome; must be positive
+     * @param[in] seed selects the random stream
+     * @throw std::invalid_argument if a size is zero
+     */
+    GenomeMatrix(std::size_t rows, std::size_t columns,
+                 unsigned long long seed = 1);
+
+    std::size_t rows() const
+    {
+        return m_rows;
+    }
+
+    std::size_t columns() const
+    {
+        return m_columns;
+    }
+
+    /** A row by storage index */
+    double* row(std::size_t r)
+    {
+        return &m_data[r * m_columns];
+    }
+
+    const double* row(std::size_t r) const
+    {
+        return &m_data[r * m_columns];
+    }
+
+    /** The row of the k-th best genome, as of the last order() */
+    double* ranked(std::size_t k)
+    {
+        return row(m_order[k]);
+    }
+
+    const double* ranked(std::size_t k) const
+    {
+        return row(m_order[k]);
+    }
+
+    /** Storage indexes, best first */
+    const std::vector<std::size_t>& getOrder() const
+    {
+        return m_order;
+    }
+
+    /** The number of calls to nextGeneration() */
+    unsigned long long getGeneration() const
+    {
+        return m_generation;
+    }
+
+    /** Fill every row with uniform random parameters. */
+    void randomize();
+
+    /**
+     * Rank the rows by score, highest first; ties keep their order.
+     * @param[in] scores one per row, by storage index
+     * @throw std::invalid_argument if there isn't one score per row
+     */
+    void order(const std::vector<double>& scores);
+
+    /** Overwrite row to with row from. */
+    void copyRow(std::size_t from, std::size_t to);
+
+    /**
+     * Add Gaussian noise to a row, clamping to [0, 1].
+     * @param[in] sigma the standard deviation
+     * @param[in] rate the chance that each parameter changes
+     */
+    void mutate(std::size_t r, double sigma, double rate = 1.0);
+
+    /** Set each parameter of a row to a uniform random value with chance rate. */
+    void mutateUniform(std::size_t r, double rate = 1.0);
+
+    /** Set row to by taking each parameter from row a or row b at random. */
+    void crossover(std::size_t a, std::size_t b, std::size_t to);
+
+    /** Move the random streams on to the next generation. */
+    void advance();
+
+    /**
+     * Replace the worst ranked rows, as NeuroEvoPopulation::combineAndMutate
+     * does: numToCombine children of two parents, then numToMutate
+     * mutated copies of one. Parents are survivors, chosen with
+     * probability falling linearly with rank. Call order() first; this
+     * calls advance().
+     * @param[in] sigma the standard deviation of mutations
+     * @param[in] rate the chance that each parameter of a mutant changes
+     * @throw std::invalid_argument if fewer than two rows would survive
+     * to combine, or none to mutate
+     */
+    void nextGeneration(std::size_t numToMutate, std::size_t numToCombine,
+                        double sigma, double rate = 1.0);
+
+private:
+
+    /** Purposes of random draws, so they never share a counter */
+    enum Stream
+    {
+        eInitial,
+        eMutateGate,
+        eMutateNormal1,
+        eMutateNormal2,
+        eUniform,
+        eCrossover,
+        eSelect,
+        eStreamCount
+    };
+
+    /** A uniform draw in [0, 1) for a row, column and purpose */
+    double random(std::size_t r, std::size_t c, Stream stream) const;
+
+    /** Pick a survivor by linear ranking from a uniform draw. */
+    std::size_t select(double u, std::size_t survivors) const;
+
+private:
+
+    const std::size_t m_rows;
+    const std::size_t m_columns;
+
+    /**
+     * Draws per row and purpose: one per column, and at least the two
+     * parent draws of eSelect, so no purpose runs into the next row
+     */
+    const std::size_t m_stride;
+
+    const unsigned long long m_seed;
+
+    unsigned long long m_generation;
+
+    /** m_rows * m_columns parameters, row-major */
+    std::vector<double> m_data;
+
+    /** Storage indexes, best first */
+    std::vector<std::size_t> m_order;
+};
+
+#endif /* GENOMEMATRIX_H_ */
@@ -0,0 +1,144 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef GENOMEROW_H_
+#define GENOMEROW_H_
+
+/**
+ * @file GenomeRow.h
+ * @brief Contains the definition of class GenomeRow, a view of one
+ * genome in a GenomeMatrix
+ * $Id$
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * One row of a GenomeMatrix, with enough of std::vector's interface for
+ * the code that used to keep each genome in its own vector.
+ *
+ * A view can't be copied, since a copy would alias the row while
+ * assignment copies values; assigning to one copies the values into its
+ * row, as assigning vectors did. The matrix must outlive its views.
+ */
+class GenomeRow
+{
+public:
+
+    typedef double* iterator;
+    typedef const double* const_iterator;
+
+    GenomeRow(double* pData, std::size_t size) :
+    m_pData(pData),
+    m_size(size)
+    {
+    }
+
+    /**
+     * Copy another row's values into this one.
+     * @throw std::invalid_argument if the lengths differ
+     */
+    GenomeRow& operator=(const GenomeRow& other)
+    {
+        if (other.m_size != m_size)
+        {
+            throw std::invalid_argument("GenomeRow lengths differ");
+        }
+        else if (other.m_pData != m_pData)
+        {
+            std::copy(other.begin(), other.end(), begin());
+        }
+        return *this;
+    }
+
+    /**
+     * Copy values into this row.
+     * @throw std::invalid_argument if the lengths differ
+     */
+    GenomeRow& operator=(const std::vector<double>& values)
+    {
+        if (values.size() != m_size)
+        {
+            throw std::invalid_argument("GenomeRow lengths differ");
+        }
+        std::copy(values.begin(), values.end(), begin());
+        return *this;
+    }
+
+    /** A copy of the values */
+    operator std::vector<double>() const
+    {
+        return std::vector<double>(begin(), end());
+    }
+
+    std::size_t size() const
+    {
+        return m_size;
+    }
+
+    bool empty() const
+    {
+        return m_size == 0;
+    }
+
+    double& operator[](std::size_t i)
+    {
+        return m_pData[i];
+    }
+
+    const double& operator[](std::size_t i) const
+    {
+        return m_pData[i];
+    }
+
+    iterator begin()
+    {
+        return m_pData;
+    }
+
+    iterator end()
+    {
+        return m_pData + m_size;
+    }
+
+    const_iterator begin() const
+    {
+        return m_pData;
+    }
+
+    const_iterator end() const
+    {
+        return m_pData + m_size;
+    }
+
+private:
+
+    /** Not implemented; a copy would alias the row */
+    GenomeRow(const GenomeRow&);
+
+private:
+
+    double* const m_pData;
+
+    const std::size_t m_size;
+};
+
+#endif /* GENOMEROW_H_ */
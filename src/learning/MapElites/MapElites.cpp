@@ -0,0 +1,729 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file MapElites.cpp
+ * @brief Contains the implementation of class MapElites
+ * $Id$
+ */
+
+#include "MapElites.h"
+#include "learning/Configuration/configuration.h"
+
+// The C++ Standard Library
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <stdexcept>
+// POSIX
+#include <unistd.h>
+
+namespace
+{
+    /** Identifies a MAP-Elites checkpoint, and its format version */
+    const char magic[8] = { 'N', 'T', 'R', 'T', 'M', 'A', 'P', '1' };
+
+    /** The largest grid allowed */
+    const std::size_t maxGridCells = 1 << 24;
+
+    /** Random samples per CVT cell, and Lloyd iterations, for placing centroids */
+    const std::size_t cvtSamplesPerCell = 50;
+    const std::size_t cvtIterations = 20;
+
+    double clamp01(double x)
+    {
+        return x < 0.0 ? 0.0 : (x > 1.0 ? 1.0 : x);
+    }
+
+    template <class T>
+    void writeVector(std::ostream& out, const std::vector<T>& v)
+    {
+        if (!v.empty())
+        {
+            out.write(reinterpret_cast<const char*>(&v[0]),
+                      v.size() * sizeof(T));
+        }
+    }
+
+    template <class T>
+    void readVector(std::istream& in, std::vector<T>& v)
+    {
+        if (!v.empty())
+        {
+            in.read(reinterpret_cast<char*>(&v[0]), v.size() * sizeof(T));
+        }
+    }
+}
+
+MapElites::Config::Config(std::size_t g,
+                          std::size_t d,
+                          std::size_t b,
+                          std::size_t c,
+                          std::size_t r,
+                          double sigma,
+                          unsigned long s,
+                          std::size_t interval) :
+genomeSize(g),
+descriptorSize(d),
+binsPerDimension(b),
+cvtCells(c),
+initialRandom(r),
+mutationSigma(sigma),
+seed(s),
+checkpointInterval(interval)
+{
+    if (genomeSize == 0)
+    {
+        throw std::invalid_argument("genomeSize is zero");
+    }
+    else if (descriptorSize == 0)
+    {
+        throw std::invalid_argument("descriptorSize is zero");
+    }
+    else if (cvtCells == 0 && binsPerDimension == 0)
+    {
+        throw std::invalid_argument("binsPerDimension is zero");
+    }
+    else if (mutationSigma < 0.0)
+    {
+        throw std::invalid_argument("mutationSigma is negative");
+    }
+}
+
+MapElites::Config::Config(configuration& config) :
+genomeSize(1),
+descriptorSize(2),
+binsPerDimension(10),
+cvtCells(0),
+initialRandom(100),
+mutationSigma(0.1),
+seed(1),
+checkpointInterval(0)
+{
+    if (config.iskey("genomeSize"))
+    {
+        genomeSize = config.getintvalue("genomeSize");
+    }
+    if (config.iskey("descriptorSize"))
+    {
+        descriptorSize = config.getintvalue("descriptorSize");
+    }
+    if (config.iskey("binsPerDimension"))
+    {
+        binsPerDimension = config.getintvalue("binsPerDimension");
+    }
+    if (config.iskey("cvtCells"))
+    {
+        cvtCells = config.getintvalue("cvtCells");
+    }
+    if (config.iskey("initialRandom"))
+    {
+        initialRandom = config.getintvalue("initialRandom");
+    }
+    if (config.iskey("mutationSigma"))
+    {
+        mutationSigma = config.getDoubleValue("mutationSigma");
+    }
+    if (config.iskey("seed"))
+    {
+        seed = config.getintvalue("seed");
+    }
+    if (config.iskey("checkpointInterval"))
+    {
+        checkpointInterval = config.getintvalue("checkpointInterval");
+    }
+    // Validate the same way
+    *this = Config(genomeSize, descriptorSize, binsPerDimension, cvtCells,
+                   initialRandom, mutationSigma, seed, checkpointInterval);
+}
+
+MapElites::MapElites(const Config& config, const std::string& checkpointPath) :
+m_config(config),
+m_checkpointPath(checkpointPath),
+m_cellCount(0),
+m_issued(0),
+m_evaluations(0),
+m_failures(0),
+m_uniform(std::tr1::mt19937(config.seed),
+          std::tr1::uniform_real<double>(0.0, 1.0)),
+m_normal(std::tr1::mt19937(config.seed + 1),
+         std::tr1::normal_distribution<double>(0.0, 1.0)),
+m_pEvaluator(NULL),
+m_trials(0),
+m_nextTrial(0)
+{
+    if (m_config.cvtCells > 0)
+    {
+        m_cellCount = m_config.cvtCells;
+        placeCentroids();
+    }
+    else
+    {
+        m_cellCount = 1;
+        for (std::size_t j = 0; j < m_config.descriptorSize; j++)
+        {
+            if (m_cellCount > maxGridCells / m_config.binsPerDimension)
+            {
+                throw std::invalid_argument("Too many grid cells; use cvtCells");
+            }
+            m_cellCount *= m_config.binsPerDimension;
+        }
+    }
+
+    m_filled.assign(m_cellCount, 0);
+    m_fitness.assign(m_cellCount, 0.0);
+    m_descriptors.assign(m_cellCount * m_config.descriptorSize, 0.0);
+    m_genomes.assign(m_cellCount * m_config.genomeSize, 0.0);
+
+    pthread_mutex_init(&m_mutex, NULL);
+}
+
+MapElites::~MapElites()
+{
+    pthread_mutex_destroy(&m_mutex);
+}
+
+void MapElites::placeCentroids()
+{
+    const std::size_t d = m_config.descriptorSize;
+    const std::size_t k = m_config.cvtCells;
+    const std::size_t n = k * cvtSamplesPerCell;
+
+    // A generator of its own, so the layout depends only on the config
+    std::tr1::variate_generator<std::tr1::mt19937,
+                                std::tr1::uniform_real<double> >
+        unit(std::tr1::mt19937(m_config.seed),
+             std::tr1::uniform_real<double>(0.0, 1.0));
+
+    std::vector<double> samples(n * d);
+    for (std::size_t i = 0; i < samples.size(); i++)
+    {
+        samples[i] = unit();
+    }
+    // Start from the first k samples
+    m_centroids.assign(samples.begin(), samples.begin() + k * d);
+
+    std::vector<double> sums(k * d);
+    std::vector<std::size_t> counts(k);
+    for (std::size_t iteration = 0; iteration < cvtIterations; iteration++)
+    {
+        std::fill(sums.begin(), sums.end(), 0.0);
+        std::fill(counts.begin(), counts.end(), 0);
+        for (std::size_t i = 0; i < n; i++)
+        {
+            const double* const pSample = &samples[i * d];
+            const std::size_t c = findCell(pSample);
+            for (std::size_t j = 0; j < d; j++)
+            {
+                sums[c * d + j] += pSample[j];
+            }
+            counts[c]++;
+        }
+        // A centroid with no samples stays where it is
+        for (std::size_t c = 0; c < k; c++)
+        {
+            if (counts[c] > 0)
+            {
+                for (std::size_t j = 0; j < d; j++)
+                {
+                    m_centroids[c * d + j] = sums[c * d + j] / counts[c];
+                }
+            }
+        }
+    }
+}
+
+std::size_t MapElites::findCell(const double* descriptor) const
+{
+    const std::size_t d = m_config.descriptorSize;
+    if (m_centroids.empty())
+    {
+        // Row major, the first dimension varies slowest
+        const std::size_t bins = m_config.binsPerDimension;
+        std::size_t cell = 0;
+        for (std::size_t j = 0; j < d; j++)
+        {
+            std::size_t bin =
+                static_cast<std::size_t>(clamp01(descriptor[j]) * bins);
+            if (bin >= bins)
+            {
+                bin = bins - 1;
+            }
+            cell = cell * bins + bin;
+        }
+        return cell;
+    }
+    else
+    {
+        const std::size_t k = m_centroids.size() / d;
+        std::size_t best = 0;
+        double bestDistance = 0.0;
+        for (std::size_t c = 0; c < k; c++)
+        {
+            const double* const pCentroid = &m_centroids[c * d];
+            double distance = 0.0;
+            for (std::size_t j = 0; j < d; j++)
+            {
+                const double delta = clamp01(descriptor[j]) - pCentroid[j];
+                distance += delta * delta;
+            }
+            if (c == 0 || distance < bestDistance)
+            {
+                best = c;
+                bestDistance = distance;
+            }
+        }
+        return best;
+    }
+}
+
+std::size_t MapElites::cellOf(const std::vector<double>& descriptor) const
+{
+    if (descriptor.size() != m_config.descriptorSize)
+    {
+        throw std::invalid_argument("Descriptor is the wrong size");
+    }
+    // The layout never changes after construction or loading
+    pthread_mutex_lock(&m_mutex);
+    const std::size_t cell = findCell(&descriptor[0]);
+    pthread_mutex_unlock(&m_mutex);
+    return cell;
+}
+
+void MapElites::nextCandidate(std::vector<double>& genome)
+{
+    const std::size_t g = m_config.genomeSize;
+    genome.resize(g);
+
+    pthread_mutex_lock(&m_mutex);
+    if (m_issued < m_config.initialRandom || m_filledCells.empty())
+    {
+        for (std::size_t i = 0; i < g; i++)
+        {
+            genome[i] = m_uniform();
+        }
+    }
+    else
+    {
+        const std::size_t n = m_filledCells.size();
+        std::size_t pick = static_cast<std::size_t>(m_uniform() * n);
+        if (pick >= n)
+        {
+            pick = n - 1;
+        }
+        const double* const pParent = &m_genomes[m_filledCells[pick] * g];
+        for (std::size_t i = 0; i < g; i++)
+        {
+            genome[i] = clamp01(pParent[i] +
+                                m_config.mutationSigma * m_normal());
+        }
+    }
+    m_issued++;
+    pthread_mutex_unlock(&m_mutex);
+}
+
+bool MapElites::report(const std::vector<double>& genome,
+                       double fitness,
+                       const std::vector<double>& descriptor)
+{
+    const std::size_t g = m_config.genomeSize;
+    const std::size_t d = m_config.descriptorSize;
+    if (genome.size() != g)
+    {
+        throw std::invalid_argument("Genome is the wrong size");
+    }
+    else if (descriptor.size() != d)
+    {
+        throw std::invalid_argument("Descriptor is the wrong size");
+    }
+
+    pthread_mutex_lock(&m_mutex);
+    // A NaN fitness is a failure
+    const bool failed = (fitness != fitness);
+    bool improved = false;
+    if (failed)
+    {
+        m_failures++;
+    }
+    else
+    {
+        m_evaluations++;
+        const std::size_t cell = findCell(&descriptor[0]);
+        if (!m_filled[cell] || fitness > m_fitness[cell])
+        {
+            if (!m_filled[cell])
+            {
+                m_filled[cell] = 1;
+                m_filledCells.push_back(cell);
+            }
+            m_fitness[cell] = fitness;
+            for (std::size_t j = 0; j < d; j++)
+            {
+                m_descriptors[cell * d + j] = clamp01(descriptor[j]);
+            }
+            std::copy(genome.begin(), genome.end(),
+                      m_genomes.begin() + cell * g);
+            improved = true;
+        }
+    }
+
+    const std::size_t reports = m_evaluations + m_failures;
+    const bool checkpoint = !m_checkpointPath.empty() &&
+                            m_config.checkpointInterval > 0 &&
+                            reports % m_config.checkpointInterval == 0;
+    try
+    {
+        if (checkpoint)
+        {
+            writeCheckpoint(m_checkpointPath);
+        }
+    }
+    catch (...)
+    {
+        pthread_mutex_unlock(&m_mutex);
+        throw;
+    }
+    pthread_mutex_unlock(&m_mutex);
+    return improved;
+}
+
+void MapElites::reportFailure()
+{
+    const std::vector<double> genome(m_config.genomeSize, 0.0);
+    const std::vector<double> descriptor(m_config.descriptorSize, 0.0);
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    report(genome, nan, descriptor);
+}
+
+void MapElites::evaluate(std::size_t trials, Evaluator& evaluator,
+                         std::size_t threads)
+{
+    if (threads == 0)
+    {
+        const long processors = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = (processors > 0) ? static_cast<std::size_t>(processors) : 1;
+    }
+#ifndef BT_NO_PROFILE
+    // Bullet's profiler is not thread safe
+    threads = 1;
+#endif
+    if (threads > trials)
+    {
+        threads = trials;
+    }
+
+    pthread_mutex_lock(&m_mutex);
+    m_pEvaluator = &evaluator;
+    m_trials = trials;
+    m_nextTrial = 0;
+    m_error.clear();
+    pthread_mutex_unlock(&m_mutex);
+
+    // The calling thread works too
+    std::vector<pthread_t> pool(threads > 1 ? threads - 1 : 0);
+    for (std::size_t i = 0; i < pool.size(); i++)
+    {
+        if (pthread_create(&pool[i], NULL, run, this) != 0)
+        {
+            // Let the started threads share the trials
+            pool.resize(i);
+            break;
+        }
+    }
+
+    run(this);
+
+    for (std::size_t i = 0; i < pool.size(); i++)
+    {
+        pthread_join(pool[i], NULL);
+    }
+
+    m_pEvaluator = NULL;
+    if (!m_error.empty())
+    {
+        throw std::runtime_error(m_error);
+    }
+}
+
+void* MapElites::run(void* pArg)
+{
+    MapElites& self = *static_cast<MapElites*>(pArg);
+    while (true)
+    {
+        pthread_mutex_lock(&self.m_mutex);
+        const std::size_t trial = self.m_nextTrial++;
+        pthread_mutex_unlock(&self.m_mutex);
+        if (trial >= self.m_trials)
+        {
+            break;
+        }
+
+        std::string error;
+        try
+        {
+            self.m_pEvaluator->run(trial);
+        }
+        catch (const std::exception& e)
+        {
+            error = e.what();
+        }
+        catch (...)
+        {
+            error = "Unknown exception";
+        }
+        if (!error.empty())
+        {
+            // Keep the first
+            pthread_mutex_lock(&self.m_mutex);
+            if (self.m_error.empty())
+            {
+                self.m_error = error;
+            }
+            pthread_mutex_unlock(&self.m_mutex);
+        }
+    }
+    return NULL;
+}
+
+std::size_t MapElites::getFilledCount() const
+{
+    pthread_mutex_lock(&m_mutex);
+    const std::size_t n = m_filledCells.size();
+    pthread_mutex_unlock(&m_mutex);
+    return n;
+}
+
+std::size_t MapElites::getEvaluationCount() const
+{
+    pthread_mutex_lock(&m_mutex);
+    const std::size_t n = m_evaluations;
+    pthread_mutex_unlock(&m_mutex);
+    return n;
+}
+
+std::size_t MapElites::getFailureCount() const
+{
+    pthread_mutex_lock(&m_mutex);
+    const std::size_t n = m_failures;
+    pthread_mutex_unlock(&m_mutex);
+    return n;
+}
+
+bool MapElites::getElite(std::size_t cell, std::vector<double>& genome,
+                         double& fitness) const
+{
+    const std::size_t g = m_config.genomeSize;
+    bool found = false;
+    pthread_mutex_lock(&m_mutex);
+    if (cell < m_cellCount && m_filled[cell])
+    {
+        genome.assign(m_genomes.begin() + cell * g,
+                      m_genomes.begin() + (cell + 1) * g);
+        fitness = m_fitness[cell];
+        found = true;
+    }
+    pthread_mutex_unlock(&m_mutex);
+    return found;
+}
+
+bool MapElites::getBest(std::vector<double>& genome, double& fitness) const
+{
+    const std::size_t g = m_config.genomeSize;
+    bool found = false;
+    pthread_mutex_lock(&m_mutex);
+    std::size_t best = 0;
+    for (std::size_t i = 0; i < m_filledCells.size(); i++)
+    {
+        const std::size_t cell = m_filledCells[i];
+        if (!found || m_fitness[cell] > m_fitness[best])
+        {
+            best = cell;
+            found = true;
+        }
+    }
+    if (found)
+    {
+        genome.assign(m_genomes.begin() + best * g,
+                      m_genomes.begin() + (best + 1) * g);
+        fitness = m_fitness[best];
+    }
+    pthread_mutex_unlock(&m_mutex);
+    return found;
+}
+
+void MapElites::saveCheckpoint(const std::string& path) const
+{
+    pthread_mutex_lock(&m_mutex);
+    try
+    {
+        writeCheckpoint(path);
+    }
+    catch (...)
+    {
+        pthread_mutex_unlock(&m_mutex);
+        throw;
+    }
+    pthread_mutex_unlock(&m_mutex);
+}
+
+void MapElites::writeCheckpoint(const std::string& path) const
+{
+    // Write a new file, then replace the old one, so an interrupted run
+    // leaves the last checkpoint intact
+    const std::string temporary = path + ".tmp";
+    {
+        std::ofstream out(temporary.c_str(),
+                          std::ios::out | std::ios::binary | std::ios::trunc);
+        const unsigned long long layout[5] = {
+            m_config.genomeSize,
+            m_config.descriptorSize,
+            m_config.binsPerDimension,
+            m_config.cvtCells,
+            m_cellCount
+        };
+        const unsigned long long counts[3] = {
+            m_issued,
+            m_evaluations,
+            m_failures
+        };
+        out.write(magic, sizeof(magic));
+        out.write(reinterpret_cast<const char*>(layout), sizeof(layout));
+        out.write(reinterpret_cast<const char*>(counts), sizeof(counts));
+        writeVector(out, m_centroids);
+        writeVector(out, m_filled);
+        writeVector(out, m_fitness);
+        writeVector(out, m_descriptors);
+        writeVector(out, m_genomes);
+        if (!out)
+        {
+            throw std::runtime_error("Could not write checkpoint " + temporary);
+        }
+    }
+    if (std::rename(temporary.c_str(), path.c_str()) != 0)
+    {
+        throw std::runtime_error("Could not replace checkpoint " + path);
+    }
+}
+
+bool MapElites::loadCheckpoint(const std::string& path)
+{
+    std::ifstream in(path.c_str(), std::ios::in | std::ios::binary);
+    if (!in)
+    {
+        return false;
+    }
+
+    char fileMagic[sizeof(magic)];
+    unsigned long long layout[5];
+    unsigned long long counts[3];
+    in.read(fileMagic, sizeof(fileMagic));
+    in.read(reinterpret_cast<char*>(layout), sizeof(layout));
+    in.read(reinterpret_cast<char*>(counts), sizeof(counts));
+    if (!in ||
+        std::memcmp(fileMagic, magic, sizeof(magic)) != 0 ||
+        layout[0] != m_config.genomeSize ||
+        layout[1] != m_config.descriptorSize ||
+        layout[2] != m_config.binsPerDimension ||
+        layout[3] != m_config.cvtCells ||
+        layout[4] != m_cellCount)
+    {
+        return false;
+    }
+
+    // Read everything before changing anything, so a truncated file
+    // leaves the archive as it was
+    std::vector<double> centroids(m_centroids.size());
+    std::vector<char> filled(m_filled.size());
+    std::vector<double> fitness(m_fitness.size());
+    std::vector<double> descriptors(m_descriptors.size());
+    std::vector<double> genomes(m_genomes.size());
+    readVector(in, centroids);
+    readVector(in, filled);
+    readVector(in, fitness);
+    readVector(in, descriptors);
+    readVector(in, genomes);
+    if (!in)
+    {
+        return false;
+    }
+
+    pthread_mutex_lock(&m_mutex);
+    m_centroids.swap(centroids);
+    m_filled.swap(filled);
+    m_fitness.swap(fitness);
+    m_descriptors.swap(descriptors);
+    m_genomes.swap(genomes);
+    m_filledCells.clear();
+    for (std::size_t c = 0; c < m_cellCount; c++)
+    {
+        if (m_filled[c])
+        {
+            m_filledCells.push_back(c);
+        }
+    }
+    m_issued = counts[0];
+    m_evaluations = counts[1];
+    m_failures = counts[2];
+    pthread_mutex_unlock(&m_mutex);
+    return true;
+}
+
+void MapElites::exportElites(const std::string& path) const
+{
+    const std::size_t g = m_config.genomeSize;
+    const std::size_t d = m_config.descriptorSize;
+    std::ofstream out(path.c_str(), std::ios::out | std::ios::trunc);
+
+    out << "cell,fitness";
+    for (std::size_t j = 0; j < d; j++)
+    {
+        out << ",d" << j;
+    }
+    for (std::size_t i = 0; i < g; i++)
+    {
+        out << ",p" << i;
+    }
+    out << std::endl << std::setprecision(17);
+
+    pthread_mutex_lock(&m_mutex);
+    for (std::size_t c = 0; c < m_cellCount; c++)
+    {
+        if (m_filled[c])
+        {
+            out << c << "," << m_fitness[c];
+            for (std::size_t j = 0; j < d; j++)
+            {
+                out << "," << m_descriptors[c * d + j];
+            }
+            for (std::size_t i = 0; i < g; i++)
+            {
+                out << "," << m_genomes[c * g + i];
+            }
+            out << std::endl;
+        }
+    }
+    pthread_mutex_unlock(&m_mutex);
+
+    if (!out)
+    {
+        throw std::runtime_error("Could not write elites " + path);
+    }
+}
@@ -0,0 +1,272 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef MAPELITES_H_
+#define MAPELITES_H_
+
+/**
+ * @file MapElites.h
+ * @brief Contains the definition of class MapElites, a quality diversity
+ * learner
+ * $Id$
+ */
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <tr1/random>
+// POSIX threads
+#include <pthread.h>
+
+class configuration;
+
+/**
+ * MAP-Elites: keeps the fittest parameter set (the elite) found for each
+ * cell of a behavior space, so that one run yields a library of
+ * different gaits rather than a single best one.
+ *
+ * Each trial reports a fitness and a behavior descriptor, e.g. heading,
+ * energy and the fraction of time each rod touches the ground, scaled
+ * to [0, 1]. The descriptor picks the cell: a regular grid with
+ * binsPerDimension bins per dimension, or, if cvtCells is set, the
+ * nearest of cvtCells centroids of a centroidal Voronoi tessellation,
+ * which keeps the archive small in many dimensions. Parameters are in
+ * [0, 1] as with AnnealEvolution. The first initialRandom candidates
+ * are uniform random; after that each is a random elite with Gaussian
+ * noise.
+ *
+ * The archive is held in contiguous arrays, one row per cell. All
+ * public members are thread safe, so trials may run in parallel, each
+ * with its own MapElitesAdapter; evaluate() runs them on a pool of
+ * threads. With a checkpoint path, the archive is saved every
+ * checkpointInterval reports and can be resumed with loadCheckpoint().
+ */
+class MapElites
+{
+public:
+
+    struct Config
+    {
+        Config(std::size_t genomeSize = 1,
+               std::size_t descriptorSize = 2,
+               std::size_t binsPerDimension = 10,
+               std::size_t cvtCells = 0,
+               std::size_t initialRandom = 100,
+               double mutationSigma = 0.1,
+               unsigned long seed = 1,
+               std::size_t checkpointInterval = 0);
+
+        /**
+         * Read the keys genomeSize, descriptorSize, binsPerDimension,
+         * cvtCells, initialRandom, mutationSigma, seed and
+         * checkpointInterval from a learning .ini file; absent keys keep
+         * their defaults.
+         */
+        explicit Config(configuration& config);
+
+        /** The number of parameters per candidate; must be positive */
+        std::size_t genomeSize;
+
+        /** The number of behavior dimensions; must be positive */
+        std::size_t descriptorSize;
+
+        /** Grid bins per dimension, if cvtCells is 0; must be positive */
+        std::size_t binsPerDimension;
+
+        /** The number of CVT cells, or 0 for a grid */
+        std::size_t cvtCells;
+
+        /** Uniform random candidates before mutating elites */
+        std::size_t initialRandom;
+
+        /** The standard deviation of mutations; must not be negative */
+        double mutationSigma;
+
+        unsigned long seed;
+
+        /** Reports between checkpoints, or 0 for none */
+        std::size_t checkpointInterval;
+    };
+
+    /** Runs one trial, e.g. a simulation whose controller has an adapter */
+    class Evaluator
+    {
+    public:
+
+        virtual ~Evaluator() { }
+
+        /**
+         * Run a trial that gets its candidate with nextCandidate() and
+         * reports it. Called concurrently from several threads.
+         * @param[in] trial the index of the trial
+         */
+        virtual void run(std::size_t trial) = 0;
+    };
+
+    /**
+     * @param[in] config the archive and search parameters
+     * @param[in] checkpointPath where to save the archive every
+     * config.checkpointInterval reports; empty for nowhere
+     * @throw std::invalid_argument if the config is invalid, or a grid
+     * would have more than 2^24 cells
+     */
+    MapElites(const Config& config, const std::string& checkpointPath = "");
+
+    ~MapElites();
+
+    /**
+     * Return the parameters to try next.
+     * @param[out] genome genomeSize values in [0, 1]
+     */
+    void nextCandidate(std::vector<double>& genome);
+
+    /**
+     * Offer the result of a trial to the archive.
+     * @param[in] genome the parameters tried
+     * @param[in] fitness higher is better
+     * @param[in] descriptor descriptorSize values, clamped to [0, 1]
+     * @return true if the genome became the elite of its cell
+     * @throw std::invalid_argument if a size is wrong
+     */
+    bool report(const std::vector<double>& genome,
+                double fitness,
+                const std::vector<double>& descriptor);
+
+    /** Count a trial that failed, e.g. because the structure exploded. */
+    void reportFailure();
+
+    /**
+     * Run trials on a pool of threads, taking the next as each finishes.
+     * Unless Bullet's profiler is compiled out (BT_NO_PROFILE) they run
+     * one at a time.
+     * @param[in] trials the number of trials
+     * @param[in,out] evaluator runs each trial
+     * @param[in] threads 0 for one per processor
+     * @throw std::runtime_error if an evaluator threw, after all trials
+     * have finished
+     */
+    void evaluate(std::size_t trials, Evaluator& evaluator,
+                  std::size_t threads = 0);
+
+    /** Return the cell a descriptor falls in. */
+    std::size_t cellOf(const std::vector<double>& descriptor) const;
+
+    std::size_t getCellCount() const
+    {
+        return m_cellCount;
+    }
+
+    /** Return the number of cells with an elite. */
+    std::size_t getFilledCount() const;
+
+    /** Return the number of reports, not counting failures. */
+    std::size_t getEvaluationCount() const;
+
+    std::size_t getFailureCount() const;
+
+    /**
+     * Copy the elite of a cell.
+     * @return false if the cell is empty or doesn't exist
+     */
+    bool getElite(std::size_t cell, std::vector<double>& genome,
+                  double& fitness) const;
+
+    /**
+     * Copy the fittest elite of all.
+     * @return false if the archive is empty
+     */
+    bool getBest(std::vector<double>& genome, double& fitness) const;
+
+    /**
+     * Save the archive, replacing the file.
+     * @throw std::runtime_error if the file can't be written
+     */
+    void saveCheckpoint(const std::string& path) const;
+
+    /**
+     * Replace the archive with a saved one.
+     * @return false, changing nothing, if the file doesn't exist or is
+     * for another genome size, descriptor size or cell layout
+     */
+    bool loadCheckpoint(const std::string& path);
+
+    /**
+     * Write the gait library as CSV: a line per elite with its cell,
+     * fitness, descriptor and genome.
+     * @throw std::runtime_error if the file can't be written
+     */
+    void exportElites(const std::string& path) const;
+
+private:
+
+    /** Not copyable */
+    MapElites(const MapElites&);
+    MapElites& operator=(const MapElites&);
+
+    /** Place the CVT centroids by Lloyd's algorithm on random samples. */
+    void placeCentroids();
+
+    /** cellOf() without locking; const state only */
+    std::size_t findCell(const double* descriptor) const;
+
+    /** saveCheckpoint() with the mutex held */
+    void writeCheckpoint(const std::string& path) const;
+
+    /** The body of an evaluate() thread. */
+    static void* run(void* pArg);
+
+private:
+
+    const Config m_config;
+
+    const std::string m_checkpointPath;
+
+    std::size_t m_cellCount;
+
+    /** cvtCells * descriptorSize centroids; empty for a grid */
+    std::vector<double> m_centroids;
+
+    /** One row per cell */
+    std::vector<char> m_filled;
+    std::vector<double> m_fitness;
+    std::vector<double> m_descriptors;
+    std::vector<double> m_genomes;
+
+    /** The filled cells, for choosing a parent */
+    std::vector<std::size_t> m_filledCells;
+
+    std::size_t m_issued;
+    std::size_t m_evaluations;
+    std::size_t m_failures;
+
+    std::tr1::variate_generator<std::tr1::mt19937,
+                                std::tr1::uniform_real<double> > m_uniform;
+    std::tr1::variate_generator<std::tr1::mt19937,
+                                std::tr1::normal_distribution<double> > m_normal;
+
+    /** The state of the current evaluate() call */
+    Evaluator* m_pEvaluator;
+    std::size_t m_trials;
+    std::size_t m_nextTrial;
+    std::string m_error;
+
+    /** Guards everything above that changes */
+    mutable pthread_mutex_t m_mutex;
+};
+
+#endif /* MAPELITES_H_ */
@@ -33,7 +33,10 @@
 
 using namespace std;
 
-NeuroEvoMember::NeuroEvoMember(configuration config)
+NeuroEvoMember::NeuroEvoMember(configuration config, double* pParameters) :
+statelessParameters(pParameters,
+                    (pParameters == NULL) ? 0 : config.getintvalue("numberOfActions")),
+nn(NULL)
 {
 	this->numInputs=config.getintvalue("numberOfStates");
     this->numOutputs=config.getintvalue("numberOfActions");
@@ -44,7 +47,7 @@ NeuroEvoMember::NeuroEvoMember(configuration config)
 		nn = new neuralNetwork(numInputs, numHidden,numOutputs);
 	else
 	{
-		statelessParameters.resize(numOutputs);
+		assert(statelessParameters.size() == (std::size_t) numOutputs);
 		for(int i=0;i<numOutputs;i++)
 			statelessParameters[i]=rand()*1.0/RAND_MAX;
 	}
@@ -31,6 +31,7 @@
 #include <vector>
 #include <tr1/random>
 #include "learning/Configuration/configuration.h"
+#include "learning/Genome/GenomeRow.h"
 
 // Forward Declarations
 class neuralNetwork;
@@ -38,7 +39,12 @@ class neuralNetwork;
 class NeuroEvoMember
 {
 public:
-	NeuroEvoMember(configuration config);
+	/**
+	 * @param[in] pParameters this member's row of its population's
+	 * GenomeMatrix, numberOfActions long, if the member has no network;
+	 * filled with random values here. NULL if it has a network.
+	 */
+	NeuroEvoMember(configuration config, double* pParameters);
 	~NeuroEvoMember();
 	void mutate(std::tr1::ranlux64_base_01 *eng);
 
@@ -51,7 +57,8 @@ public:
 	void saveToFile(const char* outputFilename);
 	void loadFromFile(const char* inputFilename);
 
-	std::vector<double> statelessParameters;
+	/** A view of this member's row, empty if it has a network */
+	GenomeRow statelessParameters;
 	//scores for evaluation
 	std::vector<double> pastScores;
 	double maxScore;
@@ -37,10 +37,13 @@
 
 using namespace std;
 
-NeuroEvoPopulation::NeuroEvoPopulation(int populationSize,configuration& config) :
-m_config(config),
+NeuroEvoPopulation::NeuroEvoPopulation(int populationSize,configuration& config,
+									   unsigned long long seed) :
 compareAverageScores(true),
-clearScoresBetweenGenerations(false)
+clearScoresBetweenGenerations(false),
+m_config(config),
+m_stateless(config.getintvalue("numberOfStates") <= 0),
+m_genomes(populationSize, config.getintvalue("numberOfActions"), seed)
 {
 	this->compareAverageScores=config.getintvalue("compareAverageScores");
 	this->clearScoresBetweenGenerations=config.getintvalue("clearScoresBetweenGenerations");
@@ -48,7 +51,12 @@ clearScoresBetweenGenerations(false)
 	for(int i=0;i<populationSize;i++)
 	{
 		cout<<"  creating members"<<endl;
-		controllers.push_back(new NeuroEvoMember(config));
+		double* const pRow = m_stateless ? m_genomes.row(i) : NULL;
+		controllers.push_back(new NeuroEvoMember(config, pRow));
+	}
+	if (m_stateless)
+	{
+		m_members = controllers;
 	}
 }
 
@@ -67,6 +75,20 @@ void NeuroEvoPopulation::mutate(std::tr1::ranlux64_base_01 *engPntr,std::size_t
 		cout<<"Trying to mutate more than half of the population"<<endl;
 		exit(0);
 	}
+	if (m_stateless)
+	{
+		// The i-th best row over the i-th worst, then half its
+		// parameters moved by 3 percent of the interval
+		const std::vector<std::size_t>& order = m_genomes.getOrder();
+		for(std::size_t i=0;i<numMutate;i++)
+		{
+			const std::size_t copyTo = order[order.size()-1-i];
+			m_genomes.copyRow(order[i], copyTo);
+			m_genomes.mutate(copyTo, 3.0 / 100.0, 0.5);
+		}
+		m_genomes.advance();
+		return;
+	}
 	for(std::size_t i=0;i<numMutate;i++)
 	{
 		int copyFrom = i;
@@ -86,6 +108,21 @@ void NeuroEvoPopulation::combineAndMutate(std::tr1::ranlux64_base_01 *eng, std::
         throw std::invalid_argument("Population will grow in size with these parameters");
     }
     
+    if (m_stateless)
+    {
+        // Parents are chosen by rank rather than by score, and the rows
+        // of the worst members are overwritten in place
+        m_genomes.nextGeneration(numToMutate, numToCombine, 3.0 / 100.0, 0.5);
+        const std::size_t n = controllers.size();
+        for(std::size_t k = n - numToMutate - numToCombine; k < n; k++)
+        {
+            // As good as new
+            controllers[k]->pastScores.clear();
+            controllers[k]->maxScore = -1000;
+        }
+        return;
+    }
+    
     std::vector<double> probabilities = generateMatingProbabilities();
     
     std::vector<NeuroEvoMember*> newControllers;
@@ -110,7 +147,7 @@ void NeuroEvoPopulation::combineAndMutate(std::tr1::ranlux64_base_01 *eng, std::
             }
         }
         
-        NeuroEvoMember* newController = new NeuroEvoMember(m_config);
+        NeuroEvoMember* newController = new NeuroEvoMember(m_config, NULL);
         newController->copyFrom(controllers[index1], controllers[index2], eng);
         
         if(unif(*eng) > 0.9)
@@ -125,7 +162,7 @@ void NeuroEvoPopulation::combineAndMutate(std::tr1::ranlux64_base_01 *eng, std::
     {
         double val1 = unif(*eng);
         int index1 = getIndexFromProbability(probabilities, val1);
-        NeuroEvoMember* newController = new NeuroEvoMember(m_config);
+        NeuroEvoMember* newController = new NeuroEvoMember(m_config, NULL);
         newController->copyFrom(controllers[index1]);
         newController->mutate(eng);
         newControllers.push_back(newController);
@@ -169,7 +206,21 @@ void NeuroEvoPopulation::orderPopulation()
 			controllers[i]->pastScores.clear();
 	}
 //	cout<<"ordering the whole population"<<endl;
-	if(compareAverageScores)
+	if (m_stateless)
+	{
+		// Rank the rows; the members follow their rows
+		std::vector<double> scores(m_members.size());
+		for(std::size_t i=0;i<m_members.size();i++)
+		{
+			scores[i] = compareAverageScores ? m_members[i]->averageScore : m_members[i]->maxScore;
+		}
+		m_genomes.order(scores);
+		for(std::size_t k=0;k<m_members.size();k++)
+		{
+			controllers[k] = m_members[m_genomes.getOrder()[k]];
+		}
+	}
+	else if(compareAverageScores)
 		sort(controllers.begin(),controllers.end(),this->comparisonFuncForAverage);
 	else
 		sort(controllers.begin(),controllers.end(),this->comparisonFuncForMax);
@@ -28,13 +28,25 @@
  */
 
 #include "NeuroEvoMember.h"
+#include "learning/Genome/GenomeMatrix.h"
 #include <vector>
 #include <tr1/random>
 
+/**
+ * Members without a network keep their parameters in one GenomeMatrix,
+ * a row each; the matrix ranks, mutates and combines the rows in place
+ * with its counter-based generator. Members with a network are sorted,
+ * copied and combined through their networks, using eng.
+ */
 class NeuroEvoPopulation {
 public:
-	NeuroEvoPopulation(int numControllers, configuration& config);
+	/**
+	 * @param[in] seed selects the random stream of the GenomeMatrix
+	 */
+	NeuroEvoPopulation(int numControllers, configuration& config,
+					   unsigned long long seed);
 	~NeuroEvoPopulation();
+	/** The members, best first as of the last orderPopulation() */
 	std::vector<NeuroEvoMember *> controllers;
     void mutate(std::tr1::ranlux64_base_01 *eng,std::size_t numToMutate);
 	void combineAndMutate(std::tr1::ranlux64_base_01 *eng, std::size_t numToMutate, std::size_t numToCombine);
@@ -50,6 +62,11 @@ private:
 	bool clearScoresBetweenGenerations;
 	int populationSize;
     configuration m_config;
+    /** True if the members have no network, so their rows evolve */
+    bool m_stateless;
+    GenomeMatrix m_genomes;
+    /** The members by row of m_genomes, if m_stateless */
+    std::vector<NeuroEvoMember *> m_members;
 };
 
 
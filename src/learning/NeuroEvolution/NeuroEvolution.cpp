@@ -57,6 +57,7 @@ NeuroEvolution::NeuroEvolution(std::string suff, std::string config, std::string
 suffix(suff)
 {
 	currentTest=0;
+	subTests=0;
 	generationNumber=0;
 	if (path != "")
 	{
@@ -80,6 +81,7 @@ suffix(suff)
 	leniencyCoef=myconfigdataaa.getDoubleValue("leniencyCoef");
 	coevolution=myconfigdataaa.getintvalue("coevolution");
     seeded = myconfigdataaa.getintvalue("startSeed");
+    surrogate = new FitnessSurrogate(FitnessSurrogate::Config(myconfigdataaa));
     
     bool learning = myconfigdataaa.getintvalue("learning");
     
@@ -94,7 +96,7 @@ suffix(suff)
 	for(int j=0;j<numberOfControllers;j++)
 	{
 		cout<<"creating Populations"<<endl;
-		populations.push_back(new NeuroEvoPopulation(populationSize,myconfigdataaa));
+		populations.push_back(new NeuroEvoPopulation(populationSize,myconfigdataaa,rdtsc()));
 	}
 
     // Overwrite the random parameters based on data
@@ -120,6 +122,7 @@ suffix(suff)
 
 NeuroEvolution::~NeuroEvolution()
 {
+	delete surrogate;
 	// @todo - solve the invalid pointer that occurs here
 	#if (0)
 	for(std::size_t i = 0; i < populations.size(); i++)
@@ -199,24 +202,33 @@ vector <NeuroEvoMember *> NeuroEvolution::nextSetOfControllers()
 	else
 		testsToDo=populationSize; //stop when we test each element once
 
-	if(currentTest == testsToDo)
+	// Skip at most a generation's worth of hopeless candidates per trial
+	int skipped = 0;
+	while(true)
 	{
-		orderAllPopulations();
-        if (numberOfChildren == 0)
-        {
-            mutateEveryController();
-        }
-        else
-        {
-            combineAndMutate();
-        }
-		cout<<"mutated the populations"<<endl;
-		this->scoresOfTheGeneration.clear();
+		if(currentTest == testsToDo)
+		{
+			orderAllPopulations();
+			if (numberOfChildren == 0)
+			{
+				mutateEveryController();
+			}
+			else
+			{
+				combineAndMutate();
+			}
+			cout<<"mutated the populations"<<endl;
+			this->scoresOfTheGeneration.clear();
 
-		if(coevolution)
-			currentTest=0;//Start from 0
-		else
-			currentTest=populationSize - numberOfElementsToMutate - numberOfChildren; //start from the mutated ones only (last x)
+			if(coevolution)
+				currentTest=0;//Start from 0
+			else
+				currentTest=populationSize - numberOfElementsToMutate - numberOfChildren; //start from the mutated ones only (last x)
+		}
+		if(coevolution || subTests != 0 || skipped == testsToDo || !skipHopeless(currentTest))
+			break;
+		currentTest++;
+		skipped++;
 	}
 
 	selectedControllers.clear();
@@ -250,6 +262,14 @@ void NeuroEvolution::updateScores(vector <double> multiscore)
 	else
 		multiscore.push_back(-1.0);
 	double score=1.0* multiscore[0] - 0.0 * multiscore[1];
+	if(surrogate->isEnabled())
+	{
+		const vector<double> parameters = parametersOf(selectedControllers);
+		if(!parameters.empty())
+		{
+			surrogate->add(parameters, score);
+		}
+	}
 	for(std::size_t oneElem=0;oneElem<selectedControllers.size();oneElem++)
 	{
 		NeuroEvoMember * controllerPointer=selectedControllers.at(oneElem);
@@ -276,3 +296,41 @@ void NeuroEvolution::updateScores(vector <double> multiscore)
 	payloadLog.close();
 	return;
 }
+
+vector<double> NeuroEvolution::parametersOf(const vector<NeuroEvoMember *>& members)
+{
+	vector<double> parameters;
+	for(std::size_t i=0;i<members.size();i++)
+	{
+		parameters.insert(parameters.end(),
+				members[i]->statelessParameters.begin(),
+				members[i]->statelessParameters.end());
+	}
+	return parameters;
+}
+
+bool NeuroEvolution::skipHopeless(int memberIndex)
+{
+	if(!surrogate->isEnabled())
+		return false;
+
+	vector<NeuroEvoMember *> members;
+	for(std::size_t i=0;i<populations.size();i++)
+		members.push_back(populations.at(i)->getMember(memberIndex));
+	// Neural network weights aren't modelled
+	const vector<double> parameters = parametersOf(members);
+	double predicted = 0.0;
+	if(parameters.empty() || !surrogate->shouldSkip(parameters, &eng, predicted))
+		return false;
+
+	// Score it as if it had been simulated, so ordering drops it
+	for(std::size_t i=0;i<members.size();i++)
+	{
+		members[i]->pastScores.push_back(predicted);
+		if(members[i]->maxScore>predicted)
+			members[i]->maxScore=leniencyCoef * members[i]->maxScore + (1.0 - leniencyCoef) * predicted;
+		else
+			members[i]->maxScore=predicted;
+	}
+	return true;
+}
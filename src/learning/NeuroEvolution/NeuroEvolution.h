@@ -30,6 +30,7 @@
 
 #include "NeuroEvoPopulation.h"
 #include "NeuroEvoMember.h"
+#include "learning/Surrogate/FitnessSurrogate.h"
 #include <fstream>
 
 class NeuroEvolution
@@ -66,6 +67,10 @@ private:
     int numberOfChildren;
     int numberOfSubtests;
     int subTests;
+    /// Skips candidates predicted to be hopeless; off unless configured
+    FitnessSurrogate* surrogate;
+    std::vector<double> parametersOf(const std::vector<NeuroEvoMember *>& members);
+    bool skipHopeless(int memberIndex);
 };
 
 #endif /* NEUROEVOLUTION_H_ */
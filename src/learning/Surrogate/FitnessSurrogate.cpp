@@ -0,0 +1,212 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file FitnessSurrogate.cpp
+ * @brief Contains the implementation of class FitnessSurrogate
+ * $Id$
+ */
+
+#include "FitnessSurrogate.h"
+#include "learning/Configuration/configuration.h"
+
+// The C++ Standard Library
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+FitnessSurrogate::Config::Config(bool e,
+                                 std::size_t k,
+                                 double m,
+                                 double x,
+                                 std::size_t minimum,
+                                 std::size_t c) :
+enabled(e),
+neighbors(k),
+margin(m),
+exploration(x),
+minSamples(minimum),
+capacity(c)
+{
+    if (neighbors == 0)
+    {
+        throw std::invalid_argument("surrogateNeighbors is zero");
+    }
+    else if (margin < 0.0)
+    {
+        throw std::invalid_argument("surrogateMargin is negative");
+    }
+    else if (exploration < 0.0 || exploration > 1.0)
+    {
+        throw std::invalid_argument("surrogateExploration is not in [0, 1]");
+    }
+    else if (capacity == 0)
+    {
+        throw std::invalid_argument("surrogateCapacity is zero");
+    }
+}
+
+FitnessSurrogate::Config::Config(configuration& config) :
+enabled(false),
+neighbors(5),
+margin(0.5),
+exploration(0.1),
+minSamples(20),
+capacity(1000)
+{
+    if (config.iskey("surrogate"))
+    {
+        enabled = config.getintvalue("surrogate");
+    }
+    if (config.iskey("surrogateNeighbors"))
+    {
+        neighbors = config.getintvalue("surrogateNeighbors");
+    }
+    if (config.iskey("surrogateMargin"))
+    {
+        margin = config.getDoubleValue("surrogateMargin");
+    }
+    if (config.iskey("surrogateExploration"))
+    {
+        exploration = config.getDoubleValue("surrogateExploration");
+    }
+    if (config.iskey("surrogateMinSamples"))
+    {
+        minSamples = config.getintvalue("surrogateMinSamples");
+    }
+    if (config.iskey("surrogateCapacity"))
+    {
+        capacity = config.getintvalue("surrogateCapacity");
+    }
+    // Validate the same way
+    *this = Config(enabled, neighbors, margin, exploration, minSamples,
+                   capacity);
+}
+
+FitnessSurrogate::FitnessSurrogate(const Config& config) :
+m_config(config),
+m_dimension(0),
+m_next(0),
+m_bestScore(0.0),
+m_worstScore(0.0),
+m_skips(0)
+{
+}
+
+void FitnessSurrogate::add(const std::vector<double>& parameters,
+                           double score)
+{
+    if (m_scores.empty())
+    {
+        m_dimension = parameters.size();
+        m_bestScore = score;
+        m_worstScore = score;
+    }
+    else if (parameters.size() != m_dimension)
+    {
+        throw std::invalid_argument("Parameters are the wrong size");
+    }
+    m_bestScore = std::max(m_bestScore, score);
+    m_worstScore = std::min(m_worstScore, score);
+
+    if (m_scores.size() < m_config.capacity)
+    {
+        m_parameters.insert(m_parameters.end(),
+                            parameters.begin(), parameters.end());
+        m_scores.push_back(score);
+    }
+    else
+    {
+        // Forget the oldest
+        std::copy(parameters.begin(), parameters.end(),
+                  m_parameters.begin() + m_next * m_dimension);
+        m_scores[m_next] = score;
+        m_next = (m_next + 1) % m_config.capacity;
+    }
+}
+
+bool FitnessSurrogate::predict(const std::vector<double>& parameters,
+                               double& score) const
+{
+    const std::size_t n = m_scores.size();
+    if (n == 0 || n < m_config.minSamples || parameters.size() != m_dimension)
+    {
+        return false;
+    }
+
+    // (squared distance, row) of every trial, nearest first
+    std::vector<std::pair<double, std::size_t> > distances(n);
+    for (std::size_t r = 0; r < n; r++)
+    {
+        const double* const pRow = &m_parameters[r * m_dimension];
+        double d2 = 0.0;
+        for (std::size_t j = 0; j < m_dimension; j++)
+        {
+            const double delta = parameters[j] - pRow[j];
+            d2 += delta * delta;
+        }
+        distances[r] = std::make_pair(d2, r);
+    }
+    const std::size_t k = std::min(m_config.neighbors, n);
+    std::partial_sort(distances.begin(), distances.begin() + k,
+                      distances.end());
+
+    // A candidate that was tried before gets the mean of those tries
+    double total = 0.0;
+    double weights = 0.0;
+    const bool exact = (distances[0].first == 0.0);
+    for (std::size_t i = 0; i < k; i++)
+    {
+        if (exact && distances[i].first > 0.0)
+        {
+            break;
+        }
+        const double w = exact ? 1.0 : 1.0 / distances[i].first;
+        total += w * m_scores[distances[i].second];
+        weights += w;
+    }
+    score = total / weights;
+    return true;
+}
+
+bool FitnessSurrogate::shouldSkip(const std::vector<double>& parameters,
+                                  std::tr1::ranlux64_base_01 *eng,
+                                  double& score)
+{
+    std::tr1::uniform_real<double> unif(0, 1);
+
+    double estimate = 0.0;
+    if (!m_config.enabled || !predict(parameters, estimate))
+    {
+        return false;
+    }
+    const double threshold =
+        m_bestScore - m_config.margin * (m_bestScore - m_worstScore);
+    if (estimate >= threshold || unif(*eng) < m_config.exploration)
+    {
+        return false;
+    }
+    score = estimate;
+    m_skips++;
+    return true;
+}
+
+std::size_t FitnessSurrogate::size() const
+{
+    return m_scores.size();
+}
@@ -0,0 +1,146 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef FITNESSSURROGATE_H_
+#define FITNESSSURROGATE_H_
+
+/**
+ * @file FitnessSurrogate.h
+ * @brief Contains the definition of class FitnessSurrogate, a cheap
+ * estimate of a candidate's score
+ * $Id$
+ */
+
+#include <cstddef>
+#include <vector>
+#include <tr1/random>
+
+class configuration;
+
+/**
+ * Estimates the score of a parameter vector from the scores of past
+ * trials, so evolution can skip candidates that are unlikely to be worth
+ * simulating. The estimate is the inverse distance weighted mean score
+ * of the nearest neighbors among the last capacity trials, which are
+ * kept in a contiguous ring buffer.
+ *
+ * A candidate is hopeless if its estimate is below the best score seen
+ * by more than margin times the range of scores seen. Even then it is
+ * simulated with probability exploration, so the surrogate keeps
+ * learning about the regions it rejects.
+ */
+class FitnessSurrogate
+{
+public:
+
+    struct Config
+    {
+        Config(bool enabled = false,
+               std::size_t neighbors = 5,
+               double margin = 0.5,
+               double exploration = 0.1,
+               std::size_t minSamples = 20,
+               std::size_t capacity = 1000);
+
+        /**
+         * Read the keys surrogate (0 or 1), surrogateNeighbors,
+         * surrogateMargin, surrogateExploration, surrogateMinSamples and
+         * surrogateCapacity; absent keys keep their defaults, so the
+         * surrogate is off unless asked for.
+         */
+        explicit Config(configuration& config);
+
+        bool enabled;
+
+        /** The number of neighbors averaged; must be positive */
+        std::size_t neighbors;
+
+        /** The fraction of the score range below the best that is hopeless */
+        double margin;
+
+        /** The chance of simulating a hopeless candidate anyway, in [0, 1] */
+        double exploration;
+
+        /** The number of trials before anything is skipped */
+        std::size_t minSamples;
+
+        /** The number of trials remembered; must be positive */
+        std::size_t capacity;
+    };
+
+    FitnessSurrogate(const Config& config);
+
+    bool isEnabled() const
+    {
+        return m_config.enabled;
+    }
+
+    /**
+     * Remember the score of a trial.
+     * @throw std::invalid_argument if the parameters aren't the size of
+     * the first ones added
+     */
+    void add(const std::vector<double>& parameters, double score);
+
+    /**
+     * Estimate a score.
+     * @return false if there are fewer than minSamples trials, or the
+     * parameters are the wrong size
+     */
+    bool predict(const std::vector<double>& parameters, double& score) const;
+
+    /**
+     * Decide whether to skip a candidate.
+     * @param[out] score the estimate, if skipping
+     * @return true if the candidate is hopeless and wasn't chosen to
+     * explore
+     */
+    bool shouldSkip(const std::vector<double>& parameters,
+                    std::tr1::ranlux64_base_01 *eng,
+                    double& score);
+
+    /** The number of trials remembered */
+    std::size_t size() const;
+
+    /** The number of candidates skipped so far */
+    std::size_t getSkipCount() const
+    {
+        return m_skips;
+    }
+
+private:
+
+    const Config m_config;
+
+    /** The length of a parameter vector, set by the first add() */
+    std::size_t m_dimension;
+
+    /** Up to capacity rows of m_dimension parameters */
+    std::vector<double> m_parameters;
+    std::vector<double> m_scores;
+
+    /** The row the next add() replaces, once full */
+    std::size_t m_next;
+
+    double m_bestScore;
+    double m_worstScore;
+
+    std::size_t m_skips;
+};
+
+#endif /* FITNESSSURROGATE_H_ */
@@ -0,0 +1,135 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file ntrtModule.cpp
+ * @brief The ntrt Python module
+ * $Id$
+ *
+ * Usage, with build/python on PYTHONPATH:
+ *
+ *     import ntrt
+ *     sim = ntrt.Simulation("resources/YamlStructures/.../model.yaml")
+ *     for _ in range(1000):
+ *         sim.actions[:] = policy(sim.rods, sim.cables)
+ *         sim.step(10)
+ *
+ * actions, rods and cables are persistent NumPy views of buffers that
+ * the simulator refreshes each step: NumPy never copies them, and they
+ * stay valid (and current) for the life of the Simulation. rods and
+ * cables are filled from the model after every step, so they are read
+ * only; copy them to keep a sample. This is the only file that needs
+ * pybind11 and C++11.
+ */
+
+// This module
+#include "tgPySimulation.h"
+// pybind11
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+// The C++ Standard Library
+#include <vector>
+
+namespace py = pybind11;
+
+namespace
+{
+    /**
+     * Return a C ordered view of the doubles at pData, which keeps owner
+     * alive.
+     */
+    py::array view(const double* pData, std::vector<py::ssize_t> shape,
+                   py::handle owner, bool writeable)
+    {
+        std::vector<py::ssize_t> strides(shape.size(), sizeof(double));
+        for (std::size_t i = shape.size() - 1; i > 0; i--)
+        {
+            strides[i - 1] = strides[i] * shape[i];
+        }
+        // NumPy wants a non-NULL pointer even for an empty array
+        static double empty = 0.0;
+        py::array_t<double> a(shape, strides,
+                              (pData != NULL) ? pData : &empty, owner);
+        if (!writeable)
+        {
+            a.attr("setflags")(py::arg("write") = false);
+        }
+        return a;
+    }
+}
+
+PYBIND11_MODULE(ntrt, m)
+{
+    m.doc() = "NASA Tensegrity Robotics Toolkit simulations";
+
+    py::class_<tgPySimulation>(m, "Simulation",
+        "A headless simulation of a model built from YAML")
+        .def(py::init([](const std::string& structurePath,
+                         double gravity, double stepSize)
+             {
+                 return new tgPySimulation(
+                     structurePath,
+                     tgPySimulation::Config(gravity, stepSize));
+             }),
+             py::arg("structure_path"),
+             py::arg("gravity") = 98.1,
+             py::arg("step_size") = 0.001)
+        .def("step", &tgPySimulation::step,
+             py::arg("steps") = 1,
+             py::call_guard<py::gil_scoped_release>(),
+             "Apply the actions, advance steps physics steps and sample")
+        .def("reset", &tgPySimulation::reset,
+             py::call_guard<py::gil_scoped_release>(),
+             "Rebuild the model; the views stay valid")
+        .def_property_readonly("time", &tgPySimulation::getTime)
+        .def_property_readonly("step_size", &tgPySimulation::getStepSize)
+        .def_property_readonly("cable_tags", &tgPySimulation::getCableTags)
+        .def_property_readonly_static("rod_columns",
+            [](py::object) { return tgPySimulation::getRodColumns(); })
+        .def_property_readonly_static("cable_columns",
+            [](py::object) { return tgPySimulation::getCableColumns(); })
+        .def_property_readonly("actions",
+            [](py::object self)
+            {
+                tgPySimulation& s = self.cast<tgPySimulation&>();
+                return view(s.actions(), { py::ssize_t(s.getCableCount()) },
+                            self, true);
+            },
+            "Control inputs, one per cable; write to command")
+        .def_property_readonly("rods",
+            [](py::object self)
+            {
+                const tgPySimulation& s = self.cast<const tgPySimulation&>();
+                return view(s.rods(),
+                            { py::ssize_t(s.getRodCount()),
+                              py::ssize_t(tgPySimulation::getRodColumns().size()) },
+                            self, false);
+            },
+            "One row per rigid body; see rod_columns")
+        .def_property_readonly("cables",
+            [](py::object self)
+            {
+                const tgPySimulation& s = self.cast<const tgPySimulation&>();
+                return view(s.cables(),
+                            { py::ssize_t(s.getCableCount()),
+                              py::ssize_t(tgPySimulation::getCableColumns().size()) },
+                            self, false);
+            },
+            "One row per cable; see cable_columns");
+}
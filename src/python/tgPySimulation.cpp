@@ -0,0 +1,247 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgPySimulation.cpp
+ * @brief Contains the definitions of members of class tgPySimulation
+ * $Id$
+ */
+
+// This module
+#include "tgPySimulation.h"
+// This application
+#include "yamlbuilder/TensegrityModel.h"
+// This library
+#include "core/terrain/tgBoxGround.h"
+#include "core/tgBaseRigid.h"
+#include "core/tgBasicActuator.h"
+#include "core/tgCast.h"
+#include "core/tgKinematicActuator.h"
+#include "core/tgSpringCableActuator.h"
+// The Bullet Physics Library
+#include "BulletDynamics/Dynamics/btRigidBody.h"
+// The C++ Standard Library
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace
+{
+    const char* const rodColumnNames[] = {
+        "com_x", "com_y", "com_z",
+        "orientation_x", "orientation_y", "orientation_z",
+        "mass",
+        "velocity_x", "velocity_y", "velocity_z",
+        "angular_velocity_x", "angular_velocity_y", "angular_velocity_z"
+    };
+
+    const char* const cableColumnNames[] = {
+        "rest_length", "current_length", "tension"
+    };
+
+    const std::size_t rodColumnCount =
+        sizeof(rodColumnNames) / sizeof(rodColumnNames[0]);
+    const std::size_t cableColumnCount =
+        sizeof(cableColumnNames) / sizeof(cableColumnNames[0]);
+
+    /** tgSimView requires a render rate, though nothing is rendered */
+    double renderRate(double stepSize)
+    {
+        return std::max(1.0 / 60.0, stepSize);
+    }
+}
+
+tgPySimulation::Config::Config(double g, double s) :
+    gravity(g),
+    stepSize(s)
+{
+    if (stepSize <= 0.0)
+    {
+        throw std::invalid_argument("stepSize is not positive");
+    }
+}
+
+tgPySimulation::tgPySimulation(const std::string& structurePath,
+                               const Config& config) :
+    m_config(config),
+    // The world deletes the ground
+    m_world(tgWorld::Config(config.gravity), new tgBoxGround()),
+    m_view(m_world, config.stepSize, renderRate(config.stepSize)),
+    m_simulation(m_view),
+    m_pModel(new TensegrityModel(structurePath)),
+    m_time(0.0)
+{
+    m_simulation.addModel(m_pModel);
+    attach();
+
+    // Sized once: the Python views point into these
+    m_rodRows.resize(m_rods.size() * rodColumnCount);
+    m_cableRows.resize(m_cables.size() * cableColumnCount);
+    m_actions.resize(m_cables.size());
+    sample();
+    resetActions();
+}
+
+tgPySimulation::~tgPySimulation()
+{
+    // m_simulation deletes the model
+}
+
+void tgPySimulation::step(int steps)
+{
+    if (steps < 0)
+    {
+        throw std::invalid_argument("steps is negative");
+    }
+
+    const double dt = m_config.stepSize;
+    for (int s = 0; s < steps; s++)
+    {
+        for (std::size_t i = 0; i < m_cables.size(); i++)
+        {
+            const double target = m_actions[i];
+            // NaN
+            if (target != target)
+            {
+                continue;
+            }
+            tgSpringCableActuator* const pCable = m_cables[i];
+            if (tgKinematicActuator* const pKinematic =
+                tgCast::cast<tgSpringCableActuator, tgKinematicActuator>(pCable))
+            {
+                pKinematic->setControlInput(target);
+            }
+            else if (tgBasicActuator* const pBasic =
+                     tgCast::cast<tgSpringCableActuator, tgBasicActuator>(pCable))
+            {
+                pBasic->setControlInput(target, dt);
+            }
+        }
+        m_simulation.step(dt);
+        m_time += dt;
+    }
+    sample();
+}
+
+void tgPySimulation::reset()
+{
+    const std::size_t rodCount = m_rods.size();
+    const std::size_t cableCount = m_cables.size();
+
+    m_simulation.reset();
+    attach();
+    m_time = 0.0;
+
+    if ((m_rods.size() != rodCount) || (m_cables.size() != cableCount))
+    {
+        throw std::runtime_error("Model changed shape on reset");
+    }
+    sample();
+    resetActions();
+}
+
+const std::vector<std::string>& tgPySimulation::getRodColumns()
+{
+    static const std::vector<std::string> columns(
+        rodColumnNames, rodColumnNames + rodColumnCount);
+    return columns;
+}
+
+const std::vector<std::string>& tgPySimulation::getCableColumns()
+{
+    static const std::vector<std::string> columns(
+        cableColumnNames, cableColumnNames + cableColumnCount);
+    return columns;
+}
+
+std::vector<std::string> tgPySimulation::getCableTags() const
+{
+    std::vector<std::string> tags;
+    for (std::size_t i = 0; i < m_cables.size(); i++)
+    {
+        tgTags cableTags = m_cables[i]->getTags();
+        tags.push_back(cableTags.joinTags(" "));
+    }
+    return tags;
+}
+
+double* tgPySimulation::actions()
+{
+    return m_actions.empty() ? NULL : &m_actions[0];
+}
+
+const double* tgPySimulation::rods() const
+{
+    return m_rodRows.empty() ? NULL : &m_rodRows[0];
+}
+
+const double* tgPySimulation::cables() const
+{
+    return m_cableRows.empty() ? NULL : &m_cableRows[0];
+}
+
+void tgPySimulation::resetActions()
+{
+    for (std::size_t i = 0; i < m_cables.size(); i++)
+    {
+        // A motor's input is a torque; don't guess one
+        m_actions[i] =
+            tgCast::cast<tgSpringCableActuator, tgKinematicActuator>(m_cables[i]) ?
+            std::numeric_limits<double>::quiet_NaN() :
+            m_cables[i]->getRestLength();
+    }
+}
+
+void tgPySimulation::attach()
+{
+    const std::vector<tgModel*> descendants = m_pModel->getDescendants();
+    m_rods = tgCast::filter<tgModel, tgBaseRigid>(descendants);
+    m_cables = tgCast::filter<tgModel, tgSpringCableActuator>(descendants);
+}
+
+void tgPySimulation::sample()
+{
+    double* pRow = m_rodRows.empty() ? NULL : &m_rodRows[0];
+    for (std::size_t i = 0; i < m_rods.size(); i++, pRow += rodColumnCount)
+    {
+        const tgBaseRigid& rod = *m_rods[i];
+        const btVector3 com = rod.centerOfMass();
+        const btVector3 orientation = rod.orientation();
+        const btRigidBody* const pBody = m_rods[i]->getPRigidBody();
+        const btVector3 v = pBody->getLinearVelocity();
+        const btVector3 w = pBody->getAngularVelocity();
+        const double row[rodColumnCount] = {
+            com.x(), com.y(), com.z(),
+            orientation.x(), orientation.y(), orientation.z(),
+            rod.mass(),
+            v.x(), v.y(), v.z(),
+            w.x(), w.y(), w.z()
+        };
+        std::copy(row, row + rodColumnCount, pRow);
+    }
+
+    pRow = m_cableRows.empty() ? NULL : &m_cableRows[0];
+    for (std::size_t i = 0; i < m_cables.size();
+         i++, pRow += cableColumnCount)
+    {
+        const tgSpringCableActuator& cable = *m_cables[i];
+        pRow[0] = cable.getRestLength();
+        pRow[1] = cable.getCurrentLength();
+        pRow[2] = cable.getTension();
+    }
+}
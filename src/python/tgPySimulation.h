@@ -0,0 +1,167 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_PY_SIMULATION_H
+#define TG_PY_SIMULATION_H
+
+/**
+ * @file tgPySimulation.h
+ * @brief Contains the definition of class tgPySimulation
+ * $Id$
+ */
+
+// This library
+#include "core/tgSimulation.h"
+#include "core/tgSimView.h"
+#include "core/tgWorld.h"
+// The C++ Standard Library
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Forward declarations
+class TensegrityModel;
+class tgBaseRigid;
+class tgSpringCableActuator;
+
+/**
+ * A headless simulation of one YAML model, with its state and commands
+ * in flat arrays of doubles, for the ntrt Python module.
+ *
+ * The arrays are sized when the model is built and never reallocated,
+ * so the module hands them to NumPy as persistent views that stay
+ * valid across step() and reset(). They are staging buffers, not the
+ * model's own state: sample() copies every rod and cable into rods and
+ * cables after each step. Rows are in the order of
+ * tgModel::getDescendants().
+ *
+ * - actions: one control input per cable, passed to setControlInput()
+ *   before every physics step: the preferred rest length of a
+ *   tgBasicActuator, or the desired motor torque of a
+ *   tgKinematicActuator. NaN leaves a cable alone.
+ * - rods: one row of getRodColumns() values per rigid body, the fields
+ *   of tgRodSensor followed by the velocities.
+ * - cables: one row of getCableColumns() values per cable, the fields
+ *   of tgSpringCableActuatorSensor.
+ */
+class tgPySimulation
+{
+public:
+
+    struct Config
+    {
+        /**
+         * @param[in] gravity in length units per second squared; the
+         * YAML builder's examples use dm/sec^2
+         * @param[in] stepSize the physics timestep, in seconds
+         * @throw std::invalid_argument if stepSize is not positive
+         */
+        Config(double gravity = 98.1, double stepSize = 0.001);
+
+        double gravity;
+        double stepSize;
+    };
+
+    /**
+     * Build the model on a flat box ground and sample it.
+     * @param[in] structurePath the YAML file, as for BuildModel
+     */
+    tgPySimulation(const std::string& structurePath,
+                   const Config& config = Config());
+
+    ~tgPySimulation();
+
+    /**
+     * Apply the actions and advance the simulation, then sample.
+     * @param[in] steps the number of physics steps
+     * @throw std::invalid_argument if steps is negative
+     */
+    void step(int steps = 1);
+
+    /**
+     * Rebuild the model as it was constructed, sample, and reset the
+     * actions; see resetActions().
+     * @throw std::runtime_error if the rebuilt model has a different
+     * number of rods or cables
+     */
+    void reset();
+
+    /** Return the simulated time since construction or reset. */
+    double getTime() const { return m_time; }
+
+    double getStepSize() const { return m_config.stepSize; }
+
+    std::size_t getRodCount() const { return m_rods.size(); }
+
+    std::size_t getCableCount() const { return m_cables.size(); }
+
+    /** Return the names of the columns of a rod row. */
+    static const std::vector<std::string>& getRodColumns();
+
+    /** Return the names of the columns of a cable row. */
+    static const std::vector<std::string>& getCableColumns();
+
+    /** Return the tags of each cable, joined with spaces. */
+    std::vector<std::string> getCableTags() const;
+
+    /** getCableCount() values; NULL if there are no cables */
+    double* actions();
+
+    /** getRodCount() rows, row major; NULL if there are no rods */
+    const double* rods() const;
+
+    /** getCableCount() rows, row major; NULL if there are no cables */
+    const double* cables() const;
+
+private:
+
+    /** Find the rods and cables of the current model. */
+    void attach();
+
+    /** Fill the rod and cable rows. */
+    void sample();
+
+    /**
+     * Set the action of each tgBasicActuator to its rest length, and of
+     * each tgKinematicActuator to NaN.
+     */
+    void resetActions();
+
+private:
+
+    const Config m_config;
+
+    tgWorld m_world;
+    tgSimView m_view;
+    tgSimulation m_simulation;
+
+    /** Owned by m_simulation */
+    TensegrityModel* m_pModel;
+
+    /** Invalidated by reset(); see attach() */
+    std::vector<tgBaseRigid*> m_rods;
+    std::vector<tgSpringCableActuator*> m_cables;
+
+    std::vector<double> m_actions;
+    std::vector<double> m_rodRows;
+    std::vector<double> m_cableRows;
+
+    double m_time;
+};
+
+#endif  // TG_PY_SIMULATION_H
@@ -28,6 +28,7 @@
 
 #include "core/tgBulletSpringCable.h"
 #include "core/tgBulletSpringCableAnchor.h"
+#include "tgUtil.h"
 
 tgBasicActuatorInfo::tgBasicActuatorInfo(const tgBasicActuator::Config& config) : 
 m_config(config),
@@ -67,6 +68,29 @@ tgModel* tgBasicActuatorInfo::createModel(tgWorld& world)
     return new tgBasicActuator(m_bulletSpringCable, getTags(), m_config);
 }
 
+std::size_t tgBasicActuatorInfo::getConfigHash() const
+{
+    std::size_t h = tgConnectorInfo::getConfigHash();
+    tgUtil::hashCombine(h, hashConfig(m_config));
+    return h;
+}
+
+std::size_t tgBasicActuatorInfo::hashConfig(const tgBasicActuator::Config& config)
+{
+    std::size_t h = 0;
+    tgUtil::hashCombine(h, tgUtil::hashDouble(config.stiffness));
+    tgUtil::hashCombine(h, tgUtil::hashDouble(config.damping));
+    tgUtil::hashCombine(h, tgUtil::hashDouble(config.pretension));
+    tgUtil::hashCombine(h, tgUtil::hashDouble(config.maxTens));
+    tgUtil::hashCombine(h, tgUtil::hashDouble(config.targetVelocity));
+    tgUtil::hashCombine(h, tgUtil::hashDouble(config.minActualLength));
+    tgUtil::hashCombine(h, tgUtil::hashDouble(config.minRestLength));
+    tgUtil::hashCombine(h, tgUtil::hashDouble(config.rotation));
+    tgUtil::hashCombine(h, config.moveCablePointAToEdge);
+    tgUtil::hashCombine(h, config.moveCablePointBToEdge);
+    return h;
+}
+
 double tgBasicActuatorInfo::getMass() 
 {
     // @todo: calculate a mass? tgBulletSpringCable doesn't have physics...
@@ -76,7 +100,11 @@ double tgBasicActuatorInfo::getMass()
 
 tgBulletSpringCable* tgBasicActuatorInfo::createTgBulletSpringCable()
 {
-     
+    return new tgBulletSpringCable(createAnchors(), m_config.stiffness, m_config.damping, m_config.pretension);
+}
+
+std::vector<tgBulletSpringCableAnchor*> tgBasicActuatorInfo::createAnchors()
+{
     // @todo: need to check somewhere that the rigid bodies have been set...
     btRigidBody* fromBody = getFromRigidBody();
     btRigidBody* toBody = getToRigidBody();
@@ -121,6 +149,6 @@ tgBulletSpringCable* tgBasicActuatorInfo::createTgBulletSpringCable()
     tgBulletSpringCableAnchor* anchor2 = new tgBulletSpringCableAnchor(toBody, to);
     anchorList.push_back(anchor2);
 	
-    return new tgBulletSpringCable(anchorList, m_config.stiffness, m_config.damping, m_config.pretension);
+    return anchorList;
 }
     
@@ -32,11 +32,13 @@
 #include "tgRigidInfo.h"
 
 #include <string>
+#include <vector>
 
 #include "core/tgBasicActuator.h"
 #include "core/tgTags.h"
 
 class tgBulletSpringCable;
+class tgBulletSpringCableAnchor;
 
 class tgBasicActuatorInfo : public tgConnectorInfo
 {
@@ -79,9 +81,35 @@ public:
 
     double getMass();
 
+    /**
+     * Hash the type and the config.
+     * @return a hash that is the same in every run
+     */
+    virtual std::size_t getConfigHash() const;
+
+    /**
+     * Hash the fields of a spring cable config that affect its behavior.
+     * Shared with the contact cable infos.
+     * @param[in] config a spring cable config
+     * @return a hash that is the same in every run
+     */
+    static std::size_t hashConfig(const tgBasicActuator::Config& config);
+
+    const tgBasicActuator::Config& getConfig() const
+    {
+        return m_config;
+    }
+
 protected:    
     
     tgBulletSpringCable* createTgBulletSpringCable();
+
+    /**
+     * Create the anchors at the ends of the pair, or at the edges of the
+     * rigids if the config says so. The caller owns them.
+     */
+    std::vector<tgBulletSpringCableAnchor*> createAnchors();
+
     tgBulletSpringCable* m_bulletSpringCable;
 private:
     
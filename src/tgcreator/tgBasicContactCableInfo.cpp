@@ -25,6 +25,8 @@
  */
 
 #include "tgBasicContactCableInfo.h"
+#include "tgBasicActuatorInfo.h"
+#include "tgUtil.h"
 
 #include "core/tgBulletContactSpringCable.h"
 
@@ -76,6 +78,13 @@ tgModel* tgBasicContactCableInfo::createModel(tgWorld& world)
     return new tgBasicActuator(m_bulletContactSpringCable, getTags(), m_config);
 }
 
+std::size_t tgBasicContactCableInfo::getConfigHash() const
+{
+    std::size_t h = tgConnectorInfo::getConfigHash();
+    tgUtil::hashCombine(h, tgBasicActuatorInfo::hashConfig(m_config));
+    return h;
+}
+
 double tgBasicContactCableInfo::getMass() 
 {
     // @todo: calculate a mass? tgBulletContactSpringCable doesn't have mass...
@@ -79,6 +79,17 @@ public:
 
     double getMass();
 
+    /**
+     * Hash the type and the config.
+     * @return a hash that is the same in every run
+     */
+    virtual std::size_t getConfigHash() const;
+
+    const tgBasicActuator::Config& getConfig() const
+    {
+        return m_config;
+    }
+
 protected:
     tgBulletContactSpringCable* m_bulletContactSpringCable;
     
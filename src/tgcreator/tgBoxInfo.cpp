@@ -26,6 +26,7 @@
 
 // This Module
 #include "tgBoxInfo.h"
+#include "tgUtil.h"
 
 // The NTRT Core library
 #include "core/tgWorldBulletPhysicsImpl.h"
@@ -116,6 +117,18 @@ btCollisionShape* tgBoxInfo::getCollisionShape(tgWorld& world) const
     return m_collisionShape;
 }
 
+std::size_t tgBoxInfo::getConfigHash() const
+{
+    std::size_t h = tgRigidInfo::getConfigHash();
+    tgUtil::hashCombine(h, tgUtil::hashDouble(m_config.width));
+    tgUtil::hashCombine(h, tgUtil::hashDouble(m_config.height));
+    tgUtil::hashCombine(h, tgUtil::hashDouble(m_config.density));
+    tgUtil::hashCombine(h, tgUtil::hashDouble(m_config.friction));
+    tgUtil::hashCombine(h, tgUtil::hashDouble(m_config.rollFriction));
+    tgUtil::hashCombine(h, tgUtil::hashDouble(m_config.restitution));
+    return h;
+}
+
 double tgBoxInfo::getMass() const
 {
   // NOTE that this function previously assumed that the full width and full height
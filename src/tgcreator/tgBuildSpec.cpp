@@ -31,6 +31,9 @@
 #include "core/tgException.h"
 #include "core/tgTags.h"
 #include "core/tgTagSearch.h"
+#include "tgUtil.h"
+// The C++ Standard Library
+#include <sstream>
 
 tgBuildSpec::RigidAgent::~RigidAgent()  
 {
@@ -72,3 +75,22 @@ void tgBuildSpec::addBuilder(std::string tag_search, tgConnectorInfo* infoFactor
     m_connectorAgents.push_back(new ConnectorAgent(tag_search, infoFactory));
 }
 
+std::size_t tgBuildSpec::getHash() const
+{
+    std::size_t h = 0;
+    for (std::size_t i = 0; i < m_rigidAgents.size(); i++)
+    {
+        std::ostringstream search;
+        search << m_rigidAgents[i]->tagSearch.getSearch();
+        tgUtil::hashCombine(h, tgUtil::hashString(search.str()));
+        tgUtil::hashCombine(h, m_rigidAgents[i]->infoFactory->getConfigHash());
+    }
+    for (std::size_t i = 0; i < m_connectorAgents.size(); i++)
+    {
+        std::ostringstream search;
+        search << m_connectorAgents[i]->tagSearch.getSearch();
+        tgUtil::hashCombine(h, tgUtil::hashString(search.str()));
+        tgUtil::hashCombine(h, m_connectorAgents[i]->infoFactory->getConfigHash());
+    }
+    return h;
+}
@@ -88,6 +88,13 @@ public:
         return m_connectorAgents;
     }
     
+    /**
+     * Return a hash of the tag searches and the configs of the builders,
+     * e.g. to key a cache of simulation results.
+     * @return a hash that is the same in every run
+     */
+    std::size_t getHash() const;
+    
 private:
     std::vector<RigidAgent*> m_rigidAgents;
     std::vector<ConnectorAgent*> m_connectorAgents;  
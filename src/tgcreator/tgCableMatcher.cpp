@@ -0,0 +1,199 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgCableMatcher.cpp
+ * @brief Implementation of class tgCableMatcher
+ * $Id$
+ */
+
+// This module
+#include "tgCableMatcher.h"
+// The C++ Standard Library
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+
+tgCableMatcher::tgCableMatcher(const std::vector<btVector3>& nodes,
+                               const std::vector<std::pair<int, int> >& cables) :
+m_nodes(nodes),
+m_cellSize(1.0),
+m_maxShell(0),
+m_lo(),
+m_hi(),
+m_matched(cables.size(), false)
+{
+    const int n = static_cast<int>(m_nodes.size());
+    double total = 0.0;
+    for (std::size_t i = 0; i < cables.size(); i++)
+    {
+        const int from = cables[i].first;
+        const int to = cables[i].second;
+        if (from < 0 || from >= n || to < 0 || to >= n)
+        {
+            throw std::invalid_argument("Cable end is not a node");
+        }
+        total += m_nodes[from].distance(m_nodes[to]);
+        m_cables.insert(std::make_pair(cableKey(from, to), static_cast<int>(i)));
+    }
+
+    // Half a typical cable keeps a handful of nodes per cell
+    if (total > 0.0)
+    {
+        m_cellSize = total / cables.size() / 2.0;
+    }
+
+    if (m_nodes.empty())
+    {
+        return;
+    }
+    m_lo = cellOf(m_nodes[0]);
+    m_hi = m_lo;
+    for (int i = 0; i < n; i++)
+    {
+        const Cell c = cellOf(m_nodes[i]);
+        m_grid.insert(std::make_pair(hashCell(c.x, c.y, c.z), i));
+        m_lo.x = std::min(m_lo.x, c.x);
+        m_lo.y = std::min(m_lo.y, c.y);
+        m_lo.z = std::min(m_lo.z, c.z);
+        m_hi.x = std::max(m_hi.x, c.x);
+        m_hi.y = std::max(m_hi.y, c.y);
+        m_hi.z = std::max(m_hi.z, c.z);
+    }
+    m_maxShell = std::max(m_hi.x - m_lo.x,
+                          std::max(m_hi.y - m_lo.y, m_hi.z - m_lo.z));
+}
+
+int tgCableMatcher::match(const btVector3& a, const btVector3& b)
+{
+    const int from = nearestNode(a);
+    const int to = nearestNode(b);
+    if (from < 0 || to < 0)
+    {
+        return -1;
+    }
+
+    typedef Index::const_iterator It;
+    const std::pair<It, It> range = m_cables.equal_range(cableKey(from, to));
+    if (range.first == range.second)
+    {
+        return -1;
+    }
+    int best = -1;
+    for (It it = range.first; it != range.second; ++it)
+    {
+        if (!m_matched[it->second] && (best < 0 || it->second < best))
+        {
+            best = it->second;
+        }
+    }
+    if (best < 0)
+    {
+        throw std::runtime_error("Two actuators match the same cable");
+    }
+    m_matched[best] = true;
+    return best;
+}
+
+int tgCableMatcher::nearestNode(const btVector3& p) const
+{
+    int best = -1;
+    double bestDist = std::numeric_limits<double>::infinity();
+    const Cell c = cellOf(p);
+    if (c.x < m_lo.x - 1 || c.x > m_hi.x + 1 ||
+        c.y < m_lo.y - 1 || c.y > m_hi.y + 1 ||
+        c.z < m_lo.z - 1 || c.z > m_hi.z + 1)
+    {
+        // Well away from the nodes, which anchors shouldn't be
+        for (std::size_t i = 0; i < m_nodes.size(); i++)
+        {
+            const double d = p.distance(m_nodes[i]);
+            if (d < bestDist)
+            {
+                best = static_cast<int>(i);
+                bestDist = d;
+            }
+        }
+        return best;
+    }
+
+    // Search shells of cells outwards. Every cell past shell r is at
+    // least r cells from p, so once the best is that close we're done
+    typedef Index::const_iterator It;
+    for (long r = 0; r <= m_maxShell + 2; r++)
+    {
+        for (long dx = -r; dx <= r; dx++)
+        {
+            for (long dy = -r; dy <= r; dy++)
+            {
+                // Only the surface of the shell is new
+                const bool inside = std::labs(dx) < r && std::labs(dy) < r;
+                for (long dz = -r; dz <= r; dz += inside ? 2 * r : 1)
+                {
+                    const std::pair<It, It> range =
+                        m_grid.equal_range(hashCell(c.x + dx, c.y + dy, c.z + dz));
+                    for (It it = range.first; it != range.second; ++it)
+                    {
+                        const double d = p.distance(m_nodes[it->second]);
+                        if (d < bestDist ||
+                            (d == bestDist && it->second < best))
+                        {
+                            best = it->second;
+                            bestDist = d;
+                        }
+                    }
+                }
+            }
+        }
+        if (best >= 0 && bestDist <= r * m_cellSize)
+        {
+            break;
+        }
+    }
+    return best;
+}
+
+tgCableMatcher::Cell tgCableMatcher::cellOf(const btVector3& p) const
+{
+    Cell c;
+    c.x = static_cast<long>(std::floor(p.x() / m_cellSize));
+    c.y = static_cast<long>(std::floor(p.y() / m_cellSize));
+    c.z = static_cast<long>(std::floor(p.z() / m_cellSize));
+    return c;
+}
+
+std::size_t tgCableMatcher::hashCell(long x, long y, long z)
+{
+    // Boost-style hash_combine, as tgUtil::hashPosition
+    std::size_t h = 0;
+    const long q[3] = { x, y, z };
+    for (int i = 0; i < 3; i++)
+    {
+        h ^= static_cast<std::size_t>(q[i]) + 0x9e3779b9 + (h << 6) + (h >> 2);
+    }
+    return h;
+}
+
+std::size_t tgCableMatcher::cableKey(int a, int b) const
+{
+    const std::size_t lo = static_cast<std::size_t>(std::min(a, b));
+    const std::size_t hi = static_cast<std::size_t>(std::max(a, b));
+    return lo * m_nodes.size() + hi;
+}
@@ -0,0 +1,124 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_CABLE_MATCHER_H
+#define TG_CABLE_MATCHER_H
+
+/**
+ * @file tgCableMatcher.h
+ * @brief Definition of class tgCableMatcher
+ * $Id$
+ */
+
+// The Bullet Physics Library
+#include "LinearMath/btVector3.h"
+// The C++ Standard Library
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include <tr1/unordered_map>
+
+/**
+ * Matches the actuators of a built model to the cables of a reduced
+ * structure, as tgFormFinder and tgInverseStatics need to apply the rest
+ * lengths they found.
+ *
+ * Each anchor is snapped to its nearest node through a uniform grid over
+ * the nodes, and the pair of nodes is looked up in a hash of the cables
+ * keyed by their unordered ends. Matching n actuators to m cables is
+ * then about O(n + m) rather than O(n m). Anchors may sit on a rigid's
+ * surface rather than at the node, so long as they are nearer their own
+ * node than any other.
+ *
+ * Each cable can be matched once; two actuators that snap to the same
+ * cable mean the model and the structure disagree.
+ */
+class tgCableMatcher
+{
+public:
+
+    /**
+     * @param[in] nodes the positions of the nodes
+     * @param[in] cables the indexes of the nodes at the ends of each
+     * cable, in nodes
+     * @throw std::invalid_argument if a cable's end is not in nodes
+     */
+    tgCableMatcher(const std::vector<btVector3>& nodes,
+                   const std::vector<std::pair<int, int> >& cables);
+
+    /**
+     * Find the cable between the nodes nearest two anchors, and mark it
+     * as matched. Several cables between the same nodes are handed out
+     * in order.
+     * @param[in] a the position of one anchor
+     * @param[in] b the position of the other
+     * @return the index of the cable, or -1 if no cable joins those nodes
+     * @throw std::runtime_error if every such cable is already matched
+     */
+    int match(const btVector3& a, const btVector3& b);
+
+    /**
+     * Return the index of the node nearest a position, or -1 if there
+     * are no nodes.
+     */
+    int nearestNode(const btVector3& p) const;
+
+private:
+
+    /** Integer coordinates of a grid cell */
+    struct Cell
+    {
+        Cell() : x(0), y(0), z(0) { }
+        long x;
+        long y;
+        long z;
+    };
+
+    Cell cellOf(const btVector3& p) const;
+
+    static std::size_t hashCell(long x, long y, long z);
+
+    /** The key of the cables between two nodes, in either order */
+    std::size_t cableKey(int a, int b) const;
+
+private:
+
+    const std::vector<btVector3> m_nodes;
+
+    /** The side of a grid cell */
+    double m_cellSize;
+
+    /** How many cells out from any cell the farthest node can be */
+    long m_maxShell;
+
+    /** The box of cells holding the nodes */
+    Cell m_lo;
+    Cell m_hi;
+
+    typedef std::tr1::unordered_multimap<std::size_t, int> Index;
+
+    /** Nodes by the hash of their cell */
+    Index m_grid;
+
+    /** Cables by cableKey() of their ends */
+    Index m_cables;
+
+    std::vector<bool> m_matched;
+};
+
+#endif  // TG_CABLE_MATCHER_H
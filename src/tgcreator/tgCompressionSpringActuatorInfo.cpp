@@ -30,6 +30,7 @@
 // Other classes from core
 #include "core/tgBulletCompressionSpring.h"
 #include "core/tgBulletSpringCableAnchor.h"
+#include "tgUtil.h"
 
 tgCompressionSpringActuatorInfo::tgCompressionSpringActuatorInfo(const tgCompressionSpringActuator::Config& config) : 
 m_config(config),
@@ -68,6 +69,18 @@ tgModel* tgCompressionSpringActuatorInfo::createModel(tgWorld& world)
     return new tgCompressionSpringActuator(m_bulletCompressionSpring, getTags(), m_config);
 }
 
+std::size_t tgCompressionSpringActuatorInfo::getConfigHash() const
+{
+    std::size_t h = tgConnectorInfo::getConfigHash();
+    tgUtil::hashCombine(h, m_config.isFreeEndAttached);
+    tgUtil::hashCombine(h, tgUtil::hashDouble(m_config.stiffness));
+    tgUtil::hashCombine(h, tgUtil::hashDouble(m_config.damping));
+    tgUtil::hashCombine(h, tgUtil::hashDouble(m_config.restLength));
+    tgUtil::hashCombine(h, m_config.moveCablePointAToEdge);
+    tgUtil::hashCombine(h, m_config.moveCablePointBToEdge);
+    return h;
+}
+
 double tgCompressionSpringActuatorInfo::getMass() 
 {
     // @todo: this should never be called, unless we wanted to model the mass of
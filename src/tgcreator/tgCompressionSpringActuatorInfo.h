@@ -96,6 +96,12 @@ public:
 
     double getMass();
 
+    /**
+     * Hash the type and the config.
+     * @return a hash that is the same in every run
+     */
+    virtual std::size_t getConfigHash() const;
+
 protected:    
 
     /**
@@ -29,12 +29,15 @@
 #include "tgPair.h"
 #include "tgPairs.h"
 #include "tgRigidInfo.h"
+#include "tgUtil.h"
 
 #include "core/tgTagSearch.h"
 
 #include "LinearMath/btVector3.h"
 #include "BulletDynamics/Dynamics/btRigidBody.h"
 
+#include <typeinfo>
+
 
 tgConnectorInfo* tgConnectorInfo::createConnectorInfo(const tgPair& pair, const tgTagSearch& tagSearch)
 {
@@ -199,3 +202,8 @@ bool tgConnectorInfo::rigidFoundIn(std::set<tgRigidInfo*> rigids, tgRigidInfo* r
     }
     return false;
 };    
+
+std::size_t tgConnectorInfo::getConfigHash() const
+{
+    return tgUtil::hashString(typeid(*this).name());
+}
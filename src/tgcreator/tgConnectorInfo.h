@@ -145,6 +145,15 @@ public:
     // Note that different connectors will likely use different methods of calculating mass...
     virtual double getMass() = 0;
     
+    /**
+     * Return a hash of everything about this connector's configuration
+     * that affects how it behaves, e.g. to key a cache of simulation
+     * results. The default hashes only the type; subclasses add their
+     * config.
+     * @return a hash that is the same in every run
+     */
+    virtual std::size_t getConfigHash() const;
+    
     
     // Choose the appropriate rigids for the connector and give the connector pointers to them
     virtual void chooseRigids(std::set<tgRigidInfo*> rigids);
@@ -0,0 +1,566 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgFormFinder.cpp
+ * @brief Implementation of class tgFormFinder
+ * @date October 2026
+ * $Id$
+ */
+
+// This module
+#include "tgFormFinder.h"
+// This library
+#include "tgBasicActuatorInfo.h"
+#include "tgBasicContactCableInfo.h"
+#include "tgCableMatcher.h"
+#include "tgConnectorInfo.h"
+#include "tgRigidInfo.h"
+#include "tgStructure.h"
+#include "tgStructureInfo.h"
+#include "tgUtil.h"
+// The NTRT Core Library
+#include "core/tgCast.h"
+#include "core/tgModel.h"
+#include "core/tgSpringCable.h"
+#include "core/tgSpringCableActuator.h"
+#include "core/tgSpringCableAnchor.h"
+// The C++ Standard Library
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <set>
+#include <stdexcept>
+#include <tr1/unordered_map>
+
+tgFormFinder::Config::Config(double g,
+                             bool useGround,
+                             double height,
+                             bool sticky,
+                             double tol,
+                             int maxIter,
+                             int constraintIter) :
+    gravity(g),
+    hasGround(useGround),
+    groundHeight(height),
+    stickyGround(sticky),
+    tolerance(tol),
+    maxIterations(maxIter),
+    constraintIterations(constraintIter)
+{
+    if (tolerance <= 0.0)
+    {
+        throw std::invalid_argument("Tolerance is not positive");
+    }
+    else if (maxIterations < 1)
+    {
+        throw std::invalid_argument("maxIterations must be at least 1");
+    }
+    else if (constraintIterations < 1)
+    {
+        throw std::invalid_argument("constraintIterations must be at least 1");
+    }
+}
+
+namespace
+{
+    /** Disjoint-set forest over node indices, for grouping rigids. */
+    int findRoot(std::vector<int>& parent, int i)
+    {
+        while (parent[i] != i)
+        {
+            parent[i] = parent[parent[i]];
+            i = parent[i];
+        }
+        return i;
+    }
+}
+
+tgFormFinder::tgFormFinder(tgStructure& structure, tgBuildSpec& buildSpec,
+                           const Config& config) :
+    m_config(config),
+    m_iterations(0),
+    m_residual(0.0)
+{
+    tgStructureInfo info(structure, buildSpec);
+    info.addRigidsAndConnectors();
+
+    addRigids(info);
+    addCables(info);
+
+    m_position = m_design;
+    m_velocity.assign(m_design.size(), btVector3(0.0, 0.0, 0.0));
+    m_force.assign(m_design.size(), btVector3(0.0, 0.0, 0.0));
+    m_grounded.assign(m_design.size(), false);
+    m_groundAnchor = m_design;
+
+    // Fictitious masses: large enough that an explicit step of dt = 1 is
+    // stable for the stiffest cable at each node
+    m_inertia.assign(m_design.size(), 0.0);
+    for (std::size_t i = 0; i < m_cables.size(); i++)
+    {
+        m_inertia[m_cables[i].from] += m_cables[i].stiffness;
+        m_inertia[m_cables[i].to] += m_cables[i].stiffness;
+    }
+    for (std::size_t i = 0; i < m_inertia.size(); i++)
+    {
+        m_inertia[i] = std::max(m_inertia[i], m_mass[i]);
+        if (m_inertia[i] <= 0.0)
+        {
+            m_inertia[i] = 1.0;
+        }
+    }
+}
+
+tgFormFinder::~tgFormFinder()
+{
+}
+
+int tgFormFinder::findNode(const btVector3& v) const
+{
+    typedef NodeIndex::const_iterator It;
+    const std::pair<It, It> range =
+        m_nodeIndex.equal_range(tgUtil::hashPosition(v));
+    for (It it = range.first; it != range.second; ++it)
+    {
+        if (m_design[it->second] == v)
+        {
+            return it->second;
+        }
+    }
+    return -1;
+}
+
+int tgFormFinder::nodeIndex(const btVector3& v)
+{
+    int i = findNode(v);
+    if (i < 0)
+    {
+        i = m_design.size();
+        m_design.push_back(v);
+        m_mass.push_back(0.0);
+        m_nodeIndex.insert(std::make_pair(tgUtil::hashPosition(v), i));
+    }
+    return i;
+}
+
+void tgFormFinder::addRigids(const tgStructureInfo& info)
+{
+    const std::vector<tgRigidInfo*> rigids = info.getAllRigids();
+
+    // Lump each rigid's mass equally on its nodes, and merge rigids that
+    // share nodes into one body
+    std::vector<int> parent;
+    std::vector<bool> inRigid;
+    for (std::size_t i = 0; i < rigids.size(); i++)
+    {
+        const tgRigidInfo* const pRigid = rigids[i];
+        assert(pRigid != NULL);
+
+        const std::set<btVector3> contained = pRigid->getContainedNodes();
+        std::vector<int> nodes;
+        for (std::set<btVector3>::const_iterator it = contained.begin();
+             it != contained.end(); ++it)
+        {
+            const int n = nodeIndex(*it);
+            if (std::find(nodes.begin(), nodes.end(), n) == nodes.end())
+            {
+                nodes.push_back(n);
+            }
+        }
+        if (nodes.empty())
+        {
+            continue;
+        }
+
+        parent.resize(m_design.size());
+        inRigid.resize(m_design.size(), false);
+        for (std::size_t j = 0; j < nodes.size(); j++)
+        {
+            m_mass[nodes[j]] += pRigid->getMass() / nodes.size();
+            if (!inRigid[nodes[j]])
+            {
+                inRigid[nodes[j]] = true;
+                parent[nodes[j]] = nodes[j];
+            }
+        }
+        for (std::size_t j = 1; j < nodes.size(); j++)
+        {
+            parent[findRoot(parent, nodes[j])] = findRoot(parent, nodes[0]);
+        }
+    }
+
+    // Gather the nodes of each body
+    std::tr1::unordered_map<int, std::vector<int> > bodies;
+    for (std::size_t i = 0; i < inRigid.size(); i++)
+    {
+        if (inRigid[i])
+        {
+            bodies[findRoot(parent, i)].push_back(i);
+        }
+    }
+
+    // Rigidify each body with O(n) links: link every node to up to four
+    // anchors that span the body (a point, a line, a plane, a volume)
+    typedef std::tr1::unordered_map<int, std::vector<int> >::const_iterator
+        BodyIt;
+    for (BodyIt it = bodies.begin(); it != bodies.end(); ++it)
+    {
+        const std::vector<int>& body = it->second;
+        const double eps = 1.0e-9;
+
+        std::vector<int> anchors;
+        anchors.push_back(body[0]);
+        const btVector3& p0 = m_design[body[0]];
+
+        int best = -1;
+        double bestDist = eps;
+        for (std::size_t j = 0; j < body.size(); j++)
+        {
+            const double d = p0.distance(m_design[body[j]]);
+            if (d > bestDist)
+            {
+                best = body[j];
+                bestDist = d;
+            }
+        }
+        if (best >= 0)
+        {
+            anchors.push_back(best);
+            const btVector3 axis = (m_design[best] - p0).normalized();
+
+            best = -1;
+            bestDist = eps;
+            for (std::size_t j = 0; j < body.size(); j++)
+            {
+                const double d =
+                    (m_design[body[j]] - p0).cross(axis).length();
+                if (d > bestDist)
+                {
+                    best = body[j];
+                    bestDist = d;
+                }
+            }
+            if (best >= 0)
+            {
+                anchors.push_back(best);
+                const btVector3 normal =
+                    axis.cross(m_design[best] - p0).normalized();
+
+                best = -1;
+                bestDist = eps;
+                for (std::size_t j = 0; j < body.size(); j++)
+                {
+                    const double d =
+                        std::fabs((m_design[body[j]] - p0).dot(normal));
+                    if (d > bestDist)
+                    {
+                        best = body[j];
+                        bestDist = d;
+                    }
+                }
+                if (best >= 0)
+                {
+                    anchors.push_back(best);
+                }
+            }
+        }
+
+        for (std::size_t j = 0; j < body.size(); j++)
+        {
+            const std::vector<int>::const_iterator self =
+                std::find(anchors.begin(), anchors.end(), body[j]);
+            // Anchors link only to the anchors before them
+            const std::size_t nLinks = (self == anchors.end()) ?
+                anchors.size() : (self - anchors.begin());
+            for (std::size_t k = 0; k < nLinks; k++)
+            {
+                Link link;
+                link.from = anchors[k];
+                link.to = body[j];
+                link.length = m_design[link.from].distance(m_design[link.to]);
+                m_links.push_back(link);
+            }
+        }
+    }
+}
+
+void tgFormFinder::addCables(const tgStructureInfo& info)
+{
+    std::vector<const tgStructureInfo*> open(1, &info);
+    while (!open.empty())
+    {
+        const tgStructureInfo* const pInfo = open.back();
+        open.pop_back();
+        open.insert(open.end(), pInfo->getChildren().begin(),
+                    pInfo->getChildren().end());
+
+        const std::vector<tgConnectorInfo*>& connectors =
+            pInfo->getConnectors();
+        for (std::size_t i = 0; i < connectors.size(); i++)
+        {
+            const tgConnectorInfo* const pConnector = connectors[i];
+            assert(pConnector != NULL);
+
+            const tgSpringCableActuator::Config* pConfig = NULL;
+            if (const tgBasicActuatorInfo* const pActuator =
+                tgCast::cast<tgConnectorInfo, tgBasicActuatorInfo>(pConnector))
+            {
+                pConfig = &pActuator->getConfig();
+            }
+            else if (const tgBasicContactCableInfo* const pContact =
+                tgCast::cast<tgConnectorInfo, tgBasicContactCableInfo>(pConnector))
+            {
+                pConfig = &pContact->getConfig();
+            }
+            if (pConfig == NULL)
+            {
+                // Not a spring cable
+                continue;
+            }
+
+            Cable cable;
+            cable.from = nodeIndex(pConnector->getFrom());
+            cable.to = nodeIndex(pConnector->getTo());
+            cable.stiffness = pConfig->stiffness;
+            cable.designLength =
+                pConnector->getFrom().distance(pConnector->getTo());
+            // Same rule as tgSpringCable
+            cable.restLength = cable.designLength -
+                pConfig->pretension / pConfig->stiffness;
+            if (cable.restLength <= 0.0)
+            {
+                throw std::invalid_argument("Pretension causes string to shorten past rest length!");
+            }
+            m_cables.push_back(cable);
+        }
+    }
+}
+
+void tgFormFinder::computeForces()
+{
+    const btVector3 g(0.0, -m_config.gravity, 0.0);
+    for (std::size_t i = 0; i < m_force.size(); i++)
+    {
+        m_force[i] = g * m_mass[i];
+    }
+    for (std::size_t i = 0; i < m_cables.size(); i++)
+    {
+        const Cable& c = m_cables[i];
+        const btVector3 d = m_position[c.to] - m_position[c.from];
+        const double length = d.length();
+        if (length > c.restLength)
+        {
+            const btVector3 f = d * (c.stiffness * (length - c.restLength) /
+                                     length);
+            m_force[c.from] += f;
+            m_force[c.to] -= f;
+        }
+    }
+}
+
+void tgFormFinder::projectConstraints()
+{
+    const double h = m_config.groundHeight;
+    for (int pass = 0; pass < m_config.constraintIterations; pass++)
+    {
+        for (std::size_t i = 0; i < m_links.size(); i++)
+        {
+            const Link& l = m_links[i];
+            const btVector3 d = m_position[l.to] - m_position[l.from];
+            const double length = d.length();
+            if (length <= 0.0)
+            {
+                continue;
+            }
+            const double wFrom = 1.0 / m_inertia[l.from];
+            const double wTo = 1.0 / m_inertia[l.to];
+            const btVector3 correction =
+                d * ((length - l.length) / (length * (wFrom + wTo)));
+            m_position[l.from] += correction * wFrom;
+            m_position[l.to] -= correction * wTo;
+        }
+
+        if (m_config.hasGround)
+        {
+            for (std::size_t i = 0; i < m_position.size(); i++)
+            {
+                btVector3& p = m_position[i];
+                if (p.y() <= h)
+                {
+                    if (m_config.stickyGround)
+                    {
+                        if (!m_grounded[i])
+                        {
+                            m_grounded[i] = true;
+                            m_groundAnchor[i] = btVector3(p.x(), h, p.z());
+                        }
+                        p = m_groundAnchor[i];
+                    }
+                    else
+                    {
+                        p.setY(h);
+                    }
+                }
+                else if (m_grounded[i])
+                {
+                    if (p.y() > h + m_config.tolerance)
+                    {
+                        // Lifted off
+                        m_grounded[i] = false;
+                    }
+                    else
+                    {
+                        p = m_groundAnchor[i];
+                    }
+                }
+            }
+        }
+    }
+}
+
+bool tgFormFinder::solve()
+{
+    const std::size_t n = m_position.size();
+    std::vector<btVector3> previous(m_position);
+    double previousEnergy = 0.0;
+
+    m_residual = std::numeric_limits<double>::infinity();
+    for (m_iterations = 0; m_iterations < m_config.maxIterations;
+         m_iterations++)
+    {
+        computeForces();
+
+        // Explicit step with dt = 1
+        double energy = 0.0;
+        for (std::size_t i = 0; i < n; i++)
+        {
+            m_velocity[i] += m_force[i] / m_inertia[i];
+            energy += m_inertia[i] * m_velocity[i].length2();
+        }
+
+        // Kinetic damping: kinetic energy peaked during the last step, so
+        // back up to halfway through it and restart from rest
+        if (energy < previousEnergy)
+        {
+            for (std::size_t i = 0; i < n; i++)
+            {
+                m_position[i] -= (m_position[i] - previous[i]) * 0.5;
+                m_velocity[i].setZero();
+            }
+            projectConstraints();
+            previousEnergy = 0.0;
+            continue;
+        }
+        previousEnergy = energy;
+
+        for (std::size_t i = 0; i < n; i++)
+        {
+            previous[i] = m_position[i];
+            m_position[i] += m_velocity[i];
+        }
+
+        projectConstraints();
+
+        // Keep velocities consistent with the constraints
+        m_residual = 0.0;
+        for (std::size_t i = 0; i < n; i++)
+        {
+            m_velocity[i] = m_position[i] - previous[i];
+            m_residual = std::max(m_residual,
+                                  static_cast<double>(m_velocity[i].length()));
+        }
+
+        if (m_residual < m_config.tolerance)
+        {
+            m_iterations++;
+            return true;
+        }
+    }
+    return false;
+}
+
+btVector3 tgFormFinder::getSettledPosition(const btVector3& designPosition) const
+{
+    const int i = findNode(designPosition);
+    return (i < 0) ? designPosition : m_position[i];
+}
+
+void tgFormFinder::apply(tgStructure& structure) const
+{
+    applyTo(structure);
+}
+
+void tgFormFinder::applyTo(tgStructure& structure) const
+{
+    std::vector<tgNode>& nodes = structure.m_nodes.getNodes();
+    for (std::size_t i = 0; i < nodes.size(); i++)
+    {
+        const btVector3 settled = getSettledPosition(nodes[i]);
+        nodes[i].setValue(settled.x(), settled.y(), settled.z());
+    }
+
+    std::vector<tgPair>& pairs = structure.m_pairs.getPairs();
+    for (std::size_t i = 0; i < pairs.size(); i++)
+    {
+        pairs[i].setFrom(getSettledPosition(pairs[i].getFrom()));
+        pairs[i].setTo(getSettledPosition(pairs[i].getTo()));
+    }
+
+    for (std::size_t i = 0; i < structure.m_children.size(); i++)
+    {
+        applyTo(*structure.m_children[i]);
+    }
+}
+
+void tgFormFinder::applyRestLengths(tgModel& model) const
+{
+    std::vector<std::pair<int, int> > ends(m_cables.size());
+    for (std::size_t i = 0; i < m_cables.size(); i++)
+    {
+        ends[i] = std::make_pair(m_cables[i].from, m_cables[i].to);
+    }
+    tgCableMatcher matcher(m_position, ends);
+
+    const std::vector<tgSpringCableActuator*> actuators =
+        tgCast::filter<tgModel, tgSpringCableActuator>(model.getDescendants());
+    for (std::size_t i = 0; i < actuators.size(); i++)
+    {
+        tgSpringCableActuator* const pActuator = actuators[i];
+        const std::vector<const tgSpringCableAnchor*> anchors =
+            pActuator->getSpringCable()->getAnchors();
+        assert(anchors.size() >= 2);
+        const int best = matcher.match(anchors.front()->getWorldPosition(),
+                                       anchors.back()->getWorldPosition());
+        if (best < 0)
+        {
+            continue;
+        }
+        const Cable* const pBest = &m_cables[best];
+
+        const double settledLength =
+            m_position[pBest->from].distance(m_position[pBest->to]);
+        const double restLength = pActuator->getRestLength() -
+            (settledLength - pBest->designLength);
+        if (restLength > 0.0)
+        {
+            pActuator->setInitialRestLength(restLength);
+        }
+    }
+}
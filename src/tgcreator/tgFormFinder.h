@@ -0,0 +1,249 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_FORM_FINDER_H
+#define TG_FORM_FINDER_H
+
+/**
+ * @file tgFormFinder.h
+ * @brief Definition of class tgFormFinder
+ * @date October 2026
+ * $Id$
+ */
+
+// The Bullet Physics Library
+#include "LinearMath/btVector3.h"
+// The C++ Standard Library
+#include <cstddef>
+#include <vector>
+#include <tr1/unordered_map>
+
+// Forward declarations
+class tgBuildSpec;
+class tgModel;
+class tgStructure;
+class tgStructureInfo;
+
+/**
+ * Computes the static equilibrium of a structure under cable pretension,
+ * gravity and (optionally) the ground, before any world is created. Apps
+ * can then build the structure at its settled pose instead of spending
+ * simulated seconds letting it settle.
+ *
+ * The structure is reduced to a graph: every distinct node position is a
+ * point mass, rigids become distance constraints that hold their nodes
+ * in place (rigids that share nodes are merged, as tgRigidAutoCompound
+ * does), and spring-cable connectors become tension-only springs whose
+ * rest lengths follow the same rule as tgSpringCable. Other connectors are
+ * ignored. The graph is solved by dynamic relaxation with kinetic damping,
+ * which is matrix-free: each iteration is O(nodes + members).
+ *
+ * Typical use:
+ * @code
+ * tgFormFinder finder(structure, spec);
+ * finder.solve();
+ * finder.apply(structure);                 // before building
+ * tgStructureInfo info(structure, spec);
+ * info.buildInto(model, world);
+ * finder.applyRestLengths(model);          // after building
+ * @endcode
+ */
+class tgFormFinder
+{
+public:
+
+    /**
+     * Solver parameters. This is Plain Old Data.
+     */
+    struct Config
+    {
+        Config(double g = 9.81,
+               bool useGround = true,
+               double groundHeight = 0.0,
+               bool sticky = true,
+               double tol = 1.0e-6,
+               int maxIter = 100000,
+               int constraintIter = 10);
+
+        /** Gravitational acceleration, along -y. Same units as tgWorld. */
+        double gravity;
+
+        /** If true, no node may go below groundHeight. */
+        bool hasGround;
+
+        /** The height of the ground plane along y. */
+        double groundHeight;
+
+        /**
+         * If true, nodes that touch the ground keep their x and z until
+         * they lift off again (an infinite-friction approximation).
+         * If false the ground is frictionless.
+         */
+        bool stickyGround;
+
+        /**
+         * Converged when no node moves more than this (length units)
+         * in one iteration.
+         */
+        double tolerance;
+
+        /** Give up after this many iterations. */
+        int maxIterations;
+
+        /** Gauss-Seidel passes per iteration over the rigid constraints. */
+        int constraintIterations;
+    };
+
+    /**
+     * Build the graph for a structure as it would be built with the given
+     * build spec. Neither is modified.
+     * @param[in] structure the structure to solve for
+     * @param[in] buildSpec the build spec that the structure will be
+     * built with
+     * @param[in] config the solver parameters
+     */
+    tgFormFinder(tgStructure& structure, tgBuildSpec& buildSpec,
+                 const Config& config = Config());
+
+    ~tgFormFinder();
+
+    /**
+     * Relax the structure to equilibrium.
+     * @return true if it converged within Config::maxIterations
+     */
+    bool solve();
+
+    /**
+     * Move every node and pair endpoint of the structure (and its children)
+     * to its settled position.
+     * @param[in,out] structure the structure passed to the constructor
+     */
+    void apply(tgStructure& structure) const;
+
+    /**
+     * Restore the cable rest lengths of a model built from the settled
+     * structure. A cable built at a settled length L computes its rest
+     * length from L, so the equilibrium tension would be lost; this
+     * shortens each one by (settled length - design length). Each
+     * actuator's anchors are snapped to their nearest settled nodes and
+     * the cable between them looked up, see tgCableMatcher.
+     * @param[in,out] model the model built from the settled structure
+     * @throw std::runtime_error if two actuators match the same cable
+     */
+    void applyRestLengths(tgModel& model) const;
+
+    /**
+     * Return the settled position of a node.
+     * @param[in] designPosition the node's position in the structure as
+     * passed to the constructor
+     * @return the settled position, or designPosition if it isn't a node
+     */
+    btVector3 getSettledPosition(const btVector3& designPosition) const;
+
+    /** Return the number of iterations the last solve() took. */
+    int getIterations() const
+    {
+        return m_iterations;
+    }
+
+    /**
+     * Return the largest node displacement in the last iteration of
+     * solve(), in length units.
+     */
+    double getResidual() const
+    {
+        return m_residual;
+    }
+
+    /** Return the number of distinct nodes in the graph. */
+    std::size_t getNodeCount() const
+    {
+        return m_design.size();
+    }
+
+private:
+
+    /** A tension-only spring between two nodes. */
+    struct Cable
+    {
+        int from;
+        int to;
+        double stiffness;
+        double restLength;
+        double designLength;
+    };
+
+    /** A fixed distance between two nodes of the same rigid. */
+    struct Link
+    {
+        int from;
+        int to;
+        double length;
+    };
+
+    /** Find or add the node at position v; return its index. */
+    int nodeIndex(const btVector3& v);
+
+    /** Return the index of the node at position v, or -1. */
+    int findNode(const btVector3& v) const;
+
+    void addRigids(const tgStructureInfo& info);
+
+    void addCables(const tgStructureInfo& info);
+
+    /** Accumulate gravity and cable forces into m_force. */
+    void computeForces();
+
+    /** Enforce the rigid links and the ground on m_position. */
+    void projectConstraints();
+
+    /** Apply the settled positions to one structure and its children */
+    void applyTo(tgStructure& structure) const;
+
+    const Config m_config;
+
+    /** Node position hash => indices of nodes with that hash */
+    typedef std::tr1::unordered_multimap<std::size_t, int> NodeIndex;
+    NodeIndex m_nodeIndex;
+
+    /** Per node: position as designed */
+    std::vector<btVector3> m_design;
+
+    /** Per node: current position, velocity and force */
+    std::vector<btVector3> m_position;
+    std::vector<btVector3> m_velocity;
+    std::vector<btVector3> m_force;
+
+    /** Per node: physical mass, for gravity */
+    std::vector<double> m_mass;
+
+    /** Per node: fictitious mass, chosen for stability of the relaxation */
+    std::vector<double> m_inertia;
+
+    /** Per node: whether it rests on the ground, and where */
+    std::vector<bool> m_grounded;
+    std::vector<btVector3> m_groundAnchor;
+
+    std::vector<Cable> m_cables;
+    std::vector<Link> m_links;
+
+    int m_iterations;
+    double m_residual;
+};
+
+#endif  // TG_FORM_FINDER_H
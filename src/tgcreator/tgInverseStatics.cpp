@@ -0,0 +1,684 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgInverseStatics.cpp
+ * @brief Implementation of class tgInverseStatics
+ * $Id$
+ */
+
+// This module
+#include "tgInverseStatics.h"
+// This library
+#include "tgBasicActuatorInfo.h"
+#include "tgBasicContactCableInfo.h"
+#include "tgCableMatcher.h"
+#include "tgConnectorInfo.h"
+#include "tgRigidInfo.h"
+#include "tgStructure.h"
+#include "tgStructureInfo.h"
+#include "tgUtil.h"
+// The NTRT Core Library
+#include "core/tgCast.h"
+#include "core/tgModel.h"
+#include "core/tgSpringCable.h"
+#include "core/tgSpringCableActuator.h"
+#include "core/tgSpringCableAnchor.h"
+// The C++ Standard Library
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <set>
+#include <stdexcept>
+
+tgInverseStatics::Config::Config(double g,
+                                 bool useGround,
+                                 double height,
+                                 double contact,
+                                 bool sticky,
+                                 double minT,
+                                 double weight,
+                                 double tol,
+                                 int maxIter) :
+    gravity(g),
+    hasGround(useGround),
+    groundHeight(height),
+    contactDistance(contact),
+    stickyGround(sticky),
+    minTension(minT),
+    targetWeight(weight),
+    tolerance(tol),
+    maxIterations(maxIter)
+{
+    if (contactDistance < 0.0)
+    {
+        throw std::invalid_argument("contactDistance is negative");
+    }
+    else if (minTension < 0.0)
+    {
+        throw std::invalid_argument("minTension is negative");
+    }
+    else if (!(targetWeight > 0.0))
+    {
+        throw std::invalid_argument("targetWeight is not positive");
+    }
+    else if (tolerance <= 0.0)
+    {
+        throw std::invalid_argument("Tolerance is not positive");
+    }
+    else if (maxIterations < 1)
+    {
+        throw std::invalid_argument("maxIterations must be at least 1");
+    }
+}
+
+namespace
+{
+    /** Disjoint-set forest over node indices, for grouping rigids. */
+    int findRoot(std::vector<int>& parent, int i)
+    {
+        while (parent[i] != i)
+        {
+            parent[i] = parent[parent[i]];
+            i = parent[i];
+        }
+        return i;
+    }
+
+    /**
+     * Solve A x = b in place for a symmetric positive definite A of
+     * size n, stored row-major, by Cholesky factorization.
+     * @return false if A is not positive definite
+     */
+    bool choleskySolve(std::vector<double>& A, std::vector<double>& b,
+                       std::size_t n)
+    {
+        for (std::size_t j = 0; j < n; j++)
+        {
+            double d = A[j * n + j];
+            for (std::size_t k = 0; k < j; k++)
+            {
+                d -= A[j * n + k] * A[j * n + k];
+            }
+            if (!(d > 0.0))
+            {
+                return false;
+            }
+            d = std::sqrt(d);
+            A[j * n + j] = d;
+            for (std::size_t i = j + 1; i < n; i++)
+            {
+                double s = A[i * n + j];
+                for (std::size_t k = 0; k < j; k++)
+                {
+                    s -= A[i * n + k] * A[j * n + k];
+                }
+                A[i * n + j] = s / d;
+            }
+        }
+        for (std::size_t i = 0; i < n; i++)
+        {
+            double s = b[i];
+            for (std::size_t k = 0; k < i; k++)
+            {
+                s -= A[i * n + k] * b[k];
+            }
+            b[i] = s / A[i * n + i];
+        }
+        for (std::size_t i = n; i-- > 0; )
+        {
+            double s = b[i];
+            for (std::size_t k = i + 1; k < n; k++)
+            {
+                s -= A[k * n + i] * b[k];
+            }
+            b[i] = s / A[i * n + i];
+        }
+        return true;
+    }
+}
+
+tgInverseStatics::tgInverseStatics(tgStructure& structure,
+                                   tgBuildSpec& buildSpec,
+                                   const Config& config) :
+    m_config(config),
+    m_rowCount(0),
+    m_residual(0.0),
+    m_iterations(0)
+{
+    tgStructureInfo info(structure, buildSpec);
+    info.addRigidsAndConnectors();
+
+    addRigids(info);
+    addCables(info);
+    assignRows();
+}
+
+int tgInverseStatics::nodeIndex(const btVector3& v)
+{
+    typedef NodeIndex::const_iterator It;
+    const std::size_t hash = tgUtil::hashPosition(v);
+    const std::pair<It, It> range = m_nodeIndex.equal_range(hash);
+    for (It it = range.first; it != range.second; ++it)
+    {
+        if (m_position[it->second] == v)
+        {
+            return it->second;
+        }
+    }
+    const int i = m_position.size();
+    m_position.push_back(v);
+    m_mass.push_back(0.0);
+    m_body.push_back(-1);
+    m_nodeIndex.insert(std::make_pair(hash, i));
+    return i;
+}
+
+void tgInverseStatics::addRigids(const tgStructureInfo& info)
+{
+    const std::vector<tgRigidInfo*> rigids = info.getAllRigids();
+
+    // Lump each rigid's mass on its nodes and merge rigids that share
+    // nodes, as tgFormFinder does
+    std::vector<int> parent;
+    for (std::size_t i = 0; i < rigids.size(); i++)
+    {
+        const tgRigidInfo* const pRigid = rigids[i];
+        assert(pRigid != NULL);
+
+        const std::set<btVector3> contained = pRigid->getContainedNodes();
+        std::vector<int> nodes;
+        for (std::set<btVector3>::const_iterator it = contained.begin();
+             it != contained.end(); ++it)
+        {
+            const int n = nodeIndex(*it);
+            if (std::find(nodes.begin(), nodes.end(), n) == nodes.end())
+            {
+                nodes.push_back(n);
+            }
+        }
+        if (nodes.empty())
+        {
+            continue;
+        }
+
+        parent.resize(m_position.size(), -1);
+        for (std::size_t j = 0; j < nodes.size(); j++)
+        {
+            m_mass[nodes[j]] += pRigid->getMass() / nodes.size();
+            if (parent[nodes[j]] < 0)
+            {
+                parent[nodes[j]] = nodes[j];
+            }
+        }
+        for (std::size_t j = 1; j < nodes.size(); j++)
+        {
+            parent[findRoot(parent, nodes[j])] = findRoot(parent, nodes[0]);
+        }
+    }
+
+    for (std::size_t i = 0; i < parent.size(); i++)
+    {
+        if (parent[i] >= 0)
+        {
+            m_body[i] = findRoot(parent, i);
+        }
+    }
+}
+
+void tgInverseStatics::addCables(const tgStructureInfo& info)
+{
+    std::vector<const tgStructureInfo*> open(1, &info);
+    while (!open.empty())
+    {
+        const tgStructureInfo* const pInfo = open.back();
+        open.pop_back();
+        // Children in order, so cables come out in pre-order
+        open.insert(open.end(), pInfo->getChildren().rbegin(),
+                    pInfo->getChildren().rend());
+
+        const std::vector<tgConnectorInfo*>& connectors =
+            pInfo->getConnectors();
+        for (std::size_t i = 0; i < connectors.size(); i++)
+        {
+            const tgConnectorInfo* const pConnector = connectors[i];
+            assert(pConnector != NULL);
+
+            const tgSpringCableActuator::Config* pConfig = NULL;
+            if (const tgBasicActuatorInfo* const pActuator =
+                tgCast::cast<tgConnectorInfo, tgBasicActuatorInfo>(pConnector))
+            {
+                pConfig = &pActuator->getConfig();
+            }
+            else if (const tgBasicContactCableInfo* const pContact =
+                tgCast::cast<tgConnectorInfo, tgBasicContactCableInfo>(pConnector))
+            {
+                pConfig = &pContact->getConfig();
+            }
+            if (pConfig == NULL)
+            {
+                // Not a spring cable
+                continue;
+            }
+
+            Cable cable;
+            cable.from = nodeIndex(pConnector->getFrom());
+            cable.to = nodeIndex(pConnector->getTo());
+            cable.stiffness = pConfig->stiffness;
+            cable.length = pConnector->getFrom().distance(pConnector->getTo());
+            if (!(cable.length > 0.0))
+            {
+                throw std::invalid_argument("Cable has zero length");
+            }
+            // Slack is not a solution, and the motor can't go past its
+            // tension or rest length limits
+            cable.lower = m_config.minTension;
+            cable.upper = std::min(pConfig->maxTens,
+                cable.stiffness * (cable.length - pConfig->minRestLength));
+            cable.upper = std::max(cable.upper, cable.lower);
+            m_cables.push_back(cable);
+            m_target.push_back(pConfig->pretension);
+        }
+    }
+}
+
+void tgInverseStatics::assignRows()
+{
+    const std::size_t n = m_position.size();
+    m_row.assign(n, 0);
+    m_reference.assign(n, btVector3(0.0, 0.0, 0.0));
+
+    // Each body's moments are about the centroid of its nodes
+    std::vector<int> count(n, 0);
+    std::vector<btVector3> sum(n, btVector3(0.0, 0.0, 0.0));
+    for (std::size_t i = 0; i < n; i++)
+    {
+        if (m_body[i] >= 0)
+        {
+            sum[m_body[i]] += m_position[i];
+            count[m_body[i]]++;
+        }
+    }
+
+    m_rowCount = 0;
+    for (std::size_t i = 0; i < n; i++)
+    {
+        if (m_body[i] < 0)
+        {
+            m_row[i] = m_rowCount;
+            m_rowCount += 3;
+        }
+        else if (m_body[i] == static_cast<int>(i))
+        {
+            m_row[i] = m_rowCount;
+            m_rowCount += 6;
+        }
+    }
+    for (std::size_t i = 0; i < n; i++)
+    {
+        if (m_body[i] >= 0)
+        {
+            const int root = m_body[i];
+            m_row[i] = m_row[root];
+            m_reference[i] = sum[root] / count[root];
+        }
+    }
+}
+
+btVector3 tgInverseStatics::getCableFrom(std::size_t cable) const
+{
+    return m_position[m_cables.at(cable).from];
+}
+
+btVector3 tgInverseStatics::getCableTo(std::size_t cable) const
+{
+    return m_position[m_cables.at(cable).to];
+}
+
+void tgInverseStatics::setTargetTensions(const std::vector<double>& tensions)
+{
+    if (tensions.size() != m_cables.size())
+    {
+        throw std::invalid_argument("Not one target tension per cable");
+    }
+    m_target = tensions;
+}
+
+void tgInverseStatics::setTensionLimits(std::size_t cable,
+                                        double lower, double upper)
+{
+    Cable& c = m_cables.at(cable);
+    if (lower > upper)
+    {
+        throw std::invalid_argument("lower is greater than upper");
+    }
+    c.lower = std::max(c.lower, lower);
+    c.upper = std::max(c.lower, std::min(c.upper, upper));
+}
+
+void tgInverseStatics::addForce(std::vector<Entry>& column, int node,
+                                const btVector3& force) const
+{
+    const std::size_t row = m_row[node];
+    for (int k = 0; k < 3; k++)
+    {
+        const Entry e = { row + k, force[k] };
+        column.push_back(e);
+    }
+    if (m_body[node] >= 0)
+    {
+        const btVector3 moment =
+            (m_position[node] - m_reference[node]).cross(force);
+        for (int k = 0; k < 3; k++)
+        {
+            const Entry e = { row + 3 + k, moment[k] };
+            column.push_back(e);
+        }
+    }
+}
+
+bool tgInverseStatics::solve()
+{
+    const double infinity = std::numeric_limits<double>::infinity();
+
+    // One column per unknown: a unit of each cable's tension, then the
+    // support forces at each node on the ground
+    std::vector<std::vector<Entry> > columns;
+    std::vector<double> lower;
+    std::vector<double> upper;
+    std::vector<double> target;
+    for (std::size_t i = 0; i < m_cables.size(); i++)
+    {
+        const Cable& c = m_cables[i];
+        const btVector3 u =
+            (m_position[c.to] - m_position[c.from]) / c.length;
+        std::vector<Entry> column;
+        addForce(column, c.from, u);
+        addForce(column, c.to, -u);
+        columns.push_back(column);
+        lower.push_back(c.lower);
+        upper.push_back(c.upper);
+        target.push_back(m_target[i]);
+    }
+    if (m_config.hasGround)
+    {
+        for (std::size_t i = 0; i < m_position.size(); i++)
+        {
+            if (m_position[i].y() > m_config.groundHeight +
+                m_config.contactDistance)
+            {
+                continue;
+            }
+            for (int k = 0; k < 3; k++)
+            {
+                if (k != 1 && !m_config.stickyGround)
+                {
+                    continue;
+                }
+                btVector3 direction(0.0, 0.0, 0.0);
+                direction[k] = 1.0;
+                std::vector<Entry> column;
+                addForce(column, i, direction);
+                columns.push_back(column);
+                // The ground only pushes
+                lower.push_back(k == 1 ? 0.0 : -infinity);
+                upper.push_back(infinity);
+                target.push_back(0.0);
+            }
+        }
+    }
+
+    // The unknowns must balance gravity
+    std::vector<double> b(m_rowCount, 0.0);
+    for (std::size_t i = 0; i < m_position.size(); i++)
+    {
+        std::vector<Entry> weight;
+        addForce(weight, i, btVector3(0.0, -m_config.gravity * m_mass[i], 0.0));
+        for (std::size_t j = 0; j < weight.size(); j++)
+        {
+            b[weight[j].row] -= weight[j].value;
+        }
+    }
+
+    // The normal equations, from the sparse columns
+    const std::size_t n = columns.size();
+    const double w = m_config.targetWeight;
+    std::vector<double> H(n * n, 0.0);
+    std::vector<double> c(n, 0.0);
+    std::vector<double> dense(m_rowCount, 0.0);
+    for (std::size_t j = 0; j < n; j++)
+    {
+        for (std::size_t e = 0; e < columns[j].size(); e++)
+        {
+            dense[columns[j][e].row] += columns[j][e].value;
+        }
+        for (std::size_t i = 0; i <= j; i++)
+        {
+            double dot = 0.0;
+            for (std::size_t e = 0; e < columns[i].size(); e++)
+            {
+                dot += columns[i][e].value * dense[columns[i][e].row];
+            }
+            H[i * n + j] = dot;
+            H[j * n + i] = dot;
+        }
+        for (std::size_t e = 0; e < columns[j].size(); e++)
+        {
+            c[j] += columns[j][e].value * b[columns[j][e].row];
+            dense[columns[j][e].row] = 0.0;
+        }
+        H[j * n + j] += w;
+        c[j] += w * target[j];
+    }
+
+    std::vector<double> x(n, 0.0);
+    for (std::size_t j = 0; j < n; j++)
+    {
+        x[j] = std::max(lower[j], std::min(upper[j], target[j]));
+    }
+    solveBoxQP(H, c, lower, upper, x);
+
+    // How far the pose is from equilibrium
+    std::vector<double> r(b);
+    for (std::size_t j = 0; j < n; j++)
+    {
+        for (std::size_t e = 0; e < columns[j].size(); e++)
+        {
+            r[columns[j][e].row] -= columns[j][e].value * x[j];
+        }
+    }
+    m_residual = 0.0;
+    for (std::size_t i = 0; i < r.size(); i++)
+    {
+        m_residual = std::max(m_residual, std::fabs(r[i]));
+    }
+
+    m_tension.assign(x.begin(), x.begin() + m_cables.size());
+    m_restLength.resize(m_cables.size());
+    for (std::size_t i = 0; i < m_cables.size(); i++)
+    {
+        // Same rule as tgSpringCable
+        m_restLength[i] = m_cables[i].length -
+            m_tension[i] / m_cables[i].stiffness;
+    }
+    return m_residual <= m_config.tolerance;
+}
+
+void tgInverseStatics::solveBoxQP(const std::vector<double>& H,
+                                  const std::vector<double>& c,
+                                  const std::vector<double>& lower,
+                                  const std::vector<double>& upper,
+                                  std::vector<double>& x)
+{
+    // Minimize x'Hx/2 - c'x. Each iteration takes a Newton step on the
+    // free variables, stopping at the first bound it hits, or if none
+    // releases the bound variable whose gradient points most inward.
+    const std::size_t n = x.size();
+    std::vector<int> bound(n, 0);
+    std::vector<double> g(n);
+    std::vector<std::size_t> free;
+    std::vector<double> A;
+    std::vector<double> p;
+
+    double scale = 1.0;
+    for (std::size_t i = 0; i < n; i++)
+    {
+        scale = std::max(scale, H[i * n + i]);
+    }
+    const double slack = 1.0e-12 * scale;
+
+    for (m_iterations = 0; m_iterations < m_config.maxIterations;
+         m_iterations++)
+    {
+        for (std::size_t i = 0; i < n; i++)
+        {
+            double s = -c[i];
+            for (std::size_t j = 0; j < n; j++)
+            {
+                s += H[i * n + j] * x[j];
+            }
+            g[i] = s;
+        }
+
+        free.clear();
+        for (std::size_t i = 0; i < n; i++)
+        {
+            if (bound[i] == 0)
+            {
+                free.push_back(i);
+            }
+        }
+        const std::size_t m = free.size();
+        A.resize(m * m);
+        p.resize(m);
+        for (std::size_t i = 0; i < m; i++)
+        {
+            for (std::size_t j = 0; j < m; j++)
+            {
+                A[i * m + j] = H[free[i] * n + free[j]];
+            }
+            p[i] = -g[free[i]];
+        }
+        if (!choleskySolve(A, p, m))
+        {
+            // Only from round off; H has w on its diagonal
+            break;
+        }
+
+        // Step until a free variable hits a bound
+        double alpha = 1.0;
+        std::size_t blocking = n;
+        int side = 0;
+        for (std::size_t k = 0; k < m; k++)
+        {
+            const std::size_t i = free[k];
+            if (p[k] < 0.0 && x[i] + p[k] < lower[i])
+            {
+                const double a = (lower[i] - x[i]) / p[k];
+                if (a < alpha)
+                {
+                    alpha = a;
+                    blocking = i;
+                    side = -1;
+                }
+            }
+            else if (p[k] > 0.0 && x[i] + p[k] > upper[i])
+            {
+                const double a = (upper[i] - x[i]) / p[k];
+                if (a < alpha)
+                {
+                    alpha = a;
+                    blocking = i;
+                    side = 1;
+                }
+            }
+        }
+        for (std::size_t k = 0; k < m; k++)
+        {
+            x[free[k]] += alpha * p[k];
+        }
+        if (blocking < n)
+        {
+            bound[blocking] = side;
+            x[blocking] = (side < 0) ? lower[blocking] : upper[blocking];
+            continue;
+        }
+
+        // Optimal on the free set; is any bound holding x back?
+        std::size_t release = n;
+        double worst = slack;
+        for (std::size_t i = 0; i < n; i++)
+        {
+            double s = -c[i];
+            for (std::size_t j = 0; j < n; j++)
+            {
+                s += H[i * n + j] * x[j];
+            }
+            const double pull = bound[i] * s;
+            if (bound[i] != 0 && pull > worst)
+            {
+                worst = pull;
+                release = i;
+            }
+        }
+        if (release == n)
+        {
+            m_iterations++;
+            return;
+        }
+        bound[release] = 0;
+    }
+}
+
+void tgInverseStatics::applyRestLengths(tgModel& model) const
+{
+    if (m_tension.size() != m_cables.size())
+    {
+        return;
+    }
+    std::vector<std::pair<int, int> > ends(m_cables.size());
+    for (std::size_t i = 0; i < m_cables.size(); i++)
+    {
+        ends[i] = std::make_pair(m_cables[i].from, m_cables[i].to);
+    }
+    tgCableMatcher matcher(m_position, ends);
+
+    const std::vector<tgSpringCableActuator*> actuators =
+        tgCast::filter<tgModel, tgSpringCableActuator>(model.getDescendants());
+    for (std::size_t i = 0; i < actuators.size(); i++)
+    {
+        tgSpringCableActuator* const pActuator = actuators[i];
+        const std::vector<const tgSpringCableAnchor*> anchors =
+            pActuator->getSpringCable()->getAnchors();
+        assert(anchors.size() >= 2);
+        const int best = matcher.match(anchors.front()->getWorldPosition(),
+                                       anchors.back()->getWorldPosition());
+        if (best < 0)
+        {
+            continue;
+        }
+
+        const double restLength = pActuator->getCurrentLength() -
+            m_tension[best] / m_cables[best].stiffness;
+        if (restLength > 0.0)
+        {
+            pActuator->setInitialRestLength(restLength);
+        }
+    }
+}
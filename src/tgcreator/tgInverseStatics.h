@@ -0,0 +1,275 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_INVERSE_STATICS_H
+#define TG_INVERSE_STATICS_H
+
+/**
+ * @file tgInverseStatics.h
+ * @brief Definition of class tgInverseStatics
+ * $Id$
+ */
+
+// The Bullet Physics Library
+#include "LinearMath/btVector3.h"
+// The C++ Standard Library
+#include <cstddef>
+#include <vector>
+#include <tr1/unordered_map>
+
+// Forward declarations
+class tgBuildSpec;
+class tgModel;
+class tgStructure;
+class tgStructureInfo;
+
+/**
+ * Finds the cable rest lengths that hold a structure in equilibrium at
+ * the pose it is given, the inverse of tgFormFinder. Controllers that
+ * need the rest lengths for a target pose or tension distribution can
+ * solve for them directly instead of iterating in simulation.
+ *
+ * The structure is reduced as tgFormFinder reduces it: rigids that share
+ * nodes are one body, each rigid's mass is lumped on its nodes, and
+ * spring-cable connectors are the only members. The unknowns are the
+ * cable tensions and, where nodes touch the ground, the support forces.
+ * Each body must have no net force or moment, and each node outside a
+ * rigid no net force. That sparse system is solved as a bounded least
+ * squares problem,
+ *
+ *     minimize |E t - f|^2 + w |t - t*|^2,  lo <= t <= hi,
+ *
+ * where f is gravity, t* the target tensions (each cable's pretension
+ * unless set) and w the weight of hitting them. A tensegrity usually has
+ * states of self-stress, so the equilibrium alone doesn't fix the
+ * tensions and the targets pick among them. The bounds come from each
+ * cable's config: at least minTension, at most maxTens, and no more than
+ * would take the rest length below minRestLength. The rest length of a
+ * cable is then its length less tension / stiffness, as in tgSpringCable.
+ *
+ * Typical use, with the structure moved to the target pose:
+ * @code
+ * tgInverseStatics statics(structure, spec);
+ * if (statics.solve())
+ * {
+ *     statics.applyRestLengths(model);     // after building
+ * }
+ * @endcode
+ */
+class tgInverseStatics
+{
+public:
+
+    /**
+     * Solver parameters. This is Plain Old Data.
+     */
+    struct Config
+    {
+        /**
+         * @param[in] g gravitational acceleration, along -y
+         * @param[in] useGround whether nodes touching the ground are
+         * supported by it
+         * @param[in] height the height of the ground plane along y
+         * @param[in] contact nodes at most this far above the ground
+         * touch it; must not be negative
+         * @param[in] sticky if true the ground can push sideways too
+         * (friction), else only up
+         * @param[in] minT the least tension of any cable; must not be
+         * negative
+         * @param[in] weight the weight w of the target tensions; must be
+         * positive
+         * @param[in] tol solve() succeeds if no force is out of balance by
+         * more than this
+         * @param[in] maxIter the most active set changes
+         * @throw std::invalid_argument if a parameter is out of range
+         */
+        Config(double g = 9.81,
+               bool useGround = true,
+               double height = 0.0,
+               double contact = 1.0e-3,
+               bool sticky = true,
+               double minT = 0.0,
+               double weight = 1.0e-6,
+               double tol = 1.0e-6,
+               int maxIter = 1000);
+
+        double gravity;
+        bool hasGround;
+        double groundHeight;
+        double contactDistance;
+        bool stickyGround;
+        double minTension;
+        double targetWeight;
+        double tolerance;
+        int maxIterations;
+    };
+
+    /**
+     * Reduce a structure as it would be built with a build spec, at its
+     * current node positions. Neither is modified.
+     * @throw std::invalid_argument if a cable has zero length
+     */
+    tgInverseStatics(tgStructure& structure, tgBuildSpec& buildSpec,
+                     const Config& config = Config());
+
+    /** The number of spring cables, in structure pre-order */
+    std::size_t getCableCount() const
+    {
+        return m_cables.size();
+    }
+
+    /** The end points of a cable */
+    btVector3 getCableFrom(std::size_t cable) const;
+    btVector3 getCableTo(std::size_t cable) const;
+
+    /**
+     * Replace the target tensions, e.g. for a tension distribution
+     * rather than a pose.
+     * @param[in] tensions one per cable
+     * @throw std::invalid_argument if there isn't one per cable
+     */
+    void setTargetTensions(const std::vector<double>& tensions);
+
+    /**
+     * Narrow the tension bounds of a cable.
+     * @throw std::out_of_range if there is no such cable
+     * @throw std::invalid_argument if lower is greater than upper
+     */
+    void setTensionLimits(std::size_t cable, double lower, double upper);
+
+    /**
+     * Solve for the tensions.
+     * @return true if the structure is in equilibrium within the
+     * tolerance; false if no tensions within the limits can hold the pose
+     */
+    bool solve();
+
+    /** The tensions found by solve(), one per cable */
+    const std::vector<double>& getTensions() const
+    {
+        return m_tension;
+    }
+
+    /** The rest lengths found by solve(), one per cable */
+    const std::vector<double>& getRestLengths() const
+    {
+        return m_restLength;
+    }
+
+    /** The largest force or moment out of balance after solve() */
+    double getResidual() const
+    {
+        return m_residual;
+    }
+
+    /** The active set changes the last solve() took */
+    int getIterations() const
+    {
+        return m_iterations;
+    }
+
+    /**
+     * Set the rest lengths of a model built from the structure at this
+     * pose. Cables are matched to actuators by the nodes nearest their
+     * anchors, see tgCableMatcher, and each rest length is taken from the
+     * built cable's length, since its anchors may sit on the rigids'
+     * surfaces.
+     * @param[in,out] model the built model
+     * @throw std::runtime_error if two actuators match the same cable
+     */
+    void applyRestLengths(tgModel& model) const;
+
+private:
+
+    /** A cable between two nodes, and its limits */
+    struct Cable
+    {
+        int from;
+        int to;
+        double stiffness;
+        double length;
+        double lower;
+        double upper;
+    };
+
+    /** One nonzero of the equilibrium matrix */
+    struct Entry
+    {
+        std::size_t row;
+        double value;
+    };
+
+    /** Find or add the node at position v; return its index. */
+    int nodeIndex(const btVector3& v);
+
+    void addRigids(const tgStructureInfo& info);
+
+    void addCables(const tgStructureInfo& info);
+
+    /** Assign each body and free node its rows of the equilibrium. */
+    void assignRows();
+
+    /** Add a force on a node to the column of an unknown. */
+    void addForce(std::vector<Entry>& column, int node,
+                  const btVector3& force) const;
+
+    /**
+     * Solve the bounded least squares problem with a primal active set
+     * method on the normal equations.
+     */
+    void solveBoxQP(const std::vector<double>& H,
+                    const std::vector<double>& c,
+                    const std::vector<double>& lower,
+                    const std::vector<double>& upper,
+                    std::vector<double>& x);
+
+private:
+
+    const Config m_config;
+
+    /** Node position hash => indices of nodes with that hash */
+    typedef std::tr1::unordered_multimap<std::size_t, int> NodeIndex;
+    NodeIndex m_nodeIndex;
+
+    /** Per node: position and lumped mass */
+    std::vector<btVector3> m_position;
+    std::vector<double> m_mass;
+
+    /** Per node: its body, or -1 if it isn't in a rigid */
+    std::vector<int> m_body;
+
+    /** Per node: the first row of its equilibrium; bodies share rows */
+    std::vector<std::size_t> m_row;
+
+    /** Per node: the point about which its body's moments are taken */
+    std::vector<btVector3> m_reference;
+
+    std::size_t m_rowCount;
+
+    std::vector<Cable> m_cables;
+
+    std::vector<double> m_target;
+
+    std::vector<double> m_tension;
+    std::vector<double> m_restLength;
+
+    double m_residual;
+    int m_iterations;
+};
+
+#endif  // TG_INVERSE_STATICS_H
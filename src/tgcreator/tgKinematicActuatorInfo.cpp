@@ -25,6 +25,7 @@
  */
 
 #include "tgKinematicActuatorInfo.h"
+#include "tgUtil.h"
 
 tgKinematicActuatorInfo::tgKinematicActuatorInfo(const tgKinematicActuator::Config& config) : 
 m_config(config),
@@ -58,3 +59,21 @@ tgModel* tgKinematicActuatorInfo::createModel(tgWorld& world)
     return new tgKinematicActuator(m_bulletSpringCable, getTags(), m_config);
 }
 
+std::size_t tgKinematicActuatorInfo::getConfigHash() const
+{
+    std::size_t h = tgConnectorInfo::getConfigHash();
+    tgUtil::hashCombine(h, hashConfig(m_config));
+    return h;
+}
+
+std::size_t tgKinematicActuatorInfo::hashConfig(const tgKinematicActuator::Config& config)
+{
+    std::size_t h = tgBasicActuatorInfo::hashConfig(config);
+    tgUtil::hashCombine(h, tgUtil::hashDouble(config.radius));
+    tgUtil::hashCombine(h, tgUtil::hashDouble(config.motorFriction));
+    tgUtil::hashCombine(h, tgUtil::hashDouble(config.motorInertia));
+    tgUtil::hashCombine(h, config.backdrivable);
+    tgUtil::hashCombine(h, tgUtil::hashDouble(config.maxOmega));
+    tgUtil::hashCombine(h, tgUtil::hashDouble(config.maxTorque));
+    return h;
+}
@@ -76,6 +76,20 @@ public:
 
     virtual tgModel* createModel(tgWorld& world);
 
+    /**
+     * Hash the type and the config, including the motor model.
+     * @return a hash that is the same in every run
+     */
+    virtual std::size_t getConfigHash() const;
+
+    /**
+     * Hash the fields of a kinematic actuator config that affect its
+     * behavior. Shared with tgKinematicContactCableInfo.
+     * @param[in] config a kinematic actuator config
+     * @return a hash that is the same in every run
+     */
+    static std::size_t hashConfig(const tgKinematicActuator::Config& config);
+
 
 private:
     
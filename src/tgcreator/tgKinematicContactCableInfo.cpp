@@ -25,6 +25,8 @@
  */
 
 #include "tgKinematicContactCableInfo.h"
+#include "tgKinematicActuatorInfo.h"
+#include "tgUtil.h"
 
 #include "core/tgBulletContactSpringCable.h"
 
@@ -60,3 +62,9 @@ tgModel* tgKinematicContactCableInfo::createModel(tgWorld& world)
     return new tgKinematicActuator(m_bulletContactSpringCable, getTags(), m_config);
 }
 
+std::size_t tgKinematicContactCableInfo::getConfigHash() const
+{
+    std::size_t h = tgConnectorInfo::getConfigHash();
+    tgUtil::hashCombine(h, tgKinematicActuatorInfo::hashConfig(m_config));
+    return h;
+}
@@ -76,6 +76,12 @@ public:
 
     virtual tgModel* createModel(tgWorld& world);
 
+    /**
+     * Hash the type and the config, including the motor model.
+     * @return a hash that is the same in every run
+     */
+    virtual std::size_t getConfigHash() const;
+
 
 private:
     
@@ -124,7 +124,7 @@ public:
      * Add a node and return the created index.
      * @param[in] node a btVector3
      * @return the key under which btVector3 is stored
-     * @todo If node is already a value in the map, return its key.
+     * @throw std::logic_error if a node already exists at that position
      */
     int addNode(const btVector3& node) {
         return addNode(tgNode(node));
@@ -227,6 +227,12 @@ public:
     }
     
 protected:
+
+    /** Nodes are indexed on their (quantized) position. */
+    virtual std::size_t elementHash(const tgNode& node) const
+    {
+        return tgUtil::hashPosition(node);
+    }
     
     // A map of m_nodes keys to names. Note that not all m_nodes will have names.
     std::map<int, std::string> m_names;  // @todo: remove this...
@@ -61,8 +61,12 @@ public:
         return getElements();
     }
 
+    /**
+     * Add a pair and return the created index.
+     * @throw std::logic_error if a pair with the same endpoints already
+     * exists, in either orientation
+     */
     int addPair(const tgPair& pair) {
-        // @todo: make sure the pair is unique (both ways -- (a.from != b.from && a.to != b.to) && (a.from != b.to && a.to != b.from) )
         return addElement(pair);
     }
 
@@ -79,7 +83,8 @@ public:
     }
 
     /*
-     * Removes the pair that's passed in as a parameter
+     * Removes the pair that's passed in as a parameter (matched in either
+     * orientation)
      * (added to accommodate structures encoded in YAML)
      * @param[in] pair a reference to the pair to remove
      */
@@ -151,6 +156,30 @@ public:
         return *this;
     }
 
+protected:
+
+    /**
+     * Pairs are indexed on their endpoints, independent of orientation,
+     * so (a, b) and (b, a) land in the same bucket.
+     */
+    virtual std::size_t elementHash(const tgPair& pair) const
+    {
+        std::size_t a = tgUtil::hashPosition(pair.getFrom());
+        std::size_t b = tgUtil::hashPosition(pair.getTo());
+        if (b < a) {
+            std::swap(a, b);
+        }
+        tgUtil::hashCombine(a, b);
+        return a;
+    }
+
+    /** Two pairs match if they connect the same points, either way round. */
+    virtual bool elementsMatch(const tgPair& a, const tgPair& b) const
+    {
+        return (a.getFrom() == b.getFrom() && a.getTo() == b.getTo()) ||
+               (a.getFrom() == b.getTo() && a.getTo() == b.getFrom());
+    }
+
 };
 
 
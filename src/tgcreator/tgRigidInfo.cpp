@@ -41,6 +41,8 @@
 // The Bullet Physics library
 #include "btBulletDynamicsCommon.h"
 #include "BulletSoftBody/btSoftRigidDynamicsWorld.h"
+// The C++ Standard Library
+#include <typeinfo>
 
 tgRigidInfo* tgRigidInfo::createRigidInfo(const tgNode& node, const tgTagSearch& tagSearch)
 {
@@ -138,6 +140,11 @@ void tgRigidInfo::setRigidBody(btRigidBody* rigidBody)
     m_collisionObject = rigidBody;
 }
 
+std::size_t tgRigidInfo::getConfigHash() const
+{
+    return tgUtil::hashString(typeid(*this).name());
+}
+
 bool tgRigidInfo::sharesNodesWith(const tgRigidInfo& other) const
 {
     const std::set<btVector3> s1 = getContainedNodes();
@@ -222,6 +222,14 @@ public:
      * @return the rigid bddy's mass
      */
     virtual double getMass() const = 0;
+
+    /**
+     * Return a hash of everything about this rigid's configuration that
+     * affects how it behaves, e.g. to key a cache of simulation results.
+     * The default hashes only the type; subclasses add their config.
+     * @return a hash that is the same in every run
+     */
+    virtual std::size_t getConfigHash() const;
     
     /**
      * Return the rigid body's center of mass.
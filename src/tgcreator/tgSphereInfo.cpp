@@ -26,6 +26,7 @@
 
 // This Module
 #include "tgSphereInfo.h"
+#include "tgUtil.h"
 
 // The NTRT Core library
 #include "core/tgWorldBulletPhysicsImpl.h"
@@ -113,6 +114,17 @@ btCollisionShape* tgSphereInfo::getCollisionShape(tgWorld& world) const
     return m_collisionShape;
 }
 
+std::size_t tgSphereInfo::getConfigHash() const
+{
+    std::size_t h = tgRigidInfo::getConfigHash();
+    tgUtil::hashCombine(h, tgUtil::hashDouble(m_config.radius));
+    tgUtil::hashCombine(h, tgUtil::hashDouble(m_config.density));
+    tgUtil::hashCombine(h, tgUtil::hashDouble(m_config.friction));
+    tgUtil::hashCombine(h, tgUtil::hashDouble(m_config.rollFriction));
+    tgUtil::hashCombine(h, tgUtil::hashDouble(m_config.restitution));
+    return h;
+}
+
 double tgSphereInfo::getMass() const
 {
     const double radius = m_config.radius;
@@ -131,6 +131,12 @@ public:
      * @return the mass of the sphere
      */
     virtual double getMass() const;
+
+    /**
+     * Hash the type and the config.
+     * @return a hash that is the same in every run
+     */
+    virtual std::size_t getConfigHash() const;
     /**
      * Return the sphere's center of mass.
      * The center of mass is a point halfway between the endpoints.
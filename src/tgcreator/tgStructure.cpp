@@ -29,9 +29,12 @@
 // This library
 #include "tgNode.h"
 #include "tgPair.h"
+#include "tgUtil.h"
 // The Bullet Physics library
 #include <LinearMath/btQuaternion.h>
 #include <LinearMath/btVector3.h>
+// The C++ Standard Library
+#include <sstream>
  
 tgStructure::tgStructure() : tgTaggable() 
 {
@@ -79,7 +82,9 @@ void tgStructure::addNode(tgNode& newNode)
 
 void tgStructure::addPair(int fromNodeIdx, int toNodeIdx, std::string tags)
 {
-    addPair(m_nodes[fromNodeIdx], m_nodes[toNodeIdx], tags);
+    // Const access keeps the node index valid while building
+    const tgNodes& nodes = m_nodes;
+    addPair(nodes[fromNodeIdx], nodes[toNodeIdx], tags);
 }
 
 void tgStructure::addPair(const btVector3& from, const btVector3& to, std::string tags)
@@ -203,6 +208,39 @@ btVector3 tgStructure::getCentroid() const {
     return centroid/numNodes;
 }
 
+std::size_t tgStructure::getHash() const {
+    std::size_t h = 0;
+    std::ostringstream tags;
+    tags << getTags();
+    tgUtil::hashCombine(h, tgUtil::hashString(tags.str()));
+
+    const std::vector<tgNode>& nodes = m_nodes.getNodes();
+    for (std::size_t i = 0; i < nodes.size(); i++) {
+        for (int j = 0; j < 3; j++) {
+            tgUtil::hashCombine(h, tgUtil::hashDouble(nodes[i][j]));
+        }
+        std::ostringstream nodeTags;
+        nodeTags << nodes[i].getTags();
+        tgUtil::hashCombine(h, tgUtil::hashString(nodeTags.str()));
+    }
+
+    const std::vector<tgPair>& pairs = m_pairs.getPairs();
+    for (std::size_t i = 0; i < pairs.size(); i++) {
+        for (int j = 0; j < 3; j++) {
+            tgUtil::hashCombine(h, tgUtil::hashDouble(pairs[i].getFrom()[j]));
+            tgUtil::hashCombine(h, tgUtil::hashDouble(pairs[i].getTo()[j]));
+        }
+        std::ostringstream pairTags;
+        pairTags << pairs[i].getTags();
+        tgUtil::hashCombine(h, tgUtil::hashString(pairTags.str()));
+    }
+
+    for (std::size_t i = 0; i < m_children.size(); i++) {
+        tgUtil::hashCombine(h, m_children[i]->getHash());
+    }
+    return h;
+}
+
 tgNode& tgStructure::findNode(const std::string& tags) {
     std::queue<tgStructure*> q;
 
@@ -33,6 +33,7 @@
 // The NTRT Core Library
 #include "core/tgTaggable.h"
 // The C++ Standard Library
+#include <cstddef>
 #include <string>
 #include <vector>
 #include <queue>
@@ -53,6 +54,10 @@ class tgTags;
  */
 class tgStructure : public tgTaggable
 {
+
+    /** Moves nodes and pairs to their settled positions */
+    friend class tgFormFinder;
+
 public:
     
     tgStructure();
@@ -157,6 +162,13 @@ public:
      */
     btVector3 getCentroid() const;
 
+    /**
+     * Returns a hash of the nodes, pairs and tags of the structure and its
+     * children, e.g. to key a cache of simulation results.
+     * @return a hash that is the same in every run
+     */
+    std::size_t getHash() const;
+
     /**
      * Get all of our pairs
      * Note: This only includes nodes owned by this structure. Use 'findPairs' 
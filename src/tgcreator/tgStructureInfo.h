@@ -52,6 +52,10 @@ class tgStructureInfo : public tgTaggable
 
     friend std::ostream& operator<<(std::ostream& os, const tgStructureInfo& obj);
 
+    /** Builds the rigid and connector infos without a world */
+    friend class tgFormFinder;
+    friend class tgInverseStatics;
+
 public:
 
     tgStructureInfo(tgStructure& structure, tgBuildSpec& buildSpec);
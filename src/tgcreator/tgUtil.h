@@ -39,6 +39,7 @@
 #include <sstream>
 #include <string>
 
+#include "core/tgHash.h"
 #include "tgRigidInfo.h"
 
 /**
@@ -351,6 +352,57 @@ public:
     }
     //static std::string strDeg(double degrees);
 
+    /**
+     * Hash a position by quantizing each coordinate onto a grid of the
+     * given resolution. Equal vectors (including 0.0 and -0.0) always hash
+     * the same; nearby vectors usually do too.
+     * @param[in] v a btVector3
+     * @param[in] resolution the grid spacing, in length units
+     * @return a hash of the grid cell containing v
+     */
+    inline static std::size_t hashPosition(const btVector3& v,
+                                           double resolution = 1.0e-6)
+    {
+        std::size_t h = 0;
+        for (int i = 0; i < 3; i++) {
+            const long long q =
+                static_cast<long long>(floor(v[i] / resolution));
+            tgHash::combine(h, static_cast<std::size_t>(q ^ (q >> 32)));
+        }
+        return h;
+    }
+
+    /**
+     * Mix a hash into a running hash, as boost::hash_combine does.
+     * @param[in,out] seed the running hash
+     * @param[in] h the hash to mix in
+     */
+    inline static void hashCombine(std::size_t& seed, std::size_t h)
+    {
+        tgHash::combine(seed, h);
+    }
+
+    /**
+     * Hash a double exactly. 0.0 and -0.0 hash the same.
+     * @param[in] d a double
+     * @return a hash of d
+     */
+    inline static std::size_t hashDouble(double d)
+    {
+        return tgHash::ofDouble(d);
+    }
+
+    /**
+     * Hash a string with FNV-1a. Unlike std::tr1::hash, the result is the
+     * same for every build, so it can be saved to files.
+     * @param[in] s a string
+     * @return a hash of s
+     */
+    inline static std::size_t hashString(const std::string& s)
+    {
+        return tgHash::ofString(s);
+    }
+
     inline static double round(double d, int precision = 5)
     {
         const double base = 10.0;
@@ -0,0 +1,110 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgWrappingCableInfo.cpp
+ * @brief Implementation of class tgWrappingCableInfo
+ * $Id$
+ */
+
+#include "tgWrappingCableInfo.h"
+
+#include "tgRodInfo.h"
+#include "tgUtil.h"
+#include "core/tgBulletSpringCableAnchor.h"
+#include "core/tgBulletWrappingSpringCable.h"
+#include "core/tgCast.h"
+#include "core/tgTagSearch.h"
+
+tgWrappingCableInfo::tgWrappingCableInfo(const tgBasicActuator::Config& config,
+                                         const std::string& wrapTags) :
+tgBasicActuatorInfo(config),
+m_wrapTags(wrapTags)
+{}
+
+tgWrappingCableInfo::tgWrappingCableInfo(const tgBasicActuator::Config& config,
+                                         tgTags tags,
+                                         const std::string& wrapTags) :
+tgBasicActuatorInfo(config, tags),
+m_wrapTags(wrapTags)
+{}
+
+tgWrappingCableInfo::tgWrappingCableInfo(const tgBasicActuator::Config& config,
+                                         const tgPair& pair,
+                                         const std::string& wrapTags) :
+tgBasicActuatorInfo(config, pair),
+m_wrapTags(wrapTags)
+{}
+
+tgConnectorInfo* tgWrappingCableInfo::createConnectorInfo(const tgPair& pair)
+{
+    return new tgWrappingCableInfo(getConfig(), pair, m_wrapTags);
+}
+
+void tgWrappingCableInfo::chooseRigids(std::set<tgRigidInfo*> rigids)
+{
+    tgBasicActuatorInfo::chooseRigids(rigids);
+
+    const tgTagSearch search(m_wrapTags);
+    m_wrapRods.clear();
+    for (std::set<tgRigidInfo*>::const_iterator it = rigids.begin();
+         it != rigids.end(); ++it)
+    {
+        tgRodInfo* const pRod = tgCast::cast<tgRigidInfo, tgRodInfo>(*it);
+        if (pRod && search.matches(*pRod))
+        {
+            m_wrapRods.push_back(pRod);
+        }
+    }
+}
+
+void tgWrappingCableInfo::initConnector(tgWorld& world)
+{
+    const std::vector<tgBulletSpringCableAnchor*> anchors = createAnchors();
+
+    // Rods compounded with an end move with it, so can't be wrapped
+    std::vector<tgBulletWrappingSpringCable::Cylinder> cylinders;
+    for (std::size_t i = 0; i < m_wrapRods.size(); i++)
+    {
+        tgRodInfo* const pRod = m_wrapRods[i];
+        btRigidBody* const body = pRod->getRigidBody();
+        if (body != NULL &&
+            body != anchors.front()->attachedBody &&
+            body != anchors.back()->attachedBody)
+        {
+            cylinders.push_back(tgBulletWrappingSpringCable::Cylinder(body,
+                                                                      pRod->getFrom(),
+                                                                      pRod->getTo(),
+                                                                      pRod->getConfig().radius));
+        }
+    }
+
+    const tgBasicActuator::Config& config = getConfig();
+    m_bulletSpringCable = new tgBulletWrappingSpringCable(anchors,
+                                                          config.stiffness,
+                                                          config.damping,
+                                                          cylinders,
+                                                          config.pretension);
+}
+
+std::size_t tgWrappingCableInfo::getConfigHash() const
+{
+    std::size_t h = tgBasicActuatorInfo::getConfigHash();
+    tgUtil::hashCombine(h, tgUtil::hashString(m_wrapTags));
+    return h;
+}
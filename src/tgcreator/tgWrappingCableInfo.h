@@ -0,0 +1,95 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgWrappingCableInfo.h
+ * @brief Definition of class tgWrappingCableInfo
+ * $Id$
+ */
+
+#ifndef SRC_TGCREATOR_TG_WRAPPING_CABLE_INFO_H
+#define SRC_TGCREATOR_TG_WRAPPING_CABLE_INFO_H
+
+#include "tgBasicActuatorInfo.h"
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "core/tgBasicActuator.h"
+#include "core/tgTags.h"
+
+class tgRodInfo;
+
+/**
+ * Builds a tgBasicActuator whose cable is a tgBulletWrappingSpringCable.
+ * It wraps the rods whose tags match wrapTags, e.g. "rod" or "spine",
+ * except those its ends are attached to.
+ */
+class tgWrappingCableInfo : public tgBasicActuatorInfo
+{
+public:
+
+    /**
+     * Construct a tgWrappingCableInfo with just a config. The pair must be
+     * filled in later, or factory methods can be used to create instances
+     * with pairs.
+     * @param[in] wrapTags a tag search for the rods to wrap
+     */
+    tgWrappingCableInfo(const tgBasicActuator::Config& config,
+                        const std::string& wrapTags);
+
+    tgWrappingCableInfo(const tgBasicActuator::Config& config,
+                        tgTags tags,
+                        const std::string& wrapTags);
+
+    tgWrappingCableInfo(const tgBasicActuator::Config& config,
+                        const tgPair& pair,
+                        const std::string& wrapTags);
+
+    virtual ~tgWrappingCableInfo() {}
+
+    virtual tgConnectorInfo* createConnectorInfo(const tgPair& pair);
+
+    using tgBasicActuatorInfo::chooseRigids;
+
+    /** Choose the end rigids, and find the rods to wrap among all rigids */
+    virtual void chooseRigids(std::set<tgRigidInfo*> rigids);
+
+    virtual void initConnector(tgWorld& world);
+
+    /**
+     * Hash the type, the config and the wrap tags.
+     * @return a hash that is the same in every run
+     */
+    virtual std::size_t getConfigHash() const;
+
+    const std::string& getWrapTags() const
+    {
+        return m_wrapTags;
+    }
+
+private:
+
+    const std::string m_wrapTags;
+
+    /** The rods to wrap, found by chooseRigids() */
+    std::vector<tgRodInfo*> m_wrapRods;
+};
+
+#endif // SRC_TGCREATOR_TG_WRAPPING_CABLE_INFO_H
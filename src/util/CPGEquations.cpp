@@ -44,14 +44,17 @@ typedef std::vector<double > cpgVars_type;
 CPGEquations::CPGEquations(int maxSteps) :
 stepSize(0.1),
 numSteps(0),
-m_maxSteps(maxSteps)
+m_maxSteps(maxSteps),
+m_updateCount(0)
  {}
 CPGEquations::CPGEquations(std::vector<CPGNode*>& newNodeList, int maxSteps) :
 nodeList(newNodeList),
 stepSize(0.1), //TODO: specify as a parameter somewhere
 numSteps(0),
-m_maxSteps(maxSteps)
+m_maxSteps(maxSteps),
+m_updateCount(0)
 {
+	refreshState();
 }
 
 CPGEquations::~CPGEquations()
@@ -70,6 +73,7 @@ int CPGEquations::addNode(std::vector<double>& newParams)
 	int index = nodeList.size();
 	CPGNode* newNode = new CPGNode(index, newParams);
 	nodeList.push_back(newNode);
+	refreshState();
 	
 	return index;
 }
@@ -258,6 +262,9 @@ void CPGEquations::update(std::vector<double>& descCom, double dt)
         throw std::runtime_error("Inefficient CPG Parameters");
     }
     
+    refreshState();
+    m_updateCount++;
+    
 	 #if (0)
 	 std::cout << dt << '\t' << nodeList[0]->nodeValue <<
 	  '\t' << nodeList[1]->nodeValue <<
@@ -266,6 +273,20 @@ void CPGEquations::update(std::vector<double>& descCom, double dt)
 	   
 }
 
+void CPGEquations::refreshState()
+{
+	const std::size_t n = nodeList.size();
+	m_phases.resize(n);
+	m_amplitudes.resize(n);
+	m_outputs.resize(n);
+	for (std::size_t i = 0; i < n; i++)
+	{
+		m_phases[i] = nodeList[i]->phiValue;
+		m_amplitudes[i] = nodeList[i]->rValue;
+		m_outputs[i] = nodeList[i]->nodeValue;
+	}
+}
+
 std::string CPGEquations::toString(const std::string& prefix) const
 {
 	std::string p = "  ";
@@ -75,8 +75,55 @@ class CPGEquations
         numSteps++;
     }
     
+    /**
+     * The number of nodes; valid indices for operator[] are below this
+     */
+    std::size_t getNodeCount() const
+    {
+        return nodeList.size();
+    }
+    
+    /**
+     * The phase (phi) of each node, in node order, as of the last
+     * update() or addNode()
+     */
+    const std::vector<double>& getPhases() const
+    {
+        return m_phases;
+    }
+    
+    /**
+     * The amplitude (r) of each node; see getPhases()
+     */
+    const std::vector<double>& getAmplitudes() const
+    {
+        return m_amplitudes;
+    }
+    
+    /**
+     * The output of each node, as from operator[]; see getPhases()
+     */
+    const std::vector<double>& getOutputs() const
+    {
+        return m_outputs;
+    }
+    
+    /**
+     * The number of calls to update() so far, so observers can tell
+     * whether the values above changed
+     */
+    std::size_t getUpdateCount() const
+    {
+        return m_updateCount;
+    }
+    
 protected:
 	
+	/**
+	 * Copy the node states into m_phases, m_amplitudes and m_outputs
+	 */
+	void refreshState();
+	
 	std::vector<CPGNode*> nodeList;
 	
     std::vector<double> XVars;
@@ -87,6 +134,12 @@ protected:
     int m_maxSteps;
     int numSteps;
     
+    std::vector<double> m_phases;
+    std::vector<double> m_amplitudes;
+    std::vector<double> m_outputs;
+    
+    std::size_t m_updateCount;
+    
 };
 
 /**
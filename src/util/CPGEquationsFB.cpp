@@ -61,6 +61,7 @@ int CPGEquationsFB::addNode(std::vector<double>& newParams)
 	int index = nodeList.size();
 	CPGNodeFB* newNode = new CPGNodeFB(index, newParams);
 	nodeList.push_back(newNode);
+	refreshState();
 	
 	return index;
 }
@@ -0,0 +1,85 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file CPGTraceLogger.cpp
+ * @brief Implementation of class CPGTraceLogger
+ * $Id$
+ */
+
+#include "CPGTraceLogger.h"
+
+#include "CPGEquations.h"
+
+// The C++ Standard Library
+#include <stdexcept>
+
+namespace
+{
+	const char magic[8] = {'N', 'T', 'R', 'T', 'C', 'P', 'G', '1'};
+}
+
+CPGTraceLogger::CPGTraceLogger(const std::string& fileName,
+								std::size_t bufferRecords) :
+m_file(fileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc),
+m_bufferSize(bufferRecords * (2 + 3 * 32)),
+m_recordCount(0)
+{
+	if (!m_file.is_open())
+	{
+		throw std::runtime_error("Could not open " + fileName);
+	}
+	m_file.write(magic, sizeof(magic));
+	m_buffer.reserve(m_bufferSize);
+}
+
+CPGTraceLogger::~CPGTraceLogger()
+{
+	flush();
+}
+
+void CPGTraceLogger::record(double time, const CPGEquations& cpg)
+{
+	const std::vector<double>& phases = cpg.getPhases();
+	const std::vector<double>& amplitudes = cpg.getAmplitudes();
+	const std::vector<double>& outputs = cpg.getOutputs();
+	const std::size_t n = phases.size();
+
+	if (m_buffer.size() + 2 + 3 * n > m_bufferSize)
+	{
+		flush();
+	}
+
+	m_buffer.push_back(static_cast<double>(n));
+	m_buffer.push_back(time);
+	m_buffer.insert(m_buffer.end(), phases.begin(), phases.end());
+	m_buffer.insert(m_buffer.end(), amplitudes.begin(), amplitudes.end());
+	m_buffer.insert(m_buffer.end(), outputs.begin(), outputs.end());
+	m_recordCount++;
+}
+
+void CPGTraceLogger::flush()
+{
+	if (!m_buffer.empty())
+	{
+		m_file.write(reinterpret_cast<const char*>(&m_buffer[0]),
+						m_buffer.size() * sizeof(double));
+		m_buffer.clear();
+	}
+	m_file.flush();
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef SRC_UTIL_CPGS_CPGTRACELOGGER
+#define SRC_UTIL_CPGS_CPGTRACELOGGER
+
+/**
+ * @file CPGTraceLogger.h
+ * @brief Definition of class CPGTraceLogger
+ * $Id$
+ */
+
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <vector>
+
+class CPGEquations;
+
+/**
+ * Writes the state of a CPGEquations to a binary file, one record per
+ * control tick, through a buffer so that a record costs a few copies
+ * rather than a file operation.
+ *
+ * The file starts with the eight bytes "NTRTCPG1". Each record is then,
+ * in native byte order:
+ * - the node count n, as a double
+ * - the time, in seconds
+ * - n phases, n amplitudes and n outputs (see CPGEquations::getPhases())
+ *
+ * The node count is repeated so that one file can hold several trials of
+ * different CPGs. With NumPy, read the doubles with np.fromfile(f, np.float64,
+ * offset=8) and walk them by their leading count.
+ */
+class CPGTraceLogger
+{
+public:
+
+	/**
+	 * Open fileName, replacing it.
+	 * @param[in] bufferRecords, roughly how many records of a 32 node
+	 * CPG to buffer between writes
+	 * @throw std::runtime_error if the file can't be opened
+	 */
+	CPGTraceLogger(const std::string& fileName,
+					std::size_t bufferRecords = 256);
+
+	/** Flush and close the file. */
+	~CPGTraceLogger();
+
+	/**
+	 * Append the current state of cpg.
+	 * @param[in] time, the time of the control tick
+	 */
+	void record(double time, const CPGEquations& cpg);
+
+	/** Write the buffered records to the file. */
+	void flush();
+
+	/** The number of records so far */
+	std::size_t getRecordCount() const
+	{
+		return m_recordCount;
+	}
+
+private:
+
+	/** Not copyable */
+	CPGTraceLogger(const CPGTraceLogger&);
+	CPGTraceLogger& operator=(const CPGTraceLogger&);
+
+	std::ofstream m_file;
+
+	/** Buffered records */
+	std::vector<double> m_buffer;
+
+	/** Flush when m_buffer would grow past this */
+	const std::size_t m_bufferSize;
+
+	std::size_t m_recordCount;
+};
+
+#endif // SRC_UTIL_CPGS_CPGTRACELOGGER
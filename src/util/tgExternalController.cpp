@@ -0,0 +1,232 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgExternalController.cpp
+ * @brief Implementation of class tgExternalController
+ * $Id$
+ */
+
+#include "tgExternalController.h"
+#include "tgSharedMemoryChannel.h"
+
+#include "controllers/tgTensionController.h"
+#include "core/tgBasicActuator.h"
+#include "core/tgCast.h"
+#include "core/tgModel.h"
+#include "core/tgRealTimePacer.h"
+#include "core/tgRod.h"
+
+// The Bullet Physics Library
+#include "LinearMath/btVector3.h"
+
+// The C++ Standard Library
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+
+namespace
+{
+	const std::size_t kActuatorValues = 4;
+	const std::size_t kRodValues = 6;
+}
+
+const std::size_t tgExternalController::kHistory;
+
+tgExternalController::Config::Config(Synchronization s, double t) :
+synchronization(s),
+timeout(t)
+{
+	if ((synchronization != eLockStep) && (synchronization != eFreeRunning))
+	{
+		throw std::invalid_argument("synchronization is not a Synchronization");
+	}
+	else if (!(timeout > 0.0))
+	{
+		throw std::invalid_argument("timeout is not positive");
+	}
+}
+
+tgExternalController::Statistics::Statistics() :
+cycles(0),
+answered(0),
+timeouts(0),
+stale(0),
+latencySum(0.0),
+maxLatency(0.0)
+{
+}
+
+double tgExternalController::Statistics::getMeanLatency() const
+{
+	return (answered == 0) ? 0.0 : latencySum / answered;
+}
+
+tgExternalController::tgExternalController(const std::string& name,
+											const Config& config) :
+m_name(name),
+m_config(config),
+m_pChannel(NULL),
+m_cycle(0),
+m_lastReply(0),
+m_time(0.0),
+m_lastLatency(-1.0),
+m_published(kHistory, Publication(0, 0.0))
+{
+}
+
+tgExternalController::~tgExternalController()
+{
+	delete m_pChannel;
+}
+
+void tgExternalController::onSetup(tgModel& subject)
+{
+	const std::vector<tgModel*> descendants = subject.getDescendants();
+	m_actuators = tgCast::filter<tgModel, tgBasicActuator>(descendants);
+	m_rods = tgCast::filter<tgModel, tgRod>(descendants);
+	m_time = 0.0;
+
+	const std::size_t stateSize = 1 + kActuatorValues * m_actuators.size() +
+		kRodValues * m_rods.size();
+	const std::size_t commandSize = std::max<std::size_t>(1, 2 * m_actuators.size());
+	if (m_pChannel == NULL ||
+		m_pChannel->getStateSize() != stateSize ||
+		m_pChannel->getCommandSize() != commandSize)
+	{
+		delete m_pChannel;
+		m_pChannel = NULL;
+		m_pChannel = new tgSharedMemoryChannel(m_name, stateSize, commandSize);
+		m_cycle = 0;
+		m_lastReply = 0;
+		m_statistics = Statistics();
+	}
+	m_state.resize(stateSize);
+	m_command.assign(commandSize, 0.0);
+}
+
+void tgExternalController::onStep(tgModel& subject, double dt)
+{
+	if (m_pChannel == NULL)
+	{
+		throw std::runtime_error("onStep called before onSetup");
+	}
+
+	fillState();
+	m_cycle++;
+	m_pChannel->publishState(m_cycle, m_state);
+	m_published[m_cycle % kHistory] = Publication(m_cycle,
+													tgRealTimePacer::now());
+
+	std::size_t reply = m_lastReply;
+	bool fresh = false;
+	if (m_config.synchronization == eLockStep)
+	{
+		fresh = m_pChannel->waitForCommand(m_cycle, m_config.timeout,
+											m_command, reply);
+		if (!fresh)
+		{
+			m_statistics.timeouts++;
+		}
+	}
+	else
+	{
+		fresh = m_pChannel->readCommand(m_command, reply) &&
+				(reply != m_lastReply);
+		if (!fresh)
+		{
+			m_statistics.stale++;
+		}
+	}
+
+	// The latency is from publishing a state to first seeing its answer,
+	// so in free-running mode it includes up to a step of waiting
+	m_lastLatency = -1.0;
+	if (fresh)
+	{
+		const Publication& p = m_published[reply % kHistory];
+		if (p.first == reply)
+		{
+			m_lastLatency = tgRealTimePacer::now() - p.second;
+			m_statistics.answered++;
+			m_statistics.latencySum += m_lastLatency;
+			m_statistics.maxLatency = std::max(m_statistics.maxLatency,
+												m_lastLatency);
+		}
+		m_lastReply = reply;
+	}
+	m_statistics.cycles++;
+
+	applyCommand(dt);
+	m_time += dt;
+}
+
+void tgExternalController::onTeardown(tgModel& subject)
+{
+	// The actuators and rods are about to be deleted
+	m_actuators.clear();
+	m_rods.clear();
+}
+
+void tgExternalController::fillState()
+{
+	std::vector<double>::iterator it = m_state.begin();
+	*it++ = m_time;
+	for (std::size_t i = 0; i < m_actuators.size(); i++)
+	{
+		const tgBasicActuator& actuator = *m_actuators[i];
+		*it++ = actuator.getRestLength();
+		*it++ = actuator.getCurrentLength();
+		*it++ = actuator.getTension();
+		*it++ = actuator.getVelocity();
+	}
+	for (std::size_t i = 0; i < m_rods.size(); i++)
+	{
+		const btVector3 com = m_rods[i]->centerOfMass();
+		const btVector3 orientation = m_rods[i]->orientation();
+		for (int j = 0; j < 3; j++)
+		{
+			*it++ = com[j];
+		}
+		for (int j = 0; j < 3; j++)
+		{
+			*it++ = orientation[j];
+		}
+	}
+	assert(it == m_state.end());
+}
+
+void tgExternalController::applyCommand(double dt)
+{
+	for (std::size_t i = 0; i < m_actuators.size(); i++)
+	{
+		const double target = m_command[2 * i + 1];
+		switch (static_cast<int>(m_command[2 * i]))
+		{
+		case eRestLength:
+			m_actuators[i]->setControlInput(target, dt);
+			break;
+		case eTension:
+			tgTensionController::control(*m_actuators[i], dt, target);
+			break;
+		default:
+			// eHold, or garbage: leave the actuator alone
+			break;
+		}
+	}
+}
@@ -0,0 +1,195 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef SRC_UTIL_TG_EXTERNAL_CONTROLLER_H
+#define SRC_UTIL_TG_EXTERNAL_CONTROLLER_H
+
+/**
+ * @file tgExternalController.h
+ * @brief Definition of class tgExternalController
+ * $Id$
+ */
+
+#include "core/tgObserver.h"
+
+// The C++ Standard Library
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Forward declarations
+class tgBasicActuator;
+class tgModel;
+class tgRod;
+class tgSharedMemoryChannel;
+
+/**
+ * Lets a controller in another process, such as robot firmware built
+ * for the host, drive a model as if it were the plant. Every step the
+ * model's state goes out over a tgSharedMemoryChannel and the latest
+ * command comes back.
+ *
+ * The state vector is the simulated time, then four values for each
+ * tgBasicActuator (rest length, current length, tension, velocity), then
+ * six for each tgRod (center of mass and orientation), in the order of
+ * getDescendants(). The command vector has two values per actuator: a
+ * type, which is eHold, eRestLength or eTension, then the target.
+ *
+ * In lock-step mode each step waits for the command that answers its
+ * state, so the controller sees every cycle; a step that times out
+ * keeps the last command. In free-running mode steps never wait and use
+ * whatever command is newest, as a real plant would.
+ */
+class tgExternalController : public tgObserver<tgModel>
+{
+public:
+
+	enum Synchronization
+	{
+		eLockStep,
+		eFreeRunning
+	};
+
+	/** The command types */
+	enum CommandType
+	{
+		eHold = 0,
+		eRestLength = 1,
+		eTension = 2
+	};
+
+	struct Config
+	{
+		/**
+		 * @param[in] synchronization, lock-step or free-running
+		 * @param[in] timeout, the longest a lock-step step waits for its
+		 * command, in seconds; must be positive
+		 */
+		Config(Synchronization synchronization = eLockStep,
+				double timeout = 1.0);
+
+		Synchronization synchronization;
+		double timeout;
+	};
+
+	/** Per-cycle accounting since the channel was created */
+	struct Statistics
+	{
+		Statistics();
+
+		/** The mean time from publishing a state to its answer, in seconds */
+		double getMeanLatency() const;
+
+		std::size_t cycles;
+
+		/** Cycles whose command answered their own state */
+		std::size_t answered;
+
+		/** Lock-step cycles that gave up waiting */
+		std::size_t timeouts;
+
+		/** Free-running cycles with no new command */
+		std::size_t stale;
+
+		double latencySum;
+		double maxLatency;
+	};
+
+	/**
+	 * @param[in] name, the shared memory name the controller attaches
+	 * to, such as "/ntrt"
+	 */
+	tgExternalController(const std::string& name,
+							const Config& config = Config());
+
+	virtual ~tgExternalController();
+
+	/**
+	 * Find the actuators and rods and create the channel. A reset keeps
+	 * the channel, so the controller stays attached, unless the model
+	 * changed shape.
+	 * @throw std::runtime_error if the channel can't be created
+	 */
+	virtual void onSetup(tgModel& subject);
+
+	/** Publish the state, then get and apply a command. */
+	virtual void onStep(tgModel& subject, double dt);
+
+	virtual void onTeardown(tgModel& subject);
+
+	const Statistics& getStatistics() const
+	{
+		return m_statistics;
+	}
+
+	/** The time from publishing the last state to its answer, or -1 */
+	double getLastLatency() const
+	{
+		return m_lastLatency;
+	}
+
+	/** NULL before onSetup() */
+	const tgSharedMemoryChannel* getChannel() const
+	{
+		return m_pChannel;
+	}
+
+private:
+
+	/** Not copyable */
+	tgExternalController(const tgExternalController&);
+	tgExternalController& operator=(const tgExternalController&);
+
+	void fillState();
+
+	void applyCommand(double dt);
+
+private:
+
+	const std::string m_name;
+
+	const Config m_config;
+
+	tgSharedMemoryChannel* m_pChannel;
+
+	/** A cycle and when its state was published */
+	typedef std::pair<std::size_t, double> Publication;
+
+	/** The number of recent publications kept for latency accounting */
+	static const std::size_t kHistory = 256;
+
+	/** Not owned */
+	std::vector<tgBasicActuator*> m_actuators;
+	std::vector<tgRod*> m_rods;
+
+	std::vector<double> m_state;
+	std::vector<double> m_command;
+
+	std::size_t m_cycle;
+	std::size_t m_lastReply;
+	double m_time;
+	double m_lastLatency;
+
+	/** Indexed by cycle modulo kHistory */
+	std::vector<Publication> m_published;
+
+	Statistics m_statistics;
+};
+
+#endif  // SRC_UTIL_TG_EXTERNAL_CONTROLLER_H
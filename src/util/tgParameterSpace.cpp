@@ -0,0 +1,128 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgParameterSpace.cpp
+ * @brief Implementation of class tgParameterSpace
+ * $Id$
+ */
+
+#include "tgParameterSpace.h"
+
+// The C++ Standard Library
+#include <algorithm>
+#include <stdexcept>
+#include <tr1/random>
+
+std::size_t tgParameterSpace::addDimension(const std::string& name,
+											double min,
+											double max,
+											std::size_t levels)
+{
+	if (min > max)
+	{
+		throw std::invalid_argument("min is greater than max for " + name);
+	}
+	else if (levels == 0)
+	{
+		throw std::invalid_argument("No levels for " + name);
+	}
+	m_names.push_back(name);
+	m_min.push_back(min);
+	m_max.push_back(max);
+	m_levels.push_back(levels);
+	return m_names.size() - 1;
+}
+
+std::size_t tgParameterSpace::getGridSize() const
+{
+	std::size_t n = m_names.empty() ? 0 : 1;
+	for (std::size_t i = 0; i < m_levels.size(); i++)
+	{
+		n *= m_levels[i];
+	}
+	return n;
+}
+
+std::vector<std::vector<double> >
+tgParameterSpace::sample(Sampling sampling,
+							std::size_t count,
+							unsigned long seed) const
+{
+	const std::size_t d = size();
+	if (sampling == eGrid)
+	{
+		count = getGridSize();
+	}
+	std::vector<std::vector<double> > points(count, std::vector<double>(d));
+
+	// The engine yields integers; the generator scales them to [0, 1)
+	std::tr1::variate_generator<std::tr1::mt19937,
+								std::tr1::uniform_real<double> >
+		unit(std::tr1::mt19937(seed), std::tr1::uniform_real<double>(0.0, 1.0));
+
+	for (std::size_t j = 0; j < d; j++)
+	{
+		const double width = m_max[j] - m_min[j];
+		if (sampling == eGrid)
+		{
+			// The first dimension varies slowest
+			std::size_t stride = 1;
+			for (std::size_t k = j + 1; k < d; k++)
+			{
+				stride *= m_levels[k];
+			}
+			const std::size_t levels = m_levels[j];
+			for (std::size_t i = 0; i < count; i++)
+			{
+				const std::size_t level = (i / stride) % levels;
+				points[i][j] = (levels == 1) ?
+					m_min[j] + 0.5 * width :
+					m_min[j] + width * level / (levels - 1);
+			}
+		}
+		else if (sampling == eLatinHypercube)
+		{
+			// A random stratum for each point, then a random place in it
+			std::vector<std::size_t> strata(count);
+			for (std::size_t i = 0; i < count; i++)
+			{
+				strata[i] = i;
+			}
+			for (std::size_t i = count; i > 1; i--)
+			{
+				const std::size_t k =
+					static_cast<std::size_t>(unit() * i) % i;
+				std::swap(strata[i - 1], strata[k]);
+			}
+			for (std::size_t i = 0; i < count; i++)
+			{
+				points[i][j] = m_min[j] +
+					width * (strata[i] + unit()) / count;
+			}
+		}
+		else
+		{
+			for (std::size_t i = 0; i < count; i++)
+			{
+				points[i][j] = m_min[j] + width * unit();
+			}
+		}
+	}
+	return points;
+}
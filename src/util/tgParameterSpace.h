@@ -0,0 +1,96 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef SRC_UTIL_TG_PARAMETER_SPACE_H
+#define SRC_UTIL_TG_PARAMETER_SPACE_H
+
+/**
+ * @file tgParameterSpace.h
+ * @brief Definition of class tgParameterSpace
+ * $Id$
+ */
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * A box of named parameters to sweep, such as cable stiffness and
+ * damping, ground friction or the start pose, and the points to run
+ * trials at: a full grid, a Latin hypercube or uniform random samples.
+ * Sampling is seeded, so a sweep can be repeated exactly.
+ */
+class tgParameterSpace
+{
+public:
+
+	enum Sampling
+	{
+		/** Every combination of each dimension's levels */
+		eGrid,
+		/** count points, one in each of count strata of every dimension */
+		eLatinHypercube,
+		/** count uniform points */
+		eRandom
+	};
+
+	/**
+	 * Add a dimension.
+	 * @param[in] levels, the number of evenly spaced values from min to
+	 * max in a grid; 1 for just the midpoint
+	 * @return the index of the dimension in each point
+	 * @throw std::invalid_argument if min > max or levels is 0
+	 */
+	std::size_t addDimension(const std::string& name,
+								double min,
+								double max,
+								std::size_t levels = 2);
+
+	/** The number of dimensions */
+	std::size_t size() const
+	{
+		return m_names.size();
+	}
+
+	const std::vector<std::string>& getNames() const
+	{
+		return m_names;
+	}
+
+	/** The number of points in a grid: the product of the levels */
+	std::size_t getGridSize() const;
+
+	/**
+	 * Return the points to run trials at, each with one value per
+	 * dimension.
+	 * @param[in] count, the number of points; ignored for a grid
+	 * @param[in] seed, for the random samplings
+	 */
+	std::vector<std::vector<double> > sample(Sampling sampling,
+												std::size_t count = 0,
+												unsigned long seed = 1) const;
+
+private:
+
+	std::vector<std::string> m_names;
+	std::vector<double> m_min;
+	std::vector<double> m_max;
+	std::vector<std::size_t> m_levels;
+};
+
+#endif // SRC_UTIL_TG_PARAMETER_SPACE_H
@@ -0,0 +1,413 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgSharedMemoryChannel.cpp
+ * @brief Implementation of class tgSharedMemoryChannel
+ * $Id$
+ */
+
+#include "tgSharedMemoryChannel.h"
+
+#include "core/tgRealTimePacer.h"
+
+// The C++ Standard Library
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+// POSIX
+#include <fcntl.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+	const char kMagic[8] = { 'N', 'T', 'R', 'T', 'S', 'H', 'M', '1' };
+
+	/** Keeps the header and each slot on their own cache lines */
+	const std::size_t kLine = 64;
+
+	struct Header
+	{
+		char magic[8];
+		uint32_t stateSize;
+		uint32_t commandSize;
+		volatile uint32_t closed;
+		/** The creator's process id, written first */
+		uint32_t owner;
+		char pad[kLine - 24];
+	};
+
+	/** Spins before a waiting loop starts yielding and checking the time */
+	const std::size_t kSpins = 100;
+
+	std::size_t roundUp(std::size_t n)
+	{
+		return (n + kLine - 1) / kLine * kLine;
+	}
+
+	std::string describe(const std::string& what, const std::string& name)
+	{
+		return what + " " + name + ": " + std::strerror(errno);
+	}
+
+	/**
+	 * Whether an existing segment is a channel still open by a live
+	 * creator. A half-made one counts if its creator is alive.
+	 */
+	bool inUse(const std::string& name)
+	{
+		const int fd = shm_open(name.c_str(), O_RDONLY, 0);
+		if (fd < 0)
+		{
+			return false;
+		}
+		Header header;
+		const bool complete = pread(fd, &header, sizeof(header), 0) == sizeof(header);
+		::close(fd);
+		if (!complete || header.owner == 0 || header.closed != 0)
+		{
+			return false;
+		}
+		// EPERM means it exists but belongs to someone else
+		const pid_t owner = static_cast<pid_t>(header.owner);
+		return kill(owner, 0) == 0 || errno == EPERM;
+	}
+}
+
+struct tgSharedMemoryChannel::Slot
+{
+	/** Odd while the values are written */
+	volatile uint32_t sequence;
+	uint32_t pad0;
+	/** 0 until the first write */
+	volatile uint64_t cycle;
+	char pad[kLine - 16];
+	// The values follow
+};
+
+tgSharedMemoryChannel::tgSharedMemoryChannel(const std::string& name,
+												std::size_t stateSize,
+												std::size_t commandSize) :
+m_name(name),
+m_owner(true),
+m_stateSize(stateSize),
+m_commandSize(commandSize),
+m_pMemory(NULL),
+m_mappedSize(0),
+m_pState(NULL),
+m_pCommand(NULL)
+{
+	if (stateSize == 0)
+	{
+		throw std::invalid_argument("stateSize is zero");
+	}
+	else if (commandSize == 0)
+	{
+		throw std::invalid_argument("commandSize is zero");
+	}
+
+	const std::size_t size = sizeof(Header) +
+		2 * sizeof(Slot) +
+		roundUp(stateSize * sizeof(double)) +
+		roundUp(commandSize * sizeof(double));
+
+	int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+	if (fd < 0 && errno == EEXIST)
+	{
+		if (inUse(name))
+		{
+			throw std::runtime_error("Channel in use: " + name);
+		}
+		// A stale segment from a crashed run would have the wrong contents
+		shm_unlink(name.c_str());
+		fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+	}
+	if (fd < 0)
+	{
+		throw std::runtime_error(describe("Can't create", name));
+	}
+	if (ftruncate(fd, size) != 0)
+	{
+		const std::string error = describe("Can't size", name);
+		::close(fd);
+		shm_unlink(name.c_str());
+		throw std::runtime_error(error);
+	}
+	try
+	{
+		map(fd, size);
+	}
+	catch (...)
+	{
+		shm_unlink(name.c_str());
+		throw;
+	}
+
+	// The segment starts zeroed; the owner goes first so that another
+	// creator sees it is taken, and the magic last so that a controller
+	// never attaches to a half-made channel
+	Header* const pHeader = static_cast<Header*>(m_pMemory);
+	pHeader->owner = static_cast<uint32_t>(getpid());
+	__sync_synchronize();
+	pHeader->stateSize = stateSize;
+	pHeader->commandSize = commandSize;
+	__sync_synchronize();
+	std::memcpy(pHeader->magic, kMagic, sizeof(kMagic));
+	__sync_synchronize();
+}
+
+tgSharedMemoryChannel::tgSharedMemoryChannel(const std::string& name) :
+m_name(name),
+m_owner(false),
+m_stateSize(0),
+m_commandSize(0),
+m_pMemory(NULL),
+m_mappedSize(0),
+m_pState(NULL),
+m_pCommand(NULL)
+{
+	const int fd = shm_open(name.c_str(), O_RDWR, 0);
+	if (fd < 0)
+	{
+		throw std::runtime_error(describe("Can't open", name));
+	}
+	struct stat status;
+	if (fstat(fd, &status) != 0 ||
+		static_cast<std::size_t>(status.st_size) < sizeof(Header))
+	{
+		::close(fd);
+		throw std::runtime_error("Not a channel: " + name);
+	}
+
+	// Read the sizes through a private copy of the header
+	Header header;
+	if (pread(fd, &header, sizeof(header), 0) != sizeof(header) ||
+		std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0)
+	{
+		::close(fd);
+		throw std::runtime_error("Not a channel: " + name);
+	}
+	m_stateSize = header.stateSize;
+	m_commandSize = header.commandSize;
+	const std::size_t size = sizeof(Header) +
+		2 * sizeof(Slot) +
+		roundUp(m_stateSize * sizeof(double)) +
+		roundUp(m_commandSize * sizeof(double));
+	if (static_cast<std::size_t>(status.st_size) < size)
+	{
+		::close(fd);
+		throw std::runtime_error("Not a channel: " + name);
+	}
+	map(fd, size);
+}
+
+tgSharedMemoryChannel::~tgSharedMemoryChannel()
+{
+	// A controller may detach and attach again, so only the creator
+	// closes the channel for good
+	if (m_owner)
+	{
+		close();
+		shm_unlink(m_name.c_str());
+	}
+	munmap(m_pMemory, m_mappedSize);
+}
+
+void tgSharedMemoryChannel::map(int fd, std::size_t size)
+{
+	void* const pMemory =
+		mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	// The mapping outlives the descriptor
+	::close(fd);
+	if (pMemory == MAP_FAILED)
+	{
+		throw std::runtime_error(describe("Can't map", m_name));
+	}
+	m_pMemory = pMemory;
+	m_mappedSize = size;
+
+	char* const pBase = static_cast<char*>(pMemory);
+	m_pState = reinterpret_cast<Slot*>(pBase + sizeof(Header));
+	m_pCommand = reinterpret_cast<Slot*>(pBase + sizeof(Header) +
+		sizeof(Slot) + roundUp(m_stateSize * sizeof(double)));
+}
+
+void tgSharedMemoryChannel::publishState(std::size_t cycle,
+											const std::vector<double>& state)
+{
+	if (state.size() != m_stateSize)
+	{
+		throw std::invalid_argument("State is the wrong size");
+	}
+	write(m_pState, cycle, state);
+}
+
+bool tgSharedMemoryChannel::readState(std::vector<double>& state,
+										std::size_t& cycle,
+										double timeout) const
+{
+	std::size_t c = 0;
+	if (!read(m_pState, m_stateSize, tgRealTimePacer::now() + timeout, state, c) ||
+		c == 0)
+	{
+		return false;
+	}
+	cycle = c;
+	return true;
+}
+
+bool tgSharedMemoryChannel::waitForState(std::size_t after, double timeout,
+											std::vector<double>& state,
+											std::size_t& cycle) const
+{
+	const double deadline = tgRealTimePacer::now() + timeout;
+	for (std::size_t spins = 0; peek(m_pState) <= after; spins++)
+	{
+		if (isClosed())
+		{
+			return false;
+		}
+		// Spin briefly for the low latency, then let others run
+		if (spins >= kSpins)
+		{
+			if (tgRealTimePacer::now() > deadline)
+			{
+				return false;
+			}
+			sched_yield();
+		}
+	}
+	// A writer that died mid-update times out here too
+	return read(m_pState, m_stateSize, deadline, state, cycle);
+}
+
+void tgSharedMemoryChannel::publishCommand(std::size_t reply,
+											const std::vector<double>& command)
+{
+	if (command.size() != m_commandSize)
+	{
+		throw std::invalid_argument("Command is the wrong size");
+	}
+	write(m_pCommand, reply, command);
+}
+
+bool tgSharedMemoryChannel::readCommand(std::vector<double>& command,
+										std::size_t& reply,
+										double timeout) const
+{
+	std::size_t r = 0;
+	if (!read(m_pCommand, m_commandSize, tgRealTimePacer::now() + timeout, command, r) ||
+		r == 0)
+	{
+		return false;
+	}
+	reply = r;
+	return true;
+}
+
+bool tgSharedMemoryChannel::waitForCommand(std::size_t cycle, double timeout,
+											std::vector<double>& command,
+											std::size_t& reply) const
+{
+	const double deadline = tgRealTimePacer::now() + timeout;
+	for (std::size_t spins = 0; peek(m_pCommand) < cycle; spins++)
+	{
+		if (isClosed())
+		{
+			return false;
+		}
+		if (spins >= kSpins)
+		{
+			if (tgRealTimePacer::now() > deadline)
+			{
+				return false;
+			}
+			sched_yield();
+		}
+	}
+	return read(m_pCommand, m_commandSize, deadline, command, reply);
+}
+
+void tgSharedMemoryChannel::close()
+{
+	Header* const pHeader = static_cast<Header*>(m_pMemory);
+	pHeader->closed = 1;
+	__sync_synchronize();
+}
+
+bool tgSharedMemoryChannel::isClosed() const
+{
+	const Header* const pHeader = static_cast<const Header*>(m_pMemory);
+	return pHeader->closed != 0;
+}
+
+void tgSharedMemoryChannel::write(Slot* pSlot, std::size_t cycle,
+									const std::vector<double>& values)
+{
+	// Odd while writing; the builtins are full barriers
+	__sync_add_and_fetch(&pSlot->sequence, 1);
+	std::memcpy(pSlot + 1, &values[0], values.size() * sizeof(double));
+	pSlot->cycle = cycle;
+	__sync_add_and_fetch(&pSlot->sequence, 1);
+}
+
+bool tgSharedMemoryChannel::read(const Slot* pSlot, std::size_t size,
+									double deadline,
+									std::vector<double>& values,
+									std::size_t& cycle)
+{
+	values.resize(size);
+	for (std::size_t spins = 0; true; spins++)
+	{
+		// Retry if the writer is mid-update, but not forever: it may
+		// have died with the sequence odd
+		if (spins >= kSpins)
+		{
+			if (tgRealTimePacer::now() > deadline)
+			{
+				return false;
+			}
+			sched_yield();
+		}
+		const uint32_t before = pSlot->sequence;
+		if (before & 1)
+		{
+			continue;
+		}
+		__sync_synchronize();
+		const std::size_t c = pSlot->cycle;
+		std::memcpy(&values[0], pSlot + 1, size * sizeof(double));
+		__sync_synchronize();
+		if (pSlot->sequence == before)
+		{
+			cycle = c;
+			return true;
+		}
+	}
+}
+
+std::size_t tgSharedMemoryChannel::peek(const Slot* pSlot)
+{
+	__sync_synchronize();
+	return pSlot->cycle;
+}
@@ -0,0 +1,201 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef SRC_UTIL_TG_SHARED_MEMORY_CHANNEL_H
+#define SRC_UTIL_TG_SHARED_MEMORY_CHANNEL_H
+
+/**
+ * @file tgSharedMemoryChannel.h
+ * @brief Definition of class tgSharedMemoryChannel
+ * $Id$
+ */
+
+// The C++ Standard Library
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * A POSIX shared memory segment through which the simulator and a
+ * controller in another process exchange a state vector and a command
+ * vector, without locks. The simulator creates the channel and
+ * publishes states; the controller attaches by name and publishes
+ * commands. Each vector has one writer and is guarded by a sequence
+ * counter that is odd while it is written, so a reader retries instead
+ * of seeing half an update and the writer never waits.
+ *
+ * States carry the simulator's cycle number; commands carry the cycle
+ * of the state they answer, which is what lock-step waits for. A
+ * controller's loop is:
+ *
+ *     tgSharedMemoryChannel channel("/ntrt");
+ *     std::size_t cycle = 0;
+ *     while (channel.waitForState(cycle, 1.0, state, cycle))
+ *     {
+ *         computeCommand(state, command);
+ *         channel.publishCommand(cycle, command);
+ *     }
+ *
+ * Both sides must run on the same machine. The sequence counters use
+ * GCC's __sync builtins.
+ */
+class tgSharedMemoryChannel
+{
+public:
+
+	/**
+	 * Create a channel. A stale segment with the same name, left by a
+	 * creator that closed it or has exited, is replaced. The channel is
+	 * removed when this is destroyed.
+	 * @param[in] name, a POSIX shared memory name such as "/ntrt"
+	 * @param[in] stateSize, the length of the state vector
+	 * @param[in] commandSize, the length of the command vector
+	 * @throw std::invalid_argument if a size is zero
+	 * @throw std::runtime_error if a live process's open channel has
+	 * the name, or the segment can't be created
+	 */
+	tgSharedMemoryChannel(const std::string& name,
+							std::size_t stateSize,
+							std::size_t commandSize);
+
+	/**
+	 * Attach to a channel someone else created.
+	 * @throw std::runtime_error if it doesn't exist or isn't a channel
+	 */
+	explicit tgSharedMemoryChannel(const std::string& name);
+
+	/** The creator closes and removes the channel; others just detach. */
+	~tgSharedMemoryChannel();
+
+	/**
+	 * Publish a state.
+	 * @param[in] cycle, greater than that of the last state
+	 * @throw std::invalid_argument if state isn't getStateSize() long
+	 */
+	void publishState(std::size_t cycle, const std::vector<double>& state);
+
+	/**
+	 * Copy the latest state.
+	 * @param[in] timeout, in seconds, for a writer that is mid-update
+	 * @return false if none has been published, or the writer didn't
+	 * finish an update in time (it may have died)
+	 */
+	bool readState(std::vector<double>& state, std::size_t& cycle,
+					double timeout = 1.0) const;
+
+	/**
+	 * Wait for a state newer than a cycle and copy it.
+	 * @param[in] after, the cycle of the last state seen, or 0
+	 * @param[in] timeout, in seconds, including any wait for a writer
+	 * that is mid-update
+	 * @return false on timeout or if the channel was closed
+	 */
+	bool waitForState(std::size_t after, double timeout,
+						std::vector<double>& state, std::size_t& cycle) const;
+
+	/**
+	 * Publish a command.
+	 * @param[in] reply, the cycle of the state it answers
+	 * @throw std::invalid_argument if command isn't getCommandSize() long
+	 */
+	void publishCommand(std::size_t reply, const std::vector<double>& command);
+
+	/**
+	 * Copy the latest command.
+	 * @param[in] timeout, in seconds, for a writer that is mid-update
+	 * @return false if none has been published, or the writer didn't
+	 * finish an update in time
+	 */
+	bool readCommand(std::vector<double>& command, std::size_t& reply,
+						double timeout = 1.0) const;
+
+	/**
+	 * Wait for a command answering a cycle, or a later one, and copy it.
+	 * @param[in] cycle, the cycle of the state it must answer
+	 * @param[in] timeout, in seconds, including any wait for a writer
+	 * that is mid-update
+	 * @return false on timeout or if the channel was closed
+	 */
+	bool waitForCommand(std::size_t cycle, double timeout,
+						std::vector<double>& command, std::size_t& reply) const;
+
+	/** Tell the other side to stop waiting. */
+	void close();
+
+	/** True once either side has closed the channel */
+	bool isClosed() const;
+
+	std::size_t getStateSize() const
+	{
+		return m_stateSize;
+	}
+
+	std::size_t getCommandSize() const
+	{
+		return m_commandSize;
+	}
+
+	const std::string& getName() const
+	{
+		return m_name;
+	}
+
+private:
+
+	/** Not copyable */
+	tgSharedMemoryChannel(const tgSharedMemoryChannel&);
+	tgSharedMemoryChannel& operator=(const tgSharedMemoryChannel&);
+
+	/** Map the segment and find the slots. */
+	void map(int fd, std::size_t size);
+
+	/** The layout of one vector's slot; defined in the .cpp */
+	struct Slot;
+
+	static void write(Slot* pSlot, std::size_t cycle,
+						const std::vector<double>& values);
+
+	/**
+	 * Copy a slot's values, retrying while the writer is mid-update.
+	 * @param[out] cycle, of the copied values, or 0 if none
+	 * @return false if the writer didn't finish by deadline
+	 */
+	static bool read(const Slot* pSlot, std::size_t size, double deadline,
+						std::vector<double>& values, std::size_t& cycle);
+
+	/** @return the cycle of the slot without copying */
+	static std::size_t peek(const Slot* pSlot);
+
+private:
+
+	const std::string m_name;
+
+	/** True for the side that created the segment */
+	const bool m_owner;
+
+	std::size_t m_stateSize;
+	std::size_t m_commandSize;
+
+	void* m_pMemory;
+	std::size_t m_mappedSize;
+
+	Slot* m_pState;
+	Slot* m_pCommand;
+};
+
+#endif  // SRC_UTIL_TG_SHARED_MEMORY_CHANNEL_H
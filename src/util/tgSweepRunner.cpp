@@ -0,0 +1,247 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgSweepRunner.cpp
+ * @brief Implementation of class tgSweepRunner
+ * $Id$
+ */
+
+#include "tgSweepRunner.h"
+
+// The C++ Standard Library
+#include <iomanip>
+#include <ostream>
+#include <stdexcept>
+// POSIX
+#include <unistd.h>
+
+tgSweepRunner::Statistics::Statistics() :
+m_count(0),
+m_failures(0),
+m_mean(0.0),
+m_m2(0.0),
+m_min(0.0),
+m_max(0.0)
+{
+}
+
+void tgSweepRunner::Statistics::add(double score)
+{
+	m_count++;
+	if (m_count == 1)
+	{
+		m_min = score;
+		m_max = score;
+	}
+	else
+	{
+		m_min = score < m_min ? score : m_min;
+		m_max = score > m_max ? score : m_max;
+	}
+	const double delta = score - m_mean;
+	m_mean += delta / m_count;
+	m_m2 += delta * (score - m_mean);
+}
+
+void tgSweepRunner::Statistics::addFailure()
+{
+	m_failures++;
+}
+
+double tgSweepRunner::Statistics::getVariance() const
+{
+	return m_count > 1 ? m_m2 / (m_count - 1) : 0.0;
+}
+
+tgSweepRunner::tgSweepRunner(std::size_t threads) :
+m_threads(threads),
+m_pPoints(NULL),
+m_pTrial(NULL),
+m_pOut(NULL),
+m_next(0)
+{
+	if (m_threads == 0)
+	{
+		const long processors = sysconf(_SC_NPROCESSORS_ONLN);
+		m_threads = (processors > 0) ? static_cast<std::size_t>(processors) : 1;
+	}
+	if (!isParallel())
+	{
+		m_threads = 1;
+	}
+	pthread_mutex_init(&m_mutex, NULL);
+}
+
+tgSweepRunner::~tgSweepRunner()
+{
+	pthread_mutex_destroy(&m_mutex);
+}
+
+tgSweepRunner::Statistics
+tgSweepRunner::run(const std::vector<std::vector<double> >& points,
+					Trial& trial,
+					std::ostream* pOut,
+					const std::vector<std::string>& names)
+{
+	m_pPoints = &points;
+	m_pTrial = &trial;
+	m_pOut = pOut;
+	m_next = 0;
+	m_statistics = Statistics();
+
+	if (pOut != NULL)
+	{
+		const std::size_t d = points.empty() ? names.size() : points[0].size();
+		*pOut << "index";
+		for (std::size_t j = 0; j < d; j++)
+		{
+			*pOut << ",";
+			if (j < names.size())
+			{
+				*pOut << names[j];
+			}
+			else
+			{
+				*pOut << "p" << j;
+			}
+		}
+		*pOut << ",score,error" << std::endl;
+	}
+
+	// The calling thread works too
+	const std::size_t poolSize =
+		(m_threads < points.size() ? m_threads : points.size());
+	std::vector<pthread_t> pool(poolSize > 1 ? poolSize - 1 : 0);
+	for (std::size_t i = 0; i < pool.size(); i++)
+	{
+		if (pthread_create(&pool[i], NULL, run, this) != 0)
+		{
+			// Let the started threads finish the sweep
+			pool.resize(i);
+			if (i == 0)
+			{
+				throw std::runtime_error("Could not start a sweep thread");
+			}
+			break;
+		}
+	}
+
+	work();
+
+	for (std::size_t i = 0; i < pool.size(); i++)
+	{
+		pthread_join(pool[i], NULL);
+	}
+
+	m_pPoints = NULL;
+	m_pTrial = NULL;
+	m_pOut = NULL;
+	return m_statistics;
+}
+
+bool tgSweepRunner::isParallel()
+{
+#ifdef BT_NO_PROFILE
+	return true;
+#else
+	return false;
+#endif
+}
+
+void tgSweepRunner::work()
+{
+	while (true)
+	{
+		pthread_mutex_lock(&m_mutex);
+		const std::size_t index = m_next++;
+		pthread_mutex_unlock(&m_mutex);
+		if (index >= m_pPoints->size())
+		{
+			break;
+		}
+
+		try
+		{
+			report(index, m_pTrial->run((*m_pPoints)[index], index), "");
+		}
+		catch (const std::exception& e)
+		{
+			report(index, 0.0, e.what());
+		}
+		catch (...)
+		{
+			report(index, 0.0, "Unknown exception");
+		}
+	}
+}
+
+void* tgSweepRunner::run(void* pArg)
+{
+	static_cast<tgSweepRunner*>(pArg)->work();
+	return NULL;
+}
+
+void tgSweepRunner::report(std::size_t index, double score,
+							const std::string& error)
+{
+	// A NaN score is a failure too
+	const bool failed = !error.empty() || (score != score);
+
+	pthread_mutex_lock(&m_mutex);
+	if (failed)
+	{
+		m_statistics.addFailure();
+	}
+	else
+	{
+		m_statistics.add(score);
+	}
+	if (m_pOut != NULL)
+	{
+		std::ostream& out = *m_pOut;
+		const std::vector<double>& p = (*m_pPoints)[index];
+		out << index << std::setprecision(17);
+		for (std::size_t j = 0; j < p.size(); j++)
+		{
+			out << "," << p[j];
+		}
+		out << ",";
+		if (!failed)
+		{
+			out << score;
+		}
+		out << ",";
+		if (!error.empty())
+		{
+			// Keep the CSV to one field
+			out << "\"";
+			for (std::size_t i = 0; i < error.size(); i++)
+			{
+				out << (error[i] == '"' || error[i] == '\n' ? '\'' : error[i]);
+			}
+			out << "\"";
+		}
+		else if (failed)
+		{
+			out << "\"NaN score\"";
+		}
+		out << std::endl;
+	}
+	pthread_mutex_unlock(&m_mutex);
+}
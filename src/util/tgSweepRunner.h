@@ -0,0 +1,212 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef SRC_UTIL_TG_SWEEP_RUNNER_H
+#define SRC_UTIL_TG_SWEEP_RUNNER_H
+
+/**
+ * @file tgSweepRunner.h
+ * @brief Definition of class tgSweepRunner
+ * $Id$
+ */
+
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <vector>
+// POSIX threads
+#include <pthread.h>
+
+/**
+ * Runs one trial per point of a parameter sweep (see tgParameterSpace)
+ * on a pool of threads in one process, instead of one process per
+ * trial. Each trial builds its own world, model and simulation from its
+ * parameters, runs it and returns a score:
+ *
+ *     class EscapeTrial : public tgSweepRunner::Trial
+ *     {
+ *         virtual double run(const std::vector<double>& p, std::size_t i)
+ *         {
+ *             tgWorld world(config, new tgBoxGround(groundConfig(p[0])));
+ *             tgSimView view(world);
+ *             tgSimulation simulation(view);
+ *             ...
+ *             return score;
+ *         }
+ *     };
+ *
+ * Threads take the next point as they finish, so slow trials don't
+ * hold up the rest. Each result is written as a CSV line as soon as it
+ * is known, in the order the trials finish, and folded into running
+ * statistics. A trial that throws or returns NaN is a failure: it is
+ * written without a score and counted, but doesn't stop the sweep.
+ *
+ * Bullet's profiler is not thread safe, so unless it is compiled out
+ * (BT_NO_PROFILE, see inc.CMakeBullet.txt) the trials run one at a time.
+ */
+class tgSweepRunner
+{
+public:
+
+	/** One trial of the sweep */
+	class Trial
+	{
+	public:
+
+		virtual ~Trial() { }
+
+		/**
+		 * Run one trial. Called concurrently from several threads, so
+		 * keep everything the trial touches local to the call.
+		 * @param[in] parameters, one value per dimension
+		 * @param[in] index, the index of the point, e.g. for a seed
+		 * @return the score
+		 */
+		virtual double run(const std::vector<double>& parameters,
+							std::size_t index) = 0;
+	};
+
+	/** Running statistics of the scores */
+	class Statistics
+	{
+	public:
+
+		Statistics();
+
+		/** Add a score. */
+		void add(double score);
+
+		/** Count a failed trial. */
+		void addFailure();
+
+		/** The number of scores */
+		std::size_t getCount() const
+		{
+			return m_count;
+		}
+
+		std::size_t getFailureCount() const
+		{
+			return m_failures;
+		}
+
+		/** The mean score, or 0 if there are none */
+		double getMean() const
+		{
+			return m_mean;
+		}
+
+		/** The sample variance of the scores, or 0 if fewer than two */
+		double getVariance() const;
+
+		/** The lowest score, or 0 if there are none */
+		double getMin() const
+		{
+			return m_min;
+		}
+
+		/** The highest score, or 0 if there are none */
+		double getMax() const
+		{
+			return m_max;
+		}
+
+	private:
+
+		std::size_t m_count;
+		std::size_t m_failures;
+		double m_mean;
+
+		/** Sum of squared deviations from the mean, as in Welford's method */
+		double m_m2;
+
+		double m_min;
+		double m_max;
+	};
+
+	/**
+	 * @param[in] threads, the number of trials to run at once; 0 for one
+	 * per processor
+	 */
+	tgSweepRunner(std::size_t threads = 0);
+
+	~tgSweepRunner();
+
+	/**
+	 * Run a trial at every point.
+	 * @param[in] points, the parameters of each trial
+	 * @param[in,out] trial, run once per point, concurrently
+	 * @param[out] pOut, where to stream a CSV line per trial: the index,
+	 * the parameters, the score and the error of a failure. May be NULL.
+	 * @param[in] names, the names of the parameters for the CSV header;
+	 * if empty, they are numbered
+	 * @return the statistics of the scores
+	 * @throw std::runtime_error if the threads can't be started
+	 */
+	Statistics run(const std::vector<std::vector<double> >& points,
+					Trial& trial,
+					std::ostream* pOut = NULL,
+					const std::vector<std::string>& names =
+						std::vector<std::string>());
+
+	/** Return the number of trials run at once. */
+	std::size_t getThreadCount() const
+	{
+		return m_threads;
+	}
+
+	/**
+	 * Return true if trials really run concurrently, i.e. Bullet's
+	 * profiler is compiled out.
+	 */
+	static bool isParallel();
+
+private:
+
+	/** Not copyable */
+	tgSweepRunner(const tgSweepRunner&);
+	tgSweepRunner& operator=(const tgSweepRunner&);
+
+	/** Run trials until there are no points left. */
+	void work();
+
+	/** The body of a pool thread. */
+	static void* run(void* pRunner);
+
+	/** Record the result of a trial; locks the mutex. */
+	void report(std::size_t index, double score, const std::string& error);
+
+private:
+
+	std::size_t m_threads;
+
+	/** The arguments of the current run() call */
+	const std::vector<std::vector<double> >* m_pPoints;
+	Trial* m_pTrial;
+	std::ostream* m_pOut;
+
+	/** The next point to run */
+	std::size_t m_next;
+
+	Statistics m_statistics;
+
+	/** Guards m_next, m_statistics and m_pOut */
+	pthread_mutex_t m_mutex;
+};
+
+#endif // SRC_UTIL_TG_SWEEP_RUNNER_H
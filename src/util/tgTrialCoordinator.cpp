@@ -0,0 +1,475 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgTrialCoordinator.cpp
+ * @brief Implementation of class tgTrialCoordinator
+ * $Id$
+ */
+
+#include "tgTrialCoordinator.h"
+
+// The C++ Standard Library
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+// POSIX
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+namespace
+{
+	/** How long to wait for workers between checks, in milliseconds */
+	const int pollInterval = 100;
+
+	double now()
+	{
+		timeval t;
+		gettimeofday(&t, NULL);
+		return t.tv_sec + 1.0e-6 * t.tv_usec;
+	}
+
+	/** Send all of a message; false if the connection failed. */
+	bool sendAll(int socket, const std::string& message)
+	{
+		std::size_t sent = 0;
+		while (sent < message.size())
+		{
+			const ssize_t n = send(socket, message.data() + sent,
+									message.size() - sent, MSG_NOSIGNAL);
+			if (n < 0 && errno == EINTR)
+			{
+				continue;
+			}
+			else if (n <= 0)
+			{
+				return false;
+			}
+			sent += n;
+		}
+		return true;
+	}
+}
+
+tgTrialCoordinator::Config::Config(unsigned short p,
+									std::size_t b,
+									double t) :
+port(p),
+batchSize(b),
+workerTimeout(t)
+{
+	if (batchSize == 0)
+	{
+		throw std::invalid_argument("batchSize is zero");
+	}
+	else if (workerTimeout < 0.0)
+	{
+		throw std::invalid_argument("workerTimeout is negative");
+	}
+}
+
+tgTrialCoordinator::Result::Result() :
+done(false),
+failed(false),
+score(0.0)
+{
+}
+
+tgTrialCoordinator::Connection::Connection(int s, double t) :
+socket(s),
+ready(false),
+lastHeard(t)
+{
+}
+
+tgTrialCoordinator::tgTrialCoordinator(const Config& config) :
+m_config(config),
+m_listener(-1),
+m_port(0),
+m_pPoints(NULL),
+m_run(0),
+m_remaining(0),
+m_pOut(NULL),
+m_requeues(0),
+m_duplicates(0)
+{
+	m_listener = socket(AF_INET, SOCK_STREAM, 0);
+	if (m_listener < 0)
+	{
+		throw std::runtime_error("Could not create a socket");
+	}
+	const int on = 1;
+	setsockopt(m_listener, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+
+	sockaddr_in address;
+	std::memset(&address, 0, sizeof(address));
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_ANY);
+	address.sin_port = htons(m_config.port);
+	socklen_t length = sizeof(address);
+	if (bind(m_listener, reinterpret_cast<sockaddr*>(&address),
+				sizeof(address)) != 0 ||
+		listen(m_listener, 64) != 0 ||
+		getsockname(m_listener, reinterpret_cast<sockaddr*>(&address),
+					&length) != 0)
+	{
+		close(m_listener);
+		std::ostringstream message;
+		message << "Could not listen on port " << m_config.port << ": "
+				<< std::strerror(errno);
+		throw std::runtime_error(message.str());
+	}
+	m_port = ntohs(address.sin_port);
+
+	// A worker that gives up before it is accepted mustn't block us
+	fcntl(m_listener, F_SETFL, fcntl(m_listener, F_GETFL) | O_NONBLOCK);
+}
+
+tgTrialCoordinator::~tgTrialCoordinator()
+{
+	for (std::size_t i = 0; i < m_connections.size(); i++)
+	{
+		sendAll(m_connections[i].socket, "DONE\n");
+		close(m_connections[i].socket);
+	}
+	close(m_listener);
+}
+
+tgSweepRunner::Statistics
+tgTrialCoordinator::run(const std::vector<std::vector<double> >& points,
+						std::vector<Result>* pResults,
+						std::ostream* pOut,
+						const std::vector<std::string>& names)
+{
+	m_pPoints = &points;
+	m_results.assign(points.size(), Result());
+	m_copies.assign(points.size(), 0);
+	m_queue.clear();
+	for (std::size_t i = 0; i < points.size(); i++)
+	{
+		m_queue.push_back(i);
+	}
+	m_run++;
+	m_remaining = points.size();
+	m_statistics = tgSweepRunner::Statistics();
+	m_pOut = pOut;
+
+	if (pOut != NULL)
+	{
+		const std::size_t d = points.empty() ? names.size() : points[0].size();
+		*pOut << "index";
+		for (std::size_t j = 0; j < d; j++)
+		{
+			*pOut << ",";
+			if (j < names.size())
+			{
+				*pOut << names[j];
+			}
+			else
+			{
+				*pOut << "p" << j;
+			}
+		}
+		*pOut << ",score,error" << std::endl;
+	}
+
+	std::vector<pollfd> fds;
+	while (m_remaining > 0)
+	{
+		for (std::size_t i = m_connections.size(); i-- > 0; )
+		{
+			if (!serve(m_connections[i], now()))
+			{
+				drop(i);
+			}
+		}
+
+		fds.resize(m_connections.size() + 1);
+		fds[0].fd = m_listener;
+		fds[0].events = POLLIN;
+		fds[0].revents = 0;
+		for (std::size_t i = 0; i < m_connections.size(); i++)
+		{
+			fds[i + 1].fd = m_connections[i].socket;
+			fds[i + 1].events = POLLIN;
+			fds[i + 1].revents = 0;
+		}
+		if (poll(&fds[0], fds.size(), pollInterval) < 0 && errno != EINTR)
+		{
+			throw std::runtime_error("Could not wait for workers");
+		}
+
+		const double t = now();
+		for (std::size_t i = m_connections.size(); i-- > 0; )
+		{
+			Connection& connection = m_connections[i];
+			if ((fds[i + 1].revents & (POLLIN | POLLHUP | POLLERR)) &&
+				!receive(connection, t))
+			{
+				drop(i);
+			}
+			else if (m_config.workerTimeout > 0.0 &&
+						!connection.outstanding.empty() &&
+						t - connection.lastHeard > m_config.workerTimeout)
+			{
+				drop(i);
+			}
+		}
+		if (fds[0].revents & POLLIN)
+		{
+			accept(t);
+		}
+	}
+
+	// Answers to this run's points still out will be ignored
+	for (std::size_t i = 0; i < m_connections.size(); i++)
+	{
+		m_connections[i].outstanding.clear();
+	}
+	if (pResults != NULL)
+	{
+		pResults->swap(m_results);
+	}
+	m_results.clear();
+	m_pPoints = NULL;
+	m_pOut = NULL;
+	return m_statistics;
+}
+
+void tgTrialCoordinator::accept(double t)
+{
+	const int s = ::accept(m_listener, NULL, NULL);
+	if (s >= 0)
+	{
+		const int on = 1;
+		setsockopt(s, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+		m_connections.push_back(Connection(s, t));
+	}
+}
+
+bool tgTrialCoordinator::receive(Connection& connection, double t)
+{
+	char buffer[4096];
+	const ssize_t n = recv(connection.socket, buffer, sizeof(buffer), 0);
+	if (n <= 0)
+	{
+		return n < 0 && errno == EINTR;
+	}
+	connection.lastHeard = t;
+	connection.input.append(buffer, n);
+
+	std::size_t end;
+	while ((end = connection.input.find('\n')) != std::string::npos)
+	{
+		const std::string line = connection.input.substr(0, end);
+		connection.input.erase(0, end + 1);
+		if (!handle(connection, line))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+bool tgTrialCoordinator::handle(Connection& connection, const std::string& line)
+{
+	std::istringstream in(line);
+	std::string command;
+	in >> command;
+	if (command == "READY")
+	{
+		connection.ready = true;
+		return true;
+	}
+	else if (command != "RESULT")
+	{
+		return false;
+	}
+
+	unsigned long run = 0;
+	std::size_t index = 0;
+	int ok = 0;
+	double score = 0.0;
+	in >> run >> index >> ok >> score;
+	if (!in)
+	{
+		return false;
+	}
+	std::string error;
+	std::getline(in, error);
+	if (!error.empty() && error[0] == ' ')
+	{
+		error.erase(0, 1);
+	}
+
+	if (run != m_run || index >= m_results.size())
+	{
+		// From a run that has finished
+		m_duplicates++;
+		return true;
+	}
+	std::vector<std::size_t>& outstanding = connection.outstanding;
+	std::vector<std::size_t>::iterator it =
+		std::find(outstanding.begin(), outstanding.end(), index);
+	if (it != outstanding.end())
+	{
+		outstanding.erase(it);
+		m_copies[index]--;
+	}
+	record(index, ok == 0, score, error);
+	return true;
+}
+
+bool tgTrialCoordinator::serve(Connection& connection, double t)
+{
+	if (!connection.ready)
+	{
+		return true;
+	}
+
+	std::vector<std::size_t> batch;
+	while (batch.size() < m_config.batchSize && !m_queue.empty())
+	{
+		batch.push_back(m_queue.front());
+		m_queue.pop_front();
+	}
+	if (batch.empty())
+	{
+		// Race the points still out with one worker only
+		for (std::size_t i = 0; i < m_connections.size() &&
+				batch.size() < m_config.batchSize; i++)
+		{
+			const std::vector<std::size_t>& out = m_connections[i].outstanding;
+			for (std::size_t j = 0; j < out.size() &&
+					batch.size() < m_config.batchSize; j++)
+			{
+				const std::size_t index = out[j];
+				if (!m_results[index].done && m_copies[index] == 1 &&
+					std::find(batch.begin(), batch.end(), index) == batch.end())
+				{
+					batch.push_back(index);
+				}
+			}
+		}
+	}
+	if (batch.empty())
+	{
+		return true;
+	}
+
+	std::ostringstream message;
+	message << std::setprecision(17)
+			<< "BATCH " << m_run << " " << batch.size() << "\n";
+	for (std::size_t i = 0; i < batch.size(); i++)
+	{
+		const std::vector<double>& p = (*m_pPoints)[batch[i]];
+		message << batch[i];
+		for (std::size_t j = 0; j < p.size(); j++)
+		{
+			message << " " << p[j];
+		}
+		message << "\n";
+		m_copies[batch[i]]++;
+		connection.outstanding.push_back(batch[i]);
+	}
+	connection.ready = false;
+	connection.lastHeard = t;
+	return sendAll(connection.socket, message.str());
+}
+
+void tgTrialCoordinator::drop(std::size_t i)
+{
+	const Connection& connection = m_connections[i];
+	for (std::size_t j = 0; j < connection.outstanding.size(); j++)
+	{
+		const std::size_t index = connection.outstanding[j];
+		m_copies[index]--;
+		if (!m_results[index].done && m_copies[index] == 0)
+		{
+			m_queue.push_front(index);
+			m_requeues++;
+		}
+	}
+	close(connection.socket);
+	m_connections.erase(m_connections.begin() + i);
+}
+
+void tgTrialCoordinator::record(std::size_t index, bool failed, double score,
+								const std::string& error)
+{
+	Result& result = m_results[index];
+	if (result.done)
+	{
+		m_duplicates++;
+		return;
+	}
+	result.done = true;
+	result.failed = failed;
+	result.score = failed ? 0.0 : score;
+	result.error = error;
+	m_remaining--;
+
+	if (failed)
+	{
+		m_statistics.addFailure();
+	}
+	else
+	{
+		m_statistics.add(score);
+	}
+	if (m_pOut != NULL)
+	{
+		std::ostream& out = *m_pOut;
+		const std::vector<double>& p = (*m_pPoints)[index];
+		out << index << std::setprecision(17);
+		for (std::size_t j = 0; j < p.size(); j++)
+		{
+			out << "," << p[j];
+		}
+		out << ",";
+		if (!failed)
+		{
+			out << score;
+		}
+		out << ",";
+		if (failed)
+		{
+			out << "\"";
+			for (std::size_t k = 0; k < error.size(); k++)
+			{
+				out << (error[k] == '"' ? '\'' : error[k]);
+			}
+			out << "\"";
+		}
+		out << std::endl;
+	}
+}
@@ -0,0 +1,228 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef SRC_UTIL_TG_TRIAL_COORDINATOR_H
+#define SRC_UTIL_TG_TRIAL_COORDINATOR_H
+
+/**
+ * @file tgTrialCoordinator.h
+ * @brief Definition of class tgTrialCoordinator
+ * $Id$
+ */
+
+#include "tgSweepRunner.h"
+
+// The C++ Standard Library
+#include <cstddef>
+#include <deque>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+/**
+ * Hands the points of a sweep or a generation to tgTrialWorker processes
+ * over TCP, possibly on other machines, and collects their scores. Each
+ * worker runs its batches with a tgSweepRunner, so a cluster of
+ * multicore machines is used fully.
+ *
+ * Workers may connect and leave at any time. The batch of a worker that
+ * disconnects, or says nothing for workerTimeout seconds, goes back in
+ * the queue. Once the queue is empty, idle workers get a second copy of
+ * the points still out, so one slow machine doesn't hold up the rest;
+ * the first result for a point is kept and later ones are ignored.
+ * Workers stay connected between calls to run(), e.g. across
+ * generations, and are told to stop when the coordinator is destroyed.
+ *
+ * The protocol is lines of text. A worker sends "READY"; the coordinator
+ * answers "BATCH run n" then n lines "index p0 p1 ...", or "DONE". The
+ * worker answers each point with "RESULT run index 1 score" or
+ * "RESULT run index 0 0 error", then sends "READY" again. The run
+ * number tells answers from an earlier call to run() apart.
+ */
+class tgTrialCoordinator
+{
+public:
+
+	struct Config
+	{
+		/**
+		 * @param[in] port, the TCP port to listen on; 0 for any free
+		 * one, see getPort()
+		 * @param[in] batchSize, the number of points sent at once; must
+		 * be positive. A multiple of the workers' thread count keeps
+		 * them busy.
+		 * @param[in] workerTimeout, the seconds a worker with points
+		 * out may be silent before it is dropped; 0 for no limit. Must
+		 * not be negative, and should be longer than a batch takes.
+		 */
+		Config(unsigned short port = 0,
+				std::size_t batchSize = 4,
+				double workerTimeout = 0.0);
+
+		unsigned short port;
+		std::size_t batchSize;
+		double workerTimeout;
+	};
+
+	/** The outcome of one point */
+	struct Result
+	{
+		Result();
+
+		/** False if no worker reported it */
+		bool done;
+
+		bool failed;
+
+		double score;
+
+		/** Why it failed */
+		std::string error;
+	};
+
+	/**
+	 * Listen for workers.
+	 * @throw std::invalid_argument if the config is invalid
+	 * @throw std::runtime_error if the port can't be opened
+	 */
+	tgTrialCoordinator(const Config& config = Config());
+
+	/** Tell the connected workers to stop. */
+	~tgTrialCoordinator();
+
+	/** The port workers should connect to */
+	unsigned short getPort() const
+	{
+		return m_port;
+	}
+
+	/**
+	 * Have the workers run a trial at every point. Blocks until every
+	 * point has a result, however many workers come and go.
+	 * @param[in] points, the parameters of each trial
+	 * @param[out] pResults, if not NULL, the result of each point
+	 * @param[out] pOut, where to stream a CSV line per point as in
+	 * tgSweepRunner::run(); may be NULL
+	 * @param[in] names, the names of the parameters for the CSV header
+	 * @return the statistics of the scores
+	 */
+	tgSweepRunner::Statistics run(const std::vector<std::vector<double> >& points,
+									std::vector<Result>* pResults = NULL,
+									std::ostream* pOut = NULL,
+									const std::vector<std::string>& names =
+										std::vector<std::string>());
+
+	/** The number of workers connected */
+	std::size_t getWorkerCount() const
+	{
+		return m_connections.size();
+	}
+
+	/** The number of points requeued because their worker was lost */
+	std::size_t getRequeueCount() const
+	{
+		return m_requeues;
+	}
+
+	/** The number of results ignored because the point was done */
+	std::size_t getDuplicateCount() const
+	{
+		return m_duplicates;
+	}
+
+private:
+
+	/** A worker's connection */
+	struct Connection
+	{
+		Connection(int socket, double now);
+
+		int socket;
+
+		/** Received text not yet split into lines */
+		std::string input;
+
+		/** The points sent and not yet answered */
+		std::vector<std::size_t> outstanding;
+
+		/** True if it asked for points and hasn't been sent any */
+		bool ready;
+
+		/** When it last sent anything */
+		double lastHeard;
+	};
+
+	/** Not copyable */
+	tgTrialCoordinator(const tgTrialCoordinator&);
+	tgTrialCoordinator& operator=(const tgTrialCoordinator&);
+
+	/** Accept a worker, if one is waiting. */
+	void accept(double now);
+
+	/**
+	 * Read from a connection and act on its complete lines.
+	 * @return false if it closed or broke the protocol
+	 */
+	bool receive(Connection& connection, double now);
+
+	/** Act on one line from a worker. */
+	bool handle(Connection& connection, const std::string& line);
+
+	/**
+	 * Send the next batch to a ready worker, if there is one.
+	 * @return false if the send failed
+	 */
+	bool serve(Connection& connection, double now);
+
+	/** Close a connection, requeueing its points. */
+	void drop(std::size_t i);
+
+	/** Record the result of a point, unless it is done. */
+	void record(std::size_t index, bool failed, double score,
+				const std::string& error);
+
+private:
+
+	const Config m_config;
+
+	int m_listener;
+
+	unsigned short m_port;
+
+	std::vector<Connection> m_connections;
+
+	/** The state of the current run() call */
+	const std::vector<std::vector<double> >* m_pPoints;
+	std::vector<Result> m_results;
+	std::deque<std::size_t> m_queue;
+
+	/** The number of workers each point is out with */
+	std::vector<unsigned int> m_copies;
+
+	/** Numbers the calls to run(), so late answers can be told apart */
+	unsigned long m_run;
+
+	std::size_t m_remaining;
+	tgSweepRunner::Statistics m_statistics;
+	std::ostream* m_pOut;
+
+	std::size_t m_requeues;
+	std::size_t m_duplicates;
+};
+
+#endif // SRC_UTIL_TG_TRIAL_COORDINATOR_H
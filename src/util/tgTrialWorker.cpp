@@ -0,0 +1,255 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgTrialWorker.cpp
+ * @brief Implementation of class tgTrialWorker
+ * $Id$
+ */
+
+#include "tgTrialWorker.h"
+
+// The C++ Standard Library
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+// POSIX
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+namespace
+{
+	/** Send all of a message; false if the connection failed. */
+	bool sendAll(int socket, const std::string& message)
+	{
+		std::size_t sent = 0;
+		while (sent < message.size())
+		{
+			const ssize_t n = send(socket, message.data() + sent,
+									message.size() - sent, MSG_NOSIGNAL);
+			if (n < 0 && errno == EINTR)
+			{
+				continue;
+			}
+			else if (n <= 0)
+			{
+				return false;
+			}
+			sent += n;
+		}
+		return true;
+	}
+
+	/**
+	 * Runs a batch's trials and keeps each result, which tgSweepRunner
+	 * only reports in aggregate. Each call writes its own element.
+	 */
+	class RecordingTrial : public tgSweepRunner::Trial
+	{
+	public:
+
+		RecordingTrial(tgSweepRunner::Trial& trial, std::size_t n) :
+		m_trial(trial),
+		scores(n, 0.0),
+		errors(n)
+		{
+		}
+
+		virtual double run(const std::vector<double>& parameters,
+							std::size_t i)
+		{
+			try
+			{
+				scores[i] = m_trial.run(parameters, indexes[i]);
+			}
+			catch (const std::exception& e)
+			{
+				errors[i] = e.what();
+				throw;
+			}
+			catch (...)
+			{
+				errors[i] = "Unknown exception";
+				throw;
+			}
+			return scores[i];
+		}
+
+	private:
+
+		tgSweepRunner::Trial& m_trial;
+
+	public:
+
+		/** The coordinator's index of each point */
+		std::vector<std::size_t> indexes;
+
+		std::vector<double> scores;
+		std::vector<std::string> errors;
+	};
+}
+
+tgTrialWorker::tgTrialWorker(const std::string& host, unsigned short port,
+								std::size_t threads) :
+m_socket(-1),
+m_runner(threads)
+{
+	std::ostringstream service;
+	service << port;
+	addrinfo hints;
+	std::memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	addrinfo* pAddresses = NULL;
+	if (getaddrinfo(host.c_str(), service.str().c_str(), &hints,
+					&pAddresses) != 0)
+	{
+		throw std::runtime_error("Could not resolve " + host);
+	}
+	for (addrinfo* p = pAddresses; p != NULL && m_socket < 0; p = p->ai_next)
+	{
+		m_socket = socket(p->ai_family, p->ai_socktype, p->ai_protocol);
+		if (m_socket >= 0 && connect(m_socket, p->ai_addr, p->ai_addrlen) != 0)
+		{
+			close(m_socket);
+			m_socket = -1;
+		}
+	}
+	freeaddrinfo(pAddresses);
+	if (m_socket < 0)
+	{
+		std::ostringstream message;
+		message << "Could not connect to " << host << ":" << port;
+		throw std::runtime_error(message.str());
+	}
+	const int on = 1;
+	setsockopt(m_socket, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+}
+
+tgTrialWorker::~tgTrialWorker()
+{
+	close(m_socket);
+}
+
+std::size_t tgTrialWorker::run(tgSweepRunner::Trial& trial)
+{
+	std::size_t count = 0;
+	std::string line;
+	while (sendAll(m_socket, "READY\n") && readLine(line))
+	{
+		std::istringstream header(line);
+		std::string command;
+		unsigned long run = 0;
+		std::size_t n = 0;
+		header >> command >> run >> n;
+		if (command != "BATCH" || !header)
+		{
+			// DONE, or something we don't understand
+			break;
+		}
+
+		RecordingTrial recorder(trial, n);
+		recorder.indexes.resize(n);
+		std::vector<std::vector<double> > points(n);
+		for (std::size_t i = 0; i < n; i++)
+		{
+			if (!readLine(line))
+			{
+				return count;
+			}
+			std::istringstream in(line);
+			in >> recorder.indexes[i];
+			double x;
+			while (in >> x)
+			{
+				points[i].push_back(x);
+			}
+		}
+
+		m_runner.run(points, recorder);
+		count += n;
+
+		std::ostringstream results;
+		results << std::setprecision(17);
+		for (std::size_t i = 0; i < n; i++)
+		{
+			std::string error = recorder.errors[i];
+			const double score = recorder.scores[i];
+			if (error.empty() && !(std::fabs(score) <= 1.0e308))
+			{
+				// NaN and infinity don't survive the text
+				error = "Non-finite score";
+			}
+			results << "RESULT " << run << " " << recorder.indexes[i];
+			if (error.empty())
+			{
+				results << " 1 " << score << "\n";
+			}
+			else
+			{
+				// Keep the error to one line
+				for (std::size_t k = 0; k < error.size(); k++)
+				{
+					if (error[k] == '\n' || error[k] == '\r')
+					{
+						error[k] = ' ';
+					}
+				}
+				results << " 0 0 " << error << "\n";
+			}
+		}
+		if (!sendAll(m_socket, results.str()))
+		{
+			break;
+		}
+	}
+	return count;
+}
+
+bool tgTrialWorker::readLine(std::string& line)
+{
+	std::size_t end;
+	while ((end = m_input.find('\n')) == std::string::npos)
+	{
+		char buffer[4096];
+		const ssize_t n = recv(m_socket, buffer, sizeof(buffer), 0);
+		if (n < 0 && errno == EINTR)
+		{
+			continue;
+		}
+		else if (n <= 0)
+		{
+			return false;
+		}
+		m_input.append(buffer, n);
+	}
+	line = m_input.substr(0, end);
+	m_input.erase(0, end + 1);
+	return true;
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef SRC_UTIL_TG_TRIAL_WORKER_H
+#define SRC_UTIL_TG_TRIAL_WORKER_H
+
+/**
+ * @file tgTrialWorker.h
+ * @brief Definition of class tgTrialWorker
+ * $Id$
+ */
+
+#include "tgSweepRunner.h"
+
+// The C++ Standard Library
+#include <cstddef>
+#include <string>
+
+/**
+ * Runs trials for a tgTrialCoordinator, possibly on another machine.
+ * Each batch of points is run with a tgSweepRunner, so the same Trial
+ * class serves a local sweep and a distributed one:
+ *
+ *     int main(int argc, char** argv)
+ *     {
+ *         EscapeTrial trial;
+ *         tgTrialWorker worker(argv[1], std::atoi(argv[2]));
+ *         worker.run(trial);
+ *         return 0;
+ *     }
+ */
+class tgTrialWorker
+{
+public:
+
+	/**
+	 * Connect to a coordinator.
+	 * @param[in] host, its name or address
+	 * @param[in] port, see tgTrialCoordinator::getPort()
+	 * @param[in] threads, passed to tgSweepRunner
+	 * @throw std::runtime_error if it can't be reached
+	 */
+	tgTrialWorker(const std::string& host, unsigned short port,
+					std::size_t threads = 0);
+
+	~tgTrialWorker();
+
+	/**
+	 * Run batches until the coordinator says it is done or goes away.
+	 * @param[in,out] trial, run once per point, concurrently
+	 * @return the number of trials run
+	 */
+	std::size_t run(tgSweepRunner::Trial& trial);
+
+private:
+
+	/** Not copyable */
+	tgTrialWorker(const tgTrialWorker&);
+	tgTrialWorker& operator=(const tgTrialWorker&);
+
+	/**
+	 * Read a line from the coordinator.
+	 * @return false if the connection closed
+	 */
+	bool readLine(std::string& line);
+
+private:
+
+	int m_socket;
+
+	tgSweepRunner m_runner;
+
+	/** Received text not yet returned by readLine() */
+	std::string m_input;
+};
+
+#endif // SRC_UTIL_TG_TRIAL_WORKER_H
@@ -0,0 +1,126 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+
+/**
+* @file tgOscillatorBank_test.cpp
+* @brief Contains a test of the rotation recurrence in tgOscillatorBank
+* $Id$
+*/
+
+// This application
+#include "controllers/tgOscillatorBank.h"
+// The C++ Standard Library
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+// Google Test
+#include "gtest/gtest.h"
+
+
+using namespace std;
+
+namespace {
+
+	class tgOscillatorBankTest : public ::testing::Test {
+		protected:
+			tgOscillatorBankTest() {
+
+			}
+
+			virtual ~tgOscillatorBankTest() {
+
+			}
+	};
+
+	// A minute at 1 kHz should match sin() to well under a micron
+	TEST_F(tgOscillatorBankTest, MatchesSine) {
+		tgOscillatorBank bank(tgOscillatorBank::Config(1000));
+		const double amplitude[] = {1.0, 2.5, 0.3};
+		const double omega[] = {6.28, 40.0, 0.7};
+		const double phase[] = {0.0, 1.0, -M_PI};
+		const double offset[] = {5.0, 0.0, 2.0};
+		for (int i = 0; i < 3; i++)
+		{
+			EXPECT_EQ(i, bank.addChannel(amplitude[i], omega[i], phase[i], offset[i]));
+		}
+
+		const double dt = 0.001;
+		double t = 0.0;
+		for (int s = 0; s < 60000; s++)
+		{
+			t += dt;
+			const vector<double>& out = bank.step(dt);
+			ASSERT_EQ(3, out.size());
+			for (int i = 0; i < 3; i++)
+			{
+				const double expected =
+					offset[i] + amplitude[i] * sin(omega[i] * t + phase[i]);
+				ASSERT_NEAR(expected, out[i], 1.0e-9) << "step " << s;
+			}
+		}
+		EXPECT_DOUBLE_EQ(t, bank.getTime());
+	}
+
+	// Changing dt or a channel mid run stays exact
+	TEST_F(tgOscillatorBankTest, ChangesAndReset) {
+		tgOscillatorBank bank;
+		bank.addChannel(1.0, 3.0, 0.5, 0.0);
+		double t = 0.0;
+		for (int s = 0; s < 500; s++)
+		{
+			const double dt = (s < 250) ? 0.001 : 0.002;
+			t += dt;
+			bank.step(dt);
+		}
+		EXPECT_NEAR(sin(3.0 * t + 0.5), bank.getOutputs()[0], 1.0e-12);
+
+		bank.setChannel(0, 2.0, 1.0, 0.0, 1.0);
+		bank.step(0.002);
+		t += 0.002;
+		EXPECT_NEAR(1.0 + 2.0 * sin(t), bank.getOutputs()[0], 1.0e-12);
+
+		bank.reset();
+		EXPECT_EQ(0.0, bank.getTime());
+		EXPECT_NEAR(1.0, bank.getOutputs()[0], 1.0e-12);
+	}
+
+	TEST_F(tgOscillatorBankTest, Limits) {
+		tgOscillatorBank bank(tgOscillatorBank::Config(1000, -0.5, 0.5));
+		bank.addChannel(1.0, M_PI, M_PI / 2.0, 0.0);
+		EXPECT_EQ(0.5, bank.getOutputs()[0]);
+		for (int s = 0; s < 1000; s++)
+		{
+			bank.step(0.001);
+		}
+		EXPECT_EQ(-0.5, bank.getOutputs()[0]);
+
+		EXPECT_THROW(tgOscillatorBank::Config(0), std::invalid_argument);
+		EXPECT_THROW(tgOscillatorBank::Config(10, 1.0, -1.0), std::invalid_argument);
+		EXPECT_THROW(bank.step(0.0), std::invalid_argument);
+		EXPECT_THROW(bank.setChannel(1, 1.0, 1.0, 0.0, 0.0), std::out_of_range);
+		EXPECT_THROW(bank.apply(std::vector<tgBasicActuator*>(), 0.001),
+					 std::invalid_argument);
+	}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
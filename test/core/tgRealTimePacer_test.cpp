@@ -0,0 +1,207 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file tgRealTimePacer_test.cpp
+* @brief Contains a test of the release schedule of tgRealTimePacer
+* $Id$
+*/
+
+// This application
+#include "core/tgRealTimePacer.h"
+// The C++ Standard Library
+#include <stdexcept>
+// Google Test
+#include "gtest/gtest.h"
+
+
+namespace {
+
+	// Periods and times that are exact in binary, so releases compare equal
+
+	/** A pacer on a clock the test moves by hand */
+	class ManualPacer : public tgRealTimePacer
+	{
+	public:
+		ManualPacer(const Config& config, double period) :
+		tgRealTimePacer(config, period),
+		time(100.0),
+		wakeLateness(0.0)
+		{
+		}
+
+		/** Run a step that takes the given time */
+		void step(double duration)
+		{
+			beginStep();
+			time += duration;
+			endStep();
+		}
+
+		double time;
+
+		/** How long after its deadline a sleep wakes */
+		double wakeLateness;
+
+	protected:
+		virtual double currentTime() const
+		{
+			return time;
+		}
+
+		virtual void sleepUntil(double t)
+		{
+			if (t > time)
+			{
+				time = t + wakeLateness;
+			}
+		}
+	};
+
+	TEST(tgRealTimePacerTest, ReleasesStepsOnSchedule) {
+		ManualPacer pacer(tgRealTimePacer::Config(), 0.25);
+		pacer.start();
+
+		// Step 0 is released by start() and is on time
+		pacer.step(0.125);
+		EXPECT_EQ(100.0, pacer.getReleaseTime());
+		EXPECT_FALSE(pacer.getLastMissed());
+		EXPECT_EQ(0.0, pacer.getLastJitter());
+
+		for (int k = 1; k < 8; k++)
+		{
+			pacer.step(0.125);
+			EXPECT_EQ(100.0 + 0.25 * k, pacer.getReleaseTime());
+			EXPECT_EQ(0.125, pacer.getLastStepTime());
+			EXPECT_FALSE(pacer.getLastMissed());
+		}
+
+		const tgRealTimePacer::Statistics& stats = pacer.getStatistics();
+		EXPECT_EQ(8u, stats.steps);
+		EXPECT_EQ(7u, stats.waits);
+		EXPECT_EQ(0u, stats.misses);
+		EXPECT_EQ(0u, stats.skipped);
+		EXPECT_EQ(0u, stats.restarts);
+		EXPECT_EQ(0.125, stats.getMeanStepTime());
+	}
+
+	TEST(tgRealTimePacerTest, ScalesTimeAndMeasuresJitter) {
+		ManualPacer pacer(tgRealTimePacer::Config(tgRealTimePacer::eCatchUp,
+												  10, 2.0), 0.25);
+		pacer.wakeLateness = 0.0625;
+		pacer.start();
+		pacer.step(0.0);
+		pacer.step(0.0);
+		EXPECT_EQ(100.5, pacer.getReleaseTime());
+		EXPECT_EQ(0.0625, pacer.getLastJitter());
+
+		// Lateness is measured from the release, not carried forward
+		pacer.step(0.0);
+		EXPECT_EQ(101.0, pacer.getReleaseTime());
+
+		const tgRealTimePacer::Statistics& stats = pacer.getStatistics();
+		EXPECT_EQ(2u, stats.waits);
+		EXPECT_EQ(0.0625, stats.getMeanJitter());
+		EXPECT_EQ(0.0625, stats.getRmsJitter());
+		EXPECT_EQ(0.0625, stats.maxJitter);
+	}
+
+	TEST(tgRealTimePacerTest, SkipsPassedReleases) {
+		ManualPacer pacer(tgRealTimePacer::Config(tgRealTimePacer::eSkip),
+						  0.25);
+		pacer.start();
+
+		// Ends at 100.625, past the releases at 100.25 and 100.5
+		pacer.step(0.625);
+		EXPECT_TRUE(pacer.getLastMissed());
+
+		pacer.step(0.125);
+		EXPECT_EQ(100.75, pacer.getReleaseTime());
+		EXPECT_FALSE(pacer.getLastMissed());
+
+		pacer.step(0.125);
+		EXPECT_EQ(101.0, pacer.getReleaseTime());
+
+		const tgRealTimePacer::Statistics& stats = pacer.getStatistics();
+		EXPECT_EQ(3u, stats.steps);
+		EXPECT_EQ(1u, stats.misses);
+		EXPECT_EQ(2u, stats.skipped);
+		EXPECT_EQ(0u, stats.restarts);
+	}
+
+	TEST(tgRealTimePacerTest, CatchesUpThenRestarts) {
+		ManualPacer pacer(tgRealTimePacer::Config(tgRealTimePacer::eCatchUp,
+												  2), 0.25);
+		pacer.start();
+
+		// Ends at 101, four releases late
+		pacer.step(1.0);
+
+		// The late releases run at once, up to maxCatchUp in a row
+		pacer.step(0.0);
+		EXPECT_EQ(100.25, pacer.getReleaseTime());
+		pacer.step(0.0);
+		EXPECT_EQ(100.5, pacer.getReleaseTime());
+		EXPECT_EQ(101.0, pacer.time);
+
+		// Then the schedule restarts from now
+		pacer.step(0.0);
+		EXPECT_EQ(101.0, pacer.getReleaseTime());
+		EXPECT_FALSE(pacer.getLastMissed());
+		pacer.step(0.0);
+		EXPECT_EQ(101.25, pacer.getReleaseTime());
+		EXPECT_EQ(101.25, pacer.time);
+
+		const tgRealTimePacer::Statistics& stats = pacer.getStatistics();
+		EXPECT_EQ(5u, stats.steps);
+		EXPECT_EQ(3u, stats.misses);
+		EXPECT_EQ(1u, stats.restarts);
+		EXPECT_EQ(0u, stats.skipped);
+		EXPECT_EQ(1u, stats.waits);
+	}
+
+	TEST(tgRealTimePacerTest, StartClearsTheSchedule) {
+		ManualPacer pacer(tgRealTimePacer::Config(), 0.25);
+		pacer.start();
+		pacer.step(1.0);
+		pacer.step(0.0);
+
+		pacer.time = 200.0;
+		pacer.start();
+		pacer.step(0.0);
+		EXPECT_EQ(200.0, pacer.getReleaseTime());
+		EXPECT_FALSE(pacer.getLastMissed());
+		EXPECT_EQ(1u, pacer.getStatistics().steps);
+		EXPECT_EQ(0u, pacer.getStatistics().misses);
+	}
+
+	TEST(tgRealTimePacerTest, RejectsBadConfig) {
+		EXPECT_THROW(tgRealTimePacer::Config(tgRealTimePacer::eSkip, 0),
+					 std::invalid_argument);
+		EXPECT_THROW(tgRealTimePacer::Config(tgRealTimePacer::eSkip, 1, 0.0),
+					 std::invalid_argument);
+		EXPECT_THROW(tgRealTimePacer(tgRealTimePacer::Config(), 0.0),
+					 std::invalid_argument);
+	}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,113 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file FitnessSurrogate_test.cpp
+* @brief Contains tests of FitnessSurrogate
+* $Id$
+*/
+
+
+// This application
+#include "learning/Surrogate/FitnessSurrogate.h"
+// The C++ Standard Library
+#include <stdexcept>
+#include <vector>
+// Google Test
+#include "gtest/gtest.h"
+
+
+using namespace std;
+
+namespace {
+
+	vector<double> point(double x, double y)
+	{
+		vector<double> p(2);
+		p[0] = x;
+		p[1] = y;
+		return p;
+	}
+
+	/** Scores x on a 5 x 5 grid of the unit square */
+	void train(FitnessSurrogate& surrogate)
+	{
+		for (int i = 0; i < 5; i++)
+		{
+			for (int j = 0; j < 5; j++)
+			{
+				surrogate.add(point(i / 4.0, j / 4.0), i / 4.0);
+			}
+		}
+	}
+
+	TEST(FitnessSurrogateTest, Predict) {
+		FitnessSurrogate surrogate(FitnessSurrogate::Config(true, 4, 0.5, 0.0, 25));
+		double score = 0.0;
+		surrogate.add(point(0.0, 0.0), 0.0);
+		EXPECT_FALSE(surrogate.predict(point(0.0, 0.0), score));
+
+		train(surrogate);
+		ASSERT_TRUE(surrogate.predict(point(0.5, 0.5), score));
+		EXPECT_DOUBLE_EQ(0.5, score);
+		ASSERT_TRUE(surrogate.predict(point(0.9, 0.1), score));
+		EXPECT_NEAR(0.9, score, 0.1);
+
+		EXPECT_THROW(surrogate.add(vector<double>(3), 0.0), invalid_argument);
+		EXPECT_THROW(FitnessSurrogate::Config(true, 0), invalid_argument);
+	}
+
+	TEST(FitnessSurrogateTest, SkipsOnlyHopeless) {
+		std::tr1::ranlux64_base_01 eng(1);
+		double score = 0.0;
+
+		FitnessSurrogate surrogate(FitnessSurrogate::Config(true, 4, 0.5, 0.0, 10));
+		train(surrogate);
+		EXPECT_TRUE(surrogate.shouldSkip(point(0.1, 0.5), &eng, score));
+		EXPECT_GT(0.5, score);
+		EXPECT_FALSE(surrogate.shouldSkip(point(0.9, 0.5), &eng, score));
+		EXPECT_EQ(1, surrogate.getSkipCount());
+
+		// Always explore
+		FitnessSurrogate explorer(FitnessSurrogate::Config(true, 4, 0.5, 1.0, 10));
+		train(explorer);
+		EXPECT_FALSE(explorer.shouldSkip(point(0.1, 0.5), &eng, score));
+
+		// Off by default
+		FitnessSurrogate off((FitnessSurrogate::Config()));
+		train(off);
+		EXPECT_FALSE(off.shouldSkip(point(0.1, 0.5), &eng, score));
+	}
+
+	TEST(FitnessSurrogateTest, ForgetsTheOldest) {
+		FitnessSurrogate surrogate(FitnessSurrogate::Config(true, 1, 0.5, 0.0, 1, 2));
+		surrogate.add(point(0.0, 0.0), 1.0);
+		surrogate.add(point(1.0, 1.0), 2.0);
+		surrogate.add(point(0.0, 0.0), 3.0);
+		EXPECT_EQ(2, surrogate.size());
+		double score = 0.0;
+		ASSERT_TRUE(surrogate.predict(point(0.1, 0.1), score));
+		EXPECT_DOUBLE_EQ(3.0, score);
+	}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
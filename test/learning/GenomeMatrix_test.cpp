@@ -0,0 +1,169 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file GenomeMatrix_test.cpp
+* @brief Contains tests of GenomeMatrix
+* $Id$
+*/
+
+
+// This application
+#include "learning/Genome/GenomeMatrix.h"
+#include "learning/Genome/GenomeRow.h"
+// The C++ Standard Library
+#include <stdexcept>
+#include <vector>
+// Google Test
+#include "gtest/gtest.h"
+
+
+using namespace std;
+
+namespace {
+
+	/** Scores a genome by its first parameter */
+	vector<double> scores(const GenomeMatrix& genomes)
+	{
+		vector<double> s(genomes.rows());
+		for (size_t r = 0; r < genomes.rows(); r++)
+		{
+			s[r] = genomes.row(r)[0];
+		}
+		return s;
+	}
+
+	TEST(GenomeMatrixTest, Order) {
+		GenomeMatrix genomes(4, 2);
+		vector<double> s(4);
+		s[0] = 1.0;
+		s[1] = 3.0;
+		s[2] = 2.0;
+		s[3] = 3.0;
+		genomes.row(1)[0] = 0.5;
+		genomes.order(s);
+		ASSERT_EQ(4, genomes.getOrder().size());
+		EXPECT_EQ(1, genomes.getOrder()[0]);
+		EXPECT_EQ(3, genomes.getOrder()[1]);
+		EXPECT_EQ(2, genomes.getOrder()[2]);
+		EXPECT_EQ(0, genomes.getOrder()[3]);
+		EXPECT_EQ(0.5, genomes.ranked(0)[0]);
+
+		EXPECT_THROW(genomes.order(vector<double>(3)), invalid_argument);
+		EXPECT_THROW(GenomeMatrix(0, 2), invalid_argument);
+	}
+
+	TEST(GenomeMatrixTest, NextGenerationKeepsSurvivors) {
+		GenomeMatrix genomes(100, 8, 3);
+		genomes.randomize();
+		genomes.order(scores(genomes));
+		const vector<double> best(genomes.ranked(0), genomes.ranked(0) + 8);
+
+		genomes.nextGeneration(30, 20, 0.1);
+		EXPECT_EQ(1, genomes.getGeneration());
+		EXPECT_EQ(best, vector<double>(genomes.ranked(0), genomes.ranked(0) + 8));
+		for (size_t r = 0; r < genomes.rows(); r++)
+		{
+			for (size_t c = 0; c < genomes.columns(); c++)
+			{
+				EXPECT_LE(0.0, genomes.row(r)[c]);
+				EXPECT_GE(1.0, genomes.row(r)[c]);
+			}
+		}
+
+		EXPECT_THROW(genomes.nextGeneration(60, 40, 0.1), invalid_argument);
+	}
+
+	TEST(GenomeMatrixTest, Evolves) {
+		GenomeMatrix genomes(1000, 4, 5);
+		genomes.randomize();
+		for (int g = 0; g < 20; g++)
+		{
+			genomes.order(scores(genomes));
+			genomes.nextGeneration(400, 400, 0.05);
+		}
+		genomes.order(scores(genomes));
+		EXPECT_LT(0.99, genomes.ranked(0)[0]);
+		EXPECT_LT(0.9, genomes.ranked(500)[0]);
+	}
+
+	TEST(GenomeMatrixTest, Repeatable) {
+		GenomeMatrix a(50, 3, 7);
+		GenomeMatrix b(50, 3, 7);
+		GenomeMatrix c(50, 3, 8);
+		a.randomize();
+		b.randomize();
+		c.randomize();
+		a.order(scores(a));
+		b.order(scores(b));
+		a.nextGeneration(10, 10, 0.2);
+		b.nextGeneration(10, 10, 0.2);
+		EXPECT_EQ(vector<double>(a.row(0), a.row(0) + 150),
+				  vector<double>(b.row(0), b.row(0) + 150));
+		EXPECT_NE(vector<double>(a.row(0), a.row(0) + 150),
+				  vector<double>(c.row(0), c.row(0) + 150));
+	}
+
+	// A row's draws repeat within a generation and change with advance()
+	TEST(GenomeMatrixTest, AdvanceDrawsAfresh) {
+		GenomeMatrix genomes(2, 1, 9);
+		genomes.row(0)[0] = 0.5;
+		genomes.row(1)[0] = 0.5;
+		genomes.mutate(0, 0.1);
+		genomes.mutate(1, 0.1);
+		const double first = genomes.row(0)[0];
+		EXPECT_NE(first, genomes.row(1)[0]);
+
+		genomes.row(0)[0] = 0.5;
+		genomes.mutate(0, 0.1);
+		EXPECT_EQ(first, genomes.row(0)[0]);
+
+		genomes.row(0)[0] = 0.5;
+		genomes.advance();
+		genomes.mutate(0, 0.1);
+		EXPECT_NE(first, genomes.row(0)[0]);
+		EXPECT_EQ(1, genomes.getGeneration());
+	}
+
+	// Views share the row; assignment copies values, as vectors did
+	TEST(GenomeMatrixTest, RowViews) {
+		GenomeMatrix genomes(3, 4);
+		GenomeRow best(genomes.row(0), genomes.columns());
+		GenomeRow worst(genomes.row(2), genomes.columns());
+		best = vector<double>(4, 0.25);
+		worst = best;
+		worst[1] = 0.75;
+		EXPECT_EQ(0.25, genomes.row(2)[0]);
+		EXPECT_EQ(0.75, genomes.row(2)[1]);
+		EXPECT_EQ(0.25, best[1]);
+
+		GenomeRow alias(genomes.row(2), genomes.columns());
+		alias[3] = 1.0;
+		EXPECT_EQ(1.0, genomes.row(2)[3]);
+
+		const vector<double> copy = worst;
+		EXPECT_EQ(vector<double>(genomes.row(2), genomes.row(2) + 4), copy);
+		EXPECT_THROW(worst = vector<double>(3, 0.0), std::invalid_argument);
+	}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
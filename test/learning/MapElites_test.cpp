@@ -0,0 +1,130 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file MapElites_test.cpp
+* @brief Contains tests of MapElites
+* $Id$
+*/
+
+// This application
+#include "learning/MapElites/MapElites.h"
+// The C++ Standard Library
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+// Google Test
+#include "gtest/gtest.h"
+
+
+using namespace std;
+
+namespace {
+
+	/** Takes a candidate; its descriptor is its first two parameters */
+	class EchoEvaluator : public MapElites::Evaluator
+	{
+	public:
+		EchoEvaluator(MapElites& archive) : m_archive(archive) { }
+
+		virtual void run(size_t trial)
+		{
+			vector<double> genome;
+			m_archive.nextCandidate(genome);
+			vector<double> descriptor(genome.begin(), genome.begin() + 2);
+			m_archive.report(genome, genome[2], descriptor);
+		}
+
+	private:
+		MapElites& m_archive;
+	};
+
+	TEST(MapElitesTest, GridCells) {
+		MapElites archive(MapElites::Config(3, 2, 4));
+		EXPECT_EQ(16, archive.getCellCount());
+
+		vector<double> d(2);
+		d[0] = 0.3;
+		d[1] = 0.9;
+		EXPECT_EQ(1 * 4 + 3, archive.cellOf(d));
+		d[0] = -1.0;
+		d[1] = 1.0;
+		EXPECT_EQ(3, archive.cellOf(d));
+
+		EXPECT_THROW(MapElites::Config(0), invalid_argument);
+		EXPECT_THROW(MapElites(MapElites::Config(1, 30, 10)), invalid_argument);
+	}
+
+	TEST(MapElitesTest, KeepsTheFittest) {
+		MapElites archive(MapElites::Config(3, 2, 4));
+		vector<double> d(2, 0.1);
+		vector<double> g(3, 0.5);
+		EXPECT_TRUE(archive.report(g, 1.0, d));
+		g[0] = 0.7;
+		EXPECT_FALSE(archive.report(g, 0.5, d));
+		EXPECT_TRUE(archive.report(g, 2.0, d));
+		archive.reportFailure();
+
+		vector<double> elite;
+		double fitness = 0.0;
+		ASSERT_TRUE(archive.getElite(0, elite, fitness));
+		EXPECT_EQ(g, elite);
+		EXPECT_EQ(2.0, fitness);
+		EXPECT_FALSE(archive.getElite(1, elite, fitness));
+		EXPECT_EQ(1, archive.getFilledCount());
+		EXPECT_EQ(3, archive.getEvaluationCount());
+		EXPECT_EQ(1, archive.getFailureCount());
+	}
+
+	TEST(MapElitesTest, EvaluateAndCheckpoint) {
+		MapElites::Config config(3, 2, 0, 8, 20, 0.2, 5);
+		MapElites archive(config);
+		EXPECT_EQ(8, archive.getCellCount());
+		EchoEvaluator evaluator(archive);
+		archive.evaluate(200, evaluator, 4);
+		EXPECT_EQ(200, archive.getEvaluationCount());
+		EXPECT_LT(4, archive.getFilledCount());
+
+		vector<double> best;
+		double fitness = 0.0;
+		ASSERT_TRUE(archive.getBest(best, fitness));
+		EXPECT_EQ(best[2], fitness);
+
+		const string path = "MapElites_test.bin";
+		archive.saveCheckpoint(path);
+		MapElites resumed(config);
+		ASSERT_TRUE(resumed.loadCheckpoint(path));
+		EXPECT_EQ(archive.getFilledCount(), resumed.getFilledCount());
+		vector<double> resumedBest;
+		double resumedFitness = 0.0;
+		ASSERT_TRUE(resumed.getBest(resumedBest, resumedFitness));
+		EXPECT_EQ(best, resumedBest);
+
+		// Another layout
+		MapElites other(MapElites::Config(3, 2, 4));
+		EXPECT_FALSE(other.loadCheckpoint(path));
+		remove(path.c_str());
+	}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,123 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file tgCableMatcher_test.cpp
+* @brief Contains a test of tgCableMatcher
+* $Id$
+*/
+
+// This application
+#include "tgcreator/tgCableMatcher.h"
+// The Bullet Physics Library
+#include "LinearMath/btVector3.h"
+// The C++ Standard Library
+#include <cstdlib>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+// Google Test
+#include "gtest/gtest.h"
+
+
+using namespace std;
+
+namespace {
+
+	// A 10 x 10 x 10 lattice of unit spacing, with a cable along x
+	// between each pair of neighbours
+	class tgCableMatcherTest : public ::testing::Test {
+		protected:
+			tgCableMatcherTest()
+			{
+				for (int x = 0; x < 10; x++)
+				{
+					for (int y = 0; y < 10; y++)
+					{
+						for (int z = 0; z < 10; z++)
+						{
+							nodes.push_back(btVector3(x, y, z));
+						}
+					}
+				}
+				for (int i = 0; i + 100 < 1000; i++)
+				{
+					cables.push_back(make_pair(i, i + 100));
+				}
+			}
+
+			vector<btVector3> nodes;
+			vector<pair<int, int> > cables;
+	};
+
+	TEST_F(tgCableMatcherTest, FindsNearestNode) {
+				tgCableMatcher matcher(nodes, cables);
+				srand(1);
+				for (int k = 0; k < 200; k++)
+				{
+					// Inside the lattice and well outside it
+					const btVector3 p(rand() % 1400 / 100.0 - 2.0,
+										rand() % 1400 / 100.0 - 2.0,
+										rand() % 1400 / 100.0 - 2.0);
+					int expected = 0;
+					for (size_t i = 1; i < nodes.size(); i++)
+					{
+						if (p.distance(nodes[i]) < p.distance(nodes[expected]))
+						{
+							expected = i;
+						}
+					}
+					EXPECT_DOUBLE_EQ(p.distance(nodes[expected]),
+										p.distance(nodes[matcher.nearestNode(p)]));
+				}
+	}
+
+	// Anchors off the nodes, in either order, find their cable once
+	TEST_F(tgCableMatcherTest, MatchesEachCableOnce) {
+				tgCableMatcher matcher(nodes, cables);
+				const btVector3 offset(0.1, -0.2, 0.1);
+				EXPECT_EQ(5, matcher.match(nodes[105] + offset, nodes[5] - offset));
+				EXPECT_EQ(6, matcher.match(nodes[6], nodes[106]));
+				EXPECT_THROW(matcher.match(nodes[5], nodes[105]), std::runtime_error);
+
+				// No cable along y
+				EXPECT_EQ(-1, matcher.match(nodes[0], nodes[10]));
+	}
+
+	TEST_F(tgCableMatcherTest, HandsOutParallelCablesInOrder) {
+				cables.push_back(make_pair(105, 5));
+				tgCableMatcher matcher(nodes, cables);
+				EXPECT_EQ(5, matcher.match(nodes[5], nodes[105]));
+				EXPECT_EQ(900, matcher.match(nodes[5], nodes[105]));
+				EXPECT_THROW(matcher.match(nodes[5], nodes[105]), std::runtime_error);
+	}
+
+	TEST_F(tgCableMatcherTest, RejectsBadCables) {
+				cables.push_back(make_pair(0, 1000));
+				EXPECT_THROW(tgCableMatcher(nodes, cables), std::invalid_argument);
+				EXPECT_EQ(-1, tgCableMatcher(vector<btVector3>(),
+												vector<pair<int, int> >())
+								.nearestNode(btVector3(0, 0, 0)));
+	}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,117 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file tgFormFinder_test.cpp
+* @brief Contains a test of the tgFormFinder equilibrium solver
+* $Id$
+*/
+
+// This application
+#include "core/tgBasicActuator.h"
+#include "core/tgRod.h"
+#include "tgcreator/tgBasicActuatorInfo.h"
+#include "tgcreator/tgBuildSpec.h"
+#include "tgcreator/tgFormFinder.h"
+#include "tgcreator/tgRodInfo.h"
+#include "tgcreator/tgStructure.h"
+// The Bullet Physics Library
+#include "LinearMath/btVector3.h"
+// The C++ Standard Library
+#include <stdexcept>
+// Google Test
+#include "gtest/gtest.h"
+
+
+using namespace std;
+
+namespace {
+
+	// Two crossed rods, 1 apart along z, joined by a loop of four cables
+	void buildCross(tgStructure& s)
+	{
+				s.addNode(-5, 0, 0);
+				s.addNode(5, 0, 0);
+				s.addNode(0, -5, 1);
+				s.addNode(0, 5, 1);
+				s.addPair(0, 1, "rod");
+				s.addPair(2, 3, "rod");
+				s.addPair(0, 2, "cable");
+				s.addPair(2, 1, "cable");
+				s.addPair(1, 3, "cable");
+				s.addPair(3, 0, "cable");
+	}
+
+	TEST(tgFormFinderTest, testCrossPullsFlat) {
+				tgStructure s;
+				buildCross(s);
+				tgBuildSpec spec;
+				spec.addBuilder("rod", new tgRodInfo(tgRod::Config()));
+				spec.addBuilder("cable",
+					new tgBasicActuatorInfo(tgBasicActuator::Config(1000, 10, 100)));
+
+				tgFormFinder finder(s, spec, tgFormFinder::Config(0.0, false));
+				EXPECT_EQ(4, finder.getNodeCount());
+				EXPECT_TRUE(finder.solve());
+
+				// The rods end up coplanar and square, still 10 long
+				const btVector3 a = finder.getSettledPosition(btVector3(-5, 0, 0));
+				const btVector3 b = finder.getSettledPosition(btVector3(5, 0, 0));
+				const btVector3 c = finder.getSettledPosition(btVector3(0, -5, 1));
+				EXPECT_NEAR(10.0, a.distance(b), 1.0e-4);
+				EXPECT_NEAR(a.z(), c.z(), 1.0e-3);
+				EXPECT_NEAR(50.0, a.distance2(c), 1.0e-2);
+
+				finder.apply(s);
+				EXPECT_EQ(a, s.getNodes()[0]);
+				EXPECT_EQ(c, s.getPairs()[1].getFrom());
+	}
+
+	TEST(tgFormFinderTest, testRodFallsToGround) {
+				tgStructure s;
+				s.addNode(0, 5, 0);
+				s.addNode(0, 5, 10);
+				s.addPair(0, 1, "rod");
+				tgBuildSpec spec;
+				spec.addBuilder("rod", new tgRodInfo(tgRod::Config()));
+
+				tgFormFinder finder(s, spec);
+				EXPECT_TRUE(finder.solve());
+				EXPECT_EQ(btVector3(0, 0, 0),
+					finder.getSettledPosition(btVector3(0, 5, 0)));
+				EXPECT_EQ(btVector3(0, 0, 10),
+					finder.getSettledPosition(btVector3(0, 5, 10)));
+	}
+
+	TEST(tgFormFinderTest, testExcessPretensionThrows) {
+				tgStructure s;
+				buildCross(s);
+				tgBuildSpec spec;
+				spec.addBuilder("rod", new tgRodInfo(tgRod::Config()));
+				spec.addBuilder("cable",
+					new tgBasicActuatorInfo(tgBasicActuator::Config(1, 10, 100)));
+
+				EXPECT_THROW(tgFormFinder finder(s, spec), std::invalid_argument);
+	}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
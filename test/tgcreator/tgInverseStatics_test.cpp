@@ -0,0 +1,135 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file tgInverseStatics_test.cpp
+* @brief Contains a test of the tgInverseStatics rest length solver
+* $Id$
+*/
+
+// This application
+#include "core/tgBasicActuator.h"
+#include "core/tgRod.h"
+#include "tgcreator/tgBasicActuatorInfo.h"
+#include "tgcreator/tgBuildSpec.h"
+#include "tgcreator/tgInverseStatics.h"
+#include "tgcreator/tgRodInfo.h"
+#include "tgcreator/tgStructure.h"
+// The Bullet Physics Library
+#include "LinearMath/btVector3.h"
+// The C++ Standard Library
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+// Google Test
+#include "gtest/gtest.h"
+
+
+using namespace std;
+
+namespace {
+
+	// Two crossed rods in a plane, joined by a square of four cables
+	void buildFlatCross(tgStructure& s)
+	{
+				s.addNode(-5, 0, 0);
+				s.addNode(5, 0, 0);
+				s.addNode(0, -5, 0);
+				s.addNode(0, 5, 0);
+				s.addPair(0, 1, "rod");
+				s.addPair(2, 3, "rod");
+				s.addPair(0, 2, "cable");
+				s.addPair(2, 1, "cable");
+				s.addPair(1, 3, "cable");
+				s.addPair(3, 0, "cable");
+	}
+
+	void addBuilders(tgBuildSpec& spec)
+	{
+				spec.addBuilder("rod", new tgRodInfo(tgRod::Config()));
+				spec.addBuilder("cable",
+					new tgBasicActuatorInfo(tgBasicActuator::Config(1000, 10, 100)));
+	}
+
+	// The square's only state of self-stress has equal tensions, so the
+	// closest to the targets is their mean
+	TEST(tgInverseStaticsTest, testCrossTakesMeanTension) {
+				tgStructure s;
+				buildFlatCross(s);
+				tgBuildSpec spec;
+				addBuilders(spec);
+
+				tgInverseStatics statics(s, spec,
+					tgInverseStatics::Config(0.0, false));
+				ASSERT_EQ(4, statics.getCableCount());
+				vector<double> targets(4, 100.0);
+				targets[1] = 200.0;
+				targets[3] = 200.0;
+				statics.setTargetTensions(targets);
+
+				EXPECT_TRUE(statics.solve());
+				const double length = sqrt(50.0);
+				for (size_t i = 0; i < 4; i++)
+				{
+					EXPECT_NEAR(150.0, statics.getTensions()[i], 1.0e-3);
+					EXPECT_NEAR(length - 0.15, statics.getRestLengths()[i], 1.0e-6);
+				}
+				EXPECT_THROW(statics.setTargetTensions(vector<double>(3)),
+								std::invalid_argument);
+	}
+
+	TEST(tgInverseStaticsTest, testConflictingLimitsFail) {
+				tgStructure s;
+				buildFlatCross(s);
+				tgBuildSpec spec;
+				addBuilders(spec);
+
+				tgInverseStatics statics(s, spec,
+					tgInverseStatics::Config(0.0, false));
+				statics.setTensionLimits(0, 0.0, 50.0);
+				statics.setTensionLimits(1, 100.0, 1000.0);
+				EXPECT_FALSE(statics.solve());
+				EXPECT_LE(statics.getTensions()[0], 50.0);
+				EXPECT_GE(statics.getTensions()[1], 100.0);
+				EXPECT_GT(statics.getResidual(), 1.0);
+	}
+
+	TEST(tgInverseStaticsTest, testGroundCarriesRod) {
+				tgStructure s;
+				s.addNode(0, 0, 0);
+				s.addNode(0, 0, 10);
+				s.addPair(0, 1, "rod");
+				tgBuildSpec spec;
+				addBuilders(spec);
+
+				tgInverseStatics statics(s, spec);
+				EXPECT_EQ(0, statics.getCableCount());
+				EXPECT_TRUE(statics.solve());
+
+				// Without the ground, nothing holds it up
+				tgInverseStatics falling(s, spec,
+					tgInverseStatics::Config(9.81, false));
+				EXPECT_FALSE(falling.solve());
+	}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,144 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file tgPairs_test.cpp
+* @brief Contains a test of the uniqueness index in tgNodes and tgPairs
+* $Id$
+*/
+
+// This application
+#include "tgcreator/tgNodes.h"
+#include "tgcreator/tgPairs.h"
+// The Bullet Physics Library
+#include "LinearMath/btVector3.h"
+// The C++ Standard Library
+#include <stdexcept>
+// Google Test
+#include "gtest/gtest.h"
+
+
+using namespace std;
+
+namespace {
+
+	TEST(tgPairsTest, testNodesAreUnique) {
+				tgNodes nodes;
+				EXPECT_EQ(0, nodes.addNode(0, 0, 0));
+				EXPECT_EQ(1, nodes.addNode(1, 2, 3));
+				
+				// Same position as an existing node, even with other tags
+				EXPECT_THROW(nodes.addNode(1, 2, 3, "other"), std::logic_error);
+				EXPECT_THROW(nodes.addNode(-0.0, 0, 0), std::logic_error);
+				EXPECT_EQ(2, nodes.size());
+	}
+
+	TEST(tgPairsTest, testNodeIndexFollowsMoves) {
+				tgNodes nodes;
+				nodes.addNode(0, 0, 0);
+				nodes.addNode(1, 0, 0);
+				nodes.move(btVector3(1, 0, 0));
+				
+				// (1, 0, 0) is now node 0; (0, 0, 0) is free again
+				EXPECT_THROW(nodes.addNode(1, 0, 0), std::logic_error);
+				EXPECT_EQ(2, nodes.addNode(0, 0, 0));
+	}
+
+	TEST(tgPairsTest, testNodeIndexFollowsAccessors) {
+				tgNodes nodes;
+				nodes.addNode(0, 0, 0);
+				nodes.addNode(1, 0, 0);
+				nodes[0] += btVector3(0, 5, 0);
+				nodes.setNode(1, btVector3(0, 7, 0));
+				
+				EXPECT_THROW(nodes.addNode(0, 5, 0), std::logic_error);
+				EXPECT_THROW(nodes.addNode(0, 7, 0), std::logic_error);
+				EXPECT_THROW(nodes.setNode(0, btVector3(0, 7, 0)), std::logic_error);
+				EXPECT_EQ(2, nodes.addNode(0, 0, 0));
+				EXPECT_EQ(3, nodes.addNode(1, 0, 0));
+	}
+
+	TEST(tgPairsTest, testRemoveRenumbersIndex) {
+				const btVector3 a(0, 0, 0);
+				const btVector3 b(0, 1, 0);
+				const btVector3 c(0, 2, 0);
+				const btVector3 d(0, 3, 0);
+				tgPairs pairs;
+				pairs.addPair(tgPair(a, b));
+				pairs.addPair(tgPair(b, c));
+				pairs.addPair(tgPair(c, d));
+				pairs.removePair(tgPair(a, b));
+				
+				// The pairs after it moved down a key
+				pairs.removePair(tgPair(d, c));
+				EXPECT_EQ(1, pairs.size());
+				EXPECT_TRUE(pairs.contains(tgPair(c, b)));
+				EXPECT_THROW(pairs.addPair(tgPair(b, c)), std::logic_error);
+				EXPECT_EQ(1, pairs.addPair(tgPair(a, b)));
+	}
+
+	TEST(tgPairsTest, testPairsAreUniqueBothWays) {
+				const btVector3 a(0, 0, 0);
+				const btVector3 b(0, 1, 0);
+				const btVector3 c(0, 2, 0);
+				tgPairs pairs;
+				EXPECT_EQ(0, pairs.addPair(tgPair(a, b)));
+				EXPECT_EQ(1, pairs.addPair(tgPair(b, c)));
+				EXPECT_THROW(pairs.addPair(tgPair(a, b)), std::logic_error);
+				EXPECT_THROW(pairs.addPair(tgPair(b, a)), std::logic_error);
+				
+				EXPECT_TRUE(pairs.contains(tgPair(c, b)));
+				pairs.removePair(tgPair(c, b));
+				EXPECT_FALSE(pairs.contains(tgPair(b, c)));
+				EXPECT_EQ(1, pairs.size());
+				EXPECT_EQ(1, pairs.addPair(tgPair(c, b)));
+	}
+
+	TEST(tgPairsTest, testManyNodes) {
+				// Would take minutes with a linear uniqueness scan
+				tgNodes nodes;
+				const int n = 50;
+				for (int i = 0; i < n; i++) {
+					for (int j = 0; j < n; j++) {
+						for (int k = 0; k < n; k++) {
+							nodes.addNode(i, j, k);
+						}
+					}
+				}
+				EXPECT_EQ(n * n * n, nodes.size());
+				EXPECT_THROW(nodes.addNode(n - 1, n - 1, n - 1), std::logic_error);
+	}
+
+	TEST(tgPairsTest, testAccessWhileBuilding) {
+				// Would rebuild the index on every add if each access did
+				tgNodes nodes;
+				const int n = 100000;
+				for (int i = 0; i < n; i++) {
+					nodes.addNode(i, 0, 0);
+					nodes[i / 2].addTags("seen");
+				}
+				EXPECT_EQ(n, nodes.size());
+				EXPECT_THROW(nodes.addNode(n - 1, 0, 0), std::logic_error);
+	}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
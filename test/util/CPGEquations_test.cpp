@@ -33,6 +33,7 @@
 // The C++ Standard Library
 #include <iostream>
 #include <fstream>
+#include <stdexcept>
 // Google Test
 #include "gtest/gtest.h"
 
@@ -172,6 +173,31 @@ namespace {
             delete m_pCPGSystem2;
 	}
 
+	TEST_F(CPGEquationsTest, testStateArrays) {
+            
+            int numNodes = 3;
+            CPGEquations* m_pCPGSystem = getCPGSystem(numNodes);
+            
+            EXPECT_EQ(numNodes, m_pCPGSystem->getNodeCount());
+            EXPECT_EQ(numNodes, m_pCPGSystem->getOutputs().size());
+            EXPECT_EQ(0, m_pCPGSystem->getUpdateCount());
+            EXPECT_THROW((*m_pCPGSystem)[numNodes], std::invalid_argument);
+            
+            std::vector<double> desComs (numNodes, 0.0);
+            m_pCPGSystem->update(desComs, 0.5);
+            EXPECT_EQ(1, m_pCPGSystem->getUpdateCount());
+            
+            for (int i = 0; i < numNodes; i++)
+            {
+                const double phi = m_pCPGSystem->getPhases()[i];
+                const double r = m_pCPGSystem->getAmplitudes()[i];
+                EXPECT_EQ((*m_pCPGSystem)[i], m_pCPGSystem->getOutputs()[i]);
+                EXPECT_NEAR(r * cos(phi), m_pCPGSystem->getOutputs()[i], 1.0e-12);
+            }
+            
+            delete m_pCPGSystem;
+	}
+
 } // namespace
 
 int main(int argc, char **argv) {
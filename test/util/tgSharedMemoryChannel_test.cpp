@@ -0,0 +1,222 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file tgSharedMemoryChannel_test.cpp
+* @brief Contains tests of tgSharedMemoryChannel
+* $Id$
+*/
+
+
+// This application
+#include "util/tgSharedMemoryChannel.h"
+// The C++ Standard Library
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+// POSIX
+#include <fcntl.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+// Google Test
+#include "gtest/gtest.h"
+
+
+using namespace std;
+
+namespace {
+
+	string channelName()
+	{
+		ostringstream name;
+		name << "/tgSharedMemoryChannel_test_" << getpid();
+		return name.str();
+	}
+
+	/**
+	 * Start a stand-in controller process that answers each state with
+	 * twice its first value, until the channel closes.
+	 * @return the pid; it exits with the number of states it answered
+	 */
+	pid_t startController(const string& name)
+	{
+		const pid_t pid = fork();
+		if (pid == 0)
+		{
+			int answered = 0;
+			try
+			{
+				tgSharedMemoryChannel channel(name);
+				vector<double> state;
+				vector<double> command(channel.getCommandSize(), 0.0);
+				size_t cycle = 0;
+				while (channel.waitForState(cycle, 5.0, state, cycle))
+				{
+					command[0] = 2.0 * state[0];
+					channel.publishCommand(cycle, command);
+					answered++;
+				}
+			}
+			catch (...)
+			{
+				_exit(255);
+			}
+			_exit(answered);
+		}
+		return pid;
+	}
+
+	int exitStatus(pid_t pid)
+	{
+		int status = 0;
+		waitpid(pid, &status, 0);
+		return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+	}
+
+} // namespace
+
+TEST(tgSharedMemoryChannelTest, LockStep)
+{
+	const string name = channelName();
+	int answered = 0;
+	pid_t pid = 0;
+	{
+		tgSharedMemoryChannel channel(name, 3, 2);
+		pid = startController(name);
+
+		vector<double> state(3, 0.0);
+		vector<double> command;
+		for (size_t cycle = 1; cycle <= 100; cycle++)
+		{
+			state[0] = cycle;
+			channel.publishState(cycle, state);
+			size_t reply = 0;
+			ASSERT_TRUE(channel.waitForCommand(cycle, 5.0, command, reply));
+			EXPECT_EQ(cycle, reply);
+			ASSERT_EQ(2u, command.size());
+			EXPECT_EQ(2.0 * cycle, command[0]);
+		}
+		// Destroying the channel closes it, which stops the controller
+	}
+	answered = exitStatus(pid);
+	EXPECT_EQ(100, answered);
+}
+
+TEST(tgSharedMemoryChannelTest, FreeRunningAndAttach)
+{
+	const string name = channelName();
+	EXPECT_THROW(tgSharedMemoryChannel missing(name), runtime_error);
+	EXPECT_THROW(tgSharedMemoryChannel(name, 0, 1), invalid_argument);
+
+	tgSharedMemoryChannel simulator(name, 2, 1);
+	tgSharedMemoryChannel controller(name);
+	EXPECT_EQ(2u, controller.getStateSize());
+	EXPECT_EQ(1u, controller.getCommandSize());
+
+	// Nothing is published yet, and nothing waits forever
+	vector<double> values;
+	size_t cycle = 0;
+	EXPECT_FALSE(controller.readState(values, cycle));
+	EXPECT_FALSE(simulator.readCommand(values, cycle));
+	EXPECT_FALSE(simulator.waitForCommand(1, 0.01, values, cycle));
+
+	// Without waiting, a reader sees the newest state
+	vector<double> state(2, 0.0);
+	for (size_t i = 1; i <= 5; i++)
+	{
+		state[1] = i;
+		simulator.publishState(i, state);
+	}
+	ASSERT_TRUE(controller.readState(values, cycle));
+	EXPECT_EQ(5u, cycle);
+	EXPECT_EQ(5.0, values[1]);
+	EXPECT_THROW(simulator.publishState(6, vector<double>(3)), invalid_argument);
+
+	controller.publishCommand(4, vector<double>(1, 7.0));
+	ASSERT_TRUE(simulator.readCommand(values, cycle));
+	EXPECT_EQ(4u, cycle);
+	EXPECT_EQ(7.0, values[0]);
+
+	controller.close();
+	EXPECT_TRUE(simulator.isClosed());
+	EXPECT_FALSE(simulator.waitForCommand(5, 1.0, values, cycle));
+}
+
+TEST(tgSharedMemoryChannelTest, RefusesLiveChannel)
+{
+	const string name = channelName();
+	{
+		tgSharedMemoryChannel first(name, 1, 1);
+		EXPECT_THROW(tgSharedMemoryChannel second(name, 1, 1), runtime_error);
+		// The first is untouched
+		tgSharedMemoryChannel controller(name);
+		EXPECT_FALSE(controller.isClosed());
+	}
+	// Once the first is gone the name is free again
+	EXPECT_NO_THROW(tgSharedMemoryChannel again(name, 1, 1));
+}
+
+TEST(tgSharedMemoryChannelTest, ReplacesStaleChannel)
+{
+	const string name = channelName();
+
+	// A creator that dies without cleaning up leaves the segment behind
+	const pid_t pid = fork();
+	if (pid == 0)
+	{
+		new tgSharedMemoryChannel(name, 1, 1);
+		_exit(0);
+	}
+	ASSERT_EQ(0, exitStatus(pid));
+
+	tgSharedMemoryChannel channel(name, 2, 1);
+	EXPECT_EQ(2u, channel.getStateSize());
+}
+
+TEST(tgSharedMemoryChannelTest, TimesOutOnDeadWriter)
+{
+	const string name = channelName();
+	tgSharedMemoryChannel simulator(name, 1, 1);
+	tgSharedMemoryChannel controller(name);
+
+	// Leave the state slot as a writer that died mid-update would: the
+	// slot follows the 64 byte header, with the sequence first and the
+	// cycle 8 bytes in
+	const int fd = shm_open(name.c_str(), O_RDWR, 0);
+	ASSERT_GE(fd, 0);
+	char* const pBase = static_cast<char*>(
+		mmap(NULL, 128, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0));
+	close(fd);
+	ASSERT_TRUE(pBase != MAP_FAILED);
+	*reinterpret_cast<volatile uint64_t*>(pBase + 72) = 3;
+	*reinterpret_cast<volatile uint32_t*>(pBase + 64) = 1;
+
+	vector<double> values;
+	size_t cycle = 0;
+	EXPECT_FALSE(controller.waitForState(0, 0.05, values, cycle));
+	EXPECT_FALSE(controller.readState(values, cycle, 0.05));
+	munmap(pBase, 128);
+}
+
+int main(int argc, char **argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,154 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file tgSweepRunner_test.cpp
+* @brief Contains tests of tgParameterSpace and tgSweepRunner
+* $Id$
+*/
+
+// This application
+#include "util/tgParameterSpace.h"
+#include "util/tgSweepRunner.h"
+// The C++ Standard Library
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+// Google Test
+#include "gtest/gtest.h"
+
+
+using namespace std;
+
+namespace {
+
+	/** Scores the sum of the parameters; fails on odd indexes if asked */
+	class SumTrial : public tgSweepRunner::Trial
+	{
+	public:
+		SumTrial(bool failOdd) : m_failOdd(failOdd) { }
+
+		virtual double run(const vector<double>& parameters, size_t index)
+		{
+			if (m_failOdd && index % 2 == 1)
+			{
+				throw runtime_error("odd");
+			}
+			double sum = 0.0;
+			for (size_t i = 0; i < parameters.size(); i++)
+			{
+				sum += parameters[i];
+			}
+			return sum;
+		}
+
+	private:
+		const bool m_failOdd;
+	};
+
+	tgParameterSpace space()
+	{
+		tgParameterSpace s;
+		s.addDimension("stiffness", 1000.0, 2000.0, 3);
+		s.addDimension("friction", 0.0, 1.0, 2);
+		return s;
+	}
+
+	TEST(tgParameterSpaceTest, Grid) {
+		const vector<vector<double> > points = space().sample(tgParameterSpace::eGrid);
+		ASSERT_EQ(6, points.size());
+		EXPECT_EQ(1000.0, points[0][0]);
+		EXPECT_EQ(0.0, points[0][1]);
+		EXPECT_EQ(1.0, points[1][1]);
+		EXPECT_EQ(1500.0, points[2][0]);
+		EXPECT_EQ(2000.0, points[5][0]);
+
+		EXPECT_THROW(tgParameterSpace().addDimension("x", 1.0, 0.0), invalid_argument);
+	}
+
+	TEST(tgParameterSpaceTest, LatinHypercube) {
+		const size_t n = 10;
+		const vector<vector<double> > points =
+			space().sample(tgParameterSpace::eLatinHypercube, n, 7);
+		ASSERT_EQ(n, points.size());
+
+		// One point in each tenth of each dimension
+		vector<int> stiffness(n, 0);
+		vector<int> friction(n, 0);
+		for (size_t i = 0; i < n; i++)
+		{
+			stiffness[static_cast<size_t>((points[i][0] - 1000.0) / 100.0)]++;
+			friction[static_cast<size_t>(points[i][1] * 10.0)]++;
+		}
+		for (size_t i = 0; i < n; i++)
+		{
+			EXPECT_EQ(1, stiffness[i]);
+			EXPECT_EQ(1, friction[i]);
+		}
+
+		// Seeded
+		EXPECT_EQ(points, space().sample(tgParameterSpace::eLatinHypercube, n, 7));
+		EXPECT_NE(points, space().sample(tgParameterSpace::eLatinHypercube, n, 8));
+	}
+
+	TEST(tgSweepRunnerTest, Statistics) {
+		const vector<vector<double> > points = space().sample(tgParameterSpace::eGrid);
+		SumTrial trial(false);
+		tgSweepRunner runner(4);
+		ostringstream out;
+		const tgSweepRunner::Statistics stats =
+			runner.run(points, trial, &out, space().getNames());
+
+		EXPECT_EQ(6, stats.getCount());
+		EXPECT_EQ(0, stats.getFailureCount());
+		EXPECT_DOUBLE_EQ(1500.5, stats.getMean());
+		EXPECT_DOUBLE_EQ(1000.0, stats.getMin());
+		EXPECT_DOUBLE_EQ(2001.0, stats.getMax());
+		EXPECT_NEAR(200000.3, stats.getVariance(), 1.0e-6);
+
+		// A header and a line per trial
+		istringstream lines(out.str());
+		string line;
+		getline(lines, line);
+		EXPECT_EQ("index,stiffness,friction,score,error", line);
+		int count = 0;
+		while (getline(lines, line))
+		{
+			count++;
+		}
+		EXPECT_EQ(6, count);
+	}
+
+	TEST(tgSweepRunnerTest, Failures) {
+		const vector<vector<double> > points = space().sample(tgParameterSpace::eGrid);
+		SumTrial trial(true);
+		tgSweepRunner runner(3);
+		const tgSweepRunner::Statistics stats = runner.run(points, trial);
+
+		EXPECT_EQ(3, stats.getCount());
+		EXPECT_EQ(3, stats.getFailureCount());
+	}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,180 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file tgTrialCoordinator_test.cpp
+* @brief Contains tests of tgTrialCoordinator and tgTrialWorker
+* $Id$
+*/
+
+
+// This application
+#include "util/tgTrialCoordinator.h"
+#include "util/tgTrialWorker.h"
+// The C++ Standard Library
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+// POSIX
+#include <sys/wait.h>
+#include <unistd.h>
+// Google Test
+#include "gtest/gtest.h"
+
+
+using namespace std;
+
+namespace {
+
+	/** Scores the sum of the parameters; fails on index 3 */
+	class SumTrial : public tgSweepRunner::Trial
+	{
+	public:
+		SumTrial(bool crash = false) : m_crash(crash) { }
+
+		virtual double run(const vector<double>& parameters, size_t index)
+		{
+			if (m_crash)
+			{
+				// A machine that goes away mid batch
+				_exit(3);
+			}
+			if (index == 3)
+			{
+				throw runtime_error("three\nlines");
+			}
+			return parameters[0] + parameters[1];
+		}
+
+	private:
+		const bool m_crash;
+	};
+
+	/** Start a worker process; it exits when the coordinator is done. */
+	pid_t startWorker(unsigned short port, bool crash = false)
+	{
+		const pid_t pid = fork();
+		if (pid == 0)
+		{
+			int status = 1;
+			try
+			{
+				SumTrial trial(crash);
+				tgTrialWorker worker("localhost", port, 1);
+				worker.run(trial);
+				status = 0;
+			}
+			catch (...)
+			{
+			}
+			_exit(status);
+		}
+		return pid;
+	}
+
+	int exitStatus(pid_t pid)
+	{
+		int status = -1;
+		waitpid(pid, &status, 0);
+		return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+	}
+
+	vector<vector<double> > points(size_t n)
+	{
+		vector<vector<double> > p(n, vector<double>(2));
+		for (size_t i = 0; i < n; i++)
+		{
+			p[i][0] = i;
+			p[i][1] = 0.25;
+		}
+		return p;
+	}
+
+	TEST(tgTrialCoordinatorTest, SeveralWorkers) {
+		vector<pid_t> workers;
+		{
+			tgTrialCoordinator coordinator(tgTrialCoordinator::Config(0, 3));
+			ASSERT_NE(0, coordinator.getPort());
+			for (int i = 0; i < 3; i++)
+			{
+				workers.push_back(startWorker(coordinator.getPort()));
+			}
+
+			// Two generations on the same workers
+			for (int generation = 0; generation < 2; generation++)
+			{
+				vector<tgTrialCoordinator::Result> results;
+				ostringstream out;
+				const tgSweepRunner::Statistics stats =
+					coordinator.run(points(20), &results, &out);
+				ASSERT_EQ(20, results.size());
+				EXPECT_EQ(19, stats.getCount());
+				EXPECT_EQ(1, stats.getFailureCount());
+				for (size_t i = 0; i < results.size(); i++)
+				{
+					EXPECT_TRUE(results[i].done);
+					EXPECT_EQ(i == 3, results[i].failed);
+					if (i != 3)
+					{
+						EXPECT_EQ(i + 0.25, results[i].score);
+					}
+				}
+				EXPECT_EQ("three lines", results[3].error);
+				EXPECT_EQ(0, out.str().find("index,p0,p1,score,error\n"));
+			}
+		}
+		for (size_t i = 0; i < workers.size(); i++)
+		{
+			EXPECT_EQ(0, exitStatus(workers[i]));
+		}
+	}
+
+	TEST(tgTrialCoordinatorTest, LostWorker) {
+		pid_t crasher;
+		pid_t worker;
+		{
+			tgTrialCoordinator coordinator(tgTrialCoordinator::Config(0, 4));
+			// The crasher connects first, so it gets the first batch
+			crasher = startWorker(coordinator.getPort(), true);
+			usleep(200000);
+			worker = startWorker(coordinator.getPort());
+
+			vector<tgTrialCoordinator::Result> results;
+			const tgSweepRunner::Statistics stats =
+				coordinator.run(points(10), &results);
+			EXPECT_EQ(9, stats.getCount());
+			EXPECT_EQ(1, stats.getFailureCount());
+			EXPECT_EQ(1, coordinator.getWorkerCount());
+
+			// Unless the other worker raced them first
+			EXPECT_GE(4, coordinator.getRequeueCount());
+		}
+		EXPECT_EQ(3, exitStatus(crasher));
+		EXPECT_EQ(0, exitStatus(worker));
+
+		EXPECT_THROW(tgTrialCoordinator::Config(0, 0), invalid_argument);
+		EXPECT_THROW(tgTrialWorker("localhost", 1), runtime_error);
+	}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,119 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file CableProximity_test.cpp
+* @brief Checks tgCableProximity's segment distances, and its pairs in a
+* contact cable simulation
+* $Id$
+*/
+
+// This application
+#include "examples/contactCables/ContactCableDemo.h"
+// This library
+#include "core/terrain/tgEmptyGround.h"
+#include "core/tgCableProximity.h"
+#include "core/tgSimView.h"
+#include "core/tgSimulation.h"
+#include "core/tgWorld.h"
+
+#include "LinearMath/btVector3.h"
+
+// The C++ Standard Library
+#include <vector>
+// Google Test
+#include "gtest/gtest.h"
+
+
+using namespace std;
+
+namespace {
+
+	TEST(CableProximityTest, FindsNearestPoints) {
+		double s = 0.0;
+		double t = 0.0;
+
+		// Skew segments crossing above each other
+		EXPECT_NEAR(0.5, tgCableProximity::closestPoints(btVector3(-1.0, 0.0, 0.0),
+														btVector3(1.0, 0.0, 0.0),
+														btVector3(0.0, -1.0, 0.5),
+														btVector3(0.0, 3.0, 0.5),
+														s, t), 1e-12);
+		EXPECT_NEAR(0.5, s, 1e-12);
+		EXPECT_NEAR(0.25, t, 1e-12);
+
+		// Nearest at an end of each
+		EXPECT_NEAR(1.0, tgCableProximity::closestPoints(btVector3(0.0, 0.0, 0.0),
+														btVector3(1.0, 0.0, 0.0),
+														btVector3(2.0, 0.0, 0.0),
+														btVector3(3.0, 0.0, 0.0),
+														s, t), 1e-12);
+		EXPECT_DOUBLE_EQ(1.0, s);
+		EXPECT_DOUBLE_EQ(0.0, t);
+
+		// Parallel
+		EXPECT_NEAR(0.1, tgCableProximity::closestPoints(btVector3(0.0, 0.0, 0.0),
+														btVector3(1.0, 0.0, 0.0),
+														btVector3(0.5, 0.1, 0.0),
+														btVector3(1.5, 0.1, 0.0),
+														s, t), 1e-12);
+	}
+
+	TEST(CableProximityTest, RejectsBadConfig) {
+		EXPECT_THROW(tgCableProximity::Config(0.0), std::invalid_argument);
+		EXPECT_THROW(tgCableProximity::Config(0.01, -1.0), std::invalid_argument);
+		EXPECT_THROW(tgCableProximity::Config(0.01, 0.0, 0.5), std::invalid_argument);
+	}
+
+	// The pairs found through the tree are all within the margin, and
+	// fewer segment pairs are measured than checking them all would
+	TEST(CableProximityTest, ChecksContactCables) {
+		tgWorld world(tgWorld::Config(0.0), new tgEmptyGround());
+		tgSimView view(world, 1.0/1000.0, 1.0/60.0);
+		tgSimulation simulation(view);
+		simulation.addModel(new ContactCableDemo());
+		simulation.setStepPlanEnabled(true);
+		simulation.setCableProximity(tgCableProximity::Config(0.05, 0.0, 2.0, 2));
+
+		for (int i = 0; i < 500; i++)
+		{
+			simulation.step(1.0/1000.0);
+		}
+
+		const tgCableProximity* const pProximity = simulation.getCableProximity();
+		ASSERT_TRUE(pProximity != NULL);
+		const size_t n = pProximity->getSegmentCount();
+		ASSERT_GT(n, 0u);
+		EXPECT_LE(pProximity->getTestCount(), n * (n - 1) / 2);
+
+		const vector<tgCableProximity::Pair>& pairs = pProximity->getPairs();
+		for (size_t i = 0; i < pairs.size(); i++)
+		{
+			EXPECT_LT(pairs[i].cable1, pairs[i].cable2);
+			EXPECT_LT(pairs[i].distance, 0.05);
+			EXPECT_NEAR(pairs[i].distance,
+						pairs[i].point1.distance(pairs[i].point2), 1e-9);
+		}
+	}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
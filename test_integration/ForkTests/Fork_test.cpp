@@ -0,0 +1,200 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file Fork_test.cpp
+* @brief Checks that forked simulations start at the parent's state and
+* are independent of each other and of the threads that step them
+* $Id$
+*/
+
+// This application
+#include "examples/contactCables/ContactCableDemo.h"
+// This library
+#include "core/terrain/tgEmptyGround.h"
+#include "core/tgLinearizer.h"
+#include "core/tgModel.h"
+#include "core/tgSimView.h"
+#include "core/tgSimulation.h"
+#include "core/tgSimulationFork.h"
+#include "core/tgSimulationState.h"
+#include "core/tgWorld.h"
+// The C++ Standard Library
+#include <memory>
+#include <vector>
+// Google Test
+#include "gtest/gtest.h"
+
+
+using namespace std;
+
+namespace {
+
+	/** Builds the same gravity free contact cable model as the parent */
+	class ContactCableFactory : public tgSimulationFork::Factory
+	{
+	public:
+		virtual tgModel* createModel(size_t branch)
+		{
+			return new ContactCableDemo();
+		}
+
+		virtual tgGround* createGround()
+		{
+			return new tgEmptyGround();
+		}
+	};
+
+	/** The state of one branch */
+	vector<double> branchState(const tgSimulationFork& fork, size_t branch)
+	{
+		tgSimulationState state;
+		fork.getSimulation(branch).captureState(state);
+		return state.getData();
+	}
+
+	class ForkTest : public ::testing::Test {
+		protected:
+			ForkTest() :
+				world(tgWorld::Config(0.0), new tgEmptyGround()),
+				view(world, 1.0/1000.0, 1.0/60.0),
+				simulation(view)
+			{
+				simulation.addModel(new ContactCableDemo());
+				// Fork mid-trial
+				for (int i = 0; i < 500; i++)
+				{
+					simulation.step(1.0/1000.0);
+				}
+			}
+
+			tgWorld world;
+			tgSimView view;
+			tgSimulation simulation;
+			ContactCableFactory factory;
+	};
+
+	TEST_F(ForkTest, StartsAtParentState) {
+				auto_ptr<tgSimulationFork> fork(simulation.fork(3, factory));
+				ASSERT_EQ(3, fork->size());
+
+				tgSimulationState parent;
+				simulation.captureState(parent);
+				for (size_t i = 0; i < fork->size(); i++)
+				{
+					EXPECT_EQ(parent.getData(), branchState(*fork, i));
+				}
+	}
+
+	// Identical branches stepped on different threads stay identical,
+	// and a resync replays the same rollout
+	TEST_F(ForkTest, BranchesAreIndependentAndRepeatable) {
+				auto_ptr<tgSimulationFork> fork(simulation.fork(4, factory, 4));
+
+				fork->step(1.0/1000.0, 1000);
+				EXPECT_DOUBLE_EQ(1.0, fork->getTime());
+				const vector<double> first = branchState(*fork, 0);
+				for (size_t i = 1; i < fork->size(); i++)
+				{
+					EXPECT_EQ(first, branchState(*fork, i));
+				}
+
+				tgSimulationState parent;
+				simulation.captureState(parent);
+				fork->sync(parent);
+				EXPECT_EQ(0.0, fork->getTime());
+				fork->step(1.0/1000.0, 1000);
+				EXPECT_EQ(first, branchState(*fork, 2));
+	}
+
+	// Syncing moves the branches' own models rather than rebuilding them
+	TEST_F(ForkTest, SyncsInPlace) {
+				auto_ptr<tgSimulationFork> fork(simulation.fork(2, factory));
+				tgModel* const pModel = &fork->getModel(1);
+				fork->step(1.0/1000.0, 100);
+
+				tgSimulationState parent;
+				simulation.captureState(parent);
+				fork->sync(parent);
+				EXPECT_EQ(pModel, &fork->getModel(1));
+				EXPECT_EQ(parent.getData(), branchState(*fork, 1));
+	}
+
+	TEST_F(ForkTest, RejectsMismatchedState) {
+				auto_ptr<tgSimulationFork> fork(simulation.fork(2, factory));
+				const tgSimulationState empty;
+				EXPECT_THROW(fork->sync(empty), std::invalid_argument);
+				EXPECT_THROW(simulation.fork(0, factory), std::invalid_argument);
+	}
+
+	TEST_F(ForkTest, SyncsEachBranchToItsOwnState) {
+				auto_ptr<tgSimulationFork> fork(simulation.fork(2, factory));
+				vector<tgSimulationState> states(2);
+				simulation.captureState(states[0]);
+				simulation.step(1.0/1000.0);
+				simulation.captureState(states[1]);
+
+				fork->sync(states);
+				EXPECT_EQ(states[0].getData(), branchState(*fork, 0));
+				EXPECT_EQ(states[1].getData(), branchState(*fork, 1));
+				EXPECT_THROW(fork->sync(vector<tgSimulationState>(1, states[0])),
+								std::invalid_argument);
+	}
+
+	// Over one short step a position hardly depends on anything but
+	// itself, and central and forward differences agree
+	TEST_F(ForkTest, Linearizes) {
+				tgLinearizer central(tgLinearizer::Config(1.0/1000.0, 1, 1.0e-4,
+															1.0e-4, true, 4),
+										simulation, factory);
+				central.linearize();
+				const size_t n = central.getStateSize();
+				const size_t m = central.getInputSize();
+				tgSimulationState parent;
+				simulation.captureState(parent);
+				ASSERT_EQ(parent.getBodyCount() * tgLinearizer::bodyCoordinates, n);
+				ASSERT_EQ(parent.getCableCount(), m);
+				ASSERT_EQ(n * n, central.getA().size());
+				ASSERT_EQ(n * m, central.getB().size());
+				EXPECT_EQ(1 + 2 * (n + m), central.getRunCount());
+
+				for (size_t i = 0; i < n; i += tgLinearizer::bodyCoordinates)
+				{
+					for (size_t k = 0; k < 3; k++)
+					{
+						EXPECT_NEAR(1.0, central.getA()[(i + k) * n + i + k], 1.0e-2);
+					}
+				}
+
+				tgLinearizer forward(tgLinearizer::Config(1.0/1000.0, 1, 1.0e-4,
+															1.0e-4, false, 4),
+										simulation, factory);
+				forward.linearize();
+				EXPECT_EQ(1 + n + m, forward.getRunCount());
+				for (size_t i = 0; i < n * n; i++)
+				{
+					EXPECT_NEAR(central.getA()[i], forward.getA()[i], 1.0e-1);
+				}
+	}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,157 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file IslandSolver_test.cpp
+* @brief Checks that solving simulation islands on several threads gives
+* the same result as the usual serial solver
+* $Id$
+*/
+
+// This library
+#include "core/tgIslandParallelSolver.h"
+#include "core/tgModel.h"
+#include "core/tgRod.h"
+#include "core/tgSimView.h"
+#include "core/tgSimulation.h"
+#include "core/tgSimulationState.h"
+#include "core/tgWorld.h"
+#include "tgcreator/tgBuildSpec.h"
+#include "tgcreator/tgRodInfo.h"
+#include "tgcreator/tgStructure.h"
+#include "tgcreator/tgStructureInfo.h"
+// The C++ Standard Library
+#include <stdexcept>
+#include <vector>
+// Google Test
+#include "gtest/gtest.h"
+
+
+using namespace std;
+
+namespace {
+
+	const double dt = 1.0/1000.0;
+
+	/**
+	 * Stacks of two crossed rods dropped on the ground, far enough apart
+	 * that each stack is its own island
+	 */
+	class StacksModel : public tgModel
+	{
+	public:
+		StacksModel(int stacks) : m_stacks(stacks) { }
+
+		virtual void setup(tgWorld& world)
+		{
+			tgStructure s;
+			for (int i = 0; i < m_stacks; i++)
+			{
+				const double x = 5.0 * i;
+				// Tilt each a little differently so the islands differ
+				const double tilt = 0.05 * i;
+				s.addNode(x - 1.0, 0.5, 0.0);
+				s.addNode(x + 1.0, 0.5 + tilt, 0.0);
+				s.addNode(x, 1.0, -1.0);
+				s.addNode(x, 1.0 + tilt, 1.0);
+				s.addPair(4 * i, 4 * i + 1, "rod");
+				s.addPair(4 * i + 2, 4 * i + 3, "rod");
+			}
+
+			tgBuildSpec spec;
+			spec.addBuilder("rod", new tgRodInfo(tgRod::Config(0.2, 1.0)));
+
+			tgStructureInfo structureInfo(s, spec);
+			structureInfo.buildInto(*this, world);
+
+			tgModel::setup(world);
+		}
+
+	private:
+		const int m_stacks;
+	};
+
+	/** The state of the stacks after a second, solved on the given threads */
+	vector<double> settle(int solverThreads)
+	{
+		tgWorld world(tgWorld::Config(9.81, 1000, solverThreads));
+		tgSimView view(world, dt, 1.0/60.0);
+		tgSimulation simulation(view);
+		simulation.addModel(new StacksModel(6));
+		for (int i = 0; i < 1000; i++)
+		{
+			simulation.step(dt);
+		}
+		tgSimulationState state;
+		simulation.captureState(state);
+		EXPECT_EQ(12u, state.getBodyCount());
+		return state.getData();
+	}
+
+	// Islands share no dynamic bodies, so solving them apart and in any
+	// order changes nothing but rounding
+	TEST(IslandSolverTest, MatchesSerialSolver) {
+		if (!tgIslandParallelSolver::isParallel())
+		{
+			return;
+		}
+		const vector<double> serial = settle(1);
+		const vector<double> parallel = settle(4);
+		ASSERT_EQ(serial.size(), parallel.size());
+		for (size_t i = 0; i < serial.size(); i++)
+		{
+			EXPECT_NEAR(serial[i], parallel[i], 1e-9) << "at " << i;
+		}
+	}
+
+	// The result depends on the island layout, not on which thread
+	// solved an island or when
+	TEST(IslandSolverTest, IsRepeatable) {
+		if (!tgIslandParallelSolver::isParallel())
+		{
+			return;
+		}
+		EXPECT_EQ(settle(3), settle(3));
+		EXPECT_EQ(settle(2), settle(4));
+	}
+
+	// A profiled build would silently solve on one thread
+	TEST(IslandSolverTest, NeedsUnprofiledBuild) {
+		if (tgIslandParallelSolver::isParallel())
+		{
+			EXPECT_NO_THROW(tgWorld::Config(9.81, 1000, 2));
+		}
+		else
+		{
+			EXPECT_THROW(tgWorld::Config(9.81, 1000, 2),
+							std::invalid_argument);
+		}
+		EXPECT_NO_THROW(tgWorld::Config(9.81, 1000, 1));
+	}
+
+	TEST(IslandSolverTest, RejectsNoSolvers) {
+		EXPECT_THROW(tgIslandParallelSolver(vector<btConstraintSolver*>()),
+						std::invalid_argument);
+	}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,172 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file SamplingMPC_test.cpp
+* @brief Checks that tgSamplingMPC drives a single cable's rest length to
+* a target, with the costs evaluated on the fork's threads
+* $Id$
+*/
+
+// This library
+#include "controllers/tgSamplingMPC.h"
+#include "core/terrain/tgEmptyGround.h"
+#include "core/tgBasicActuator.h"
+#include "core/tgCast.h"
+#include "core/tgModel.h"
+#include "core/tgRod.h"
+#include "core/tgSimView.h"
+#include "core/tgSimulation.h"
+#include "core/tgWorld.h"
+#include "tgcreator/tgBasicActuatorInfo.h"
+#include "tgcreator/tgBuildSpec.h"
+#include "tgcreator/tgRodInfo.h"
+#include "tgcreator/tgStructure.h"
+#include "tgcreator/tgStructureInfo.h"
+// The C++ Standard Library
+#include <cmath>
+#include <vector>
+// Google Test
+#include "gtest/gtest.h"
+
+
+using namespace std;
+
+namespace {
+
+	const double dt = 1.0/1000.0;
+
+	/** A fixed rod and a free one, ten apart, joined by one cable */
+	class OneCableModel : public tgModel
+	{
+	public:
+		virtual void setup(tgWorld& world)
+		{
+			tgStructure s;
+			s.addNode(0.0, 0.0, 0.0);
+			s.addNode(0.0, 1.0, 0.0);
+			s.addNode(0.0, 11.0, 0.0);
+			s.addNode(0.0, 12.0, 0.0);
+			s.addPair(0, 1, "fixed");
+			s.addPair(2, 3, "free");
+			s.addPair(1, 2, "cable");
+
+			tgBuildSpec spec;
+			spec.addBuilder("fixed", new tgRodInfo(tgRod::Config(0.1, 0.0)));
+			spec.addBuilder("free", new tgRodInfo(tgRod::Config(0.1, 1.0)));
+			spec.addBuilder("cable", new tgBasicActuatorInfo(tgBasicActuator::Config(100.0, 1.0)));
+
+			tgStructureInfo structureInfo(s, spec);
+			structureInfo.buildInto(*this, world);
+
+			tgModel::setup(world);
+		}
+	};
+
+	class OneCableFactory : public tgSimulationFork::Factory
+	{
+	public:
+		virtual tgModel* createModel(size_t branch)
+		{
+			return new OneCableModel();
+		}
+
+		virtual tgGround* createGround()
+		{
+			return new tgEmptyGround();
+		}
+	};
+
+	/** Penalizes the squared distance of the rest length from a target */
+	class RestLengthMPC : public tgSamplingMPC
+	{
+	public:
+		RestLengthMPC(const Config& config,
+						tgSimulation& simulation,
+						tgSimulationFork::Factory& factory,
+						double target) :
+		tgSamplingMPC(config, simulation, factory),
+		m_target(target)
+		{
+		}
+
+	protected:
+		// Runs on the fork's threads, so it reads only the branch's model
+		virtual double stageCost(const tgModel& model, size_t knot) const
+		{
+			const vector<tgBasicActuator*> actuators =
+				tgCast::filter<tgModel, tgBasicActuator>(model.getDescendants());
+			const double error = actuators[0]->getRestLength() - m_target;
+			return error * error;
+		}
+
+	private:
+		const double m_target;
+	};
+
+	class SamplingMPCTest : public ::testing::Test {
+		protected:
+			SamplingMPCTest() :
+				world(tgWorld::Config(0.0), new tgEmptyGround()),
+				view(world, dt, 1.0/60.0),
+				simulation(view)
+			{
+				OneCableModel* const pModel = new OneCableModel();
+				simulation.addModel(pModel);
+				actuators = tgCast::filter<tgModel, tgBasicActuator>
+					(pModel->getDescendants());
+			}
+
+			/** Control and step for the given number of steps */
+			void run(RestLengthMPC& mpc, int steps)
+			{
+				for (int i = 0; i < steps; i++)
+				{
+					mpc.control(actuators, dt);
+					simulation.step(dt);
+				}
+			}
+
+			tgWorld world;
+			tgSimView view;
+			tgSimulation simulation;
+			OneCableFactory factory;
+			vector<tgBasicActuator*> actuators;
+	};
+
+	TEST_F(SamplingMPCTest, DrivesRestLengthToTarget) {
+				ASSERT_EQ(1u, actuators.size());
+				const double start = actuators[0]->getRestLength();
+				const double target = start - 3.0;
+
+				RestLengthMPC mpc(tgSamplingMPC::Config(16, 5, 10, 1.0, 0.0,
+														0.1, 20.0, 4),
+									simulation, factory, target);
+				run(mpc, 1000);
+
+				EXPECT_EQ(100u, mpc.getPlanCount());
+				EXPECT_NEAR(target, actuators[0]->getRestLength(), 0.5);
+				EXPECT_LT(mpc.getBestCost(), 5 * 0.5 * 0.5);
+	}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
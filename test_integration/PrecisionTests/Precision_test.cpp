@@ -0,0 +1,335 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file Precision_test.cpp
+* @brief Compares single precision runs of the integration scenarios
+* against double precision references
+* $Id$
+*
+* Built with double precision (the default), each test records its
+* trajectory and score in PRECISION_REFERENCE_DIR, under the NTRT build
+* directory, and checks that they read back exactly. Built with
+* USE_DOUBLE_PRECISION=OFF (see conf/bullet.conf), each test runs the
+* same scenario and compares, failing if there is no reference. A failed
+* expectation means single precision is not safe for that kind of run.
+*/
+
+// This application
+#include "examples/contactCables/ContactCableDemo.h"
+#include "examples/learningSpines/BaseSpineCPGControl.h"
+#include "examples/learningSpines/KinematicSpineCPGControl.h"
+#include "examples/learningSpines/TetrahedralComplex/FlemonsSpineModelLearning.h"
+#include "examples/motorModel/tsTestRig.h"
+// This library
+#include "core/terrain/tgEmptyGround.h"
+#include "core/tgBulletUtil.h"
+#include "core/tgCast.h"
+#include "core/tgModel.h"
+#include "core/tgSimView.h"
+#include "core/tgSimulation.h"
+#include "core/tgSpringCableActuator.h"
+#include "core/tgWorld.h"
+#include "helpers/FileHelpers.h"
+// The Bullet Physics Library
+#include "btBulletDynamicsCommon.h"
+// The C++ Standard Library
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+// POSIX
+#include <sys/stat.h>
+// Google Test
+#include "gtest/gtest.h"
+
+
+using namespace std;
+
+namespace {
+
+	/** A run to compare: samples of the state, and a final score */
+	struct Trajectory
+	{
+		vector<vector<double> > samples;
+		double score;
+	};
+
+	/** The positions of all dynamic bodies and the cable rest lengths */
+	vector<double> sample(const tgWorld& world, tgModel& model)
+	{
+		vector<double> state;
+		const btCollisionObjectArray& objects =
+			tgBulletUtil::worldToDynamicsWorld(world).getCollisionObjectArray();
+		for (int i = 0; i < objects.size(); i++)
+		{
+			const btRigidBody* const pBody = btRigidBody::upcast(objects[i]);
+			if (pBody != NULL && !pBody->isStaticOrKinematicObject())
+			{
+				const btVector3& p = pBody->getCenterOfMassPosition();
+				state.push_back(p.x());
+				state.push_back(p.y());
+				state.push_back(p.z());
+			}
+		}
+		const vector<tgSpringCableActuator*> cables =
+			tgCast::filter<tgModel, tgSpringCableActuator>(model.getDescendants());
+		for (size_t i = 0; i < cables.size(); i++)
+		{
+			state.push_back(cables[i]->getRestLength());
+		}
+		return state;
+	}
+
+	/** Run steps in blocks of every, sampling after each block */
+	void record(tgSimulation& simulation, const tgWorld& world,
+				tgModel& model, int steps, int every, Trajectory& result)
+	{
+		result.samples.push_back(sample(world, model));
+		for (int i = 0; i < steps; i += every)
+		{
+			simulation.run(every);
+			result.samples.push_back(sample(world, model));
+		}
+	}
+
+	string referencePath(const string& name)
+	{
+		return string(PRECISION_REFERENCE_DIR) + "/" + name + ".ref";
+	}
+
+	void writeReference(const string& name, const Trajectory& t)
+	{
+		mkdir(PRECISION_REFERENCE_DIR, 0755);
+		ofstream out(referencePath(name).c_str(), ios::trunc);
+		out << setprecision(17);
+		out << t.score << endl;
+		for (size_t i = 0; i < t.samples.size(); i++)
+		{
+			for (size_t j = 0; j < t.samples[i].size(); j++)
+			{
+				out << t.samples[i][j] << " ";
+			}
+			out << endl;
+		}
+		ASSERT_TRUE(out.good()) << "Could not write " << referencePath(name);
+	}
+
+	bool readReference(const string& name, Trajectory& t)
+	{
+		ifstream in(referencePath(name).c_str());
+		if (!(in >> t.score))
+		{
+			return false;
+		}
+		string line;
+		getline(in, line);
+		while (getline(in, line))
+		{
+			istringstream values(line);
+			vector<double> s;
+			double v;
+			while (values >> v)
+			{
+				s.push_back(v);
+			}
+			t.samples.push_back(s);
+		}
+		return true;
+	}
+
+	/**
+	 * Record the reference (double precision) or compare against it
+	 * (single precision).
+	 * @param[in] tolerance the largest acceptable deviation of any
+	 * sampled value, relative to the largest reference value
+	 * @param[in] horizon how many samples the tolerance holds for;
+	 * chaotic runs diverge eventually, and only their score can be held
+	 * after that
+	 * @param[in] scoreTolerance the largest acceptable relative change
+	 * of the score
+	 */
+	void check(const string& name, const Trajectory& run,
+			   double tolerance, size_t horizon, double scoreTolerance)
+	{
+#ifdef BT_USE_DOUBLE_PRECISION
+		writeReference(name, run);
+
+		// 17 digits must round trip, or the single build compares
+		// against something else
+		Trajectory written;
+		ASSERT_TRUE(readReference(name, written));
+		EXPECT_EQ(run.score, written.score);
+		EXPECT_EQ(run.samples, written.samples);
+#else
+		Trajectory reference;
+		if (!readReference(name, reference))
+		{
+			FAIL() << name << ": no double precision reference at "
+				   << referencePath(name)
+				   << "; run the double precision build first";
+		}
+		ASSERT_EQ(reference.samples.size(), run.samples.size());
+		horizon = min(horizon, reference.samples.size());
+
+		double scale = 0.0;
+		for (size_t i = 0; i < horizon; i++)
+		{
+			for (size_t j = 0; j < reference.samples[i].size(); j++)
+			{
+				scale = max(scale, fabs(reference.samples[i][j]));
+			}
+		}
+		scale = max(scale, 1.0e-12);
+
+		double worst = 0.0;
+		int diverged = -1;
+		for (size_t i = 0; i < horizon; i++)
+		{
+			ASSERT_EQ(reference.samples[i].size(), run.samples[i].size());
+			for (size_t j = 0; j < reference.samples[i].size(); j++)
+			{
+				const double d =
+					fabs(reference.samples[i][j] - run.samples[i][j]) / scale;
+				worst = max(worst, d);
+				if (d > tolerance && diverged < 0)
+				{
+					diverged = static_cast<int>(i);
+				}
+			}
+		}
+		const double scoreChange = fabs(run.score - reference.score) /
+			max(fabs(reference.score), 1.0e-12);
+
+		cout << name << ": worst relative deviation " << worst
+			 << ", first sample over tolerance " << diverged
+			 << " of " << horizon
+			 << ", score " << run.score << " vs " << reference.score
+			 << " (" << 100.0 * scoreChange << "%)" << endl;
+
+		EXPECT_LE(worst, tolerance);
+		EXPECT_LE(scoreChange, scoreTolerance);
+#endif
+	}
+
+	class PrecisionTest : public ::testing::Test {
+		protected:
+			PrecisionTest() {
+
+			}
+
+			virtual ~PrecisionTest() {
+
+			}
+	};
+
+	// Gravity free contact cables, which conserve momentum
+	TEST_F(PrecisionTest, ContactCables) {
+				const tgWorld::Config config(0.0); // gravity, cm/sec^2
+				tgEmptyGround* ground = new tgEmptyGround();
+				tgWorld world(config, ground);
+
+				const double stepSize = 1.0/1000.0; // Seconds
+				const double renderRate = 1.0/60.0; // Seconds
+				tgSimView view(world, stepSize, renderRate);
+				tgSimulation simulation(view);
+
+				ContactCableDemo* myModel = new ContactCableDemo();
+				simulation.addModel(myModel);
+
+				Trajectory run;
+				record(simulation, world, *myModel, 5000, 100, run);
+				run.score = myModel->getEnergy();
+
+				check("ContactCables", run, 1.0e-3, run.samples.size(), 1.0e-3);
+	}
+
+	// The motor test rig: a controlled actuator against the ground
+	TEST_F(PrecisionTest, KinematicMotor) {
+				const tgWorld::Config config(981); // gravity, dm/sec^2
+				tgWorld world(config);
+
+				const double stepSize = 1.0/1000.0; // Seconds
+				const double renderRate = 1.0/60.0; // Seconds
+				tgSimView view(world, stepSize, renderRate);
+				tgSimulation simulation(view);
+
+				tsTestRig* const myModel = new tsTestRig(true);
+				simulation.addModel(myModel);
+
+				Trajectory run;
+				record(simulation, world, *myModel, 1000, 50, run);
+				const std::vector<tgSpringCableActuator*>& muscles =
+					myModel->getAllMuscles();
+				ASSERT_EQ(1, muscles.size());
+				run.score = muscles[0]->getRestLength();
+
+				check("KinematicMotor", run, 1.0e-3, run.samples.size(), 1.0e-3);
+	}
+
+	// A learning workload: 15 seconds of CPG controlled spine with
+	// ground contact. Chaotic, so the trajectory is only held for the
+	// first three seconds; the score is held for the whole run.
+	TEST_F(PrecisionTest, SpineScore) {
+				std::string filePath = FileHelpers::getResourcePath("learningSpines/TetrahedralComplex/logs/scores.csv");
+				ofstream clearResults;
+				clearResults.open(filePath.c_str(), ios::trunc);
+				clearResults.close();
+
+				const tgWorld::Config config(981); // gravity, cm/sec^2
+				tgWorld world(config);
+
+				const double stepSize = 1.0/1000.0; // Seconds
+				const double renderRate = 1.0/60.0; // Seconds
+				tgSimView view(world, stepSize, renderRate);
+				tgSimulation simulation(view);
+
+				const int segments = 12;
+				FlemonsSpineModelLearning* myModel =
+				  new FlemonsSpineModelLearning(segments);
+
+				// As in WorldConf_Spines_test
+				BaseSpineCPGControl::Config control_config(3, 8, 8, 2, 6, .01,
+															-30.0, 30.0,
+															-1 * M_PI, M_PI,
+															0.0, 1000.0, 210.0,
+															true,
+															10.0, -30.0, 30.0);
+				KinematicSpineCPGControl* const myControl =
+				  new KinematicSpineCPGControl(control_config, "default", "learningSpines/TetrahedralComplex/");
+				myModel->attach(myControl);
+				simulation.addModel(myModel);
+
+				Trajectory run;
+				record(simulation, world, *myModel, 15000, 1000, run);
+				simulation.reset();
+				run.score = FileHelpers::getFinalScore(filePath);
+
+				check("SpineScore", run, 1.0e-2, 4, 5.0e-2);
+	}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,70 @@
+#!@PYTHON_EXECUTABLE@
+# Copyright (c) 2012, United States Government, as represented by the
+# Administrator of the National Aeronautics and Space Administration.
+# All rights reserved.
+#
+# The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+# under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+# http://www.apache.org/licenses/LICENSE-2.0.
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+# either express or implied. See the License for the specific language
+# governing permissions and limitations under the License.
+
+# Smoke test of the ntrt Python module. CMake fills in the paths below
+# and installs this as the executable ntrt_test, so runAllTests.py runs
+# it with the other integration tests.
+
+import sys
+sys.path.insert(0, "@NTRT_PYTHON_DIR@")
+
+import unittest
+import numpy
+import ntrt
+
+class TestSimulation(unittest.TestCase):
+
+    # Three rods and nine tgBasicActuator cables
+    PRISM = "@YAML_DIR@/BaseStructures/3Prism.yaml"
+
+    def setUp(self):
+        self.sim = ntrt.Simulation(self.PRISM)
+
+    def testShapes(self):
+        rodColumns = len(ntrt.Simulation.rod_columns)
+        cableColumns = len(ntrt.Simulation.cable_columns)
+        self.assertEqual(self.sim.rods.shape, (3, rodColumns))
+        self.assertEqual(self.sim.cables.shape, (9, cableColumns))
+        self.assertEqual(self.sim.actions.shape, (9,))
+        self.assertEqual(len(self.sim.cable_tags), 9)
+
+    def testStepRefreshesViews(self):
+        rods = self.sim.rods
+        cables = self.sim.cables
+        before = rods.copy()
+        self.sim.step(100)
+        self.assertAlmostEqual(self.sim.time, 100 * self.sim.step_size)
+        self.assertEqual(rods.shape, (3, len(ntrt.Simulation.rod_columns)))
+        self.assertFalse(numpy.array_equal(rods, before))
+        self.assertTrue(numpy.all(numpy.isfinite(rods)))
+        self.assertTrue(numpy.all(numpy.isfinite(cables)))
+
+    def testOnlyActionsAreWriteable(self):
+        self.assertTrue(self.sim.actions.flags.writeable)
+        self.assertFalse(self.sim.rods.flags.writeable)
+        self.assertFalse(self.sim.cables.flags.writeable)
+
+    def testResetKeepsViews(self):
+        rods = self.sim.rods
+        start = rods.copy()
+        self.sim.step(100)
+        self.sim.reset()
+        self.assertEqual(self.sim.time, 0.0)
+        numpy.testing.assert_allclose(rods, start)
+
+if __name__ == "__main__":
+    unittest.main()
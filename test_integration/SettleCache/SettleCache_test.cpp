@@ -0,0 +1,193 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file SettleCache_test.cpp
+* @brief Checks that a settled state saved by tgSettleCache restores to
+* the same world, and that models it can't save are refused
+* $Id$
+*/
+
+// This library
+#include "core/terrain/tgEmptyGround.h"
+#include "core/tgBasicActuator.h"
+#include "core/tgModel.h"
+#include "core/tgRod.h"
+#include "core/tgSimView.h"
+#include "core/tgSimulation.h"
+#include "core/tgSimulationState.h"
+#include "core/tgWorld.h"
+#include "tgcreator/tgBasicActuatorInfo.h"
+#include "tgcreator/tgBasicContactCableInfo.h"
+#include "tgcreator/tgBuildSpec.h"
+#include "tgcreator/tgRodInfo.h"
+#include "tgcreator/tgStructure.h"
+#include "tgcreator/tgStructureInfo.h"
+// The C++ Standard Library
+#include <cstdio>
+#include <stdexcept>
+#include <vector>
+// Google Test
+#include "gtest/gtest.h"
+
+
+using namespace std;
+
+namespace {
+
+	const double dt = 1.0/1000.0;
+
+	const char* const cacheFile = "SettleCache_test.cache";
+
+	/**
+	 * Two crossed rods joined end to end by four pretensioned cables,
+	 * which set them swinging
+	 */
+	class CrossModel : public tgModel
+	{
+	public:
+		CrossModel(bool contact) : m_contact(contact) { }
+
+		virtual void setup(tgWorld& world)
+		{
+			tgStructure s;
+			s.addNode(-1.0, 2.0, 0.0);
+			s.addNode(1.0, 2.0, 0.0);
+			s.addNode(0.0, 2.5, -1.0);
+			s.addNode(0.0, 2.0, 1.0);
+			s.addPair(0, 1, "rod");
+			s.addPair(2, 3, "rod");
+			s.addPair(0, 2, "cable");
+			s.addPair(2, 1, "cable");
+			s.addPair(1, 3, "cable");
+			s.addPair(3, 0, "cable");
+
+			const tgBasicActuator::Config cable(500.0, 5.0, 100.0);
+			tgBuildSpec spec;
+			spec.addBuilder("rod", new tgRodInfo(tgRod::Config(0.1, 1.0)));
+			if (m_contact)
+			{
+				spec.addBuilder("cable", new tgBasicContactCableInfo(cable));
+			}
+			else
+			{
+				spec.addBuilder("cable", new tgBasicActuatorInfo(cable));
+			}
+
+			tgStructureInfo structureInfo(s, spec);
+			structureInfo.buildInto(*this, world);
+
+			tgModel::setup(world);
+		}
+
+	private:
+		const bool m_contact;
+	};
+
+	class SettleCacheTest : public ::testing::Test {
+		protected:
+			SettleCacheTest()
+			{
+				std::remove(cacheFile);
+			}
+
+			virtual ~SettleCacheTest()
+			{
+				std::remove(cacheFile);
+			}
+
+			/**
+			 * Settle through the cache, then run on; return the states
+			 * after both. No gravity or ground, so nothing but the
+			 * bodies and cables carries over.
+			 */
+			bool run(size_t key, vector<double>& settled, vector<double>& after,
+					 double worldSize = 1000.0)
+			{
+				tgWorld world(tgWorld::Config(0.0, worldSize),
+							  new tgEmptyGround());
+				tgSimView view(world, dt, 1.0/60.0);
+				tgSimulation simulation(view);
+				simulation.addModel(new CrossModel(false));
+				simulation.setSettleCache(cacheFile, key);
+				const bool restored = simulation.settle(dt, 500);
+
+				tgSimulationState state;
+				simulation.captureState(state);
+				settled = state.getData();
+				for (int i = 0; i < 500; i++)
+				{
+					simulation.step(dt);
+				}
+				simulation.captureState(state);
+				after = state.getData();
+				return restored;
+			}
+	};
+
+	TEST_F(SettleCacheTest, RestoresSavedState) {
+				vector<double> settled;
+				vector<double> after;
+				EXPECT_FALSE(run(1, settled, after));
+				ASSERT_EQ(2u * tgSimulationState::bodySize +
+						  4u * tgSimulationState::cableSize, settled.size());
+
+				vector<double> restoredSettled;
+				vector<double> restoredAfter;
+				EXPECT_TRUE(run(1, restoredSettled, restoredAfter));
+				EXPECT_EQ(settled, restoredSettled);
+
+				// The cables carry on from where they were
+				ASSERT_EQ(after.size(), restoredAfter.size());
+				for (size_t i = 0; i < after.size(); i++)
+				{
+					EXPECT_NEAR(after[i], restoredAfter[i], 1e-9) << "at " << i;
+				}
+	}
+
+	TEST_F(SettleCacheTest, MissesOtherKey) {
+				vector<double> settled;
+				vector<double> after;
+				EXPECT_FALSE(run(1, settled, after));
+				EXPECT_FALSE(run(2, settled, after));
+				EXPECT_TRUE(run(2, settled, after));
+	}
+
+	TEST_F(SettleCacheTest, MissesOtherWorldConfig) {
+				vector<double> settled;
+				vector<double> after;
+				EXPECT_FALSE(run(1, settled, after, 1000.0));
+				EXPECT_FALSE(run(1, settled, after, 500.0));
+				EXPECT_TRUE(run(1, settled, after, 500.0));
+	}
+
+	TEST_F(SettleCacheTest, RefusesContactCables) {
+				tgWorld world(tgWorld::Config(0.0), new tgEmptyGround());
+				tgSimView view(world, dt, 1.0/60.0);
+				tgSimulation simulation(view);
+				simulation.addModel(new CrossModel(true));
+				simulation.setSettleCache(cacheFile, 1);
+				EXPECT_THROW(simulation.settle(dt, 10), std::invalid_argument);
+	}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
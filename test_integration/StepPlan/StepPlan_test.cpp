@@ -0,0 +1,260 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file StepPlan_test.cpp
+* @brief Checks that tgSimulation's step plan steps nested, controlled
+* models exactly as recursing through them does
+* $Id$
+*/
+
+// This library
+#include "core/tgBasicActuator.h"
+#include "core/tgCast.h"
+#include "core/tgModel.h"
+#include "core/tgObserver.h"
+#include "core/tgRod.h"
+#include "core/tgSimView.h"
+#include "core/tgSimulation.h"
+#include "core/tgSimulationState.h"
+#include "core/tgSubject.h"
+#include "core/tgWorld.h"
+#include "tgcreator/tgBasicActuatorInfo.h"
+#include "tgcreator/tgBuildSpec.h"
+#include "tgcreator/tgRodInfo.h"
+#include "tgcreator/tgStructure.h"
+#include "tgcreator/tgStructureInfo.h"
+// The C++ Standard Library
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+// Google Test
+#include "gtest/gtest.h"
+
+
+using namespace std;
+
+namespace {
+
+	const double dt = 1.0/1000.0;
+
+	/** Two crossed rods at x, joined end to end by four cables */
+	void buildCross(tgModel& model, tgWorld& world, double x)
+	{
+		tgStructure s;
+		s.addNode(x - 1.0, 1.0, 0.0);
+		s.addNode(x + 1.0, 1.0, 0.0);
+		s.addNode(x, 1.2, -1.0);
+		s.addNode(x, 1.2, 1.0);
+		s.addPair(0, 1, "rod");
+		s.addPair(2, 3, "rod");
+		s.addPair(0, 2, "cable");
+		s.addPair(2, 1, "cable");
+		s.addPair(1, 3, "cable");
+		s.addPair(3, 0, "cable");
+
+		tgBuildSpec spec;
+		spec.addBuilder("rod", new tgRodInfo(tgRod::Config(0.1, 1.0)));
+		spec.addBuilder("cable", new tgBasicActuatorInfo(tgBasicActuator::Config(500.0, 5.0)));
+
+		tgStructureInfo structureInfo(s, spec);
+		structureInfo.buildInto(model, world);
+	}
+
+	/**
+	 * A controlled cross, stepped the usual way: notify the controllers,
+	 * then step the children through tgModel::step()
+	 */
+	class CrossModel : public tgSubject<CrossModel>, public tgModel
+	{
+	public:
+		CrossModel(double x) : m_x(x) { }
+
+		virtual void setup(tgWorld& world)
+		{
+			buildCross(*this, world, m_x);
+			tgModel::setup(world);
+		}
+
+		virtual void step(double dt)
+		{
+			notifyStep(dt);
+			tgModel::step(dt);
+		}
+
+	private:
+		const double m_x;
+	};
+
+	/** The cross at the origin, with two more crosses as sub-models */
+	class NestedModel : public CrossModel
+	{
+	public:
+		NestedModel() : CrossModel(0.0)
+		{
+			attach(&m_controller);
+		}
+
+		virtual void setup(tgWorld& world)
+		{
+			// Children are deleted on teardown, so make them each time
+			for (int i = 1; i <= 2; i++)
+			{
+				CrossModel* const pChild = new CrossModel(3.0 * i);
+				pChild->attach(&m_controller);
+				addChild(pChild);
+			}
+			CrossModel::setup(world);
+		}
+
+	private:
+		/**
+		 * Swings the rest lengths of the cross it is notified by, with a
+		 * phase from the order it is notified in, so the result depends
+		 * on the order the controllers run
+		 */
+		class SwayController : public tgObserver<CrossModel>
+		{
+		public:
+			SwayController() : m_calls(0) { }
+
+			virtual void onStep(CrossModel& subject, double dt)
+			{
+				const vector<tgBasicActuator*> cables =
+					tgCast::filter<tgModel, tgBasicActuator>(subject.getChildren());
+				const double target = 1.2 + 0.3 * sin(0.01 * m_calls);
+				for (size_t i = 0; i < cables.size(); i++)
+				{
+					cables[i]->setControlInput(target + 0.1 * i, dt);
+				}
+				m_calls++;
+			}
+
+		private:
+			int m_calls;
+		};
+
+		SwayController m_controller;
+	};
+
+	/** The state after some steps of the nested model */
+	vector<double> run(bool plan, int steps)
+	{
+		tgWorld world(tgWorld::Config(9.81));
+		tgSimView view(world, dt, 1.0/60.0);
+		tgSimulation simulation(view);
+		simulation.setStepPlanEnabled(plan);
+		simulation.addModel(new NestedModel());
+		for (int i = 0; i < steps; i++)
+		{
+			simulation.step(dt);
+		}
+
+		tgSimulationState state;
+		simulation.captureState(state);
+		EXPECT_EQ(6u, state.getBodyCount());
+		return state.getData();
+	}
+
+	TEST(StepPlanTest, MatchesRecursion) {
+				const vector<double> recursive = run(false, 2000);
+				ASSERT_FALSE(recursive.empty());
+				EXPECT_EQ(recursive, run(true, 2000));
+	}
+
+	/** Counts its steps */
+	class CountingModel : public tgModel
+	{
+	public:
+		CountingModel() : m_steps(0) { }
+
+		virtual void step(double dt)
+		{
+			m_steps++;
+			tgModel::step(dt);
+		}
+
+		int m_steps;
+	};
+
+	/** Steps its child itself, as some older models do */
+	class ExplicitModel : public tgModel
+	{
+	public:
+		ExplicitModel() : m_pChild(NULL) { }
+
+		virtual void setup(tgWorld& world)
+		{
+			m_pChild = new CountingModel();
+			addChild(m_pChild);
+			tgModel::setup(world);
+		}
+
+		virtual void step(double dt)
+		{
+			m_pChild->step(dt);
+		}
+
+		CountingModel* m_pChild;
+	};
+
+	// By default step() recurses, so a model that steps its children
+	// itself steps them once
+	TEST(StepPlanTest, IsOffByDefault) {
+				tgWorld world(tgWorld::Config(9.81));
+				tgSimView view(world, dt, 1.0/60.0);
+				tgSimulation simulation(view);
+				ExplicitModel* const pModel = new ExplicitModel();
+				simulation.addModel(pModel);
+				for (int i = 0; i < 10; i++)
+				{
+					simulation.step(dt);
+				}
+				EXPECT_EQ(10, pModel->m_pChild->m_steps);
+	}
+
+	// The features that need the plan don't turn it on behind the
+	// models' backs, and it stays on while they're set
+	TEST(StepPlanTest, IsExplicit) {
+				tgWorld world(tgWorld::Config(9.81));
+				tgSimView view(world, dt, 1.0/60.0);
+				tgSimulation simulation(view);
+				simulation.addModel(new ExplicitModel());
+				const tgAdaptiveTimestep::Config adaptive(dt, dt);
+				const tgCableProximity::Config proximity(0.05);
+				EXPECT_THROW(simulation.setAdaptiveTimestep(adaptive),
+							 std::logic_error);
+				EXPECT_THROW(simulation.setCableProximity(proximity),
+							 std::logic_error);
+
+				simulation.setStepPlanEnabled(true);
+				simulation.setAdaptiveTimestep(adaptive);
+				simulation.setCableProximity(proximity);
+				EXPECT_THROW(simulation.setStepPlanEnabled(false),
+							 std::logic_error);
+				simulation.disableAdaptiveTimestep();
+				simulation.disableCableProximity();
+				simulation.setStepPlanEnabled(false);
+	}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
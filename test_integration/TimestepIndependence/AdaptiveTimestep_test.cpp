@@ -0,0 +1,86 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file AdaptiveTimestep_test.cpp
+* @brief Checks that tgSimulation's adaptive mode, held to one substep
+* per control period, is the fixed step
+* $Id$
+*/
+
+// This application
+#include "examples/motorModel/tsTestRig.h"
+// This library
+#include "core/tgAdaptiveTimestep.h"
+#include "core/tgSimView.h"
+#include "core/tgSimulation.h"
+#include "core/tgSimulationState.h"
+#include "core/tgWorld.h"
+// The C++ Standard Library
+#include <vector>
+// Google Test
+#include "gtest/gtest.h"
+
+
+using namespace std;
+
+namespace {
+
+	const double stepSize = 1.0/1000.0;
+
+	/** The state after some steps of the linear motor rig */
+	vector<double> run(bool adaptive, int steps)
+	{
+		tgWorld world(tgWorld::Config(981));
+		tgSimView view(world, stepSize, 1.0/60.0);
+		tgSimulation simulation(view);
+		// Adaptive mode steps through the plan
+		simulation.setStepPlanEnabled(true);
+		if (adaptive)
+		{
+			simulation.setAdaptiveTimestep(tgAdaptiveTimestep::Config(stepSize, stepSize));
+		}
+		simulation.addModel(new tsTestRig(false));
+		for (int i = 0; i < steps; i++)
+		{
+			simulation.step(stepSize);
+		}
+		if (adaptive)
+		{
+			EXPECT_EQ(steps, simulation.getAdaptiveTimestep()->getSubstepCount());
+		}
+
+		tgSimulationState state;
+		simulation.captureState(state);
+		return state.getData();
+	}
+
+	// minStep = maxStep = the control period leaves one substep, taken
+	// in the same order as the fixed step
+	TEST(AdaptiveTimestepTest, SingleSubstepMatchesFixedStep) {
+				const vector<double> fixed = run(false, 2000);
+				ASSERT_FALSE(fixed.empty());
+				EXPECT_EQ(fixed, run(true, 2000));
+	}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,241 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file WorldArena_test.cpp
+* @brief Checks that blocks allocated through two world arenas go back
+* to the arena they came from, whichever thread or Scope frees them
+* $Id$
+*/
+
+// This library
+#include "core/tgWorldArena.h"
+// The Bullet Physics Library
+#include "LinearMath/btAlignedAllocator.h"
+// The C++ Standard Library
+#include <cstring>
+#include <vector>
+// Google Test
+#include "gtest/gtest.h"
+// POSIX threads
+#include <pthread.h>
+
+
+using namespace std;
+
+namespace {
+
+	/** Allocated by main() before any arena installs the hooks */
+	void* pEarly = NULL;
+
+	/** Allocate count blocks of assorted sizes, each filled with fill */
+	vector<char*> allocate(size_t count, char fill)
+	{
+		vector<char*> blocks;
+		for (size_t i = 0; i < count; i++)
+		{
+			const size_t size = 8 + (i * 37) % 3000;
+			char* const p = static_cast<char*>(btAlignedAlloc(size, 16));
+			memset(p, fill, size);
+			blocks.push_back(p);
+		}
+		return blocks;
+	}
+
+	/** Check that every block still holds fill, so none overlap */
+	void expectFilled(const vector<char*>& blocks, char fill)
+	{
+		for (size_t i = 0; i < blocks.size(); i++)
+		{
+			const size_t size = 8 + (i * 37) % 3000;
+			for (size_t j = 0; j < size; j++)
+			{
+				ASSERT_EQ(fill, blocks[i][j]) << "block " << i;
+			}
+		}
+	}
+
+	void* freeAll(void* pBlocks)
+	{
+		const vector<char*>& blocks = *static_cast<vector<char*>*>(pBlocks);
+		for (size_t i = 0; i < blocks.size(); i++)
+		{
+			btAlignedFree(blocks[i]);
+		}
+		return NULL;
+	}
+
+	class WorldArenaTest : public ::testing::Test {
+		protected:
+			WorldArenaTest() :
+				pFirst(new tgWorldArena()),
+				pSecond(new tgWorldArena())
+			{
+			}
+
+			virtual ~WorldArenaTest()
+			{
+				pFirst->release();
+				pSecond->release();
+			}
+
+			tgWorldArena* pFirst;
+			tgWorldArena* pSecond;
+	};
+
+	TEST_F(WorldArenaTest, FreesGoHomeFromAnyWorld) {
+				vector<char*> first;
+				vector<char*> second;
+				{
+					tgWorldArena::Scope scope(*pFirst);
+					first = allocate(200, 'a');
+				}
+				{
+					tgWorldArena::Scope scope(*pSecond);
+					second = allocate(100, 'b');
+				}
+				EXPECT_EQ(200u, pFirst->getLiveCount());
+				EXPECT_EQ(100u, pSecond->getLiveCount());
+				expectFilled(first, 'a');
+				expectFilled(second, 'b');
+
+				// The first world's blocks, freed while the second is current
+				{
+					tgWorldArena::Scope scope(*pSecond);
+					freeAll(&first);
+				}
+				EXPECT_EQ(0u, pFirst->getLiveCount());
+				EXPECT_EQ(100u, pSecond->getLiveCount());
+
+				// The second world's blocks, freed on a thread with no Scope
+				pthread_t thread;
+				ASSERT_EQ(0, pthread_create(&thread, NULL, freeAll, &second));
+				pthread_join(thread, NULL);
+				EXPECT_EQ(0u, pSecond->getLiveCount());
+
+				EXPECT_TRUE(pFirst->rewind());
+				EXPECT_TRUE(pSecond->rewind());
+	}
+
+	// Freed blocks are reused by their own arena only
+	TEST_F(WorldArenaTest, ReusesOwnBlocks) {
+				vector<char*> first;
+				{
+					tgWorldArena::Scope scope(*pFirst);
+					first = allocate(50, 'a');
+				}
+				const size_t chunks = pFirst->getChunkCount();
+				{
+					tgWorldArena::Scope scope(*pSecond);
+					freeAll(&first);
+				}
+				{
+					tgWorldArena::Scope scope(*pFirst);
+					first = allocate(50, 'c');
+				}
+				EXPECT_EQ(chunks, pFirst->getChunkCount());
+				EXPECT_EQ(0u, pSecond->getChunkCount());
+				expectFilled(first, 'c');
+				freeAll(&first);
+				EXPECT_EQ(0u, pFirst->getLiveCount());
+	}
+
+	// Blocks from outside any Scope, or too large, come from malloc and
+	// go back there
+	TEST_F(WorldArenaTest, FallsBackToMalloc) {
+				void* const pLoose = btAlignedAlloc(64, 16);
+				void* pLarge = NULL;
+				{
+					tgWorldArena::Scope scope(*pFirst);
+					pLarge = btAlignedAlloc(tgWorldArena::getMaxBlockSize() + 1, 16);
+				}
+				EXPECT_EQ(0u, pFirst->getLiveCount());
+				EXPECT_EQ(0u, pSecond->getLiveCount());
+				{
+					tgWorldArena::Scope scope(*pSecond);
+					btAlignedFree(pLoose);
+					btAlignedFree(pLarge);
+				}
+				EXPECT_EQ(0u, pSecond->getLiveCount());
+	}
+
+	// The hooks free what Bullet allocated before they were installed
+	// without reading anything in front of it
+	TEST_F(WorldArenaTest, FreesBlocksFromBeforeInstall) {
+				ASSERT_TRUE(pEarly != NULL);
+				{
+					tgWorldArena::Scope scope(*pFirst);
+					btAlignedFree(pEarly);
+					pEarly = NULL;
+				}
+				EXPECT_EQ(0u, pFirst->getLiveCount());
+	}
+
+	// Frees under a Teardown skip the free lists, and the arena starts
+	// over once the last block is gone
+	TEST_F(WorldArenaTest, TeardownReleasesInBulk) {
+				vector<char*> first;
+				{
+					tgWorldArena::Scope scope(*pFirst);
+					first = allocate(100, 'a');
+				}
+				char* const pStart = first[0];
+				{
+					tgWorldArena::Teardown teardown(*pFirst);
+					freeAll(&first);
+					EXPECT_EQ(0u, pFirst->getLiveCount());
+				}
+				{
+					tgWorldArena::Scope scope(*pFirst);
+					first = allocate(1, 'b');
+				}
+				EXPECT_EQ(pStart, first[0]);
+
+				// A survivor stops the rewind, and the dropped blocks
+				// aren't handed out again
+				vector<char*> survivor;
+				{
+					tgWorldArena::Scope scope(*pFirst);
+					survivor = allocate(1, 'c');
+				}
+				{
+					tgWorldArena::Teardown teardown(*pFirst);
+					freeAll(&first);
+				}
+				EXPECT_EQ(1u, pFirst->getLiveCount());
+				{
+					tgWorldArena::Scope scope(*pFirst);
+					first = allocate(1, 'd');
+				}
+				EXPECT_NE(pStart, first[0]);
+				expectFilled(survivor, 'c');
+				freeAll(&first);
+				freeAll(&survivor);
+	}
+
+	TEST_F(WorldArenaTest, RejectsSmallChunks) {
+				EXPECT_THROW(new tgWorldArena(16), std::invalid_argument);
+	}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	pEarly = btAlignedAlloc(64, 16);
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,100 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file WrappingCable_test.cpp
+* @brief Checks the path tgBulletWrappingSpringCable finds over a cylinder
+* $Id$
+*/
+
+// This library
+#include "core/tgBulletWrappingSpringCable.h"
+
+#include "LinearMath/btVector3.h"
+
+// The C++ Standard Library
+#include <cmath>
+// Google Test
+#include "gtest/gtest.h"
+
+
+using namespace std;
+
+namespace {
+
+	typedef tgBulletWrappingSpringCable::Wrap Wrap;
+
+	/** A unit cylinder along z from -1 to 1 */
+	Wrap wrapUnit(const btVector3& from, const btVector3& to)
+	{
+		return tgBulletWrappingSpringCable::wrapCylinder(from, to,
+														btVector3(0.0, 0.0, -1.0),
+														btVector3(0.0, 0.0, 1.0),
+														1.0);
+	}
+
+	TEST(WrappingCableTest, WrapsInAPlane) {
+		const Wrap wrap = wrapUnit(btVector3(-2.0, 0.0, 0.0), btVector3(2.0, 0.0, 0.0));
+
+		// Tangents of length sqrt(3) and a sixth of a turn
+		ASSERT_EQ(0, wrap.cylinder);
+		EXPECT_NEAR(M_PI / 3.0, wrap.angle, 1e-12);
+		EXPECT_NEAR(2.0 * sqrt(3.0) + M_PI / 3.0, wrap.length, 1e-12);
+		EXPECT_NEAR(1.0, wrap.tangent1.length(), 1e-12);
+		EXPECT_NEAR(1.0, wrap.tangent2.length(), 1e-12);
+		EXPECT_NEAR(sqrt(3.0), wrap.tangent1.distance(btVector3(-2.0, 0.0, 0.0)), 1e-12);
+		EXPECT_NEAR(sqrt(3.0), wrap.tangent2.distance(btVector3(2.0, 0.0, 0.0)), 1e-12);
+	}
+
+	TEST(WrappingCableTest, WrapsAlongAHelix) {
+		const Wrap wrap = wrapUnit(btVector3(-2.0, 0.0, -0.5), btVector3(2.0, 0.0, 0.5));
+
+		// Unrolled, the path is a straight line
+		const double around = 2.0 * sqrt(3.0) + M_PI / 3.0;
+		ASSERT_EQ(0, wrap.cylinder);
+		EXPECT_NEAR(sqrt(around * around + 1.0), wrap.length, 1e-12);
+		EXPECT_NEAR(-0.5 + sqrt(3.0) / around, wrap.tangent1.z(), 1e-12);
+		EXPECT_NEAR(0.5 - sqrt(3.0) / around, wrap.tangent2.z(), 1e-12);
+	}
+
+	TEST(WrappingCableTest, StaysStraightWhenClear) {
+		const btVector3 from(-2.0, 2.0, 0.0);
+		const btVector3 to(2.0, 2.0, 0.0);
+
+		// Passes beside the cylinder
+		Wrap wrap = wrapUnit(from, to);
+		EXPECT_EQ(-1, wrap.cylinder);
+		EXPECT_DOUBLE_EQ(4.0, wrap.length);
+		EXPECT_EQ(to, wrap.tangent1);
+		EXPECT_EQ(from, wrap.tangent2);
+
+		// Passes over its end
+		wrap = wrapUnit(btVector3(-2.0, 0.0, -10.0), btVector3(2.0, 0.0, 10.0));
+		EXPECT_EQ(-1, wrap.cylinder);
+
+		// Starts inside it
+		wrap = wrapUnit(btVector3(0.5, 0.0, 0.0), btVector3(2.0, 0.0, 0.0));
+		EXPECT_EQ(-1, wrap.cylinder);
+	}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}